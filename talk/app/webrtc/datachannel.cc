@@ -38,6 +38,11 @@ namespace webrtc {
 static size_t kMaxQueuedReceivedDataBytes = 16 * 1024 * 1024;
 static size_t kMaxQueuedSendDataBytes = 16 * 1024 * 1024;
 
+// DataBuffers kept for reuse, and the largest buffer size kept, so that a
+// burst of large messages does not leave memory held up.
+static size_t kMaxPooledDataBuffers = 64;
+static size_t kMaxPooledDataBufferSize = 64 * 1024;
+
 enum {
   MSG_CHANNELREADY,
 };
@@ -114,7 +119,10 @@ DataChannel::DataChannel(
       send_ssrc_set_(false),
       receive_ssrc_set_(false),
       send_ssrc_(0),
-      receive_ssrc_(0) {
+      receive_ssrc_(0),
+      buffered_amount_low_(0),
+      buffered_amount_high_(0),
+      buffered_amount_above_low_(false) {
 }
 
 bool DataChannel::Init(const InternalDataChannelInit& config) {
@@ -158,7 +166,11 @@ bool DataChannel::Init(const InternalDataChannelInit& config) {
   return true;
 }
 
-DataChannel::~DataChannel() {}
+DataChannel::~DataChannel() {
+  for (size_t i = 0; i < free_buffers_.size(); ++i) {
+    delete free_buffers_[i];
+  }
+}
 
 void DataChannel::RegisterObserver(DataChannelObserver* observer) {
   observer_ = observer;
@@ -182,6 +194,14 @@ uint64 DataChannel::buffered_amount() const {
   return queued_send_data_.byte_count();
 }
 
+void DataChannel::SetBufferedAmountWatermarks(uint64 low, uint64 high) {
+  ASSERT(low <= high);
+  buffered_amount_low_ = low;
+  buffered_amount_high_ = high;
+  buffered_amount_above_low_ = false;
+  CheckBufferedAmount();
+}
+
 void DataChannel::Close() {
   if (state_ == kClosed)
     return;
@@ -325,9 +345,10 @@ void DataChannel::OnDataReceived(cricket::DataChannel* channel,
   waiting_for_open_ack_ = false;
 
   bool binary = (params.type == cricket::DMT_BINARY);
-  rtc::scoped_ptr<DataBuffer> buffer(new DataBuffer(payload, binary));
   if (was_ever_writable_ && observer_) {
-    observer_->OnMessage(*buffer.get());
+    DataBuffer* buffer = NewDataBuffer(payload, binary);
+    observer_->OnMessage(*buffer);
+    RecycleDataBuffer(buffer);
   } else {
     if (queued_received_data_.byte_count() + payload.length() >
             kMaxQueuedReceivedDataBytes) {
@@ -340,7 +361,7 @@ void DataChannel::OnDataReceived(cricket::DataChannel* channel,
 
       return;
     }
-    queued_received_data_.Push(buffer.release());
+    queued_received_data_.Push(NewDataBuffer(payload, binary));
   }
 }
 
@@ -452,9 +473,48 @@ void DataChannel::DeliverQueuedReceivedData() {
   }
 
   while (!queued_received_data_.Empty()) {
-    rtc::scoped_ptr<DataBuffer> buffer(queued_received_data_.Front());
-    observer_->OnMessage(*buffer);
+    DataBuffer* buffer = queued_received_data_.Front();
     queued_received_data_.Pop();
+    observer_->OnMessage(*buffer);
+    RecycleDataBuffer(buffer);
+  }
+}
+
+DataBuffer* DataChannel::NewDataBuffer(const rtc::Buffer& data, bool binary) {
+  if (free_buffers_.empty()) {
+    return new DataBuffer(data, binary);
+  }
+  DataBuffer* buffer = free_buffers_.back();
+  free_buffers_.pop_back();
+  buffer->data.SetData(data.data(), data.length());
+  buffer->binary = binary;
+  return buffer;
+}
+
+void DataChannel::RecycleDataBuffer(DataBuffer* buffer) {
+  if (free_buffers_.size() < kMaxPooledDataBuffers &&
+      buffer->data.capacity() <= kMaxPooledDataBufferSize) {
+    free_buffers_.push_back(buffer);
+  } else {
+    delete buffer;
+  }
+}
+
+void DataChannel::CheckBufferedAmount() {
+  if (buffered_amount_high_ == 0) {
+    return;
+  }
+  const uint64 amount = buffered_amount();
+  if (!buffered_amount_above_low_ && amount >= buffered_amount_high_) {
+    buffered_amount_above_low_ = true;
+    if (observer_) {
+      observer_->OnBufferedAmountHigh();
+    }
+  } else if (buffered_amount_above_low_ && amount <= buffered_amount_low_) {
+    buffered_amount_above_low_ = false;
+    if (observer_) {
+      observer_->OnBufferedAmountLow();
+    }
   }
 }
 
@@ -462,12 +522,15 @@ void DataChannel::SendQueuedDataMessages() {
   ASSERT(was_ever_writable_ && state_ == kOpen);
 
   while (!queued_send_data_.Empty()) {
-    rtc::scoped_ptr<DataBuffer> buffer(queued_send_data_.Front());
+    DataBuffer* buffer = queued_send_data_.Front();
     if (!SendDataMessage(*buffer, false)) {
+      // Leave the message in the queue until the transport unblocks again.
       break;
     }
     queued_send_data_.Pop();
+    RecycleDataBuffer(buffer);
   }
+  CheckBufferedAmount();
 }
 
 bool DataChannel::SendDataMessage(const DataBuffer& buffer,
@@ -521,7 +584,8 @@ bool DataChannel::QueueSendDataMessage(const DataBuffer& buffer) {
     LOG(LS_ERROR) << "Can't buffer any more data for the data channel.";
     return false;
   }
-  queued_send_data_.Push(new DataBuffer(buffer));
+  queued_send_data_.Push(NewDataBuffer(buffer.data, buffer.binary));
+  CheckBufferedAmount();
   return true;
 }
 
@@ -532,14 +596,15 @@ void DataChannel::SendQueuedControlMessages() {
   control_packets.Swap(&queued_control_data_);
 
   while (!control_packets.Empty()) {
-    rtc::scoped_ptr<DataBuffer> buf(control_packets.Front());
-    SendControlMessage(buf->data);
+    DataBuffer* buf = control_packets.Front();
     control_packets.Pop();
+    SendControlMessage(buf->data);
+    RecycleDataBuffer(buf);
   }
 }
 
 void DataChannel::QueueControlMessage(const rtc::Buffer& buffer) {
-  queued_control_data_.Push(new DataBuffer(buffer, true));
+  queued_control_data_.Push(NewDataBuffer(buffer, true));
 }
 
 bool DataChannel::SendControlMessage(const rtc::Buffer& buffer) {
@@ -30,6 +30,7 @@
 
 #include <deque>
 #include <string>
+#include <vector>
 
 #include "talk/app/webrtc/datachannelinterface.h"
 #include "talk/app/webrtc/proxy.h"
@@ -124,6 +125,7 @@ class DataChannel : public DataChannelInterface,
   virtual bool negotiated() const { return config_.negotiated; }
   virtual int id() const { return config_.id; }
   virtual uint64 buffered_amount() const;
+  virtual void SetBufferedAmountWatermarks(uint64 low, uint64 high);
   virtual void Close();
   virtual DataState state() const { return state_; }
   virtual bool Send(const DataBuffer& buffer);
@@ -212,6 +214,15 @@ class DataChannel : public DataChannelInterface,
 
   void DeliverQueuedReceivedData();
 
+  // Returns a DataBuffer holding a copy of |data|, reusing the storage of a
+  // pooled one if there is any.
+  DataBuffer* NewDataBuffer(const rtc::Buffer& data, bool binary);
+  // Returns |buffer| to the pool, or deletes it if the pool is full.
+  void RecycleDataBuffer(DataBuffer* buffer);
+
+  // Notifies the observer if buffered_amount() crossed a watermark.
+  void CheckBufferedAmount();
+
   void SendQueuedDataMessages();
   bool SendDataMessage(const DataBuffer& buffer, bool queue_if_blocked);
   bool QueueSendDataMessage(const DataBuffer& buffer);
@@ -238,6 +249,13 @@ class DataChannel : public DataChannelInterface,
   PacketQueue queued_control_data_;
   PacketQueue queued_received_data_;
   PacketQueue queued_send_data_;
+  // DataBuffers done with, kept to be reused by NewDataBuffer().
+  std::vector<DataBuffer*> free_buffers_;
+  uint64 buffered_amount_low_;
+  uint64 buffered_amount_high_;
+  // True from when OnBufferedAmountHigh() is called until
+  // OnBufferedAmountLow() is.
+  bool buffered_amount_above_low_;
 };
 
 class DataChannelFactory {
@@ -264,6 +282,7 @@ BEGIN_PROXY_MAP(DataChannel)
   PROXY_CONSTMETHOD0(int, id)
   PROXY_CONSTMETHOD0(DataState, state)
   PROXY_CONSTMETHOD0(uint64, buffered_amount)
+  PROXY_METHOD2(void, SetBufferedAmountWatermarks, uint64, uint64)
   PROXY_METHOD0(void, Close)
   PROXY_METHOD1(bool, Send, const DataBuffer&)
 END_PROXY()
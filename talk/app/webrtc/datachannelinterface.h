@@ -90,6 +90,13 @@ class DataChannelObserver {
   virtual void OnStateChange() = 0;
   //  A data buffer was successfully received.
   virtual void OnMessage(const DataBuffer& buffer) = 0;
+  // The buffered amount has reached the high watermark set with
+  // SetBufferedAmountWatermarks(). Applications streaming data should stop
+  // sending until OnBufferedAmountLow() is called.
+  virtual void OnBufferedAmountHigh() {}
+  // The buffered amount has dropped to the low watermark after having reached
+  // the high watermark.
+  virtual void OnBufferedAmountLow() {}
 
  protected:
   virtual ~DataChannelObserver() {}
@@ -128,6 +135,9 @@ class DataChannelInterface : public rtc::RefCountInterface {
   // (UTF-8 text and binary data) that have been queued using SendBuffer but
   // have not yet been transmitted to the network.
   virtual uint64 buffered_amount() const = 0;
+  // Sets the buffered_amount() at which the observer is told to stop and to
+  // resume sending. A |high| of 0, the default, disables the notifications.
+  virtual void SetBufferedAmountWatermarks(uint64 low, uint64 high) = 0;
   virtual void Close() = 0;
   // Sends |data| to the remote peer.
   virtual bool Send(const DataBuffer& buffer) = 0;
@@ -0,0 +1,148 @@
+/*
+ * libjingle
+ * Copyright 2014, Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "talk/app/webrtc/dtlsidentitypool.h"
+
+#include "webrtc/base/logging.h"
+
+namespace webrtc {
+
+enum {
+  MSG_GENERATE,
+};
+
+DtlsIdentityPool::DtlsIdentityPool(const std::string& common_name,
+                                   size_t size)
+    : common_name_(common_name),
+      size_(size),
+      generating_(false) {
+  thread_.SetName("DtlsIdentityPool", this);
+  thread_.Start();
+  rtc::CritScope cs(&crit_);
+  GenerateIfNeeded_l();
+}
+
+DtlsIdentityPool::~DtlsIdentityPool() {
+  // Waits for an identity being generated.
+  thread_.Stop();
+  while (!identities_.empty()) {
+    delete identities_.front();
+    identities_.pop_front();
+  }
+}
+
+void DtlsIdentityPool::set_size(size_t size) {
+  rtc::CritScope cs(&crit_);
+  size_ = size;
+  while (identities_.size() > size_) {
+    delete identities_.back();
+    identities_.pop_back();
+  }
+  GenerateIfNeeded_l();
+}
+
+size_t DtlsIdentityPool::size() const {
+  rtc::CritScope cs(&crit_);
+  return size_;
+}
+
+size_t DtlsIdentityPool::ready() const {
+  rtc::CritScope cs(&crit_);
+  return identities_.size();
+}
+
+void DtlsIdentityPool::RequestIdentity(rtc::Thread* thread,
+                                       rtc::MessageHandler* handler,
+                                       uint32 message_id) {
+  rtc::CritScope cs(&crit_);
+  Request request(thread, handler, message_id);
+  if (!identities_.empty()) {
+    PostIdentity_l(request, identities_.front());
+    identities_.pop_front();
+  } else {
+    requests_.push_back(request);
+  }
+  GenerateIfNeeded_l();
+}
+
+void DtlsIdentityPool::CancelRequests(rtc::MessageHandler* handler) {
+  rtc::CritScope cs(&crit_);
+  std::deque<Request>::iterator it = requests_.begin();
+  while (it != requests_.end()) {
+    if (it->handler == handler) {
+      it = requests_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void DtlsIdentityPool::OnMessage(rtc::Message* msg) {
+  ASSERT(msg->message_id == MSG_GENERATE);
+  ASSERT(thread_.IsCurrent());
+  rtc::SSLIdentity* identity = rtc::SSLIdentity::Generate(common_name_);
+
+  rtc::CritScope cs(&crit_);
+  generating_ = false;
+  if (!identity) {
+    LOG(LS_ERROR) << "Failed to generate an identity for the pool.";
+    // Fails the waiting requests rather than retrying at once. The next
+    // request starts a new attempt.
+    while (!requests_.empty()) {
+      PostIdentity_l(requests_.front(), NULL);
+      requests_.pop_front();
+    }
+    return;
+  }
+  if (!requests_.empty()) {
+    PostIdentity_l(requests_.front(), identity);
+    requests_.pop_front();
+  } else if (identities_.size() < size_) {
+    identities_.push_back(identity);
+  } else {
+    // The requests were cancelled, or the pool made smaller.
+    delete identity;
+  }
+  GenerateIfNeeded_l();
+}
+
+void DtlsIdentityPool::PostIdentity_l(const Request& request,
+                                      rtc::SSLIdentity* identity) {
+  request.thread->Post(request.handler, request.message_id,
+                       new rtc::ScopedMessageData<rtc::SSLIdentity>(identity));
+}
+
+void DtlsIdentityPool::GenerateIfNeeded_l() {
+  if (generating_ ||
+      (identities_.size() >= size_ && requests_.empty())) {
+    return;
+  }
+  generating_ = true;
+  thread_.Post(this, MSG_GENERATE);
+}
+
+}  // namespace webrtc
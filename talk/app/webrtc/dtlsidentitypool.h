@@ -0,0 +1,98 @@
+/*
+ * libjingle
+ * Copyright 2014, Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TALK_APP_WEBRTC_DTLSIDENTITYPOOL_H_
+#define TALK_APP_WEBRTC_DTLSIDENTITYPOOL_H_
+
+#include <deque>
+#include <string>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/messagehandler.h"
+#include "webrtc/base/sslidentity.h"
+#include "webrtc/base/thread.h"
+
+namespace webrtc {
+
+// Keeps a number of DTLS identities ready for new sessions, so that they do
+// not have to wait for a key pair to be generated. The identities are
+// generated on a thread owned by the pool, which refills the pool as
+// identities are taken. All methods are thread safe.
+class DtlsIdentityPool : public rtc::MessageHandler {
+ public:
+  // |size| is the number of identities to keep ready.
+  DtlsIdentityPool(const std::string& common_name, size_t size);
+  virtual ~DtlsIdentityPool();
+
+  void set_size(size_t size);
+  size_t size() const;
+  // Returns the number of identities ready to be taken.
+  size_t ready() const;
+
+  // Requests an identity, which is posted to |handler| on |thread| in a
+  // message with id |message_id|. The data of the message is a
+  // rtc::ScopedMessageData<rtc::SSLIdentity>, which holds NULL if the
+  // identity could not be generated. The identity is posted at once if one is
+  // ready, else as soon as one has been generated.
+  void RequestIdentity(rtc::Thread* thread,
+                       rtc::MessageHandler* handler,
+                       uint32 message_id);
+  // Drops the requests of |handler| that are still waiting for an identity.
+  // Must be called before |handler| is destroyed.
+  void CancelRequests(rtc::MessageHandler* handler);
+
+ private:
+  struct Request {
+    Request(rtc::Thread* thread, rtc::MessageHandler* handler,
+            uint32 message_id)
+        : thread(thread), handler(handler), message_id(message_id) {}
+
+    rtc::Thread* thread;
+    rtc::MessageHandler* handler;
+    uint32 message_id;
+  };
+
+  // rtc::MessageHandler implementation.
+  virtual void OnMessage(rtc::Message* msg);
+
+  void PostIdentity_l(const Request& request, rtc::SSLIdentity* identity);
+  void GenerateIfNeeded_l();
+
+  const std::string common_name_;
+  rtc::Thread thread_;
+  mutable rtc::CriticalSection crit_;
+  size_t size_;
+  bool generating_;
+  std::deque<rtc::SSLIdentity*> identities_;
+  std::deque<Request> requests_;
+
+  DISALLOW_COPY_AND_ASSIGN(DtlsIdentityPool);
+};
+
+}  // namespace webrtc
+
+#endif  // TALK_APP_WEBRTC_DTLSIDENTITYPOOL_H_
@@ -0,0 +1,116 @@
+/*
+ * libjingle
+ * Copyright 2014, Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "talk/app/webrtc/dtlsidentitypool.h"
+
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread.h"
+
+using webrtc::DtlsIdentityPool;
+
+static const char kCommonName[] = "WebRTC";
+static const int kTimeoutMs = 10000;
+
+enum {
+  MSG_IDENTITY,
+};
+
+// Receives the identities posted by the pool.
+class IdentityReceiver : public rtc::MessageHandler {
+ public:
+  IdentityReceiver() : received_(0) {}
+
+  int received() const { return received_; }
+  rtc::SSLIdentity* identity() const { return identity_.get(); }
+
+ private:
+  virtual void OnMessage(rtc::Message* msg) {
+    EXPECT_EQ(MSG_IDENTITY, static_cast<int>(msg->message_id));
+    rtc::ScopedMessageData<rtc::SSLIdentity>* data =
+        static_cast<rtc::ScopedMessageData<rtc::SSLIdentity>*>(msg->pdata);
+    identity_.reset(data->data().release());
+    delete data;
+    ++received_;
+  }
+
+  int received_;
+  rtc::scoped_ptr<rtc::SSLIdentity> identity_;
+};
+
+TEST(DtlsIdentityPoolTest, FillsToSize) {
+  DtlsIdentityPool pool(kCommonName, 2);
+  EXPECT_EQ(2u, pool.size());
+  EXPECT_EQ_WAIT(2u, pool.ready(), kTimeoutMs);
+}
+
+TEST(DtlsIdentityPoolTest, RequestIdentityFromFullPool) {
+  DtlsIdentityPool pool(kCommonName, 2);
+  EXPECT_EQ_WAIT(2u, pool.ready(), kTimeoutMs);
+
+  IdentityReceiver receiver;
+  pool.RequestIdentity(rtc::Thread::Current(), &receiver, MSG_IDENTITY);
+  EXPECT_EQ(1u, pool.ready());
+  EXPECT_EQ_WAIT(1, receiver.received(), kTimeoutMs);
+  EXPECT_TRUE(receiver.identity() != NULL);
+  // The identity taken is replaced.
+  EXPECT_EQ_WAIT(2u, pool.ready(), kTimeoutMs);
+}
+
+TEST(DtlsIdentityPoolTest, RequestIdentityFromEmptyPool) {
+  DtlsIdentityPool pool(kCommonName, 0);
+  IdentityReceiver receiver1;
+  IdentityReceiver receiver2;
+  pool.RequestIdentity(rtc::Thread::Current(), &receiver1, MSG_IDENTITY);
+  pool.RequestIdentity(rtc::Thread::Current(), &receiver2, MSG_IDENTITY);
+  EXPECT_EQ_WAIT(1, receiver1.received(), kTimeoutMs);
+  EXPECT_EQ_WAIT(1, receiver2.received(), kTimeoutMs);
+  EXPECT_TRUE(receiver1.identity() != NULL);
+  EXPECT_TRUE(receiver2.identity() != NULL);
+  EXPECT_EQ(0u, pool.ready());
+}
+
+TEST(DtlsIdentityPoolTest, CancelRequests) {
+  DtlsIdentityPool pool(kCommonName, 0);
+  IdentityReceiver cancelled_receiver;
+  IdentityReceiver receiver;
+  pool.RequestIdentity(rtc::Thread::Current(), &cancelled_receiver,
+                       MSG_IDENTITY);
+  pool.CancelRequests(&cancelled_receiver);
+  pool.RequestIdentity(rtc::Thread::Current(), &receiver, MSG_IDENTITY);
+  EXPECT_EQ_WAIT(1, receiver.received(), kTimeoutMs);
+  EXPECT_EQ(0, cancelled_receiver.received());
+}
+
+TEST(DtlsIdentityPoolTest, SetSize) {
+  DtlsIdentityPool pool(kCommonName, 2);
+  EXPECT_EQ_WAIT(2u, pool.ready(), kTimeoutMs);
+  pool.set_size(1);
+  EXPECT_EQ(1u, pool.ready());
+  pool.set_size(3);
+  EXPECT_EQ_WAIT(3u, pool.ready(), kTimeoutMs);
+}
@@ -1026,7 +1026,7 @@ class StatsObserverWrapper : public StatsObserver {
       // Should we use the '.name' enum value here instead of converting the
       // name to a string?
       jstring j_name = JavaStringFromStdString(jni, value.display_name());
-      jstring j_value = JavaStringFromStdString(jni, value.value);
+      jstring j_value = JavaStringFromStdString(jni, value.ToString());
       jobject j_element_value =
           jni->NewObject(*j_value_class_, j_value_ctor_, j_name, j_value);
       jni->SetObjectArrayElement(j_values, i, j_element_value);
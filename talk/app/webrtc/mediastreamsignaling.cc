@@ -27,6 +27,8 @@
 
 #include "talk/app/webrtc/mediastreamsignaling.h"
 
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "talk/app/webrtc/audiotrack.h"
@@ -51,6 +53,9 @@ namespace webrtc {
 using rtc::scoped_ptr;
 using rtc::scoped_refptr;
 
+// (stream label, track id) pairs of the tracks already known.
+typedef std::set<std::pair<std::string, std::string> > TrackIdSet;
+
 static bool ParseConstraintsForAnswer(
     const MediaConstraintsInterface* constraints,
     cricket::MediaSessionOptions* options) {
@@ -588,15 +593,15 @@ void MediaStreamSignaling::UpdateRemoteStreamsList(
     cricket::MediaType media_type,
     StreamCollection* new_streams) {
   TrackInfos* current_tracks = GetRemoteTracks(media_type);
+  cricket::StreamSsrcIndex streams_by_ssrc(streams);
 
   // Find removed tracks. Ie tracks where the track id or ssrc don't match the
   // new StreamParam.
   TrackInfos::iterator track_it = current_tracks->begin();
   while (track_it != current_tracks->end()) {
     const TrackInfo& info = *track_it;
-    cricket::StreamParams params;
-    if (!cricket::GetStreamBySsrc(streams, info.ssrc, &params) ||
-        params.id != info.track_id) {
+    const cricket::StreamParams* params = streams_by_ssrc.Find(info.ssrc);
+    if (!params || params->id != info.track_id) {
       OnRemoteTrackRemoved(info.stream_label, info.track_id, media_type);
       track_it = current_tracks->erase(track_it);
     } else {
@@ -604,7 +609,15 @@ void MediaStreamSignaling::UpdateRemoteStreamsList(
     }
   }
 
-  // Find new and active tracks.
+  TrackIdSet known_tracks;
+  for (track_it = current_tracks->begin(); track_it != current_tracks->end();
+       ++track_it) {
+    known_tracks.insert(
+        std::make_pair(track_it->stream_label, track_it->track_id));
+  }
+
+  // Find new tracks. A known track is in a known MediaStream already, so the
+  // streams that did not change are skipped without further lookups.
   for (cricket::StreamParamsVec::const_iterator it = streams.begin();
        it != streams.end(); ++it) {
     // The sync_label is the MediaStream label and the |stream.id| is the
@@ -612,6 +625,8 @@ void MediaStreamSignaling::UpdateRemoteStreamsList(
     const std::string& stream_label = it->sync_label;
     const std::string& track_id = it->id;
     uint32 ssrc = it->first_ssrc();
+    if (!known_tracks.insert(std::make_pair(stream_label, track_id)).second)
+      continue;
 
     rtc::scoped_refptr<MediaStreamInterface> stream =
         remote_streams_->find(stream_label);
@@ -622,12 +637,8 @@ void MediaStreamSignaling::UpdateRemoteStreamsList(
       new_streams->AddStream(stream);
     }
 
-    const TrackInfo* track_info = FindTrackInfo(*current_tracks, stream_label,
-                                                track_id);
-    if (!track_info) {
-      current_tracks->push_back(TrackInfo(stream_label, track_id, ssrc));
-      OnRemoteTrackSeen(stream_label, track_id, it->first_ssrc(), media_type);
-    }
+    current_tracks->push_back(TrackInfo(stream_label, track_id, ssrc));
+    OnRemoteTrackSeen(stream_label, track_id, ssrc, media_type);
   }
 }
 
@@ -775,15 +786,16 @@ void MediaStreamSignaling::UpdateLocalTracks(
     const std::vector<cricket::StreamParams>& streams,
     cricket::MediaType media_type) {
   TrackInfos* current_tracks = GetLocalTracks(media_type);
+  cricket::StreamSsrcIndex streams_by_ssrc(streams);
 
   // Find removed tracks. Ie tracks where the track id, stream label or ssrc
   // don't match the new StreamParam.
   TrackInfos::iterator track_it = current_tracks->begin();
   while (track_it != current_tracks->end()) {
     const TrackInfo& info = *track_it;
-    cricket::StreamParams params;
-    if (!cricket::GetStreamBySsrc(streams, info.ssrc, &params) ||
-        params.id != info.track_id || params.sync_label != info.stream_label) {
+    const cricket::StreamParams* params = streams_by_ssrc.Find(info.ssrc);
+    if (!params || params->id != info.track_id ||
+        params->sync_label != info.stream_label) {
       OnLocalTrackRemoved(info.stream_label, info.track_id, info.ssrc,
                           media_type);
       track_it = current_tracks->erase(track_it);
@@ -792,7 +804,14 @@ void MediaStreamSignaling::UpdateLocalTracks(
     }
   }
 
-  // Find new and active tracks.
+  TrackIdSet known_tracks;
+  for (track_it = current_tracks->begin(); track_it != current_tracks->end();
+       ++track_it) {
+    known_tracks.insert(
+        std::make_pair(track_it->stream_label, track_it->track_id));
+  }
+
+  // Find new tracks.
   for (cricket::StreamParamsVec::const_iterator it = streams.begin();
        it != streams.end(); ++it) {
     // The sync_label is the MediaStream label and the |stream.id| is the
@@ -800,13 +819,9 @@ void MediaStreamSignaling::UpdateLocalTracks(
     const std::string& stream_label = it->sync_label;
     const std::string& track_id = it->id;
     uint32 ssrc = it->first_ssrc();
-    const TrackInfo* track_info = FindTrackInfo(*current_tracks,
-                                                stream_label,
-                                                track_id);
-    if (!track_info) {
+    if (known_tracks.insert(std::make_pair(stream_label, track_id)).second) {
       current_tracks->push_back(TrackInfo(stream_label, track_id, ssrc));
-      OnLocalTrackSeen(stream_label, track_id, it->first_ssrc(),
-                       media_type);
+      OnLocalTrackSeen(stream_label, track_id, ssrc, media_type);
     }
   }
 }
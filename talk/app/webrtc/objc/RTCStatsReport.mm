@@ -58,7 +58,7 @@
     webrtc::StatsReport::Values::const_iterator it = statsReport.values.begin();
     for (; it != statsReport.values.end(); ++it) {
       RTCPair* pair = [[RTCPair alloc] initWithKey:@(it->display_name())
-                                             value:@(it->value.c_str())];
+                                             value:@(it->ToString().c_str())];
       [values addObject:pair];
     }
     _values = values;
@@ -384,7 +384,8 @@ bool PeerConnection::DoInitialize(
 
   // Initialize the WebRtcSession. It creates transport channels etc.
   if (!session_->Initialize(factory_->options(), constraints,
-                            dtls_identity_service, type))
+                            dtls_identity_service,
+                            factory_->dtls_identity_pool(), type))
     return false;
 
   // Register PeerConnection as receiver of local ice candidates.
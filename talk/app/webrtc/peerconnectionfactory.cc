@@ -27,6 +27,8 @@
 
 #include "talk/app/webrtc/peerconnectionfactory.h"
 
+#include <algorithm>
+
 #include "talk/app/webrtc/audiotrack.h"
 #include "talk/app/webrtc/localaudiosource.h"
 #include "talk/app/webrtc/mediastreamproxy.h"
@@ -37,6 +39,7 @@
 #include "talk/app/webrtc/videosource.h"
 #include "talk/app/webrtc/videosourceproxy.h"
 #include "talk/app/webrtc/videotrack.h"
+#include "talk/app/webrtc/webrtcsessiondescriptionfactory.h"
 #include "talk/media/devices/dummydevicemanager.h"
 #include "talk/media/webrtc/webrtcmediaengine.h"
 #include "talk/media/webrtc/webrtcvideodecoderfactory.h"
@@ -180,6 +183,19 @@ PeerConnectionFactory::~PeerConnectionFactory() {
   }
 }
 
+void PeerConnectionFactory::SetOptions(const Options& options) {
+  options_ = options;
+  size_t pool_size = static_cast<size_t>(
+      std::max(options_.dtls_identity_pool_size, 0));
+  if (dtls_identity_pool_) {
+    dtls_identity_pool_->set_size(pool_size);
+  } else if (pool_size > 0) {
+    // Starts generating the identities before the first PeerConnection.
+    dtls_identity_pool_.reset(
+        new DtlsIdentityPool(kWebRTCIdentityName, pool_size));
+  }
+}
+
 bool PeerConnectionFactory::Initialize() {
   InitMessageData result(false);
   signaling_thread_->Send(this, MSG_INIT_FACTORY, &result);
@@ -29,6 +29,7 @@
 
 #include <string>
 
+#include "talk/app/webrtc/dtlsidentitypool.h"
 #include "talk/app/webrtc/mediastreaminterface.h"
 #include "talk/app/webrtc/peerconnectioninterface.h"
 #include "talk/session/media/channelmanager.h"
@@ -40,9 +41,7 @@ namespace webrtc {
 class PeerConnectionFactory : public PeerConnectionFactoryInterface,
                               public rtc::MessageHandler {
  public:
-  virtual void SetOptions(const Options& options) {
-    options_ = options;
-  }
+  virtual void SetOptions(const Options& options);
 
   virtual rtc::scoped_refptr<PeerConnectionInterface>
       CreatePeerConnection(
@@ -78,6 +77,8 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface,
   virtual rtc::Thread* signaling_thread();
   virtual rtc::Thread* worker_thread();
   const Options& options() const { return options_; }
+  // Returns NULL unless Options::dtls_identity_pool_size has been set.
+  DtlsIdentityPool* dtls_identity_pool() { return dtls_identity_pool_.get(); }
 
  protected:
   PeerConnectionFactory();
@@ -114,6 +115,7 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface,
   rtc::Thread* signaling_thread_;
   rtc::Thread* worker_thread_;
   Options options_;
+  rtc::scoped_ptr<DtlsIdentityPool> dtls_identity_pool_;
   rtc::scoped_refptr<PortAllocatorFactoryInterface> allocator_factory_;
   // External Audio device used for audio playback.
   rtc::scoped_refptr<AudioDeviceModule> default_adm_;
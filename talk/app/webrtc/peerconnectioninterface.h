@@ -469,10 +469,15 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
    public:
     Options() :
       disable_encryption(false),
-      disable_sctp_data_channels(false) {
+      disable_sctp_data_channels(false),
+      dtls_identity_pool_size(0) {
     }
     bool disable_encryption;
     bool disable_sctp_data_channels;
+    // Number of DTLS identities to generate ahead of time, on a background
+    // thread, for PeerConnections that enable DTLS without a
+    // DTLSIdentityServiceInterface. 0 generates each identity when needed.
+    int dtls_identity_pool_size;
   };
 
   virtual void SetOptions(const Options& options) = 0;
@@ -51,10 +51,20 @@
 // END_PROXY()
 //
 // The proxy can be created using TestProxy::Create(Thread*, TestInterface*).
+//
+// Void methods whose caller does not need to wait for the call to finish can
+// be declared with PROXY_ASYNC_METHOD*, e.g. PROXY_ASYNC_METHOD1(FooD, bool).
+// The call is then posted to the owner thread and the proxy returns at once.
+// Calls on a proxy still run in the order they are made. The arguments are
+// copied, so pointer arguments must stay valid until the call has run.
+//
+// A MethodCallBatch can be used to make several calls with one thread hop.
 
 #ifndef TALK_APP_WEBRTC_PROXY_H_
 #define TALK_APP_WEBRTC_PROXY_H_
 
+#include <vector>
+
 #include "webrtc/base/event.h"
 #include "webrtc/base/thread.h"
 
@@ -119,6 +129,84 @@ class SynchronousMethodCall
   rtc::MessageHandler* proxy_;
 };
 
+// Base class of the calls made by PROXY_ASYNC_METHOD*. The call is posted as
+// the message data, so that it is deleted if the message is cleared.
+class AsynchronousMethodCall : public rtc::MessageData {
+ public:
+  virtual void Run() = 0;
+
+  // Runs the call directly on |t|, or posts it there to be run by |handler|.
+  // Takes ownership of the call.
+  void Invoke(rtc::Thread* t, rtc::MessageHandler* handler) {
+    if (t->IsCurrent()) {
+      Run();
+      delete this;
+    } else {
+      t->Post(handler, 0, this);
+    }
+  }
+};
+
+class AsynchronousMethodCallHandler : public rtc::MessageHandler {
+ public:
+  AsynchronousMethodCallHandler() {}
+
+ private:
+  void OnMessage(rtc::Message* msg) {
+    AsynchronousMethodCall* call =
+        static_cast<AsynchronousMethodCall*>(msg->pdata);
+    call->Run();
+    delete call;
+  }
+};
+
+// Type used to hold an argument of an asynchronous call. Const references
+// are held by value, since the caller does not wait for the call.
+template <typename T>
+struct AsyncArg {
+  typedef T Type;
+};
+
+template <typename T>
+struct AsyncArg<const T&> {
+  typedef T Type;
+};
+
+// A call made by MethodCallBatch.
+class BatchedCall {
+ public:
+  virtual ~BatchedCall() {}
+  virtual void Run() = 0;
+};
+
+template <typename C, typename M, typename R>
+class BatchedCall0 : public BatchedCall {
+ public:
+  BatchedCall0(C* c, M m, R* r) : c_(c), m_(m), r_(r) {}
+
+  virtual void Run() { *r_ = (c_->*m_)(); }
+
+ private:
+  C* c_;
+  M m_;
+  R* r_;
+};
+
+template <typename C, typename M, typename T1, typename R>
+class BatchedCall1 : public BatchedCall {
+ public:
+  BatchedCall1(C* c, M m, const T1& a1, R* r)
+      : c_(c), m_(m), a1_(a1), r_(r) {}
+
+  virtual void Run() { *r_ = (c_->*m_)(a1_); }
+
+ private:
+  C* c_;
+  M m_;
+  T1 a1_;
+  R* r_;
+};
+
 }  // internal
 
 template <typename C, typename R>
@@ -249,6 +337,93 @@ class MethodCall3 : public rtc::Message,
   T3 a3_;
 };
 
+template <typename C>
+class AsyncMethodCall0 : public internal::AsynchronousMethodCall {
+ public:
+  typedef void (C::*Method)();
+  AsyncMethodCall0(C* c, Method m) : c_(c), m_(m) {}
+
+ private:
+  virtual void Run() { (c_->*m_)(); }
+
+  rtc::scoped_refptr<C> c_;
+  Method m_;
+};
+
+template <typename C, typename T1>
+class AsyncMethodCall1 : public internal::AsynchronousMethodCall {
+ public:
+  typedef void (C::*Method)(T1 a1);
+  AsyncMethodCall1(C* c, Method m, T1 a1) : c_(c), m_(m), a1_(a1) {}
+
+ private:
+  virtual void Run() { (c_->*m_)(a1_); }
+
+  rtc::scoped_refptr<C> c_;
+  Method m_;
+  typename internal::AsyncArg<T1>::Type a1_;
+};
+
+template <typename C, typename T1, typename T2>
+class AsyncMethodCall2 : public internal::AsynchronousMethodCall {
+ public:
+  typedef void (C::*Method)(T1 a1, T2 a2);
+  AsyncMethodCall2(C* c, Method m, T1 a1, T2 a2)
+      : c_(c), m_(m), a1_(a1), a2_(a2) {}
+
+ private:
+  virtual void Run() { (c_->*m_)(a1_, a2_); }
+
+  rtc::scoped_refptr<C> c_;
+  Method m_;
+  typename internal::AsyncArg<T1>::Type a1_;
+  typename internal::AsyncArg<T2>::Type a2_;
+};
+
+// Collects calls, and makes them all on the owner thread with a single
+// thread hop. The calls can be made on proxies, which then run them directly.
+//
+//   MethodCallBatch batch;
+//   batch.Add(track1.get(), &AudioTrackInterface::state, &state1);
+//   batch.Add(track2.get(), &AudioTrackInterface::state, &state2);
+//   batch.Marshal(signaling_thread);
+//
+// The results are written to the given pointers by Marshal().
+class MethodCallBatch : public rtc::MessageHandler {
+ public:
+  MethodCallBatch() {}
+  ~MethodCallBatch() {
+    for (size_t i = 0; i < calls_.size(); ++i) {
+      delete calls_[i];
+    }
+  }
+
+  template <typename C, typename M, typename R>
+  void Add(C* c, M m, R* r) {
+    calls_.push_back(new internal::BatchedCall0<C, M, R>(c, m, r));
+  }
+
+  template <typename C, typename M, typename T1, typename R>
+  void Add(C* c, M m, const T1& a1, R* r) {
+    calls_.push_back(new internal::BatchedCall1<C, M, T1, R>(c, m, a1, r));
+  }
+
+  size_t size() const { return calls_.size(); }
+
+  void Marshal(rtc::Thread* t) {
+    internal::SynchronousMethodCall(this).Invoke(t);
+  }
+
+ private:
+  void OnMessage(rtc::Message*) {
+    for (size_t i = 0; i < calls_.size(); ++i) {
+      calls_[i]->Run();
+    }
+  }
+
+  std::vector<internal::BatchedCall*> calls_;
+};
+
 #define BEGIN_PROXY_MAP(c) \
   class c##Proxy : public c##Interface {\
    protected:\
@@ -302,6 +477,24 @@ class MethodCall3 : public rtc::Message,
       return call.Marshal(owner_thread_);\
     }\
 
+#define PROXY_ASYNC_METHOD0(method)\
+    void method() OVERRIDE {\
+      (new AsyncMethodCall0<C>(c_.get(), &C::method))->Invoke(\
+          owner_thread_, &async_handler_);\
+    }\
+
+#define PROXY_ASYNC_METHOD1(method, t1)\
+    void method(t1 a1) OVERRIDE {\
+      (new AsyncMethodCall1<C, t1>(c_.get(), &C::method, a1))->Invoke(\
+          owner_thread_, &async_handler_);\
+    }\
+
+#define PROXY_ASYNC_METHOD2(method, t1, t2)\
+    void method(t1 a1, t2 a2) OVERRIDE {\
+      (new AsyncMethodCall2<C, t1, t2>(c_.get(), &C::method, a1, a2))\
+          ->Invoke(owner_thread_, &async_handler_);\
+    }\
+
 #define END_PROXY() \
    private:\
     void Release_s() {\
@@ -309,6 +502,7 @@ class MethodCall3 : public rtc::Message,
     }\
     mutable rtc::Thread* owner_thread_;\
     rtc::scoped_refptr<C> c_;\
+    internal::AsynchronousMethodCallHandler async_handler_;\
   };\
 
 }  // namespace webrtc
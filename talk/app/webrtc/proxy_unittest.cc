@@ -30,14 +30,18 @@
 #include <string>
 
 #include "testing/base/public/gmock.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/refcount.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 
 using ::testing::_;
 using ::testing::DoAll;
 using ::testing::Exactly;
+using ::testing::InSequence;
 using ::testing::InvokeWithoutArgs;
 using ::testing::Return;
 
@@ -52,6 +56,8 @@ class FakeInterface : public rtc::RefCountInterface {
   virtual std::string Method1(std::string s) = 0;
   virtual std::string ConstMethod1(std::string s) const = 0;
   virtual std::string Method2(std::string s1, std::string s2) = 0;
+  virtual void AsyncMethod0() = 0;
+  virtual void AsyncMethod1(const std::string& s) = 0;
 
  protected:
   ~FakeInterface() {}
@@ -65,6 +71,8 @@ BEGIN_PROXY_MAP(Fake)
   PROXY_METHOD1(std::string, Method1, std::string)
   PROXY_CONSTMETHOD1(std::string, ConstMethod1, std::string)
   PROXY_METHOD2(std::string, Method2, std::string, std::string)
+  PROXY_ASYNC_METHOD0(AsyncMethod0)
+  PROXY_ASYNC_METHOD1(AsyncMethod1, const std::string&)
 END_PROXY()
 
 // Implementation of the test interface.
@@ -83,11 +91,75 @@ class Fake : public FakeInterface {
 
   MOCK_METHOD2(Method2, std::string(std::string, std::string));
 
+  MOCK_METHOD0(AsyncMethod0, void());
+  MOCK_METHOD1(AsyncMethod1, void(const std::string&));
+
  protected:
   Fake() {}
   ~Fake() {}
 };
 
+// Implementation of the test interface that only counts the calls, used to
+// measure the cost of the proxy itself.
+class CountingFake : public FakeInterface {
+ public:
+  static rtc::scoped_refptr<CountingFake> Create() {
+    return new rtc::RefCountedObject<CountingFake>();
+  }
+
+  virtual void VoidMethod0() { ++calls_; }
+  virtual std::string Method0() { ++calls_; return std::string(); }
+  virtual std::string ConstMethod0() const { return std::string(); }
+  virtual std::string Method1(std::string s) { ++calls_; return s; }
+  virtual std::string ConstMethod1(std::string s) const { return s; }
+  virtual std::string Method2(std::string s1, std::string s2) {
+    ++calls_;
+    return s1;
+  }
+  virtual void AsyncMethod0() { ++calls_; }
+  virtual void AsyncMethod1(const std::string& s) { ++calls_; }
+
+  int calls() const { return calls_; }
+
+ protected:
+  CountingFake() : calls_(0) {}
+  ~CountingFake() {}
+
+ private:
+  int calls_;
+};
+
+// Keeps a thread busy with tasks of |task_us| microseconds each, one after
+// the other, until stopped.
+class ThreadLoad : public rtc::MessageHandler {
+ public:
+  ThreadLoad(rtc::Thread* thread, int task_us)
+      : thread_(thread), task_us_(task_us), running_(true) {
+    thread_->Post(this);
+  }
+
+  void Stop() {
+    rtc::CritScope cs(&crit_);
+    running_ = false;
+  }
+
+ private:
+  virtual void OnMessage(rtc::Message*) {
+    uint64 end = rtc::TimeMicros() + task_us_;
+    while (rtc::TimeMicros() < end) {
+    }
+    rtc::CritScope cs(&crit_);
+    if (running_) {
+      thread_->Post(this);
+    }
+  }
+
+  rtc::Thread* thread_;
+  int task_us_;
+  rtc::CriticalSection crit_;
+  bool running_;
+};
+
 class ProxyTest: public testing::Test {
  public:
   // Checks that the functions is called on the |signaling_thread_|.
@@ -167,4 +239,113 @@ TEST_F(ProxyTest, Method2) {
   EXPECT_EQ("Method2", fake_proxy_->Method2(arg1, arg2));
 }
 
+TEST_F(ProxyTest, AsyncMethod0) {
+  InSequence sequence;
+  EXPECT_CALL(*fake_, AsyncMethod0())
+            .Times(Exactly(1))
+            .WillOnce(InvokeWithoutArgs(this, &ProxyTest::CheckThread));
+  EXPECT_CALL(*fake_, VoidMethod0())
+            .Times(Exactly(1))
+            .WillOnce(InvokeWithoutArgs(this, &ProxyTest::CheckThread));
+  fake_proxy_->AsyncMethod0();
+  // Synchronous calls are made after the asynchronous calls before them.
+  fake_proxy_->VoidMethod0();
+}
+
+TEST_F(ProxyTest, AsyncMethod1) {
+  const std::string arg1 = "arg1";
+  InSequence sequence;
+  EXPECT_CALL(*fake_, AsyncMethod1(arg1))
+            .Times(Exactly(1))
+            .WillOnce(InvokeWithoutArgs(this, &ProxyTest::CheckThread));
+  EXPECT_CALL(*fake_, VoidMethod0())
+            .Times(Exactly(1));
+  {
+    // The argument is copied, since the caller does not wait for the call.
+    std::string arg = arg1;
+    fake_proxy_->AsyncMethod1(arg);
+    arg = "changed";
+  }
+  fake_proxy_->VoidMethod0();
+}
+
+TEST_F(ProxyTest, MethodCallBatch) {
+  const std::string arg1 = "arg1";
+  EXPECT_CALL(*fake_, Method0())
+            .Times(Exactly(1))
+            .WillOnce(
+                DoAll(InvokeWithoutArgs(this, &ProxyTest::CheckThread),
+                      Return("Method0")));
+  EXPECT_CALL(*fake_, ConstMethod0())
+            .Times(Exactly(1))
+            .WillOnce(
+                DoAll(InvokeWithoutArgs(this, &ProxyTest::CheckThread),
+                      Return("ConstMethod0")));
+  EXPECT_CALL(*fake_, Method1(arg1))
+            .Times(Exactly(1))
+            .WillOnce(
+                DoAll(InvokeWithoutArgs(this, &ProxyTest::CheckThread),
+                      Return("Method1")));
+
+  std::string method0;
+  std::string const_method0;
+  std::string method1;
+  MethodCallBatch batch;
+  batch.Add(fake_proxy_.get(), &FakeInterface::Method0, &method0);
+  batch.Add(fake_proxy_.get(), &FakeInterface::ConstMethod0, &const_method0);
+  batch.Add(fake_proxy_.get(), &FakeInterface::Method1, arg1, &method1);
+  EXPECT_EQ(3u, batch.size());
+  batch.Marshal(signaling_thread_.get());
+  EXPECT_EQ("Method0", method0);
+  EXPECT_EQ("ConstMethod0", const_method0);
+  EXPECT_EQ("Method1", method1);
+}
+
+// Measures the cost of synchronous, asynchronous and batched calls while the
+// signaling thread is busy with tasks of 50 us.
+TEST_F(ProxyTest, DISABLED_CallLatencyAndThroughputPerf) {
+  const int kCalls = 2000;
+  const int kBatchSize = 20;
+  rtc::scoped_refptr<CountingFake> counting_fake = CountingFake::Create();
+  rtc::scoped_refptr<FakeInterface> proxy =
+      FakeProxy::Create(signaling_thread_.get(), counting_fake.get());
+  ThreadLoad load(signaling_thread_.get(), 50);
+
+  uint64 start = rtc::TimeMicros();
+  for (int i = 0; i < kCalls; ++i) {
+    proxy->VoidMethod0();
+  }
+  uint64 sync_us = rtc::TimeMicros() - start;
+
+  start = rtc::TimeMicros();
+  for (int i = 0; i < kCalls; ++i) {
+    proxy->AsyncMethod0();
+  }
+  uint64 async_post_us = rtc::TimeMicros() - start;
+  // Waits for the posted calls to run.
+  proxy->VoidMethod0();
+  uint64 async_us = rtc::TimeMicros() - start;
+
+  start = rtc::TimeMicros();
+  std::string results[kBatchSize];
+  for (int i = 0; i < kCalls; i += kBatchSize) {
+    MethodCallBatch batch;
+    for (int j = 0; j < kBatchSize; ++j) {
+      batch.Add(proxy.get(), &FakeInterface::Method0, &results[j]);
+    }
+    batch.Marshal(signaling_thread_.get());
+  }
+  uint64 batch_us = rtc::TimeMicros() - start;
+
+  load.Stop();
+  // Waits for the last task of the load.
+  proxy->ConstMethod0();
+  EXPECT_EQ(3 * kCalls + 1, counting_fake->calls());
+  LOG(LS_INFO) << kCalls << " calls under load: synchronous " << sync_us
+               << " us, asynchronous " << async_post_us << " us to post and "
+               << async_us << " us to run, batches of " << kBatchSize << " "
+               << batch_us << " us";
+  proxy = NULL;
+}
+
 }  // namespace webrtc
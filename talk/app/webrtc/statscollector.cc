@@ -32,6 +32,8 @@
 
 #include "talk/session/media/channel.h"
 #include "webrtc/base/base64.h"
+#include "webrtc/base/bind.h"
+#include "webrtc/base/linked_ptr.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/timing.h"
 
@@ -102,14 +104,18 @@ bool ExtractValueFromReport(
     const StatsReport& report,
     StatsReport::StatsValueName name,
     std::string* value) {
-  StatsReport::Values::const_iterator it = report.values.begin();
-  for (; it != report.values.end(); ++it) {
-    if (it->name == name) {
-      *value = it->value;
-      return true;
-    }
-  }
-  return false;
+  const StatsReport::Value* found = report.FindValue(name);
+  if (!found)
+    return false;
+  *value = found->ToString();
+  return true;
+}
+
+// Returns true if |report| has a track id value equal to |track_id|.
+bool HasTrackId(const StatsReport& report, const std::string& track_id) {
+  const StatsReport::Value* found =
+      report.FindValue(StatsReport::kStatsValueNameTrackId);
+  return found && found->string_val() == track_id;
 }
 
 void AddTrackReport(StatsSet* reports, const std::string& track_id) {
@@ -141,8 +147,7 @@ void ExtractStats(const cricket::VoiceReceiverInfo& info, StatsReport* report) {
                    info.jitter_buffer_preferred_ms);
   report->AddValue(StatsReport::kStatsValueNameCurrentDelayMs,
                    info.delay_estimate_ms);
-  report->AddValue(StatsReport::kStatsValueNameExpandRate,
-                   rtc::ToString<float>(info.expand_rate));
+  report->AddFloat(StatsReport::kStatsValueNameExpandRate, info.expand_rate);
   report->AddValue(StatsReport::kStatsValueNamePacketsReceived,
                    info.packets_rcvd);
   report->AddValue(StatsReport::kStatsValueNamePacketsLost,
@@ -176,8 +181,8 @@ void ExtractStats(const cricket::VoiceSenderInfo& info, StatsReport* report) {
   report->AddValue(StatsReport::kStatsValueNameJitterReceived,
                    info.jitter_ms);
   report->AddValue(StatsReport::kStatsValueNameRtt, info.rtt_ms);
-  report->AddValue(StatsReport::kStatsValueNameEchoCancellationQualityMin,
-                   rtc::ToString<float>(info.aec_quality_min));
+  report->AddFloat(StatsReport::kStatsValueNameEchoCancellationQualityMin,
+                   info.aec_quality_min);
   report->AddValue(StatsReport::kStatsValueNameEchoDelayMedian,
                    info.echo_delay_median_ms);
   report->AddValue(StatsReport::kStatsValueNameEchoDelayStdDev,
@@ -365,8 +370,28 @@ void ExtractStatsFromList(const std::vector<T>& data,
   }
 }
 
+// The local and remote certificates of a transport.
+struct TransportCertificates {
+  rtc::linked_ptr<rtc::SSLIdentity> identity;
+  rtc::linked_ptr<rtc::SSLCertificate> remote_cert;
+};
+
 }  // namespace
 
+struct StatsCollector::WorkerStats {
+  WorkerStats()
+      : session_stats_ok(false), voice_info_ok(false), video_info_ok(false) {}
+
+  bool session_stats_ok;
+  cricket::SessionStats session_stats;
+  // Keyed by the transport names in |session_stats.transport_stats|.
+  std::map<std::string, TransportCertificates> certificates;
+  bool voice_info_ok;
+  cricket::VoiceMediaInfo voice_info;
+  bool video_info_ok;
+  cricket::VideoMediaInfo video_info;
+};
+
 const char* IceCandidateTypeToStatsType(const std::string& candidate_type) {
   if (candidate_type == cricket::LOCAL_PORT_TYPE) {
     return STATSREPORT_LOCAL_PORT_TYPE;
@@ -465,7 +490,7 @@ void StatsCollector::GetStats(MediaStreamTrackInterface* track,
   if (!track) {
     StatsSet::const_iterator it;
     for (it = reports_.begin(); it != reports_.end(); ++it)
-      reports->push_back(&(*it));
+      reports->push_back(&it->second);
     return;
   }
 
@@ -483,19 +508,14 @@ void StatsCollector::GetStats(MediaStreamTrackInterface* track,
 
   reports->push_back(report);
 
-  std::string track_id;
+  const std::string track_id = track->id();
   for (StatsSet::const_iterator it = reports_.begin(); it != reports_.end();
        ++it) {
-    if (it->type != StatsReport::kStatsReportTypeSsrc)
+    if (it->second.type != StatsReport::kStatsReportTypeSsrc)
       continue;
 
-    if (ExtractValueFromReport(*it,
-                               StatsReport::kStatsValueNameTrackId,
-                               &track_id)) {
-      if (track_id == track->id()) {
-        reports->push_back(&(*it));
-      }
-    }
+    if (HasTrackId(it->second, track_id))
+      reports->push_back(&it->second);
   }
 }
 
@@ -513,9 +533,56 @@ StatsCollector::UpdateStats(PeerConnectionInterface::StatsOutputLevel level) {
   stats_gathering_started_ = time_now;
 
   if (session_) {
-    ExtractSessionInfo();
-    ExtractVoiceInfo();
-    ExtractVideoInfo(level);
+    // Fetch the session, transport and media channel stats in one go on the
+    // worker thread, then update the reports here.
+    WorkerStats stats;
+    session_->worker_thread()->Invoke<void>(
+        rtc::Bind(&StatsCollector::GatherStats_w, this, level, &stats));
+    ExtractSessionInfo(stats);
+    ExtractVoiceInfo(stats);
+    ExtractVideoInfo(level, stats);
+  }
+}
+
+void StatsCollector::GatherStats_w(
+    PeerConnectionInterface::StatsOutputLevel level,
+    WorkerStats* stats) {
+  ASSERT(session_->worker_thread()->IsCurrent());
+  // The signaling thread is blocked for the duration of this call, so the
+  // session's transports and channels can't go away underneath us.  The calls
+  // below that would otherwise Invoke() on the worker thread run inline.
+  stats->session_stats_ok = session_->GetStats(&stats->session_stats);
+  if (stats->session_stats_ok) {
+    for (cricket::TransportStatsMap::const_iterator it =
+             stats->session_stats.transport_stats.begin();
+         it != stats->session_stats.transport_stats.end(); ++it) {
+      cricket::Transport* transport =
+          session_->GetTransport(it->second.content_name);
+      if (!transport)
+        continue;
+
+      TransportCertificates& certs = stats->certificates[it->first];
+      rtc::SSLIdentity* identity = NULL;
+      if (transport->GetIdentity(&identity))
+        certs.identity = rtc::linked_ptr<rtc::SSLIdentity>(identity);
+      rtc::SSLCertificate* remote_cert = NULL;
+      if (transport->GetRemoteCertificate(&remote_cert))
+        certs.remote_cert = rtc::linked_ptr<rtc::SSLCertificate>(remote_cert);
+    }
+  }
+
+  cricket::VoiceChannel* voice_channel = session_->voice_channel();
+  if (voice_channel)
+    stats->voice_info_ok = voice_channel->GetStats(&stats->voice_info);
+
+  cricket::VideoChannel* video_channel = session_->video_channel();
+  if (video_channel) {
+    cricket::StatsOptions options;
+    options.include_received_propagation_stats =
+        (level >= PeerConnectionInterface::kStatsOutputLevelDebug) ?
+            true : false;
+    stats->video_info_ok =
+        video_channel->GetStats(options, &stats->video_info);
   }
 }
 
@@ -547,11 +614,8 @@ StatsReport* StatsCollector::PrepareLocalReport(
   report = GetOrCreateReport(
       StatsReport::kStatsReportTypeSsrc, ssrc_id, direction);
 
-  // Clear out stats from previous GatherStats calls if any.
-  // This is required since the report will be returned for the new values.
-  // Having the old values in the report will lead to multiple values with
-  // the same name.
-  // TODO(xians): Consider changing StatsReport to use map instead of vector.
+  // Clear out stats from previous GatherStats calls if any, so that values
+  // which are no longer reported don't linger.
   report->values.clear();
   report->timestamp = stats_gathering_started_;
 
@@ -626,16 +690,21 @@ std::string StatsCollector::AddOneCertificateReport(
 
   std::string fingerprint = ssl_fingerprint->GetRfc4572Fingerprint();
 
+  StatsReport* report = reports_.FindOrAddNew(
+      StatsId(StatsReport::kStatsReportTypeCertificate, fingerprint));
+  report->type = StatsReport::kStatsReportTypeCertificate;
+  report->timestamp = stats_gathering_started_;
+  // The report id is derived from the fingerprint, so a report that already
+  // has the DER encoding describes this very certificate.
+  if (report->FindValue(StatsReport::kStatsValueNameDer))
+    return report->id;
+
   rtc::Buffer der_buffer;
   cert->ToDER(&der_buffer);
   std::string der_base64;
   rtc::Base64::EncodeFromArray(
       der_buffer.data(), der_buffer.length(), &der_base64);
 
-  StatsReport* report = reports_.ReplaceOrAddNew(
-      StatsId(StatsReport::kStatsReportTypeCertificate, fingerprint));
-  report->type = StatsReport::kStatsReportTypeCertificate;
-  report->timestamp = stats_gathering_started_;
   report->AddValue(StatsReport::kStatsValueNameFingerprint, fingerprint);
   report->AddValue(StatsReport::kStatsValueNameFingerprintAlgorithm,
                    digest_algorithm);
@@ -701,10 +770,10 @@ std::string StatsCollector::AddCandidateReport(
   return ost.str();
 }
 
-void StatsCollector::ExtractSessionInfo() {
+void StatsCollector::ExtractSessionInfo(const WorkerStats& stats) {
   ASSERT(session_->signaling_thread()->IsCurrent());
   // Extract information from the base session.
-  StatsReport* report = reports_.ReplaceOrAddNew(
+  StatsReport* report = reports_.FindOrAddNew(
       StatsId(StatsReport::kStatsReportTypeSession, session_->id()));
   report->type = StatsReport::kStatsReportTypeSession;
   report->timestamp = stats_gathering_started_;
@@ -712,48 +781,43 @@ void StatsCollector::ExtractSessionInfo() {
   report->AddBoolean(StatsReport::kStatsValueNameInitiator,
                      session_->initiator());
 
-  cricket::SessionStats stats;
-  if (session_->GetStats(&stats)) {
+  if (stats.session_stats_ok) {
     // Store the proxy map away for use in SSRC reporting.
-    proxy_to_transport_ = stats.proxy_to_transport;
-
-    for (cricket::TransportStatsMap::iterator transport_iter
-             = stats.transport_stats.begin();
-         transport_iter != stats.transport_stats.end(); ++transport_iter) {
-      // Attempt to get a copy of the certificates from the transport and
-      // expose them in stats reports.  All channels in a transport share the
-      // same local and remote certificates.
-      //
-      // Note that Transport::GetIdentity and Transport::GetRemoteCertificate
-      // invoke method calls on the worker thread and block this thread, but
-      // messages are still processed on this thread, which may blow way the
-      // existing transports. So we cannot reuse |transport| after these calls.
+    proxy_to_transport_ = stats.session_stats.proxy_to_transport;
+
+    for (cricket::TransportStatsMap::const_iterator transport_iter
+             = stats.session_stats.transport_stats.begin();
+         transport_iter != stats.session_stats.transport_stats.end();
+         ++transport_iter) {
+      // Expose the certificates fetched from the transport in stats reports.
+      // All channels in a transport share the same local and remote
+      // certificates.
       std::string local_cert_report_id, remote_cert_report_id;
 
-      cricket::Transport* transport =
-          session_->GetTransport(transport_iter->second.content_name);
-      rtc::scoped_ptr<rtc::SSLIdentity> identity;
-      if (transport && transport->GetIdentity(identity.accept())) {
-        local_cert_report_id =
-            AddCertificateReports(&(identity->certificate()));
-      }
-
-      transport = session_->GetTransport(transport_iter->second.content_name);
-      rtc::scoped_ptr<rtc::SSLCertificate> cert;
-      if (transport && transport->GetRemoteCertificate(cert.accept())) {
-        remote_cert_report_id = AddCertificateReports(cert.get());
+      std::map<std::string, TransportCertificates>::const_iterator certs =
+          stats.certificates.find(transport_iter->first);
+      if (certs != stats.certificates.end()) {
+        if (certs->second.identity.get()) {
+          local_cert_report_id =
+              AddCertificateReports(&(certs->second.identity->certificate()));
+        }
+        if (certs->second.remote_cert.get()) {
+          remote_cert_report_id =
+              AddCertificateReports(certs->second.remote_cert.get());
+        }
       }
 
-      for (cricket::TransportChannelStatsList::iterator channel_iter
+      for (cricket::TransportChannelStatsList::const_iterator channel_iter
                = transport_iter->second.channel_stats.begin();
            channel_iter != transport_iter->second.channel_stats.end();
            ++channel_iter) {
         std::ostringstream ostc;
         ostc << "Channel-" << transport_iter->second.content_name
              << "-" << channel_iter->component;
-        StatsReport* channel_report = reports_.ReplaceOrAddNew(ostc.str());
+        StatsReport* channel_report = reports_.FindOrAddNew(ostc.str());
         channel_report->type = StatsReport::kStatsReportTypeComponent;
         channel_report->timestamp = stats_gathering_started_;
+        channel_report->values.clear();
         channel_report->AddValue(StatsReport::kStatsValueNameComponent,
                                  channel_iter->component);
         if (!local_cert_report_id.empty())
@@ -770,9 +834,10 @@ void StatsCollector::ExtractSessionInfo() {
           std::ostringstream ost;
           ost << "Conn-" << transport_iter->first << "-"
               << channel_iter->component << "-" << i;
-          StatsReport* report = reports_.ReplaceOrAddNew(ost.str());
+          StatsReport* report = reports_.FindOrAddNew(ost.str());
           report->type = StatsReport::kStatsReportTypeCandidatePair;
           report->timestamp = stats_gathering_started_;
+          report->values.clear();
           // Link from connection to its containing channel.
           report->AddValue(StatsReport::kStatsValueNameChannelId,
                            channel_report->id);
@@ -819,14 +884,14 @@ void StatsCollector::ExtractSessionInfo() {
   }
 }
 
-void StatsCollector::ExtractVoiceInfo() {
+void StatsCollector::ExtractVoiceInfo(const WorkerStats& stats) {
   ASSERT(session_->signaling_thread()->IsCurrent());
 
   if (!session_->voice_channel()) {
     return;
   }
-  cricket::VoiceMediaInfo voice_info;
-  if (!session_->voice_channel()->GetStats(&voice_info)) {
+  const cricket::VoiceMediaInfo& voice_info = stats.voice_info;
+  if (!stats.voice_info_ok) {
     LOG(LS_ERROR) << "Failed to get voice channel stats.";
     return;
   }
@@ -845,18 +910,15 @@ void StatsCollector::ExtractVoiceInfo() {
 }
 
 void StatsCollector::ExtractVideoInfo(
-    PeerConnectionInterface::StatsOutputLevel level) {
+    PeerConnectionInterface::StatsOutputLevel level,
+    const WorkerStats& stats) {
   ASSERT(session_->signaling_thread()->IsCurrent());
 
   if (!session_->video_channel())
     return;
 
-  cricket::StatsOptions options;
-  options.include_received_propagation_stats =
-      (level >= PeerConnectionInterface::kStatsOutputLevelDebug) ?
-          true : false;
-  cricket::VideoMediaInfo video_info;
-  if (!session_->video_channel()->GetStats(options, &video_info)) {
+  const cricket::VideoMediaInfo& video_info = stats.video_info;
+  if (!stats.video_info_ok) {
     LOG(LS_ERROR) << "Failed to get video channel stats.";
     return;
   }
@@ -925,13 +987,8 @@ void StatsCollector::UpdateStatsFromExistingLocalAudioTracks() {
     }
 
     // The same ssrc can be used by both local and remote audio tracks.
-    std::string track_id;
-    if (!ExtractValueFromReport(*report,
-                                StatsReport::kStatsValueNameTrackId,
-                                &track_id) ||
-        track_id != track->id()) {
+    if (!HasTrackId(*report, track->id()))
       continue;
-    }
 
     UpdateReportFromAudioTrack(track, report);
   }
@@ -946,8 +1003,8 @@ void StatsCollector::UpdateReportFromAudioTrack(AudioTrackInterface* track,
 
   int signal_level = 0;
   if (track->GetSignalLevel(&signal_level)) {
-    report->ReplaceValue(StatsReport::kStatsValueNameAudioInputLevel,
-                         rtc::ToString<int>(signal_level));
+    report->AddValue(StatsReport::kStatsValueNameAudioInputLevel,
+                     signal_level);
   }
 
   rtc::scoped_refptr<AudioProcessorInterface> audio_processor(
@@ -957,19 +1014,18 @@ void StatsCollector::UpdateReportFromAudioTrack(AudioTrackInterface* track,
 
   AudioProcessorInterface::AudioProcessorStats stats;
   audio_processor->GetStats(&stats);
-  report->ReplaceValue(StatsReport::kStatsValueNameTypingNoiseState,
-                       stats.typing_noise_detected ? "true" : "false");
-  report->ReplaceValue(StatsReport::kStatsValueNameEchoReturnLoss,
-                       rtc::ToString<int>(stats.echo_return_loss));
-  report->ReplaceValue(
-      StatsReport::kStatsValueNameEchoReturnLossEnhancement,
-      rtc::ToString<int>(stats.echo_return_loss_enhancement));
-  report->ReplaceValue(StatsReport::kStatsValueNameEchoDelayMedian,
-                       rtc::ToString<int>(stats.echo_delay_median_ms));
-  report->ReplaceValue(StatsReport::kStatsValueNameEchoCancellationQualityMin,
-                       rtc::ToString<float>(stats.aec_quality_min));
-  report->ReplaceValue(StatsReport::kStatsValueNameEchoDelayStdDev,
-                       rtc::ToString<int>(stats.echo_delay_std_ms));
+  report->AddBoolean(StatsReport::kStatsValueNameTypingNoiseState,
+                     stats.typing_noise_detected);
+  report->AddValue(StatsReport::kStatsValueNameEchoReturnLoss,
+                   stats.echo_return_loss);
+  report->AddValue(StatsReport::kStatsValueNameEchoReturnLossEnhancement,
+                   stats.echo_return_loss_enhancement);
+  report->AddValue(StatsReport::kStatsValueNameEchoDelayMedian,
+                   stats.echo_delay_median_ms);
+  report->AddFloat(StatsReport::kStatsValueNameEchoCancellationQualityMin,
+                   stats.aec_quality_min);
+  report->AddValue(StatsReport::kStatsValueNameEchoDelayStdDev,
+                   stats.echo_delay_std_ms);
 }
 
 bool StatsCollector::GetTrackIdBySsrc(uint32 ssrc, std::string* track_id,
@@ -119,9 +119,18 @@ class StatsCollector {
   // returns the leaf certificate's report's ID.
   std::string AddCertificateReports(const rtc::SSLCertificate* cert);
 
-  void ExtractSessionInfo();
-  void ExtractVoiceInfo();
-  void ExtractVideoInfo(PeerConnectionInterface::StatsOutputLevel level);
+  // Stats fetched from the worker thread for one call to UpdateStats().
+  struct WorkerStats;
+
+  // Runs on the worker thread and fills in |stats| with everything the
+  // reports are built from, so that a poll costs a single thread hop.
+  void GatherStats_w(PeerConnectionInterface::StatsOutputLevel level,
+                     WorkerStats* stats);
+
+  void ExtractSessionInfo(const WorkerStats& stats);
+  void ExtractVoiceInfo(const WorkerStats& stats);
+  void ExtractVideoInfo(PeerConnectionInterface::StatsOutputLevel level,
+                        const WorkerStats& stats);
   void BuildSsrcToTransportId();
   webrtc::StatsReport* GetOrCreateReport(const std::string& type,
                                          const std::string& id,
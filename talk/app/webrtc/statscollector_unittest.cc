@@ -154,7 +154,7 @@ bool GetValue(const StatsReport* report,
   StatsReport::Values::const_iterator it = report->values.begin();
   for (; it != report->values.end(); ++it) {
     if (it->name == name) {
-      *value = it->value;
+      *value = it->ToString();
       return true;
     }
   }
@@ -907,6 +907,135 @@ TEST_F(StatsCollectorTest, TransportObjectLinkedFromSsrcObject) {
   ASSERT_FALSE(transport_report == NULL);
 }
 
+// This test verifies that reports are kept across calls to UpdateStats and
+// that their values are replaced rather than appended.
+TEST_F(StatsCollectorTest, ReportsAreUpdatedInPlace) {
+  webrtc::StatsCollector stats(&session_);  // Implementation under test.
+  // Ignore unused callback (logspam).
+  EXPECT_CALL(session_, GetTransport(_))
+      .WillRepeatedly(Return(static_cast<cricket::Transport*>(NULL)));
+  MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
+  // The content_name known by the video channel.
+  const std::string kVcName("vcname");
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+      media_engine_, media_channel, &session_, kVcName, false, NULL);
+  AddOutgoingVideoTrackStats();
+  stats.AddStream(stream_);
+
+  cricket::VideoSenderInfo video_sender_info;
+  video_sender_info.add_ssrc(1234);
+  video_sender_info.bytes_sent = 100;
+  cricket::VideoMediaInfo stats_read;
+  stats_read.senders.push_back(video_sender_info);
+  video_sender_info.bytes_sent = 200;
+  cricket::VideoMediaInfo new_stats_read;
+  new_stats_read.senders.push_back(video_sender_info);
+
+  EXPECT_CALL(session_, video_channel()).WillRepeatedly(Return(&video_channel));
+  EXPECT_CALL(session_, voice_channel()).WillRepeatedly(ReturnNull());
+  EXPECT_CALL(*media_channel, GetStats(_, _))
+      .WillOnce(DoAll(SetArgPointee<1>(stats_read), Return(true)))
+      .WillOnce(DoAll(SetArgPointee<1>(new_stats_read), Return(true)));
+
+  InitSessionStats(kVcName);
+  EXPECT_CALL(session_, GetStats(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(session_stats_),
+                            Return(true)));
+
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  StatsReports reports;
+  stats.GetStats(NULL, &reports);
+  const StatsReport* report =
+      FindNthReportByType(reports, StatsReport::kStatsReportTypeSsrc, 1);
+  ASSERT_TRUE(report != NULL);
+  const StatsReport::Value* bytes_sent =
+      report->FindValue(StatsReport::kStatsValueNameBytesSent);
+  ASSERT_TRUE(bytes_sent != NULL);
+  EXPECT_EQ(StatsReport::Value::kInt64, bytes_sent->type());
+  EXPECT_EQ(100, bytes_sent->int64_val());
+  const size_t num_values = report->values.size();
+
+  stats.ClearUpdateStatsCacheForTest();
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  reports.clear();
+  stats.GetStats(NULL, &reports);
+  EXPECT_EQ(report,
+            FindNthReportByType(reports, StatsReport::kStatsReportTypeSsrc, 1));
+  EXPECT_EQ(num_values, report->values.size());
+  bytes_sent = report->FindValue(StatsReport::kStatsValueNameBytesSent);
+  ASSERT_TRUE(bytes_sent != NULL);
+  EXPECT_EQ(200, bytes_sent->int64_val());
+  EXPECT_EQ("200", ExtractSsrcStatsValue(
+      reports, StatsReport::kStatsValueNameBytesSent));
+}
+
+// Test the time required to update and get the stats of one peer connection
+// that sends and receives audio and video over a single transport.
+TEST_F(StatsCollectorTest, DISABLED_UpdateAndGetStatsPerf) {
+  webrtc::StatsCollector stats(&session_);  // Implementation under test.
+  EXPECT_CALL(session_, GetTransport(_))
+      .WillRepeatedly(Return(static_cast<cricket::Transport*>(NULL)));
+  MockVoiceMediaChannel* voice_media_channel = new MockVoiceMediaChannel();
+  MockVideoMediaChannel* video_media_channel = new MockVideoMediaChannel();
+  const std::string kVcName("vcname");
+  cricket::VoiceChannel voice_channel(rtc::Thread::Current(),
+      media_engine_, voice_media_channel, &session_, kVcName, false);
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+      media_engine_, video_media_channel, &session_, kVcName, false, NULL);
+  stream_ = webrtc::MediaStream::Create("streamlabel");
+  audio_track_ = new rtc::RefCountedObject<FakeAudioTrack>(kLocalTrackId);
+  stream_->AddTrack(audio_track_);
+  stats.AddStream(stream_);
+  stats.AddLocalAudioTrack(audio_track_, kSsrcOfTrack);
+  EXPECT_CALL(session_, GetLocalTrackIdBySsrc(_, _))
+      .WillRepeatedly(DoAll(SetArgPointee<1>(kLocalTrackId), Return(true)));
+  EXPECT_CALL(session_, GetRemoteTrackIdBySsrc(_, _))
+      .WillRepeatedly(DoAll(SetArgPointee<1>(kRemoteTrackId), Return(true)));
+
+  cricket::VoiceMediaInfo voice_info;
+  cricket::VoiceSenderInfo voice_sender_info;
+  InitVoiceSenderInfo(&voice_sender_info);
+  voice_info.senders.push_back(voice_sender_info);
+  cricket::VoiceReceiverInfo voice_receiver_info;
+  InitVoiceReceiverInfo(&voice_receiver_info);
+  voice_receiver_info.local_stats[0].ssrc = kSsrcOfTrack + 1;
+  voice_info.receivers.push_back(voice_receiver_info);
+  EXPECT_CALL(*voice_media_channel, GetStats(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(voice_info), Return(true)));
+
+  cricket::VideoMediaInfo video_info;
+  cricket::VideoSenderInfo video_sender_info;
+  video_sender_info.add_ssrc(kSsrcOfTrack + 2);
+  video_info.senders.push_back(video_sender_info);
+  cricket::VideoReceiverInfo video_receiver_info;
+  video_receiver_info.add_ssrc(kSsrcOfTrack + 3);
+  video_info.receivers.push_back(video_receiver_info);
+  video_info.bw_estimations.push_back(cricket::BandwidthEstimationInfo());
+  EXPECT_CALL(*video_media_channel, GetStats(_, _))
+      .WillRepeatedly(DoAll(SetArgPointee<1>(video_info), Return(true)));
+
+  EXPECT_CALL(session_, voice_channel()).WillRepeatedly(Return(&voice_channel));
+  EXPECT_CALL(session_, video_channel()).WillRepeatedly(Return(&video_channel));
+  InitSessionStats(kVcName);
+  EXPECT_CALL(session_, GetStats(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(session_stats_),
+                            Return(true)));
+
+  const int kNumPolls = 1000;
+  uint64 start = rtc::TimeMicros();
+  for (int i = 0; i < kNumPolls; ++i) {
+    stats.ClearUpdateStatsCacheForTest();
+    stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+    StatsReports reports;
+    stats.GetStats(NULL, &reports);
+    EXPECT_FALSE(reports.empty());
+  }
+  uint64 elapsed = rtc::TimeMicros() - start;
+
+  LOG(LS_INFO) << "Average UpdateStats and GetStats time: "
+               << elapsed / kNumPolls << " us";
+}
+
 // This test verifies that a remote stats object will not be created for
 // an outgoing SSRC where remote stats are not returned.
 TEST_F(StatsCollectorTest, RemoteSsrcInfoIsAbsent) {
@@ -1250,6 +1379,72 @@ TEST_F(StatsCollectorTest, NoCertificates) {
   ASSERT_EQ(kNotFound, remote_certificate_id);
 }
 
+// This test verifies that a value which is no longer reported is removed from
+// a report that is kept across calls to UpdateStats.
+TEST_F(StatsCollectorTest, ValueRemovedWhenNoLongerReported) {
+  webrtc::StatsCollector stats(&session_);  // Implementation under test.
+  StatsReports reports;  // returned values.
+
+  // Fake stats to process.
+  cricket::TransportChannelStats channel_stats;
+  channel_stats.component = 1;
+
+  cricket::TransportStats transport_stats;
+  transport_stats.content_name = "audio";
+  transport_stats.channel_stats.push_back(channel_stats);
+
+  cricket::SessionStats session_stats;
+  session_stats.transport_stats[transport_stats.content_name] =
+      transport_stats;
+
+  // Fake transport object, with a remote certificate at first.
+  rtc::FakeSSLCertificate remote_cert(DerToPem("This is a remote DER."));
+  rtc::scoped_ptr<cricket::FakeTransport> transport(
+      new cricket::FakeTransport(
+          session_.signaling_thread(),
+          session_.worker_thread(),
+          transport_stats.content_name));
+  cricket::FakeTransportChannel* channel =
+      static_cast<cricket::FakeTransportChannel*>(
+          transport->CreateChannel(channel_stats.component));
+  ASSERT_FALSE(channel == NULL);
+  channel->SetRemoteCertificate(&remote_cert);
+
+  // Configure MockWebRtcSession
+  EXPECT_CALL(session_, GetTransport(transport_stats.content_name))
+    .WillRepeatedly(Return(transport.get()));
+  EXPECT_CALL(session_, GetStats(_))
+    .WillRepeatedly(DoAll(SetArgPointee<0>(session_stats),
+                          Return(true)));
+  EXPECT_CALL(session_, video_channel()).WillRepeatedly(ReturnNull());
+  EXPECT_CALL(session_, voice_channel()).WillRepeatedly(ReturnNull());
+
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  stats.GetStats(NULL, &reports);
+  EXPECT_NE(kNotFound, ExtractStatsValue(
+      StatsReport::kStatsReportTypeComponent,
+      reports,
+      StatsReport::kStatsValueNameRemoteCertificateId));
+
+  // The remote certificate goes away.
+  channel->SetRemoteCertificate(NULL);
+  stats.ClearUpdateStatsCacheForTest();
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  reports.clear();
+  stats.GetStats(NULL, &reports);
+  const StatsReport* channel_report = FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeComponent, 1);
+  ASSERT_TRUE(channel_report != NULL);
+  EXPECT_EQ(kNotFound, ExtractStatsValue(
+      StatsReport::kStatsReportTypeComponent,
+      reports,
+      StatsReport::kStatsValueNameRemoteCertificateId));
+  EXPECT_EQ("1", ExtractStatsValue(
+      StatsReport::kStatsReportTypeComponent,
+      reports,
+      StatsReport::kStatsValueNameComponent));
+}
+
 // This test verifies that a remote certificate with an unsupported digest
 // algorithm is correctly ignored.
 TEST_F(StatsCollectorTest, UnsupportedDigestIgnored) {
@@ -80,23 +80,91 @@ bool StatsReport::operator==(const std::string& other_id) const {
 
 // The copy ctor can't be declared as explicit due to problems with STL.
 StatsReport::Value::Value(const Value& other)
-    : name(other.name), value(other.value) {
+    : name(other.name), type_(other.type_), int64_(other.int64_),
+      string_(other.string_) {
 }
 
-StatsReport::Value::Value(StatsValueName name)
-    : name(name) {
+StatsReport::Value::Value(StatsValueName name, int64 value)
+    : name(name), type_(kInt64), int64_(value) {
+}
+
+StatsReport::Value::Value(StatsValueName name, float value)
+    : name(name), type_(kFloat), int64_(0) {
+  float_ = value;
+}
+
+StatsReport::Value::Value(StatsValueName name, bool value)
+    : name(name), type_(kBool), int64_(0) {
+  bool_ = value;
 }
 
 StatsReport::Value::Value(StatsValueName name, const std::string& value)
-    : name(name), value(value) {
+    : name(name), type_(kString), int64_(0), string_(value) {
 }
 
 StatsReport::Value& StatsReport::Value::operator=(const Value& other) {
   const_cast<StatsValueName&>(name) = other.name;
-  value = other.value;
+  type_ = other.type_;
+  int64_ = other.int64_;
+  string_ = other.string_;
   return *this;
 }
 
+void StatsReport::Value::Set(int64 value) {
+  type_ = kInt64;
+  int64_ = value;
+}
+
+void StatsReport::Value::Set(float value) {
+  type_ = kFloat;
+  float_ = value;
+}
+
+void StatsReport::Value::Set(bool value) {
+  type_ = kBool;
+  bool_ = value;
+}
+
+void StatsReport::Value::Set(const std::string& value) {
+  type_ = kString;
+  string_ = value;
+}
+
+int64 StatsReport::Value::int64_val() const {
+  ASSERT(type_ == kInt64);
+  return int64_;
+}
+
+float StatsReport::Value::float_val() const {
+  ASSERT(type_ == kFloat);
+  return float_;
+}
+
+bool StatsReport::Value::bool_val() const {
+  ASSERT(type_ == kBool);
+  return bool_;
+}
+
+const std::string& StatsReport::Value::string_val() const {
+  ASSERT(type_ == kString);
+  return string_;
+}
+
+std::string StatsReport::Value::ToString() const {
+  switch (type_) {
+    case kInt64:
+      return rtc::ToString<int64>(int64_);
+    case kFloat:
+      return rtc::ToString<float>(float_);
+    case kBool:
+      return bool_ ? "true" : "false";
+    case kString:
+      return string_;
+  }
+  ASSERT(false);
+  return std::string();
+}
+
 const char* StatsReport::Value::display_name() const {
   switch (name) {
     case kStatsValueNameAudioOutputLevel:
@@ -307,13 +375,34 @@ const char* StatsReport::Value::display_name() const {
   return nullptr;
 }
 
+namespace {
+
+// Adds a value with |name|, or overwrites the one already in |values|.
+// A report holds a few dozen values at most, so a linear scan comparing the
+// integer |name| is cheaper than keeping a separate index.
+template <typename T>
+void SetValue(StatsReport::Values* values,
+              StatsReport::StatsValueName name,
+              const T& value) {
+  for (StatsReport::Values::iterator it = values->begin();
+       it != values->end(); ++it) {
+    if (it->name == name) {
+      it->Set(value);
+      return;
+    }
+  }
+  values->push_back(StatsReport::Value(name, value));
+}
+
+}  // namespace
+
 void StatsReport::AddValue(StatsReport::StatsValueName name,
                            const std::string& value) {
-  values.push_back(Value(name, value));
+  SetValue(&values, name, value);
 }
 
 void StatsReport::AddValue(StatsReport::StatsValueName name, int64 value) {
-  AddValue(name, rtc::ToString<int64>(value));
+  SetValue(&values, name, value);
 }
 
 template <typename T>
@@ -331,8 +420,6 @@ void StatsReport::AddValue(StatsReport::StatsValueName name,
 }
 
 // Implementation specializations for the variants of AddValue that we use.
-// TODO(tommi): Converting these ints to strings and copying strings, is not
-// very efficient.  Figure out a way to reduce the string churn.
 template
 void StatsReport::AddValue<std::string>(
     StatsReport::StatsValueName, const std::vector<std::string>&);
@@ -345,21 +432,20 @@ template
 void StatsReport::AddValue<int64_t>(
     StatsReport::StatsValueName, const std::vector<int64_t>&);
 
+void StatsReport::AddFloat(StatsReport::StatsValueName name, float value) {
+  SetValue(&values, name, value);
+}
+
 void StatsReport::AddBoolean(StatsReport::StatsValueName name, bool value) {
-  AddValue(name, value ? "true" : "false");
+  SetValue(&values, name, value);
 }
 
-void StatsReport::ReplaceValue(StatsReport::StatsValueName name,
-                               const std::string& value) {
-  for (Values::iterator it = values.begin(); it != values.end(); ++it) {
-    if ((*it).name == name) {
-      it->value = value;
-      return;
-    }
+const StatsReport::Value* StatsReport::FindValue(StatsValueName name) const {
+  for (Values::const_iterator it = values.begin(); it != values.end(); ++it) {
+    if (it->name == name)
+      return &(*it);
   }
-  // It is not reachable here, add an ASSERT to make sure the overwriting is
-  // always a success.
-  ASSERT(false);
+  return NULL;
 }
 
 StatsSet::StatsSet() {
@@ -378,8 +464,8 @@ StatsSet::const_iterator StatsSet::end() const {
 
 StatsReport* StatsSet::InsertNew(const std::string& id) {
   ASSERT(Find(id) == NULL);
-  const StatsReport* ret = &(*list_.insert(StatsReportCopyable(id)).first);
-  return const_cast<StatsReport*>(ret);
+  return &list_.insert(std::make_pair(id, StatsReportCopyable(id)))
+      .first->second;
 }
 
 StatsReport* StatsSet::FindOrAddNew(const std::string& id) {
@@ -395,9 +481,8 @@ StatsReport* StatsSet::ReplaceOrAddNew(const std::string& id) {
 // Looks for a report with the given |id|.  If one is not found, NULL
 // will be returned.
 StatsReport* StatsSet::Find(const std::string& id) {
-  const_iterator it = std::find(begin(), end(), id);
-  return it == end() ? NULL :
-      const_cast<StatsReport*>(static_cast<const StatsReport*>(&(*it)));
+  iterator it = list_.find(id);
+  return it == list_.end() ? NULL : &it->second;
 }
 
 }  // namespace webrtc
@@ -31,8 +31,7 @@
 #ifndef TALK_APP_WEBRTC_STATSTYPES_H_
 #define TALK_APP_WEBRTC_STATSTYPES_H_
 
-#include <algorithm>
-#include <set>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -176,9 +175,20 @@ class StatsReport {
   };
 
   struct Value {
+    // The type of the value held.  Numbers and booleans are stored as is and
+    // only formatted when ToString() is called.
+    enum Type {
+      kInt64,
+      kFloat,
+      kBool,
+      kString,
+    };
+
     // The copy ctor can't be declared as explicit due to problems with STL.
     Value(const Value& other);
-    explicit Value(StatsValueName name);
+    Value(StatsValueName name, int64 value);
+    Value(StatsValueName name, float value);
+    Value(StatsValueName name, bool value);
     Value(StatsValueName name, const std::string& value);
 
     // TODO(tommi): Remove this operator once we don't need it.
@@ -186,21 +196,53 @@ class StatsReport {
     // The public |name| member variable is otherwise meant to be read-only.
     Value& operator=(const Value& other);
 
+    // Overwrite the held value, and its type, in place.
+    void Set(int64 value);
+    void Set(float value);
+    void Set(bool value);
+    void Set(const std::string& value);
+
+    Type type() const { return type_; }
+
+    // Accessors for the typed value.  Only the one matching type() may be
+    // called.
+    int64 int64_val() const;
+    float float_val() const;
+    bool bool_val() const;
+    const std::string& string_val() const;
+
+    // Returns the value formatted as a string, e.g. "42", "0.5" or "true".
+    std::string ToString() const;
+    // Same as ToString(), for the consumers of the string |value| member
+    // that values used to have.
+    std::string value() const { return ToString(); }
+
     // Returns the string representation of |name|.
     const char* display_name() const;
 
     const StatsValueName name;
 
-    std::string value;
+   private:
+    Type type_;
+    union {
+      int64 int64_;
+      float float_;
+      bool bool_;
+    };
+    std::string string_;
   };
 
+  // The AddXxx() methods add a value with the given |name| or, when the report
+  // already has one, overwrite it in place.
   void AddValue(StatsValueName name, const std::string& value);
   void AddValue(StatsValueName name, int64 value);
   template <typename T>
   void AddValue(StatsValueName name, const std::vector<T>& value);
+  void AddFloat(StatsValueName name, float value);
   void AddBoolean(StatsValueName name, bool value);
 
-  void ReplaceValue(StatsValueName name, const std::string& value);
+  // Returns the value with the given |name|, or NULL if there is none.
+  const Value* FindValue(StatsValueName name) const;
 
   double timestamp;  // Time since 1970-01-01T00:00:00Z in milliseconds.
   typedef std::vector<Value> Values;
@@ -285,14 +327,16 @@ typedef std::vector<const StatsReport*> StatsReports;
 
 // A map from the report id to the report.
 // This class wraps an STL container and provides a limited set of
-// functionality in order to keep things simple.
+// functionality in order to keep things simple.  Reports are never removed
+// from the set, so pointers to them stay valid and can be updated in place
+// from one stats poll to the next.
 // TODO(tommi): Use a thread checker here (currently not in libjingle).
 class StatsSet {
  public:
   StatsSet();
   ~StatsSet();
 
-  typedef std::set<StatsReportCopyable> Container;
+  typedef std::map<std::string, StatsReportCopyable> Container;
   typedef Container::iterator iterator;
   typedef Container::const_iterator const_iterator;
 
@@ -169,7 +169,7 @@ class MockStatsObserver : public webrtc::StatsObserver {
           reports_[i].values.begin();
       for (; it != reports_[i].values.end(); ++it) {
         if (it->name == name) {
-          return rtc::FromString<int>(it->value);
+          return static_cast<int>(it->int64_val());
         }
       }
     }
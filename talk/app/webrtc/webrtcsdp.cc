@@ -30,6 +30,7 @@
 #include <limits.h>
 #include <stdio.h>
 #include <algorithm>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -181,6 +182,7 @@ static const char kSdpDelimiterSlash = '/';
 static const char kNewLine = '\n';
 static const char kReturn = '\r';
 static const char kLineBreak[] = "\r\n";
+static const size_t kSdpReservedSizePerContent = 2048;
 
 // TODO: Generate the Session and Time description
 // instead of hardcoding.
@@ -447,7 +449,8 @@ static bool GetLine(const std::string& message,
   if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Reuse the capacity of |line|, which callers keep across lines.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -478,6 +481,21 @@ static void InitAttrLine(const std::string& attribute, std::ostringstream* os) {
   InitLine(kLineTypeAttributes, attribute, os);
 }
 
+// Appends "a=|attribute|" to |message|. Lines written once per codec, feedback
+// parameter or ssrc are appended in place this way, without an ostringstream.
+static void AppendAttrLine(const char* attribute, std::string* message) {
+  message->push_back(kLineTypeAttributes);
+  message->push_back(kSdpDelimiterEqual);
+  message->append(attribute);
+}
+
+// Appends |value| in decimal to |message|.
+static void AppendInt(int64 value, std::string* message) {
+  char buffer[24];
+  rtc::sprintfn(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+  message->append(buffer);
+}
+
 // Writes a SDP attribute line based on |attribute| and |value| to |message|.
 static void AddAttributeLine(const std::string& attribute, int value,
                              std::string* message) {
@@ -524,42 +542,84 @@ static bool AddSsrcLine(uint32 ssrc_id, const std::string& attribute,
                         const std::string& value, std::string* message) {
   // RFC 5576
   // a=ssrc:<ssrc-id> <attribute>:<value>
-  std::ostringstream os;
-  InitAttrLine(kAttributeSsrc, &os);
-  os << kSdpDelimiterColon << ssrc_id << kSdpDelimiterSpace
-     << attribute << kSdpDelimiterColon << value;
-  return AddLine(os.str(), message);
+  if (!message)
+    return false;
+
+  AppendAttrLine(kAttributeSsrc, message);
+  message->push_back(kSdpDelimiterColon);
+  AppendInt(ssrc_id, message);
+  message->push_back(kSdpDelimiterSpace);
+  message->append(attribute);
+  message->push_back(kSdpDelimiterColon);
+  message->append(value);
+  message->append(kLineBreak);
+  return true;
 }
 
-// Split the message into two parts by the first delimiter.
+// Split the part of |message| from |start| into two parts by the first
+// delimiter.
 static bool SplitByDelimiter(const std::string& message,
+                             size_t start,
                              const char delimiter,
                              std::string* field1,
                              std::string* field2) {
   // Find the first delimiter
-  size_t pos = message.find(delimiter);
+  size_t pos = message.find(delimiter, start);
   if (pos == std::string::npos) {
     return false;
   }
-  *field1 = message.substr(0, pos);
+  field1->assign(message, start, pos - start);
   // The rest is the value.
-  *field2 = message.substr(pos + 1);
+  field2->assign(message, pos + 1, std::string::npos);
   return true;
 }
 
+// Split the message into two parts by the first delimiter.
+static bool SplitByDelimiter(const std::string& message,
+                             const char delimiter,
+                             std::string* field1,
+                             std::string* field2) {
+  return SplitByDelimiter(message, 0, delimiter, field1, field2);
+}
+
+// Splits the part of |line| from |start| by |delimiter| into |fields|, like
+// rtc::split(line.substr(start), ...), but without copying the line and
+// reusing the strings already in |fields|.
+static size_t SplitFields(const std::string& line,
+                          size_t start,
+                          const char delimiter,
+                          std::vector<std::string>* fields) {
+  size_t count = 0;
+  size_t field_begin = start;
+  while (true) {
+    size_t field_end = line.find(delimiter, field_begin);
+    if (field_end == std::string::npos) {
+      field_end = line.size();
+    }
+    if (count == fields->size()) {
+      fields->push_back(std::string());
+    }
+    (*fields)[count++].assign(line, field_begin, field_end - field_begin);
+    if (field_end == line.size()) {
+      break;
+    }
+    field_begin = field_end + 1;
+  }
+  fields->resize(count);
+  return count;
+}
+
 // Get value only from <attribute>:<value>.
 static bool GetValue(const std::string& message, const std::string& attribute,
                      std::string* value, SdpParseError* error) {
-  std::string leftpart;
-  if (!SplitByDelimiter(message, kSdpDelimiterColon, &leftpart, value)) {
-    return ParseFailedGetValue(message, attribute, error);
-  }
+  size_t pos = message.find(kSdpDelimiterColon);
   // The left part should end with the expected attribute.
-  if (leftpart.length() < attribute.length() ||
-      leftpart.compare(leftpart.length() - attribute.length(),
-                       attribute.length(), attribute) != 0) {
+  if (pos == std::string::npos || pos < attribute.length() ||
+      message.compare(pos - attribute.length(), attribute.length(),
+                      attribute) != 0) {
     return ParseFailedGetValue(message, attribute, error);
   }
+  value->assign(message, pos + 1, std::string::npos);
   return true;
 }
 
@@ -571,12 +631,32 @@ static bool CaseInsensitiveFind(std::string str1, std::string str2) {
   return str1.find(str2) != std::string::npos;
 }
 
+// Parses |s| if it is a plain decimal number of at most 9 digits, which fits
+// in any integer type of 32 bits or more. Most numbers in SDP are, and this
+// avoids the istringstream of rtc::FromString(), which handles the rest.
+template <class T>
+static bool FromDecimalString(const std::string& s, T* t) {
+  if (!std::numeric_limits<T>::is_integer || sizeof(T) < sizeof(int32) ||
+      s.empty() || s.size() > 9) {
+    return false;
+  }
+  T value = 0;
+  for (size_t i = 0; i < s.size(); ++i) {
+    if (s[i] < '0' || s[i] > '9') {
+      return false;
+    }
+    value = value * 10 + (s[i] - '0');
+  }
+  *t = value;
+  return true;
+}
+
 template <class T>
 static bool GetValueFromString(const std::string& line,
                                const std::string& s,
                                T* t,
                                SdpParseError* error) {
-  if (!rtc::FromString(s, t)) {
+  if (!FromDecimalString(s, t) && !rtc::FromString(s, t)) {
     std::ostringstream description;
     description << "Invalid value: " << s << ".";
     return ParseFailed(line, description.str(), error);
@@ -788,6 +868,9 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc) {
   }
 
   std::string message;
+  // Write the description into a buffer reserved up front. A media section is
+  // typically 1-2 KB.
+  message.reserve(kSdpReservedSizePerContent * (desc->contents().size() + 1));
 
   // Session Description.
   AddLine(kSessionVersion, &message);
@@ -955,7 +1038,7 @@ bool ParseCandidate(const std::string& message, Candidate* candidate,
   // a=candidate:<blah>CRLF for backward compatibility and for parsing a line
   // from the SDP.
   if (IsLineType(first_line, kLineTypeAttributes)) {
-    first_line = first_line.substr(kLinePrefixLength);
+    first_line.erase(0, kLinePrefixLength);
   }
 
   std::string attribute_candidate;
@@ -1118,8 +1201,7 @@ bool ParseSctpPort(const std::string& line,
   // draft-ietf-mmusic-sctp-sdp-07
   // a=sctp-port
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_min_fields = 2;
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -1137,8 +1219,7 @@ bool ParseExtmap(const std::string& line, RtpHeaderExtension* extmap,
   // RFC 5285
   // a=extmap:<value>["/"<direction>] <URI> <extensionattributes>
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_min_fields = 2;
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -1433,7 +1514,6 @@ void BuildRtpContentAttributes(
   // Specify latency for buffered mode.
   // a=x-google-buffer-latency:<value>
   if (media_desc->buffered_mode_latency() != cricket::kBufferedModeDisabled) {
-    std::ostringstream os;
     InitAttrLine(kAttributeXGoogleBufferLatency, &os);
     os << kSdpDelimiterColon << media_desc->buffered_mode_latency();
     AddLine(os.str(), message);
@@ -1454,7 +1534,6 @@ void BuildRtpContentAttributes(
       if (track->ssrc_groups[i].ssrcs.empty()) {
         continue;
       }
-      std::ostringstream os;
       InitAttrLine(kAttributeSsrcGroup, &os);
       os << kSdpDelimiterColon << track->ssrc_groups[i].semantics;
       std::vector<uint32>::const_iterator ssrc =
@@ -1476,13 +1555,8 @@ void BuildRtpContentAttributes(
       // a=ssrc:<ssrc-id> msid:identifier [appdata]
       // The appdata consists of the "id" attribute of a MediaStreamTrack, which
       // is corresponding to the "name" attribute of StreamParams.
-      std::string appdata = track->id;
-      std::ostringstream os;
-      InitAttrLine(kAttributeSsrc, &os);
-      os << kSdpDelimiterColon << ssrc << kSdpDelimiterSpace
-         << kSsrcAttributeMsid << kSdpDelimiterColon << track->sync_label
-         << kSdpDelimiterSpace << appdata;
-      AddLine(os.str(), message);
+      AddSsrcLine(ssrc, kSsrcAttributeMsid,
+                  track->sync_label + kSdpDelimiterSpace + track->id, message);
 
       // TODO(ronghuawu): Remove below code which is for backward compatibility.
       // draft-alvestrand-rtcweb-mid-01
@@ -1503,20 +1577,6 @@ void WriteFmtpHeader(int payload_type, std::ostringstream* os) {
   *os << kSdpDelimiterColon << payload_type;
 }
 
-void WriteRtcpFbHeader(int payload_type, std::ostringstream* os) {
-  // rtcp-fb header: a=rtcp-fb:|payload_type|
-  // <parameters>/<ccm <ccm_parameters>>
-  // Add a=rtcp-fb
-  InitAttrLine(kAttributeRtcpFb, os);
-  // Add :
-  *os << kSdpDelimiterColon;
-  if (payload_type == kWildcardPayloadType) {
-    *os << "*";
-  } else {
-    *os << payload_type;
-  }
-}
-
 void WriteFmtpParameter(const std::string& parameter_name,
                         const std::string& parameter_value,
                         std::ostringstream* os) {
@@ -1586,13 +1646,21 @@ void AddRtcpFbLines(const T& codec, std::string* message) {
   for (std::vector<cricket::FeedbackParam>::const_iterator iter =
            codec.feedback_params.params().begin();
        iter != codec.feedback_params.params().end(); ++iter) {
-    std::ostringstream os;
-    WriteRtcpFbHeader(codec.id, &os);
-    os << " " << iter->id();
+    // a=rtcp-fb:<payload type> <id> [<param>]
+    AppendAttrLine(kAttributeRtcpFb, message);
+    message->push_back(kSdpDelimiterColon);
+    if (codec.id == kWildcardPayloadType) {
+      message->push_back('*');
+    } else {
+      AppendInt(codec.id, message);
+    }
+    message->push_back(kSdpDelimiterSpace);
+    message->append(iter->id());
     if (!iter->param().empty()) {
-      os << " " << iter->param();
+      message->push_back(kSdpDelimiterSpace);
+      message->append(iter->param());
     }
-    AddLine(os.str(), message);
+    message->append(kLineBreak);
   }
 }
 
@@ -1653,10 +1721,14 @@ void BuildRtpMap(const MediaContentDescription* media_desc,
       // a=rtpmap:<payload type> <encoding name>/<clock rate>
       // [/<encodingparameters>]
       if (it->id != kWildcardPayloadType) {
-        InitAttrLine(kAttributeRtpmap, &os);
-        os << kSdpDelimiterColon << it->id << " " << it->name
-         << "/" << kDefaultVideoClockrate;
-        AddLine(os.str(), message);
+        AppendAttrLine(kAttributeRtpmap, message);
+        message->push_back(kSdpDelimiterColon);
+        AppendInt(it->id, message);
+        message->push_back(kSdpDelimiterSpace);
+        message->append(it->name);
+        message->push_back(kSdpDelimiterSlash);
+        AppendInt(kDefaultVideoClockrate, message);
+        message->append(kLineBreak);
       }
       AddRtcpFbLines(*it, message);
       AddFmtpLine(*it, message);
@@ -1674,13 +1746,18 @@ void BuildRtpMap(const MediaContentDescription* media_desc,
       // RFC 4566
       // a=rtpmap:<payload type> <encoding name>/<clock rate>
       // [/<encodingparameters>]
-      InitAttrLine(kAttributeRtpmap, &os);
-      os << kSdpDelimiterColon << it->id << " ";
-      os << it->name << "/" << it->clockrate;
+      AppendAttrLine(kAttributeRtpmap, message);
+      message->push_back(kSdpDelimiterColon);
+      AppendInt(it->id, message);
+      message->push_back(kSdpDelimiterSpace);
+      message->append(it->name);
+      message->push_back(kSdpDelimiterSlash);
+      AppendInt(it->clockrate, message);
       if (it->channels != 1) {
-        os << "/" << it->channels;
+        message->push_back(kSdpDelimiterSlash);
+        AppendInt(it->channels, message);
       }
-      AddLine(os.str(), message);
+      message->append(kLineBreak);
       AddRtcpFbLines(*it, message);
       AddFmtpLine(*it, message);
       int minptime = 0;
@@ -1818,8 +1895,7 @@ bool ParseSessionDescription(const std::string& message, size_t* pos,
                                  std::string(), error);
   }
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_fields = 6;
   if (fields.size() != expected_fields) {
     return ParseFailedExpectFieldNum(line, expected_fields, error);
@@ -1956,8 +2032,7 @@ bool ParseGroupAttribute(const std::string& line,
   // RFC 5888 and draft-holmberg-mmusic-sdp-bundle-negotiation-00
   // a=group:BUNDLE video voice
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   std::string semantics;
   if (!GetValue(fields[0], kAttributeGroup, &semantics, error)) {
     return false;
@@ -1980,8 +2055,7 @@ static bool ParseFingerprintAttribute(const std::string& line,
   }
 
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_fields = 2;
   if (fields.size() != expected_fields) {
     return ParseFailedExpectFieldNum(line, expected_fields, error);
@@ -2016,7 +2090,7 @@ static bool ParseDtlsSetup(const std::string& line,
   // setup-attr           =  "a=setup:" role
   // role                 =  "active" / "passive" / "actpass" / "holdconn"
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength), kSdpDelimiterColon, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterColon, &fields);
   const size_t expected_fields = 2;
   if (fields.size() != expected_fields) {
     return ParseFailedExpectFieldNum(line, expected_fields, error);
@@ -2161,8 +2235,7 @@ bool ParseMediaDescription(const std::string& message,
     ++mline_index;
 
     std::vector<std::string> fields;
-    rtc::split(line.substr(kLinePrefixLength),
-                     kSdpDelimiterSpace, &fields);
+    SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
     const size_t expected_min_fields = 4;
     if (fields.size() < expected_min_fields) {
       return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -2725,7 +2798,7 @@ bool ParseSsrcAttribute(const std::string& line, SsrcInfoVec* ssrc_infos,
   // a=ssrc:<ssrc-id> <attribute>
   // a=ssrc:<ssrc-id> <attribute>:<value>
   std::string field1, field2;
-  if (!SplitByDelimiter(line.substr(kLinePrefixLength),
+  if (!SplitByDelimiter(line, kLinePrefixLength,
                         kSdpDelimiterSpace,
                         &field1,
                         &field2)) {
@@ -2806,8 +2879,7 @@ bool ParseSsrcGroupAttribute(const std::string& line,
   // RFC 5576
   // a=ssrc-group:<semantics> <ssrc-id> ...
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_min_fields = 2;
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -2832,8 +2904,7 @@ bool ParseCryptoAttribute(const std::string& line,
                           MediaContentDescription* media_desc,
                           SdpParseError* error) {
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   // RFC 4568
   // a=crypto:<tag> <crypto-suite> <key-params> [<session-params>]
   const size_t expected_min_fields = 3;
@@ -2899,8 +2970,7 @@ bool ParseRtpmapAttribute(const std::string& line,
                           MediaContentDescription* media_desc,
                           SdpParseError* error) {
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   // RFC 4566
   // a=rtpmap:<payload type> <encoding name>/<clock rate>[/<encodingparameters>]
   const size_t expected_min_fields = 2;
@@ -3016,8 +3086,7 @@ bool ParseFmtpAttributes(const std::string& line, const MediaType media_type,
     return true;
   }
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitFields(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
 
   // RFC 5576
   // a=fmtp:<format> <format specific parameters>
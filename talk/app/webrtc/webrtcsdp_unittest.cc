@@ -41,6 +41,7 @@
 #include "webrtc/base/sslfingerprint.h"
 #include "webrtc/base/stringencode.h"
 #include "webrtc/base/stringutils.h"
+#include "webrtc/base/timeutils.h"
 
 using cricket::AudioCodec;
 using cricket::AudioContentDescription;
@@ -2527,3 +2528,63 @@ TEST_F(WebRtcSdpTest, MediaContentOrderMaintainedRoundTrip) {
     EXPECT_EQ(sdp_string, serialized_sdp);
   }
 }
+
+// Returns an SDP with |num_pairs| copies of the audio and video sections of
+// kSdpFullString, each with its own mid.
+static std::string CreateLargeSdp(int num_pairs) {
+  const std::string full_sdp = kSdpFullString;
+  const size_t audio_start = full_sdp.find("m=audio");
+  const size_t video_start = full_sdp.find("m=video");
+  EXPECT_NE(std::string::npos, audio_start);
+  EXPECT_NE(std::string::npos, video_start);
+  const std::string audio_sdp =
+      full_sdp.substr(audio_start, video_start - audio_start);
+  const std::string video_sdp = full_sdp.substr(video_start);
+
+  std::string sdp = full_sdp.substr(0, audio_start);
+  for (int i = 0; i < num_pairs; ++i) {
+    const std::string suffix = "_" + rtc::ToString(i);
+    std::string audio = audio_sdp;
+    Replace(std::string("a=mid:") + kAudioContentName,
+            std::string("a=mid:") + kAudioContentName + suffix, &audio);
+    std::string video = video_sdp;
+    Replace(std::string("a=mid:") + kVideoContentName,
+            std::string("a=mid:") + kVideoContentName + suffix, &video);
+    sdp += audio + video;
+  }
+  return sdp;
+}
+
+// Test that an SDP with 50 m-lines survives deserializing and serializing.
+TEST_F(WebRtcSdpTest, DeserializeAndSerializeLargeSdp) {
+  const int kNumMediaSectionPairs = 25;
+  const std::string sdp = CreateLargeSdp(kNumMediaSectionPairs);
+  JsepSessionDescription jdesc(kDummyString);
+  ASSERT_TRUE(SdpDeserialize(sdp, &jdesc));
+  EXPECT_EQ(2u * kNumMediaSectionPairs,
+            jdesc.description()->contents().size());
+  EXPECT_EQ(sdp, webrtc::SdpSerialize(jdesc));
+}
+
+// Test the time required to deserialize and serialize the SDP above.
+TEST_F(WebRtcSdpTest, DISABLED_DeserializeAndSerializeLargeSdpPerf) {
+  const std::string sdp = CreateLargeSdp(25);
+  const int kNumRuns = 100;
+  uint64 deserialize_time = 0;
+  uint64 serialize_time = 0;
+  for (int i = 0; i < kNumRuns; ++i) {
+    JsepSessionDescription jdesc(kDummyString);
+    uint64 start = rtc::TimeMicros();
+    ASSERT_TRUE(SdpDeserialize(sdp, &jdesc));
+    deserialize_time += rtc::TimeMicros() - start;
+
+    start = rtc::TimeMicros();
+    std::string message = webrtc::SdpSerialize(jdesc);
+    serialize_time += rtc::TimeMicros() - start;
+  }
+
+  LOG(LS_INFO) << "Average SdpDeserialize time: "
+               << deserialize_time / kNumRuns << " us";
+  LOG(LS_INFO) << "Average SdpSerialize time: "
+               << serialize_time / kNumRuns << " us";
+}
@@ -512,6 +512,7 @@ bool WebRtcSession::Initialize(
     const PeerConnectionFactoryInterface::Options& options,
     const MediaConstraintsInterface*  constraints,
     DTLSIdentityServiceInterface* dtls_identity_service,
+    DtlsIdentityPool* dtls_identity_pool,
     PeerConnectionInterface::IceTransportsType ice_transport) {
   // TODO(perkj): Take |constraints| into consideration. Return false if not all
   // mandatory constraints can be fulfilled. Note that |constraints|
@@ -648,6 +649,7 @@ bool WebRtcSession::Initialize(
       channel_manager_,
       mediastream_signaling_,
       dtls_identity_service,
+      dtls_identity_pool,
       this,
       id(),
       data_channel_type_,
@@ -56,6 +56,7 @@ class VoiceChannel;
 
 namespace webrtc {
 
+class DtlsIdentityPool;
 class IceRestartAnswerLatch;
 class JsepIceCandidate;
 class MediaStreamSignaling;
@@ -115,9 +116,12 @@ class WebRtcSession : public cricket::BaseSession,
                 MediaStreamSignaling* mediastream_signaling);
   virtual ~WebRtcSession();
 
+  // |dtls_identity_pool| is used, if not NULL, to get the DTLS identity when
+  // DTLS is enabled without a |dtls_identity_service|.
   bool Initialize(const PeerConnectionFactoryInterface::Options& options,
                   const MediaConstraintsInterface* constraints,
                   DTLSIdentityServiceInterface* dtls_identity_service,
+                  DtlsIdentityPool* dtls_identity_pool,
                   PeerConnectionInterface::IceTransportsType ice_transport);
   // Deletes the voice, video and data channel and changes the session state
   // to STATE_RECEIVEDTERMINATE.
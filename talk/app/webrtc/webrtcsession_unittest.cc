@@ -26,6 +26,7 @@
  */
 
 #include "talk/app/webrtc/audiotrack.h"
+#include "talk/app/webrtc/dtlsidentitypool.h"
 #include "talk/app/webrtc/jsepicecandidate.h"
 #include "talk/app/webrtc/jsepsessiondescription.h"
 #include "talk/app/webrtc/mediastreamsignaling.h"
@@ -56,6 +57,7 @@
 #include "webrtc/base/sslstreamadapter.h"
 #include "webrtc/base/stringutils.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/base/virtualsocketserver.h"
 
 #define MAYBE_SKIP_TEST(feature)                    \
@@ -79,6 +81,7 @@ using webrtc::CreateSessionDescriptionObserver;
 using webrtc::CreateSessionDescriptionRequest;
 using webrtc::DTLSIdentityRequestObserver;
 using webrtc::DTLSIdentityServiceInterface;
+using webrtc::DtlsIdentityPool;
 using webrtc::FakeConstraints;
 using webrtc::IceCandidateCollection;
 using webrtc::JsepIceCandidate;
@@ -98,6 +101,7 @@ using webrtc::kSdpWithoutDtlsFingerprint;
 using webrtc::kSdpWithoutSdesCrypto;
 using webrtc::kSessionError;
 using webrtc::kSessionErrorDesc;
+using webrtc::kWebRTCIdentityName;
 using webrtc::kMaxUnsignalledRecvStreams;
 
 typedef PeerConnectionInterface::RTCOfferAnswerOptions RTCOfferAnswerOptions;
@@ -382,7 +386,8 @@ class WebRtcSessionTest : public testing::Test {
         observer_.ice_gathering_state_);
 
     EXPECT_TRUE(session_->Initialize(options_, constraints_.get(),
-                                     identity_service, ice_type_));
+                                     identity_service, identity_pool_.get(),
+                                     ice_type_));
     session_->set_metrics_observer(&metrics_observer_);
   }
 
@@ -403,6 +408,15 @@ class WebRtcSessionTest : public testing::Test {
     Init(identity_service);
   }
 
+  // Enables DTLS without an identity service, so that the session generates
+  // its identity, or takes it from |identity_pool_| if set.
+  void InitWithDtlsGeneratedIdentity() {
+    constraints_.reset(new FakeConstraints());
+    constraints_->AddOptional(
+        webrtc::MediaConstraintsInterface::kEnableDtlsSrtp, true);
+    Init(NULL);
+  }
+
   // Creates a local offer and applies it. Starts ice.
   // Call mediastream_signaling_.UseOptionsWithStreamX() before this function
   // to decide which streams to create.
@@ -1215,6 +1229,55 @@ class WebRtcSessionTest : public testing::Test {
                           cricket::PORTALLOCATOR_ENABLE_BUNDLE);
   }
 
+  // Applies a renegotiated remote offer and the local answer as participants
+  // join a conference, each sending one audio and one video stream, until
+  // there are |participant_counts[i]| participants for each i. The last
+  // |joins_per_count| participants of each count join one at a time; the
+  // time taken by their renegotiations is logged. Verifies that the streams
+  // of all participants are received.
+  void JoinParticipants(const int* participant_counts, size_t num_counts,
+                        int joins_per_count) {
+    cricket::MediaSessionOptions options;
+    options.recv_video = true;
+    int participants = 0;
+    int version = 0;
+    for (size_t i = 0; i < num_counts; ++i) {
+      uint64 elapsed_us = 0;
+      while (participants < participant_counts[i]) {
+        std::string label = "participant" + rtc::ToString(participants);
+        options.AddSendStream(cricket::MEDIA_TYPE_AUDIO, label + "a", label);
+        options.AddSendStream(cricket::MEDIA_TYPE_VIDEO, label + "v", label);
+        ++participants;
+        // Join all but the last few participants at once.
+        if (participants < participant_counts[i] - joins_per_count)
+          continue;
+
+        SessionDescriptionInterface* offer = CreateRemoteOfferWithVersion(
+            options, cricket::SEC_DISABLED, rtc::ToString(++version),
+            session_->remote_description());
+        ASSERT_TRUE(offer != NULL);
+        uint64 start = rtc::TimeMicros();
+        SetRemoteDescriptionWithoutError(offer);
+        uint64 remote_us = rtc::TimeMicros() - start;
+        SessionDescriptionInterface* answer = CreateAnswer(NULL);
+        ASSERT_TRUE(answer != NULL);
+        start = rtc::TimeMicros();
+        SetLocalDescriptionWithoutError(answer);
+        if (participants > participant_counts[i] - joins_per_count)
+          elapsed_us += remote_us + rtc::TimeMicros() - start;
+      }
+
+      EXPECT_EQ(static_cast<size_t>(participants),
+                mediastream_signaling_.remote_streams()->count());
+      ASSERT_TRUE(media_engine_->GetVoiceChannel(0) != NULL);
+      EXPECT_EQ(static_cast<size_t>(participants),
+                media_engine_->GetVoiceChannel(0)->recv_streams().size());
+      LOG(LS_INFO) << "Renegotiation with " << participants
+                   << " participants: " << elapsed_us / joins_per_count
+                   << " us per join.";
+    }
+  }
+
   cricket::FakeMediaEngine* media_engine_;
   cricket::FakeDataEngine* data_engine_;
   cricket::FakeDeviceManager* device_manager_;
@@ -1232,6 +1295,7 @@ class WebRtcSessionTest : public testing::Test {
   rtc::FakeNetworkManager network_manager_;
   rtc::scoped_ptr<cricket::BasicPortAllocator> allocator_;
   PeerConnectionFactoryInterface::Options options_;
+  rtc::scoped_ptr<DtlsIdentityPool> identity_pool_;
   rtc::scoped_ptr<FakeConstraints> constraints_;
   FakeMediaStreamSignaling mediastream_signaling_;
   rtc::scoped_ptr<WebRtcSessionForTest> session_;
@@ -3385,6 +3449,76 @@ TEST_F(WebRtcSessionTest, TestCreateOfferAfterIdentityRequestReturnSuccess) {
   EXPECT_TRUE(offer != NULL);
 }
 
+// Verifies that the identity is taken from the pool when there is one, and
+// that the pool is refilled.
+TEST_F(WebRtcSessionTest, TestCreateOfferWithIdentityFromPool) {
+  MAYBE_SKIP_TEST(rtc::SSLStreamAdapter::HaveDtlsSrtp);
+  identity_pool_.reset(new DtlsIdentityPool(kWebRTCIdentityName, 1));
+  EXPECT_EQ_WAIT(1u, identity_pool_->ready(), 10000);
+  InitWithDtlsGeneratedIdentity();
+
+  EXPECT_TRUE(session_->waiting_for_identity());
+  EXPECT_EQ(0u, identity_pool_->ready());
+  EXPECT_TRUE_WAIT(!session_->waiting_for_identity(), 1000);
+
+  mediastream_signaling_.SendAudioVideoStream1();
+  rtc::scoped_ptr<SessionDescriptionInterface> offer(CreateOffer());
+  ASSERT_TRUE(offer != NULL);
+  VerifyFingerprintStatus(offer->description(), true);
+  EXPECT_EQ_WAIT(1u, identity_pool_->ready(), 10000);
+}
+
+// Measures how long sessions wait for their DTLS identity when it is
+// generated for each session, and when it is taken from a pool that has had
+// time to fill.
+TEST_F(WebRtcSessionTest, DISABLED_IdentityLatencyWithAndWithoutPoolPerf) {
+  MAYBE_SKIP_TEST(rtc::SSLStreamAdapter::HaveDtlsSrtp);
+  const int kSessions = 5;
+
+  uint64 start = rtc::TimeMicros();
+  for (int i = 0; i < kSessions; ++i) {
+    InitWithDtlsGeneratedIdentity();
+    EXPECT_TRUE_WAIT(!session_->waiting_for_identity(), 10000);
+    session_.reset();
+  }
+  uint64 without_pool_us = rtc::TimeMicros() - start;
+
+  identity_pool_.reset(new DtlsIdentityPool(kWebRTCIdentityName, kSessions));
+  EXPECT_EQ_WAIT(static_cast<size_t>(kSessions), identity_pool_->ready(),
+                 10000 * kSessions);
+  start = rtc::TimeMicros();
+  for (int i = 0; i < kSessions; ++i) {
+    InitWithDtlsGeneratedIdentity();
+    EXPECT_TRUE_WAIT(!session_->waiting_for_identity(), 10000);
+    session_.reset();
+  }
+  uint64 with_pool_us = rtc::TimeMicros() - start;
+
+  LOG(LS_INFO) << "DTLS identity for " << kSessions << " sessions: "
+               << without_pool_us / kSessions << " us each when generated, "
+               << with_pool_us / kSessions << " us each from the pool.";
+}
+
+// Tests that the streams of all participants are received as participants
+// join a conference, each with its own renegotiation.
+TEST_F(WebRtcSessionTest, RenegotiationWithJoiningParticipants) {
+  options_.disable_encryption = true;
+  Init(NULL);
+  const int kParticipantCounts[] = {4, 8};
+  JoinParticipants(kParticipantCounts, ARRAY_SIZE(kParticipantCounts), 2);
+}
+
+// Measures the renegotiations above with up to 200 participants. Only the
+// joining participant's streams should be touched, so the time per
+// renegotiation should grow no more than linearly with the participant count.
+TEST_F(WebRtcSessionTest,
+       DISABLED_RenegotiationLatencyWithParticipantCountPerf) {
+  options_.disable_encryption = true;
+  Init(NULL);
+  const int kParticipantCounts[] = {10, 50, 200};
+  JoinParticipants(kParticipantCounts, ARRAY_SIZE(kParticipantCounts), 5);
+}
+
 // Verifies that CreateOffer fails when CreateOffer is called after async
 // identity generation fails.
 TEST_F(WebRtcSessionTest, TestCreateOfferAfterIdentityRequestReturnFailure) {
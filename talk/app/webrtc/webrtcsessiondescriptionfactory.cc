@@ -27,6 +27,7 @@
 
 #include "talk/app/webrtc/webrtcsessiondescriptionfactory.h"
 
+#include "talk/app/webrtc/dtlsidentitypool.h"
 #include "talk/app/webrtc/jsep.h"
 #include "talk/app/webrtc/jsepsessiondescription.h"
 #include "talk/app/webrtc/mediaconstraintsinterface.h"
@@ -36,13 +37,14 @@
 using cricket::MediaSessionOptions;
 
 namespace webrtc {
-namespace {
-static const char kFailedDueToIdentityFailed[] =
-    " failed because DTLS identity request failed";
 
 // Arbitrary constant used as common name for the identity.
 // Chosen to make the certificates more readable.
-static const char kWebRTCIdentityName[] = "WebRTC";
+const char kWebRTCIdentityName[] = "WebRTC";
+
+namespace {
+static const char kFailedDueToIdentityFailed[] =
+    " failed because DTLS identity request failed";
 
 static const uint64 kInitSessionVersion = 2;
 
@@ -70,6 +72,7 @@ enum {
   MSG_CREATE_SESSIONDESCRIPTION_SUCCESS,
   MSG_CREATE_SESSIONDESCRIPTION_FAILED,
   MSG_GENERATE_IDENTITY,
+  MSG_POOLED_IDENTITY,
 };
 
 struct CreateSessionDescriptionMsg : public rtc::MessageData {
@@ -108,6 +111,7 @@ WebRtcSessionDescriptionFactory::WebRtcSessionDescriptionFactory(
     cricket::ChannelManager* channel_manager,
     MediaStreamSignaling* mediastream_signaling,
     DTLSIdentityServiceInterface* dtls_identity_service,
+    DtlsIdentityPool* dtls_identity_pool,
     WebRtcSession* session,
     const std::string& session_id,
     cricket::DataChannelType dct,
@@ -121,6 +125,7 @@ WebRtcSessionDescriptionFactory::WebRtcSessionDescriptionFactory(
       // |kInitSessionVersion|.
       session_version_(kInitSessionVersion),
       identity_service_(dtls_identity_service),
+      identity_pool_(dtls_identity_pool),
       session_(session),
       session_id_(session_id),
       data_channel_type_(dct),
@@ -155,12 +160,21 @@ WebRtcSessionDescriptionFactory::WebRtcSessionDescriptionFactory(
   } else {
     identity_request_state_ = IDENTITY_WAITING;
     // Do not generate the identity in the constructor since the caller has
-    // not got a chance to connect to SignalIdentityReady.
-    signaling_thread_->Post(this, MSG_GENERATE_IDENTITY, NULL);
+    // not got a chance to connect to SignalIdentityReady. The pool posts the
+    // identity as well.
+    if (identity_pool_) {
+      identity_pool_->RequestIdentity(signaling_thread_, this,
+                                      MSG_POOLED_IDENTITY);
+    } else {
+      signaling_thread_->Post(this, MSG_GENERATE_IDENTITY, NULL);
+    }
   }
 }
 
 WebRtcSessionDescriptionFactory::~WebRtcSessionDescriptionFactory() {
+  if (identity_pool_) {
+    identity_pool_->CancelRequests(this);
+  }
   transport_desc_factory_.set_identity(NULL);
 }
 
@@ -293,6 +307,18 @@ void WebRtcSessionDescriptionFactory::OnMessage(rtc::Message* msg) {
       SetIdentity(rtc::SSLIdentity::Generate(kWebRTCIdentityName));
       break;
     }
+    case MSG_POOLED_IDENTITY: {
+      rtc::ScopedMessageData<rtc::SSLIdentity>* param =
+          static_cast<rtc::ScopedMessageData<rtc::SSLIdentity>*>(msg->pdata);
+      rtc::SSLIdentity* identity = param->data().release();
+      delete param;
+      if (!identity) {
+        LOG(LS_WARNING) << "No identity from the pool, generating one.";
+        identity = rtc::SSLIdentity::Generate(kWebRTCIdentityName);
+      }
+      SetIdentity(identity);
+      break;
+    }
     default:
       ASSERT(false);
       break;
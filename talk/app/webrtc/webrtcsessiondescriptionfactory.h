@@ -40,11 +40,15 @@ class TransportDescriptionFactory;
 
 namespace webrtc {
 class CreateSessionDescriptionObserver;
+class DtlsIdentityPool;
 class MediaConstraintsInterface;
 class MediaStreamSignaling;
 class SessionDescriptionInterface;
 class WebRtcSession;
 
+// Common name of the DTLS identities generated for sessions.
+extern const char kWebRTCIdentityName[];
+
 // DTLS identity request callback class.
 class WebRtcIdentityRequestObserver : public DTLSIdentityRequestObserver,
                                       public sigslot::has_slots<> {
@@ -94,6 +98,7 @@ class WebRtcSessionDescriptionFactory : public rtc::MessageHandler,
       cricket::ChannelManager* channel_manager,
       MediaStreamSignaling* mediastream_signaling,
       DTLSIdentityServiceInterface* dtls_identity_service,
+      DtlsIdentityPool* dtls_identity_pool,
       // TODO(jiayl): remove the dependency on session once b/10226852 is fixed.
       WebRtcSession* session,
       const std::string& session_id,
@@ -157,6 +162,7 @@ class WebRtcSessionDescriptionFactory : public rtc::MessageHandler,
   rtc::scoped_ptr<DTLSIdentityServiceInterface> identity_service_;
   rtc::scoped_refptr<WebRtcIdentityRequestObserver>
       identity_request_observer_;
+  DtlsIdentityPool* identity_pool_;
   WebRtcSession* session_;
   std::string session_id_;
   cricket::DataChannelType data_channel_type_;
@@ -641,6 +641,8 @@
         'app/webrtc/datachannel.cc',
         'app/webrtc/datachannel.h',
         'app/webrtc/datachannelinterface.h',
+        'app/webrtc/dtlsidentitypool.cc',
+        'app/webrtc/dtlsidentitypool.h',
         'app/webrtc/dtmfsender.cc',
         'app/webrtc/dtmfsender.h',
         'app/webrtc/dtmfsenderinterface.h',
@@ -203,6 +203,7 @@
       },
       'sources': [
         'app/webrtc/datachannel_unittest.cc',
+        'app/webrtc/dtlsidentitypool_unittest.cc',
         'app/webrtc/dtmfsender_unittest.cc',
         'app/webrtc/jsepsessiondescription_unittest.cc',
         'app/webrtc/localaudiosource_unittest.cc',
@@ -260,6 +260,34 @@ bool RemoveStreamByIds(StreamParamsVec* streams,
   return RemoveStream(streams, StreamSelector(groupid, id));
 }
 
+StreamSsrcIndex::StreamSsrcIndex(const StreamParamsVec& streams)
+    : streams_(streams) {
+  for (StreamParamsVec::const_iterator stream = streams.begin();
+       stream != streams.end(); ++stream) {
+    for (std::vector<uint32>::const_iterator ssrc = stream->ssrcs.begin();
+         ssrc != stream->ssrcs.end(); ++ssrc) {
+      // insert() keeps the first stream with the SSRC, like GetStream().
+      streams_by_ssrc_.insert(std::make_pair(*ssrc, &*stream));
+    }
+  }
+}
+
+const StreamParams* StreamSsrcIndex::Find(uint32 ssrc) const {
+  if (ssrc == 0) {
+    // StreamSelector matches SSRC 0 by ids instead, so search for it.
+    StreamSelector selector(ssrc);
+    for (StreamParamsVec::const_iterator stream = streams_.begin();
+         stream != streams_.end(); ++stream) {
+      if (selector.Matches(*stream))
+        return &*stream;
+    }
+    return NULL;
+  }
+  std::map<uint32, const StreamParams*>::const_iterator it =
+      streams_by_ssrc_.find(ssrc);
+  return it != streams_by_ssrc_.end() ? it->second : NULL;
+}
+
 bool IsOneSsrcStream(const StreamParams& sp) {
   if (sp.ssrcs.size() == 1 && sp.ssrc_groups.empty()) {
     return true;
@@ -44,6 +44,7 @@
 #define TALK_MEDIA_BASE_STREAMPARAMS_H_
 
 #include <algorithm>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -294,6 +295,22 @@ bool RemoveStreamByIds(StreamParamsVec* streams,
                        const std::string& groupid,
                        const std::string& id);
 
+// Finds streams by SSRC the same way as GetStreamBySsrc(), but in O(log n).
+// Use this to compare two stream lists, as when applying a new session
+// description, without a linear search per stream. |streams| must outlive
+// the index and must not change while it is in use.
+class StreamSsrcIndex {
+ public:
+  explicit StreamSsrcIndex(const StreamParamsVec& streams);
+
+  // Returns the first stream that contains |ssrc|, or NULL if none does.
+  const StreamParams* Find(uint32 ssrc) const;
+
+ private:
+  const StreamParamsVec& streams_;
+  std::map<uint32, const StreamParams*> streams_by_ssrc_;
+};
+
 // Checks if |sp| defines parameters for a single primary stream. There may
 // be an RTX stream associated with the primary stream. Leaving as non-static so
 // we can test this function.
@@ -28,6 +28,7 @@
 #include "talk/media/base/streamparams.h"
 #include "talk/media/base/testutils.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/stringencode.h"
 
 static const uint32 kSsrcs1[] = {1};
 static const uint32 kSsrcs2[] = {1, 2};
@@ -280,3 +281,32 @@ TEST(StreamParams, TestIsSimulcastStream_InvalidStreams) {
   stream3.ssrc_groups.push_back(sg);
   EXPECT_FALSE(cricket::IsSimulcastStream(stream3));
 }
+
+TEST(StreamParams, StreamSsrcIndexMatchesGetStreamBySsrc) {
+  cricket::StreamParamsVec streams;
+  streams.push_back(cricket::StreamParams::CreateLegacy(10));
+  streams.push_back(CreateStreamParamsWithSsrcGroup(
+      cricket::kSimSsrcGroupSemantics, kSsrcs3, ARRAY_SIZE(kSsrcs3)));
+  // Shares SSRC 1 with the stream above, which is found first.
+  streams.push_back(cricket::StreamParams::CreateLegacy(1));
+  for (size_t i = 0; i < streams.size(); ++i)
+    streams[i].id = "stream" + rtc::ToString(i);
+  cricket::StreamParams no_ssrcs;
+  streams.push_back(no_ssrcs);
+
+  cricket::StreamSsrcIndex index(streams);
+  EXPECT_EQ(&streams[0], index.Find(10));
+  EXPECT_EQ(&streams[1], index.Find(1));
+  EXPECT_EQ(&streams[1], index.Find(3));
+  EXPECT_TRUE(index.Find(7) == NULL);
+  // SSRC 0 selects the stream with empty ids, as GetStreamBySsrc() does.
+  EXPECT_EQ(&streams[3], index.Find(0));
+
+  for (uint32 ssrc = 0; ssrc <= 10; ++ssrc) {
+    cricket::StreamParams stream;
+    bool found = cricket::GetStreamBySsrc(streams, ssrc, &stream);
+    ASSERT_EQ(found, index.Find(ssrc) != NULL) << "ssrc " << ssrc;
+    if (found)
+      EXPECT_EQ(stream, *index.Find(ssrc)) << "ssrc " << ssrc;
+  }
+}
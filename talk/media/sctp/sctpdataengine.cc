@@ -102,16 +102,20 @@ std::string ListArray(const uint16* array, int num_elems) {
 }  // namespace
 
 namespace cricket {
-typedef rtc::ScopedMessageData<SctpInboundPacket> InboundPacketMessage;
-typedef rtc::ScopedMessageData<rtc::Buffer> OutboundPacketMessage;
 
-// The biggest SCTP packet.  Starting from a 'safe' wire MTU value of 1280,
-// take off 80 bytes for DTLS/TURN/TCP/IP overhead.
+// The default biggest SCTP packet.  Starting from a 'safe' wire MTU value of
+// 1280, take off 80 bytes for DTLS/TURN/TCP/IP overhead.
 static const size_t kSctpMtu = 1200;
 
+// The most packets kept for reuse in each direction, enough for a burst of
+// full-sized packets filling the default usrsctp window. Buffers grown past
+// kMaxPooledSctpPacketSize by a large message are not kept.
+static const size_t kMaxPooledSctpPackets = 256;
+static const size_t kMaxPooledSctpPacketSize = 16 * 1024;
+
 enum {
-  MSG_SCTPINBOUNDPACKET = 1,   // MessageData is SctpInboundPacket
-  MSG_SCTPOUTBOUNDPACKET = 2,  // MessageData is rtc:Buffer
+  MSG_SCTPINBOUNDPACKET = 1,   // No MessageData; drains inbound_packets_
+  MSG_SCTPOUTBOUNDPACKET = 2,  // No MessageData; drains outbound_packets_
 };
 
 struct SctpInboundPacket {
@@ -122,6 +126,47 @@ struct SctpInboundPacket {
   int flags;
 };
 
+static size_t PacketCapacity(const rtc::Buffer* packet) {
+  return packet->capacity();
+}
+
+static size_t PacketCapacity(const SctpInboundPacket* packet) {
+  return packet->buffer.capacity();
+}
+
+// Takes a packet from |pool|, or allocates one if it is empty.
+template <class T>
+static T* GetPooledPacket(std::vector<T*>* pool) {
+  if (pool->empty()) {
+    return new T;
+  }
+  T* packet = pool->back();
+  pool->pop_back();
+  return packet;
+}
+
+// Returns the |packets| to |pool| for reuse, and clears |packets|.
+template <class T>
+static void RecyclePackets(std::vector<T*>* packets, std::vector<T*>* pool) {
+  for (size_t i = 0; i < packets->size(); ++i) {
+    if (pool->size() < kMaxPooledSctpPackets &&
+        PacketCapacity((*packets)[i]) <= kMaxPooledSctpPacketSize) {
+      pool->push_back((*packets)[i]);
+    } else {
+      delete (*packets)[i];
+    }
+  }
+  packets->clear();
+}
+
+template <class T>
+static void DeletePackets(std::vector<T*>* packets) {
+  for (size_t i = 0; i < packets->size(); ++i) {
+    delete (*packets)[i];
+  }
+  packets->clear();
+}
+
 // Helper for logging SCTP messages.
 static void debug_sctp_printf(const char *format, ...) {
   char s[255];
@@ -186,9 +231,7 @@ static int OnSctpOutboundPacket(void* addr, void* data, size_t length,
                   << "; tos: " << std::hex << static_cast<int>(tos)
                   << "; set_df: " << std::hex << static_cast<int>(set_df);
   // Note: We have to copy the data; the caller will delete it.
-  OutboundPacketMessage* msg =
-      new OutboundPacketMessage(new rtc::Buffer(data, length));
-  channel->worker_thread()->Post(channel, MSG_SCTPOUTBOUNDPACKET, msg);
+  channel->QueueOutboundPacket(data, length);
   return 0;
 }
 
@@ -201,7 +244,7 @@ static int OnSctpInboundPacket(struct socket* sock, union sctp_sockstore addr,
                                struct sctp_rcvinfo rcv, int flags,
                                void* ulp_info) {
   SctpDataMediaChannel* channel = static_cast<SctpDataMediaChannel*>(ulp_info);
-  // Post data to the channel's receiver thread (copying it).
+  // Queue data for the channel's receiver thread (copying it).
   // TODO(ldixon): Unclear if copy is needed as this method is responsible for
   // memory cleanup. But this does simplify code.
   const SctpDataMediaChannel::PayloadProtocolIdentifier ppid =
@@ -213,16 +256,12 @@ static int OnSctpInboundPacket(struct socket* sock, union sctp_sockstore addr,
     LOG(LS_ERROR) << "Received an unknown PPID " << ppid
                   << " on an SCTP packet.  Dropping.";
   } else {
-    SctpInboundPacket* packet = new SctpInboundPacket;
-    packet->buffer.SetData(data, length);
-    packet->params.ssrc = rcv.rcv_sid;
-    packet->params.seq_num = rcv.rcv_ssn;
-    packet->params.timestamp = rcv.rcv_tsn;
-    packet->params.type = type;
-    packet->flags = flags;
-    // The ownership of |packet| transfers to |msg|.
-    InboundPacketMessage* msg = new InboundPacketMessage(packet);
-    channel->worker_thread()->Post(channel, MSG_SCTPINBOUNDPACKET, msg);
+    ReceiveDataParams params;
+    params.ssrc = rcv.rcv_sid;
+    params.seq_num = rcv.rcv_ssn;
+    params.timestamp = rcv.rcv_tsn;
+    params.type = type;
+    channel->QueueInboundPacket(data, length, params, flags);
   }
   free(data);
   return 1;
@@ -306,6 +345,10 @@ SctpDataMediaChannel::SctpDataMediaChannel(rtc::Thread* thread)
       local_port_(kSctpDefaultPort),
       remote_port_(kSctpDefaultPort),
       sock_(NULL),
+      mtu_(kSctpMtu),
+      socket_mtu_(kSctpMtu),
+      send_buffer_size_(0),
+      recv_buffer_size_(0),
       sending_(false),
       receiving_(false),
       debug_name_("SctpDataMediaChannel") {
@@ -313,6 +356,12 @@ SctpDataMediaChannel::SctpDataMediaChannel(rtc::Thread* thread)
 
 SctpDataMediaChannel::~SctpDataMediaChannel() {
   CloseSctpSocket();
+  // Packets that were queued but not drained yet are dropped.
+  rtc::CritScope cs(&packets_crit_);
+  DeletePackets(&outbound_packets_);
+  DeletePackets(&inbound_packets_);
+  DeletePackets(&free_outbound_packets_);
+  DeletePackets(&free_inbound_packets_);
 }
 
 sockaddr_conn SctpDataMediaChannel::GetSctpSockAddr(int port) {
@@ -359,6 +408,20 @@ bool SctpDataMediaChannel::OpenSctpSocket() {
     return false;
   }
 
+  // Socket buffer sizes, if set. They bound the data in flight.
+  if (send_buffer_size_ > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_SNDBUF, &send_buffer_size_,
+                         sizeof(send_buffer_size_))) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "Failed to set SO_SNDBUF.";
+    return false;
+  }
+  if (recv_buffer_size_ > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &recv_buffer_size_,
+                         sizeof(recv_buffer_size_))) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "Failed to set SO_RCVBUF.";
+    return false;
+  }
+
   // Enable stream ID resets.
   struct sctp_assoc_value stream_rst;
   stream_rst.assoc_id = SCTP_ALL_ASSOC;
@@ -378,11 +441,13 @@ bool SctpDataMediaChannel::OpenSctpSocket() {
     return false;
   }
 
-  // Disable MTU discovery
+  // Disable MTU discovery. The MTU is latched, so that the packets usrsctp
+  // makes are checked against the MTU it was given.
+  socket_mtu_ = mtu_;
   struct sctp_paddrparams params = {0};
   params.spp_assoc_id = 0;
   params.spp_flags = SPP_PMTUD_DISABLE;
-  params.spp_pathmtu = kSctpMtu;
+  params.spp_pathmtu = rtc::checked_cast<uint32_t>(socket_mtu_);
   if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_PEER_ADDR_PARAMS, &params,
       sizeof(params))) {
     LOG_ERRNO(LS_ERROR) << debug_name_
@@ -595,7 +660,7 @@ void SctpDataMediaChannel::OnPacketReceived(
   if (sending_) {
     // Pass received packet to SCTP stack. Once processed by usrsctp, the data
     // will be will be given to the global OnSctpInboundData, and then,
-    // marshalled by a Post and handled with OnMessage.
+    // queued by QueueInboundPacket and handled with OnMessage.
     usrsctp_conninput(this, packet->data(), packet->length(), 0);
   } else {
     // TODO(ldixon): Consider caching the packet for very slightly better
@@ -891,7 +956,7 @@ bool SctpDataMediaChannel::SetRecvCodecs(const std::vector<DataCodec>& codecs) {
 
 void SctpDataMediaChannel::OnPacketFromSctpToNetwork(
     rtc::Buffer* buffer) {
-  if (buffer->length() > kSctpMtu) {
+  if (buffer->length() > socket_mtu_) {
     LOG(LS_ERROR) << debug_name_ << "->OnPacketFromSctpToNetwork(...): "
                   << "SCTP seems to have made a packet that is bigger "
                      "than its official MTU.";
@@ -939,20 +1004,97 @@ bool SctpDataMediaChannel::SendQueuedStreamResets() {
   return true;
 }
 
+void SctpDataMediaChannel::QueueOutboundPacket(const void* data,
+                                               size_t length) {
+  rtc::CritScope cs(&packets_crit_);
+  rtc::Buffer* packet = GetPooledPacket(&free_outbound_packets_);
+  packet->SetData(data, length);
+  outbound_packets_.push_back(packet);
+  // Only the first packet of a batch needs a message; the worker thread
+  // drains all the packets queued by the time it gets to it.
+  if (outbound_packets_.size() == 1) {
+    worker_thread_->Post(this, MSG_SCTPOUTBOUNDPACKET);
+  }
+}
+
+void SctpDataMediaChannel::QueueInboundPacket(const void* data,
+                                              size_t length,
+                                              const ReceiveDataParams& params,
+                                              int flags) {
+  rtc::CritScope cs(&packets_crit_);
+  SctpInboundPacket* packet = GetPooledPacket(&free_inbound_packets_);
+  packet->buffer.SetData(data, length);
+  packet->params = params;
+  packet->flags = flags;
+  inbound_packets_.push_back(packet);
+  if (inbound_packets_.size() == 1) {
+    worker_thread_->Post(this, MSG_SCTPINBOUNDPACKET);
+  }
+}
+
+bool SctpDataMediaChannel::GetSocketBufferSizes(int* send_buffer_size,
+                                                int* recv_buffer_size) const {
+  if (!sock_)
+    return false;
+  socklen_t length = sizeof(*send_buffer_size);
+  if (usrsctp_getsockopt(sock_, SOL_SOCKET, SO_SNDBUF, send_buffer_size,
+                         &length)) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "Failed to get SO_SNDBUF.";
+    return false;
+  }
+  length = sizeof(*recv_buffer_size);
+  if (usrsctp_getsockopt(sock_, SOL_SOCKET, SO_RCVBUF, recv_buffer_size,
+                         &length)) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "Failed to get SO_RCVBUF.";
+    return false;
+  }
+  return true;
+}
+
+size_t SctpDataMediaChannel::num_free_outbound_packets() const {
+  rtc::CritScope cs(&packets_crit_);
+  return free_outbound_packets_.size();
+}
+
+size_t SctpDataMediaChannel::num_free_inbound_packets() const {
+  rtc::CritScope cs(&packets_crit_);
+  return free_inbound_packets_.size();
+}
+
+void SctpDataMediaChannel::DrainOutboundPackets() {
+  std::vector<rtc::Buffer*> packets;
+  {
+    rtc::CritScope cs(&packets_crit_);
+    packets.swap(outbound_packets_);
+  }
+  for (size_t i = 0; i < packets.size(); ++i) {
+    OnPacketFromSctpToNetwork(packets[i]);
+  }
+  rtc::CritScope cs(&packets_crit_);
+  RecyclePackets(&packets, &free_outbound_packets_);
+}
+
+void SctpDataMediaChannel::DrainInboundPackets() {
+  std::vector<SctpInboundPacket*> packets;
+  {
+    rtc::CritScope cs(&packets_crit_);
+    packets.swap(inbound_packets_);
+  }
+  for (size_t i = 0; i < packets.size(); ++i) {
+    OnInboundPacketFromSctpToChannel(packets[i]);
+  }
+  rtc::CritScope cs(&packets_crit_);
+  RecyclePackets(&packets, &free_inbound_packets_);
+}
+
 void SctpDataMediaChannel::OnMessage(rtc::Message* msg) {
   switch (msg->message_id) {
-    case MSG_SCTPINBOUNDPACKET: {
-      rtc::scoped_ptr<InboundPacketMessage> pdata(
-          static_cast<InboundPacketMessage*>(msg->pdata));
-      OnInboundPacketFromSctpToChannel(pdata->data().get());
+    case MSG_SCTPINBOUNDPACKET:
+      DrainInboundPackets();
       break;
-    }
-    case MSG_SCTPOUTBOUNDPACKET: {
-      rtc::scoped_ptr<OutboundPacketMessage> pdata(
-          static_cast<OutboundPacketMessage*>(msg->pdata));
-      OnPacketFromSctpToNetwork(pdata->data().get());
+    case MSG_SCTPOUTBOUNDPACKET:
+      DrainOutboundPackets();
       break;
-    }
   }
 }
 }  // namespace cricket
@@ -45,6 +45,7 @@ enum PreservedErrno {
 #include "talk/media/base/mediachannel.h"
 #include "talk/media/base/mediaengine.h"
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/scoped_ptr.h"
 
 // Defined by "usrsctplib/usrsctp.h"
@@ -72,18 +73,24 @@ const int kSctpDefaultPort = 5000;
 //  2.  usrsctp_sendv(data)
 // [worker thread returns; sctp thread then calls the following]
 //  3.  OnSctpOutboundPacket(wrapped_data)
-// [sctp thread returns having posted a message for the worker thread]
-//  4.  SctpDataMediaChannel::OnMessage(wrapped_data)
-//  5.  SctpDataMediaChannel::OnPacketFromSctpToNetwork(wrapped_data)
+//  4.  SctpDataMediaChannel::QueueOutboundPacket(wrapped_data)
+// [sctp thread returns having queued the packet, and posted a message for the
+//  worker thread if it is the first of a batch]
+//  5.  SctpDataMediaChannel::OnMessage()
+//  5a. SctpDataMediaChannel::OnPacketFromSctpToNetwork(wrapped_data), for each
+//      packet queued since the last message
 //  6.  NetworkInterface::SendPacket(wrapped_data)
 //  7.  ... across network ... a packet is sent back ...
 //  8.  SctpDataMediaChannel::OnPacketReceived(wrapped_data)
 //  9.  usrsctp_conninput(wrapped_data)
 // [worker thread returns; sctp thread then calls the following]
 //  10.  OnSctpInboundData(data)
-// [sctp thread returns having posted a message fot the worker thread]
-//  11. SctpDataMediaChannel::OnMessage(inboundpacket)
-//  12. SctpDataMediaChannel::OnInboundPacketFromSctpToChannel(inboundpacket)
+//  10a. SctpDataMediaChannel::QueueInboundPacket(data)
+// [sctp thread returns having queued the packet, and posted a message for the
+//  worker thread if it is the first of a batch]
+//  11. SctpDataMediaChannel::OnMessage()
+//  12. SctpDataMediaChannel::OnInboundPacketFromSctpToChannel(inboundpacket),
+//      for each packet queued since the last message
 //  13. SctpDataMediaChannel::OnDataFromSctpToChannel(data)
 //  14. SctpDataMediaChannel::SignalDataReceived(data)
 // [from the same thread, methods registered/connected to
@@ -163,6 +170,35 @@ class SctpDataMediaChannel : public DataMediaChannel,
   // Exposed to allow Post call from c-callbacks.
   rtc::Thread* worker_thread() const { return worker_thread_; }
 
+  // Called from the c-callbacks, possibly on a usrsctp thread. The packet is
+  // copied into a pooled buffer and handed to the worker thread, which
+  // drains all the packets queued since its last wakeup at once.
+  void QueueOutboundPacket(const void* data, size_t length);
+  void QueueInboundPacket(const void* data, size_t length,
+                          const ReceiveDataParams& params, int flags);
+
+  // The number of drained packets kept for reuse by the c-callbacks.
+  size_t num_free_outbound_packets() const;
+  size_t num_free_inbound_packets() const;
+
+  // Sets the largest SCTP packet size. It must fit in the path MTU once the
+  // DTLS, TURN and IP overheads are added. An open socket keeps the MTU it
+  // was opened with; the new one applies from the next OpenSctpSocket().
+  void set_mtu(size_t mtu) { mtu_ = mtu; }
+  size_t mtu() const { return mtu_; }
+  // Sets the SCTP socket send and receive buffer sizes, in bytes. Larger
+  // buffers allow more data in flight on high bandwidth-delay paths. 0 keeps
+  // the usrsctp defaults. Like the MTU, they apply from the next
+  // OpenSctpSocket().
+  void set_socket_buffer_sizes(int send_buffer_size, int recv_buffer_size) {
+    send_buffer_size_ = send_buffer_size;
+    recv_buffer_size_ = recv_buffer_size;
+  }
+  // Gets the buffer sizes of the open socket. Returns false if there is no
+  // open socket or usrsctp fails to report them.
+  bool GetSocketBufferSizes(int* send_buffer_size,
+                            int* recv_buffer_size) const;
+
   // TODO(ldixon): add a DataOptions class to mediachannel.h
   virtual bool SetOptions(int options) { return false; }
   virtual int GetOptions() const { return 0; }
@@ -211,6 +247,10 @@ class SctpDataMediaChannel : public DataMediaChannel,
   // Queues a stream for reset.
   bool ResetStream(uint32 ssrc);
 
+  // Called by OnMessage to handle all the queued packets.
+  void DrainOutboundPackets();
+  void DrainInboundPackets();
+
   // Called by OnMessage to send packet on the network.
   void OnPacketFromSctpToNetwork(rtc::Buffer* buffer);
   // Called by OnMessage to decide what to do with the packet.
@@ -232,6 +272,11 @@ class SctpDataMediaChannel : public DataMediaChannel,
   int local_port_;
   int remote_port_;
   struct socket* sock_;  // The socket created by usrsctp_socket(...).
+  // The configured MTU, and the one |sock_| was opened with.
+  size_t mtu_;
+  size_t socket_mtu_;
+  int send_buffer_size_;
+  int recv_buffer_size_;
 
   // sending_ is true iff there is a connected socket.
   bool sending_;
@@ -251,6 +296,14 @@ class SctpDataMediaChannel : public DataMediaChannel,
 
   // A human-readable name for debugging messages.
   std::string debug_name_;
+
+  // Packets queued by the c-callbacks for the worker thread, and the pools of
+  // packets it is done with, for the c-callbacks to reuse.
+  mutable rtc::CriticalSection packets_crit_;
+  std::vector<rtc::Buffer*> outbound_packets_;
+  std::vector<SctpInboundPacket*> inbound_packets_;
+  std::vector<rtc::Buffer*> free_outbound_packets_;
+  std::vector<SctpInboundPacket*> free_inbound_packets_;
 };
 
 }  // namespace cricket
@@ -28,6 +28,7 @@
 #include <errno.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,7 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/ssladapter.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 
 #ifdef HAVE_NSS_SSL_H
 // TODO(thorcarpenter): Remove after webrtc switches over to BoringSSL.
@@ -61,16 +63,22 @@ class SctpFakeNetworkInterface : public cricket::MediaChannel::NetworkInterface,
  public:
   explicit SctpFakeNetworkInterface(rtc::Thread* thread)
     : thread_(thread),
-      dest_(NULL) {
+      dest_(NULL),
+      num_packets_sent_(0),
+      max_packet_size_(0) {
   }
 
   void SetDestination(cricket::DataMediaChannel* dest) { dest_ = dest; }
+  int num_packets_sent() const { return num_packets_sent_; }
+  size_t max_packet_size() const { return max_packet_size_; }
 
  protected:
   // Called to send raw packet down the wire (e.g. SCTP an packet).
   virtual bool SendPacket(rtc::Buffer* packet,
                           rtc::DiffServCodePoint dscp) {
     LOG(LS_VERBOSE) << "SctpFakeNetworkInterface::SendPacket";
+    ++num_packets_sent_;
+    max_packet_size_ = std::max(max_packet_size_, packet->length());
 
     // TODO(ldixon): Can/should we use Buffer.TransferTo here?
     // Note: this assignment does a deep copy of data from packet.
@@ -115,6 +123,8 @@ class SctpFakeNetworkInterface : public cricket::MediaChannel::NetworkInterface,
   // Not owned by this class.
   rtc::Thread* thread_;
   cricket::DataMediaChannel* dest_;
+  int num_packets_sent_;
+  size_t max_packet_size_;
 };
 
 // This is essentially a buffer to hold recieved data. It stores only the last
@@ -124,10 +134,11 @@ class SctpFakeNetworkInterface : public cricket::MediaChannel::NetworkInterface,
 // instead of replacing it.
 class SctpFakeDataReceiver : public sigslot::has_slots<> {
  public:
-  SctpFakeDataReceiver() : received_(false) {}
+  SctpFakeDataReceiver() : received_(false), bytes_received_(0) {}
 
   void Clear() {
     received_ = false;
+    bytes_received_ = 0;
     last_data_ = "";
     last_params_ = cricket::ReceiveDataParams();
   }
@@ -135,16 +146,19 @@ class SctpFakeDataReceiver : public sigslot::has_slots<> {
   virtual void OnDataReceived(const cricket::ReceiveDataParams& params,
                               const char* data, size_t length) {
     received_ = true;
+    bytes_received_ += length;
     last_data_ = std::string(data, length);
     last_params_ = params;
   }
 
   bool received() const { return received_; }
+  size_t bytes_received() const { return bytes_received_; }
   std::string last_data() const { return last_data_; }
   cricket::ReceiveDataParams last_params() const { return last_params_; }
 
  private:
   bool received_;
+  size_t bytes_received_;
   std::string last_data_;
   cricket::ReceiveDataParams last_params_;
 };
@@ -236,6 +250,13 @@ class SctpDataMediaChannelTest : public testing::Test,
   }
 
   void SetupConnectedChannels() {
+    CreateChannels();
+    ConnectChannels();
+  }
+
+  // Creates two channels which send their packets to each other. They can be
+  // configured before ConnectChannels() opens their sockets.
+  void CreateChannels() {
     net1_.reset(new SctpFakeNetworkInterface(rtc::Thread::Current()));
     net2_.reset(new SctpFakeNetworkInterface(rtc::Thread::Current()));
     recv1_.reset(new SctpFakeDataReceiver());
@@ -247,7 +268,9 @@ class SctpDataMediaChannelTest : public testing::Test,
     // Setup two connected channels ready to send and receive.
     net1_->SetDestination(chan2_.get());
     net2_->SetDestination(chan1_.get());
+  }
 
+  void ConnectChannels() {
     LOG(LS_VERBOSE) << "Channel setup ----------------------------- ";
     AddStream(1);
     AddStream(2);
@@ -329,6 +352,7 @@ class SctpDataMediaChannelTest : public testing::Test,
   cricket::SctpDataMediaChannel* channel2() { return chan2_.get(); }
   SctpFakeDataReceiver* receiver1() { return recv1_.get(); }
   SctpFakeDataReceiver* receiver2() { return recv2_.get(); }
+  SctpFakeNetworkInterface* network1() { return net1_.get(); }
 
  private:
   rtc::scoped_ptr<cricket::SctpDataEngine> engine_;
@@ -395,6 +419,63 @@ TEST_F(SctpDataMediaChannelTest, SendData) {
                   << ", recv1.last_data=" << receiver1()->last_data();
 }
 
+// A message larger than the MTU is split into packets that fit it.
+TEST_F(SctpDataMediaChannelTest, PacketsFitConfiguredMtu) {
+  const size_t kMtu = 600;
+  CreateChannels();
+  channel1()->set_mtu(kMtu);
+  channel2()->set_mtu(kMtu);
+  ConnectChannels();
+
+  const std::string message(4000, 'a');
+  cricket::SendDataResult result;
+  ASSERT_TRUE(SendData(channel1(), 1, message, &result));
+  EXPECT_EQ(cricket::SDR_SUCCESS, result);
+  EXPECT_TRUE_WAIT(ReceivedData(receiver2(), 1, message), 1000);
+  EXPECT_LE(network1()->max_packet_size(), kMtu);
+}
+
+// A new MTU doesn't change the packets of the open socket.
+TEST_F(SctpDataMediaChannelTest, OpenSocketKeepsItsMtu) {
+  const size_t kMtu = 600;
+  SetupConnectedChannels();
+  channel1()->set_mtu(kMtu);
+  channel2()->set_mtu(kMtu);
+
+  const std::string message(4000, 'a');
+  cricket::SendDataResult result;
+  ASSERT_TRUE(SendData(channel1(), 1, message, &result));
+  EXPECT_EQ(cricket::SDR_SUCCESS, result);
+  EXPECT_TRUE_WAIT(ReceivedData(receiver2(), 1, message), 1000);
+  EXPECT_GT(network1()->max_packet_size(), kMtu);
+  EXPECT_EQ(kMtu, channel1()->mtu());
+}
+
+TEST_F(SctpDataMediaChannelTest, SocketBufferSizesAreApplied) {
+  const int kSendBufferSize = 64 * 1024;
+  const int kRecvBufferSize = 96 * 1024;
+  CreateChannels();
+  int send_buffer_size = 0;
+  int recv_buffer_size = 0;
+  EXPECT_FALSE(channel1()->GetSocketBufferSizes(&send_buffer_size,
+                                                &recv_buffer_size));
+  channel1()->set_socket_buffer_sizes(kSendBufferSize, kRecvBufferSize);
+  ConnectChannels();
+
+  ASSERT_TRUE(channel1()->GetSocketBufferSizes(&send_buffer_size,
+                                               &recv_buffer_size));
+  EXPECT_EQ(kSendBufferSize, send_buffer_size);
+  EXPECT_EQ(kRecvBufferSize, recv_buffer_size);
+  // The other channel keeps the usrsctp defaults.
+  ASSERT_TRUE(channel2()->GetSocketBufferSizes(&send_buffer_size,
+                                               &recv_buffer_size));
+  EXPECT_NE(kSendBufferSize, send_buffer_size);
+
+  cricket::SendDataResult result;
+  ASSERT_TRUE(SendData(channel1(), 1, "hello?", &result));
+  EXPECT_TRUE_WAIT(ReceivedData(receiver2(), 1, "hello?"), 1000);
+}
+
 // Sends a lot of large messages at once and verifies SDR_BLOCK is returned.
 TEST_F(SctpDataMediaChannelTest, SendDataBlocked) {
   SetupConnectedChannels();
@@ -509,3 +590,106 @@ TEST_F(SctpDataMediaChannelTest, ReusesAStream) {
   channel1()->RemoveSendStream(1);
   EXPECT_TRUE_WAIT(chan_2_sig_receiver.StreamCloseCount(1) == 2, 1000);
 }
+
+// Dispatches the next message on |thread|, if there is one.
+static void DispatchNextMessage(rtc::Thread* thread) {
+  rtc::Message msg;
+  if (thread->Get(&msg, 0)) {
+    thread->Dispatch(&msg);
+  }
+}
+
+// The packets queued by the usrsctp callbacks are handed to the worker thread
+// in batches, and the drained buffers are reused for the next batch. This does
+// not need a connected socket, so it doesn't use the fixture above.
+TEST(SctpDataMediaChannelQueueTest, DrainsOutboundPacketsInBatches) {
+  rtc::Thread* thread = rtc::Thread::Current();
+  SctpFakeNetworkInterface net(thread);
+  cricket::SctpDataMediaChannel channel(thread);
+  channel.SetInterface(&net);
+
+  const int kNumPackets = 10;
+  const std::string packet(100, 'x');
+  for (int batch = 0; batch < 2; ++batch) {
+    for (int i = 0; i < kNumPackets; ++i) {
+      channel.QueueOutboundPacket(packet.data(), packet.size());
+    }
+    // The second batch takes all of its buffers from the pool.
+    EXPECT_EQ(0u, channel.num_free_outbound_packets());
+    // A single wakeup sends the whole batch.
+    EXPECT_EQ(1u, thread->size());
+    DispatchNextMessage(thread);
+    EXPECT_EQ((batch + 1) * kNumPackets, net.num_packets_sent());
+    EXPECT_EQ(static_cast<size_t>(kNumPackets),
+              channel.num_free_outbound_packets());
+    // Drop the packets posted to the network.
+    while (!thread->empty()) {
+      DispatchNextMessage(thread);
+    }
+  }
+}
+
+TEST(SctpDataMediaChannelQueueTest, DrainsInboundPacketsInBatches) {
+  rtc::Thread* thread = rtc::Thread::Current();
+  SctpFakeDataReceiver receiver;
+  cricket::SctpDataMediaChannel channel(thread);
+  channel.SignalDataReceived.connect(
+      &receiver, &SctpFakeDataReceiver::OnDataReceived);
+  channel.SetReceive(true);
+
+  const int kNumPackets = 10;
+  const std::string packet(100, 'x');
+  cricket::ReceiveDataParams params;
+  params.ssrc = 1;
+  params.type = cricket::DMT_TEXT;
+  for (int batch = 0; batch < 2; ++batch) {
+    for (int i = 0; i < kNumPackets; ++i) {
+      channel.QueueInboundPacket(packet.data(), packet.size(), params, 0);
+    }
+    EXPECT_EQ(0u, channel.num_free_inbound_packets());
+    EXPECT_EQ(1u, thread->size());
+    DispatchNextMessage(thread);
+    EXPECT_TRUE(thread->empty());
+    EXPECT_EQ((batch + 1) * kNumPackets * packet.size(),
+              receiver.bytes_received());
+    EXPECT_EQ(static_cast<size_t>(kNumPackets),
+              channel.num_free_inbound_packets());
+  }
+
+  // Buffers grown by a large message are not kept.
+  const std::string large_packet(64 * 1024, 'x');
+  channel.QueueInboundPacket(large_packet.data(), large_packet.size(), params,
+                             0);
+  DispatchNextMessage(thread);
+  EXPECT_EQ(static_cast<size_t>(kNumPackets - 1),
+            channel.num_free_inbound_packets());
+}
+
+// Measures the throughput of a data channel over the loopback network
+// interfaces, sending messages as fast as SCTP takes them.
+TEST_F(SctpDataMediaChannelTest, DISABLED_SendDataThroughputPerf) {
+  SetupConnectedChannels();
+
+  const size_t kMessageSize = 1024;
+  const size_t kNumMessages = 4096;
+  const std::string message(kMessageSize, 'x');
+  uint32 start = rtc::Time();
+  size_t num_sent = 0;
+  while (num_sent < kNumMessages) {
+    cricket::SendDataResult result;
+    if (SendData(channel1(), 1, message, &result)) {
+      ++num_sent;
+      continue;
+    }
+    ASSERT_EQ(cricket::SDR_BLOCK, result);
+    // Deliver the packets in flight, and the SACKs that free the window.
+    rtc::Thread::Current()->ProcessMessages(1);
+  }
+  EXPECT_TRUE_WAIT(
+      receiver2()->bytes_received() == kNumMessages * kMessageSize, 10000);
+  int32 elapsed_ms = std::max<int32>(rtc::TimeSince(start), 1);
+
+  LOG(LS_INFO) << "Sent " << kNumMessages << " messages of " << kMessageSize
+               << " bytes in " << elapsed_ms << " ms: "
+               << kNumMessages * kMessageSize * 8 / elapsed_ms << " kbps";
+}
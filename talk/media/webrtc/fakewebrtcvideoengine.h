@@ -819,6 +819,7 @@ class FakeWebRtcVideoEngine
   WEBRTC_STUB(WaitForFirstKeyFrame, (const int, const bool));
   WEBRTC_STUB(StartDebugRecording, (int, const char*));
   WEBRTC_STUB(StopDebugRecording, (int));
+  WEBRTC_STUB(WriteEncodePipelineTimings, (int, const char*));
   WEBRTC_VOID_FUNC(SuspendBelowMinBitrate, (int channel)) {
     WEBRTC_ASSERT_CHANNEL(channel);
     channels_[channel]->suspend_below_min_bitrate_ = true;
@@ -1058,13 +1058,16 @@ bool BaseChannel::UpdateLocalStreams_w(const std::vector<StreamParams>& streams,
     }
     return true;
   }
-  // Else streams are all the streams we want to send.
+  // Else streams are all the streams we want to send. Only the streams that
+  // differ from |local_streams_| are touched.
+  StreamSsrcIndex new_streams(streams);
+  StreamSsrcIndex old_streams(local_streams_);
 
   // Check for streams that have been removed.
   bool ret = true;
   for (StreamParamsVec::const_iterator it = local_streams_.begin();
        it != local_streams_.end(); ++it) {
-    if (!GetStreamBySsrc(streams, it->first_ssrc(), NULL)) {
+    if (!new_streams.Find(it->first_ssrc())) {
       if (!media_channel()->RemoveSendStream(it->first_ssrc())) {
         std::ostringstream desc;
         desc << "Failed to remove send stream with ssrc "
@@ -1077,7 +1080,7 @@ bool BaseChannel::UpdateLocalStreams_w(const std::vector<StreamParams>& streams,
   // Check for new streams.
   for (StreamParamsVec::const_iterator it = streams.begin();
        it != streams.end(); ++it) {
-    if (!GetStreamBySsrc(local_streams_, it->first_ssrc(), NULL)) {
+    if (!old_streams.Find(it->first_ssrc())) {
       if (media_channel()->AddSendStream(*it)) {
         LOG(LS_INFO) << "Add send ssrc: " << it->ssrcs[0];
       } else {
@@ -1135,13 +1138,16 @@ bool BaseChannel::UpdateRemoteStreams_w(
     }
     return true;
   }
-  // Else streams are all the streams we want to receive.
+  // Else streams are all the streams we want to receive. Only the streams
+  // that differ from |remote_streams_| are touched.
+  StreamSsrcIndex new_streams(streams);
+  StreamSsrcIndex old_streams(remote_streams_);
 
   // Check for streams that have been removed.
   bool ret = true;
   for (StreamParamsVec::const_iterator it = remote_streams_.begin();
        it != remote_streams_.end(); ++it) {
-    if (!GetStreamBySsrc(streams, it->first_ssrc(), NULL)) {
+    if (!new_streams.Find(it->first_ssrc())) {
       if (!RemoveRecvStream_w(it->first_ssrc())) {
         std::ostringstream desc;
         desc << "Failed to remove remote stream with ssrc "
@@ -1154,7 +1160,7 @@ bool BaseChannel::UpdateRemoteStreams_w(
   // Check for new streams.
   for (StreamParamsVec::const_iterator it = streams.begin();
       it != streams.end(); ++it) {
-    if (!GetStreamBySsrc(remote_streams_, it->first_ssrc(), NULL)) {
+    if (!old_streams.Find(it->first_ssrc())) {
       if (AddRecvStream_w(*it)) {
         LOG(LS_INFO) << "Add remote ssrc: " << it->ssrcs[0];
       } else {
@@ -2139,8 +2145,15 @@ bool DataChannel::Init() {
 bool DataChannel::SendData(const SendDataParams& params,
                            const rtc::Buffer& payload,
                            SendDataResult* result) {
-  return InvokeOnWorker(Bind(&DataMediaChannel::SendData,
-                             media_channel(), params, payload, result));
+  // The call is synchronous, so |payload| outlives it and need not be copied.
+  return InvokeOnWorker(Bind(&DataChannel::SendData_w,
+                             this, params, &payload, result));
+}
+
+bool DataChannel::SendData_w(const SendDataParams& params,
+                             const rtc::Buffer* payload,
+                             SendDataResult* result) {
+  return media_channel()->SendData(params, *payload, result);
 }
 
 const ContentInfo* DataChannel::GetFirstContent(
@@ -694,6 +694,12 @@ class DataChannel : public BaseChannel {
   virtual void ChangeState();
   virtual bool WantsPacket(bool rtcp, rtc::Buffer* packet);
 
+  // Takes |payload| by pointer so that binding it for the worker thread does
+  // not copy it.
+  bool SendData_w(const SendDataParams& params,
+                  const rtc::Buffer* payload,
+                  SendDataResult* result);
+
   virtual void OnMessage(rtc::Message* pmsg);
   virtual void GetSrtpCiphers(std::vector<std::string>* ciphers) const;
   virtual void OnConnectionMonitorUpdate(
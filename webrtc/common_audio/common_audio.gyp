@@ -117,7 +117,11 @@
           ],
         }],
         ['target_arch=="ia32" or target_arch=="x64"', {
-          'dependencies': ['common_audio_sse2',],
+          'dependencies': [
+            'common_audio_avx2',
+            'common_audio_sse2',
+            'common_audio_sse4_1',
+          ],
         }],
         ['target_arch=="arm" or target_arch=="armv7"', {
           'sources': [
@@ -180,12 +184,41 @@
           'sources': [
             'fir_filter_sse.cc',
             'resampler/sinc_resampler_sse.cc',
+            'signal_processing/cross_correlation_sse2.c',
+            'signal_processing/dot_product_with_scale_sse2.c',
+            'signal_processing/downsample_fast_sse2.c',
+            'signal_processing/min_max_operations_sse2.c',
+            'signal_processing/vector_scaling_operations_sse2.c',
           ],
           'cflags': ['-msse2',],
           'xcode_settings': {
             'OTHER_CFLAGS': ['-msse2',],
           },
         },
+        {
+          'target_name': 'common_audio_sse4_1',
+          'type': 'static_library',
+          'sources': [
+            'signal_processing/min_max_operations_sse4_1.c',
+          ],
+          'cflags': ['-msse4.1',],
+          'xcode_settings': {
+            'OTHER_CFLAGS': ['-msse4.1',],
+          },
+        },
+        {
+          'target_name': 'common_audio_avx2',
+          'type': 'static_library',
+          'sources': [
+            'signal_processing/cross_correlation_avx2.c',
+            'signal_processing/dot_product_with_scale_avx2.c',
+            'signal_processing/min_max_operations_avx2.c',
+          ],
+          'cflags': ['-mavx2',],
+          'xcode_settings': {
+            'OTHER_CFLAGS': ['-mavx2',],
+          },
+        },
       ],  # targets
     }],
     ['(target_arch=="arm" and arm_version==7) or target_arch=="armv7"', {
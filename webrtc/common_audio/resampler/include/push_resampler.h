@@ -12,6 +12,7 @@
 #define WEBRTC_COMMON_AUDIO_RESAMPLER_INCLUDE_PUSH_RESAMPLER_H_
 
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -23,28 +24,46 @@ class PushSincResampler;
 template <typename T>
 class PushResampler {
  public:
+  // The number of parameter sets whose resamplers are kept around.
+  static const size_t kMaxCachedConfigs = 4;
+
   PushResampler();
   virtual ~PushResampler();
 
   // Must be called whenever the parameters change. Free to be called at any
   // time as it is a no-op if parameters have not changed since the last call.
+  // The resamplers of the last |kMaxCachedConfigs| parameter sets are kept,
+  // so that going back to earlier parameters doesn't reallocate them or
+  // recompute their filter kernels. A reused resampler is flushed, and gives
+  // the same output as a new one.
   int InitializeIfNeeded(int src_sample_rate_hz, int dst_sample_rate_hz,
                          int num_channels);
 
   // Returns the total number of samples provided in destination (e.g. 32 kHz,
-  // 2 channel audio gives 640 samples).
+  // 2 channel audio gives 640 samples). With T = int16_t, |src| and |dst| may
+  // be the same buffer, which then must have room for the output.
   int Resample(const T* src, int src_length, T* dst, int dst_capacity);
 
  private:
-  scoped_ptr<PushSincResampler> sinc_resampler_;
-  scoped_ptr<PushSincResampler> sinc_resampler_right_;
-  int src_sample_rate_hz_;
-  int dst_sample_rate_hz_;
-  int num_channels_;
-  scoped_ptr<T[]> src_left_;
-  scoped_ptr<T[]> src_right_;
-  scoped_ptr<T[]> dst_left_;
-  scoped_ptr<T[]> dst_right_;
+  // The resamplers and buffers for one set of parameters.
+  struct Config {
+    Config(int src_sample_rate_hz, int dst_sample_rate_hz, int num_channels);
+    ~Config();
+
+    const int src_sample_rate_hz;
+    const int dst_sample_rate_hz;
+    const int num_channels;
+    // Not used when the rates are equal.
+    scoped_ptr<PushSincResampler> sinc_resampler;
+    scoped_ptr<PushSincResampler> sinc_resampler_right;
+    scoped_ptr<T[]> src_left;
+    scoped_ptr<T[]> src_right;
+    scoped_ptr<T[]> dst_left;
+    scoped_ptr<T[]> dst_right;
+  };
+
+  // Most recently used first. The first one is the current configuration.
+  ScopedVector<Config> configs_;
 };
 
 }  // namespace webrtc
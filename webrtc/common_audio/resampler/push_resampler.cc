@@ -19,10 +19,38 @@
 namespace webrtc {
 
 template <typename T>
-PushResampler<T>::PushResampler()
-    : src_sample_rate_hz_(0),
-      dst_sample_rate_hz_(0),
-      num_channels_(0) {
+const size_t PushResampler<T>::kMaxCachedConfigs;
+
+template <typename T>
+PushResampler<T>::Config::Config(int src_sample_rate_hz,
+                                 int dst_sample_rate_hz,
+                                 int num_channels)
+    : src_sample_rate_hz(src_sample_rate_hz),
+      dst_sample_rate_hz(dst_sample_rate_hz),
+      num_channels(num_channels) {
+  if (src_sample_rate_hz == dst_sample_rate_hz)
+    return;
+
+  const int src_size_10ms_mono = src_sample_rate_hz / 100;
+  const int dst_size_10ms_mono = dst_sample_rate_hz / 100;
+  sinc_resampler.reset(new PushSincResampler(src_size_10ms_mono,
+                                             dst_size_10ms_mono));
+  if (num_channels == 2) {
+    src_left.reset(new T[src_size_10ms_mono]);
+    src_right.reset(new T[src_size_10ms_mono]);
+    dst_left.reset(new T[dst_size_10ms_mono]);
+    dst_right.reset(new T[dst_size_10ms_mono]);
+    sinc_resampler_right.reset(new PushSincResampler(src_size_10ms_mono,
+                                                     dst_size_10ms_mono));
+  }
+}
+
+template <typename T>
+PushResampler<T>::Config::~Config() {
+}
+
+template <typename T>
+PushResampler<T>::PushResampler() {
 }
 
 template <typename T>
@@ -33,68 +61,84 @@ template <typename T>
 int PushResampler<T>::InitializeIfNeeded(int src_sample_rate_hz,
                                          int dst_sample_rate_hz,
                                          int num_channels) {
-  if (src_sample_rate_hz == src_sample_rate_hz_ &&
-      dst_sample_rate_hz == dst_sample_rate_hz_ &&
-      num_channels == num_channels_)
+  for (size_t i = 0; i < configs_.size(); ++i) {
+    Config* config = configs_[i];
+    if (src_sample_rate_hz != config->src_sample_rate_hz ||
+        dst_sample_rate_hz != config->dst_sample_rate_hz ||
+        num_channels != config->num_channels)
+      continue;
     // No-op if settings haven't changed.
+    if (i == 0)
+      return 0;
+
+    // Move the resamplers of the earlier settings to the front, with the
+    // state they would have if they were new.
+    configs_.weak_erase(configs_.begin() + i);
+    configs_.insert(configs_.begin(), config);
+    if (config->sinc_resampler.get())
+      config->sinc_resampler->Flush();
+    if (config->sinc_resampler_right.get())
+      config->sinc_resampler_right->Flush();
     return 0;
+  }
 
   if (src_sample_rate_hz <= 0 || dst_sample_rate_hz <= 0 ||
       num_channels <= 0 || num_channels > 2)
     return -1;
 
-  src_sample_rate_hz_ = src_sample_rate_hz;
-  dst_sample_rate_hz_ = dst_sample_rate_hz;
-  num_channels_ = num_channels;
-
-  const int src_size_10ms_mono = src_sample_rate_hz / 100;
-  const int dst_size_10ms_mono = dst_sample_rate_hz / 100;
-  sinc_resampler_.reset(new PushSincResampler(src_size_10ms_mono,
-                                              dst_size_10ms_mono));
-  if (num_channels_ == 2) {
-    src_left_.reset(new T[src_size_10ms_mono]);
-    src_right_.reset(new T[src_size_10ms_mono]);
-    dst_left_.reset(new T[dst_size_10ms_mono]);
-    dst_right_.reset(new T[dst_size_10ms_mono]);
-    sinc_resampler_right_.reset(new PushSincResampler(src_size_10ms_mono,
-                                                      dst_size_10ms_mono));
-  }
-
+  if (configs_.size() == kMaxCachedConfigs)
+    configs_.pop_back();
+  configs_.insert(configs_.begin(), new Config(src_sample_rate_hz,
+                                               dst_sample_rate_hz,
+                                               num_channels));
   return 0;
 }
 
 template <typename T>
 int PushResampler<T>::Resample(const T* src, int src_length, T* dst,
                                int dst_capacity) {
-  const int src_size_10ms = src_sample_rate_hz_ * num_channels_ / 100;
-  const int dst_size_10ms = dst_sample_rate_hz_ * num_channels_ / 100;
+  if (configs_.empty())
+    return -1;
+  Config* config = configs_[0];
+  const int num_channels = config->num_channels;
+  const int src_size_10ms = config->src_sample_rate_hz * num_channels / 100;
+  const int dst_size_10ms = config->dst_sample_rate_hz * num_channels / 100;
   if (src_length != src_size_10ms || dst_capacity < dst_size_10ms)
     return -1;
 
-  if (src_sample_rate_hz_ == dst_sample_rate_hz_) {
+  if (config->src_sample_rate_hz == config->dst_sample_rate_hz) {
     // The old resampler provides this memcpy facility in the case of matching
     // sample rates, so reproduce it here for the sinc resampler.
-    memcpy(dst, src, src_length * sizeof(T));
+    if (dst != src)
+      memcpy(dst, src, src_length * sizeof(T));
     return src_length;
   }
-  if (num_channels_ == 2) {
-    const int src_length_mono = src_length / num_channels_;
-    const int dst_capacity_mono = dst_capacity / num_channels_;
-    T* deinterleaved[] = {src_left_.get(), src_right_.get()};
-    Deinterleave(src, src_length_mono, num_channels_, deinterleaved);
+  // The deinterleaving below and the int16_t version of
+  // PushSincResampler::Resample() read all of the source before writing to the
+  // destination, so |src| may equal |dst| for int16_t.
+  if (num_channels == 2) {
+    const int src_length_mono = src_length / num_channels;
+    const int dst_capacity_mono = dst_capacity / num_channels;
+    T* deinterleaved[] = {config->src_left.get(), config->src_right.get()};
+    Deinterleave(src, src_length_mono, num_channels, deinterleaved);
 
     int dst_length_mono =
-        sinc_resampler_->Resample(src_left_.get(), src_length_mono,
-                                  dst_left_.get(), dst_capacity_mono);
-    sinc_resampler_right_->Resample(src_right_.get(), src_length_mono,
-                                    dst_right_.get(), dst_capacity_mono);
-
-    deinterleaved[0] = dst_left_.get();
-    deinterleaved[1] = dst_right_.get();
-    Interleave(deinterleaved, dst_length_mono, num_channels_, dst);
-    return dst_length_mono * num_channels_;
+        config->sinc_resampler->Resample(config->src_left.get(),
+                                         src_length_mono,
+                                         config->dst_left.get(),
+                                         dst_capacity_mono);
+    config->sinc_resampler_right->Resample(config->src_right.get(),
+                                           src_length_mono,
+                                           config->dst_right.get(),
+                                           dst_capacity_mono);
+
+    deinterleaved[0] = config->dst_left.get();
+    deinterleaved[1] = config->dst_right.get();
+    Interleave(deinterleaved, dst_length_mono, num_channels, dst);
+    return dst_length_mono * num_channels;
   } else {
-    return sinc_resampler_->Resample(src, src_length, dst, dst_capacity);
+    return config->sinc_resampler->Resample(src, src_length, dst,
+                                            dst_capacity);
   }
 }
 
@@ -8,9 +8,17 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
 
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
 // Quality testing of PushResampler is handled through output_mixer_unittest.cc.
 
 namespace webrtc {
@@ -25,4 +33,142 @@ TEST(PushResamplerTest, VerifiesInputParameters) {
   EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 2));
 }
 
+namespace {
+
+const int kMaxFrameSamples = 2 * 480;
+
+// Fills 10 ms of a 440 Hz tone, starting at frame |frame_index|.
+void FillTone(int sample_rate_hz, int num_channels, int frame_index,
+              int16_t* audio) {
+  const int samples_per_channel = sample_rate_hz / 100;
+  for (int i = 0; i < samples_per_channel; ++i) {
+    const double t = static_cast<double>(
+        frame_index * samples_per_channel + i) / sample_rate_hz;
+    const int16_t value = static_cast<int16_t>(
+        10000 * sin(2 * 3.14159265358979 * 440 * t));
+    for (int j = 0; j < num_channels; ++j)
+      audio[i * num_channels + j] = value;
+  }
+}
+
+}  // namespace
+
+TEST(PushResamplerTest, ReusedResamplersGiveSameOutputAsNewOnes) {
+  // Alternates between two output rates, as the receive side does when the
+  // mixing frequency changes, and comes back to the first input rate after
+  // the cache has been filled.
+  const int kSettings[][3] = {
+    {16000, 32000, 1}, {16000, 48000, 1}, {16000, 32000, 1},
+    {16000, 48000, 2}, {16000, 48000, 1}, {8000, 32000, 1},
+    {32000, 16000, 2}, {44100, 16000, 1}, {16000, 32000, 1},
+  };
+  const int kFramesPerSetting = 5;
+  PushResampler<int16_t> cached;
+  int16_t src[kMaxFrameSamples];
+  int16_t expected[kMaxFrameSamples];
+  int16_t actual[kMaxFrameSamples];
+  int frame_index = 0;
+  for (size_t n = 0; n < sizeof(kSettings) / sizeof(kSettings[0]); ++n) {
+    const int src_rate = kSettings[n][0];
+    const int dst_rate = kSettings[n][1];
+    const int num_channels = kSettings[n][2];
+    PushResampler<int16_t> fresh;
+    ASSERT_EQ(0, fresh.InitializeIfNeeded(src_rate, dst_rate, num_channels));
+    ASSERT_EQ(0, cached.InitializeIfNeeded(src_rate, dst_rate, num_channels));
+    const int src_length = src_rate / 100 * num_channels;
+    const int dst_length = dst_rate / 100 * num_channels;
+    for (int i = 0; i < kFramesPerSetting; ++i, ++frame_index) {
+      FillTone(src_rate, num_channels, frame_index, src);
+      EXPECT_EQ(dst_length, fresh.Resample(src, src_length, expected,
+                                           kMaxFrameSamples));
+      EXPECT_EQ(dst_length, cached.Resample(src, src_length, actual,
+                                            kMaxFrameSamples));
+      EXPECT_EQ(0, memcmp(expected, actual, dst_length * sizeof(int16_t)));
+    }
+  }
+}
+
+TEST(PushResamplerTest, ResamplesInPlace) {
+  const int kRates[] = {8000, 16000, 32000, 44100, 48000};
+  const int kNumRates = sizeof(kRates) / sizeof(*kRates);
+  int16_t src[kMaxFrameSamples];
+  int16_t expected[kMaxFrameSamples];
+  int16_t in_place[kMaxFrameSamples];
+  for (int num_channels = 1; num_channels <= 2; ++num_channels) {
+    for (int i = 0; i < kNumRates; ++i) {
+      for (int j = 0; j < kNumRates; ++j) {
+        PushResampler<int16_t> resampler;
+        PushResampler<int16_t> in_place_resampler;
+        ASSERT_EQ(0, resampler.InitializeIfNeeded(kRates[i], kRates[j],
+                                                  num_channels));
+        ASSERT_EQ(0, in_place_resampler.InitializeIfNeeded(
+            kRates[i], kRates[j], num_channels));
+        const int src_length = kRates[i] / 100 * num_channels;
+        const int dst_length = kRates[j] / 100 * num_channels;
+        for (int frame = 0; frame < 3; ++frame) {
+          FillTone(kRates[i], num_channels, frame, src);
+          memcpy(in_place, src, src_length * sizeof(int16_t));
+          EXPECT_EQ(dst_length, resampler.Resample(src, src_length, expected,
+                                                   kMaxFrameSamples));
+          EXPECT_EQ(dst_length, in_place_resampler.Resample(
+              in_place, src_length, in_place, kMaxFrameSamples));
+          EXPECT_EQ(0, memcmp(expected, in_place,
+                              dst_length * sizeof(int16_t)));
+        }
+      }
+    }
+  }
+}
+
+// Prints the number of 10 ms conversions per second for the common rate
+// pairs, and for a resampler that switches between two output rates on every
+// call, with and without reusing the resamplers of earlier settings.
+TEST(PushResamplerTest, DISABLED_Benchmark) {
+  const int kRates[] = {8000, 16000, 32000, 44100, 48000};
+  const int kNumRates = sizeof(kRates) / sizeof(*kRates);
+  const int kIterations = 500;
+  int16_t src[kMaxFrameSamples];
+  int16_t dst[kMaxFrameSamples];
+
+  printf("10 ms conversions per second:\n");
+  for (int num_channels = 1; num_channels <= 2; ++num_channels) {
+    for (int i = 0; i < kNumRates; ++i) {
+      for (int j = 0; j < kNumRates; ++j) {
+        PushResampler<int16_t> resampler;
+        ASSERT_EQ(0, resampler.InitializeIfNeeded(kRates[i], kRates[j],
+                                                  num_channels));
+        const int src_length = kRates[i] / 100 * num_channels;
+        FillTone(kRates[i], num_channels, 0, src);
+        TickTime start = TickTime::Now();
+        for (int n = 0; n < kIterations; ++n)
+          resampler.Resample(src, src_length, dst, kMaxFrameSamples);
+        const int64_t elapsed_us = std::max<int64_t>(
+            (TickTime::Now() - start).Microseconds(), 1);
+        printf("%5d -> %5d Hz, %d channel(s): %8.0f\n", kRates[i], kRates[j],
+               num_channels, kIterations * 1e6 / elapsed_us);
+      }
+    }
+  }
+
+  FillTone(16000, 1, 0, src);
+  PushResampler<int16_t> cached;
+  TickTime start = TickTime::Now();
+  for (int n = 0; n < kIterations; ++n) {
+    cached.InitializeIfNeeded(16000, n % 2 ? 32000 : 48000, 1);
+    cached.Resample(src, 160, dst, kMaxFrameSamples);
+  }
+  const int64_t cached_us = (TickTime::Now() - start).Microseconds();
+  start = TickTime::Now();
+  for (int n = 0; n < kIterations; ++n) {
+    PushResampler<int16_t> fresh;
+    fresh.InitializeIfNeeded(16000, n % 2 ? 32000 : 48000, 1);
+    fresh.Resample(src, 160, dst, kMaxFrameSamples);
+  }
+  const int64_t fresh_us = (TickTime::Now() - start).Microseconds();
+  printf("16000 -> 32000/48000 Hz, switching every call: %8.0f reused, "
+         "%8.0f reinitialized\n",
+         kIterations * 1e6 / std::max<int64_t>(cached_us, 1),
+         kIterations * 1e6 / std::max<int64_t>(fresh_us, 1));
+}
+
 }  // namespace webrtc
@@ -40,6 +40,10 @@ class PushSincResampler : public SincResamplerCallback {
                float* destination,
                int destination_capacity);
 
+  // Discards the buffered audio, so that the next Resample() call starts the
+  // same way as on a new instance.
+  void Flush();
+
   // Implements SincResamplerCallback.
   virtual void Run(int frames, float* destination) OVERRIDE;
 
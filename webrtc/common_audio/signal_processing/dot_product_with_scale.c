@@ -10,10 +10,10 @@
 
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 
-int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
-                                      const int16_t* vector2,
-                                      int length,
-                                      int scaling) {
+int32_t WebRtcSpl_DotProductWithScaleC(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       int length,
+                                       int scaling) {
   int32_t sum = 0;
   int i = 0;
 
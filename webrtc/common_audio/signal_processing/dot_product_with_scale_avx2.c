@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <immintrin.h>
+
+// AVX2 version of WebRtcSpl_DotProductWithScale() for x86 platforms. Same as
+// the SSE2 version, on 16 samples at a time. The unpacks work within each
+// 128-bit lane, which doesn't matter since all products are summed.
+int32_t WebRtcSpl_DotProductWithScaleAVX2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          int length,
+                                          int scaling) {
+  int i = 0;
+  int32_t sum = 0;
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m256i sum_32x8 = _mm256_setzero_si256();
+  __m128i sum_32x4;
+
+  for (i = 0; i + 16 <= length; i += 16) {
+    __m256i seq1_16x16 = _mm256_loadu_si256((const __m256i*)&vector1[i]);
+    __m256i seq2_16x16 = _mm256_loadu_si256((const __m256i*)&vector2[i]);
+    __m256i low = _mm256_mullo_epi16(seq1_16x16, seq2_16x16);
+    __m256i high = _mm256_mulhi_epi16(seq1_16x16, seq2_16x16);
+    __m256i prod0 = _mm256_sra_epi32(_mm256_unpacklo_epi16(low, high), shift);
+    __m256i prod1 = _mm256_sra_epi32(_mm256_unpackhi_epi16(low, high), shift);
+    sum_32x8 = _mm256_add_epi32(sum_32x8, _mm256_add_epi32(prod0, prod1));
+  }
+  sum_32x4 = _mm_add_epi32(_mm256_castsi256_si128(sum_32x8),
+                           _mm256_extracti128_si256(sum_32x8, 1));
+  sum_32x4 = _mm_add_epi32(
+      sum_32x4, _mm_shuffle_epi32(sum_32x4, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum_32x4 = _mm_add_epi32(
+      sum_32x4, _mm_shuffle_epi32(sum_32x4, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(sum_32x4);
+
+  for (; i < length; i++) {
+    sum += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return sum;
+}
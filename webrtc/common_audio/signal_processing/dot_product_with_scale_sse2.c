@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+// SSE2 version of WebRtcSpl_DotProductWithScale() for x86 platforms. Each
+// product is shifted before it is accumulated, as in the C version, so the
+// full 32-bit products are formed from their low and high halves instead of
+// using _mm_madd_epi16().
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          int length,
+                                          int scaling) {
+  int i = 0;
+  int32_t sum = 0;
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m128i sum_32x4 = _mm_setzero_si128();
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    __m128i seq1_16x8 = _mm_loadu_si128((const __m128i*)&vector1[i]);
+    __m128i seq2_16x8 = _mm_loadu_si128((const __m128i*)&vector2[i]);
+    __m128i low = _mm_mullo_epi16(seq1_16x8, seq2_16x8);
+    __m128i high = _mm_mulhi_epi16(seq1_16x8, seq2_16x8);
+    __m128i prod0 = _mm_sra_epi32(_mm_unpacklo_epi16(low, high), shift);
+    __m128i prod1 = _mm_sra_epi32(_mm_unpackhi_epi16(low, high), shift);
+    sum_32x4 = _mm_add_epi32(sum_32x4, _mm_add_epi32(prod0, prod1));
+  }
+  sum_32x4 = _mm_add_epi32(
+      sum_32x4, _mm_shuffle_epi32(sum_32x4, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum_32x4 = _mm_add_epi32(
+      sum_32x4, _mm_shuffle_epi32(sum_32x4, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(sum_32x4);
+
+  for (; i < length; i++) {
+    sum += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return sum;
+}
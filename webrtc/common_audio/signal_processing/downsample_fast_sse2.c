@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+// Longer filters are run by the scalar loop only.
+#define MAX_COEFFICIENTS 64
+
+// SSE2 version of WebRtcSpl_DownsampleFast() for x86 platforms.
+// The filters in use are short (3 to 7 taps in NetEq and iLBC), so instead of
+// vectorizing over the taps, four output samples are computed at a time. The
+// coefficients are reversed and zero padded to a multiple of eight, so each
+// output sample is one _mm_madd_epi16() per eight taps on a contiguous window
+// of |data_in|.
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 int data_in_length,
+                                 int16_t* data_out,
+                                 int data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 int coefficients_length,
+                                 int factor,
+                                 int delay) {
+  int i = 0;
+  int j = 0;
+  int k = 0;
+  int32_t out_s32 = 0;
+  int endpos = delay + factor * (data_out_length - 1) + 1;
+  int padded_length = (coefficients_length + 7) & ~7;
+  // The padded window of an output sample must not read past |data_in|.
+  int vector_endpos = data_in_length - padded_length + coefficients_length;
+  int16_t reversed[MAX_COEFFICIENTS];
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length <= 0 || coefficients_length <= 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+
+  if (coefficients_length > MAX_COEFFICIENTS) {
+    vector_endpos = 0;
+  } else {
+    for (j = 0; j < padded_length; j++) {
+      reversed[j] = j < coefficients_length ?
+          coefficients[coefficients_length - 1 - j] : 0;
+    }
+  }
+  if (vector_endpos > endpos) {
+    vector_endpos = endpos;
+  }
+
+  for (i = delay; i + 3 * factor < vector_endpos; i += 4 * factor) {
+    const int16_t* window = &data_in[i - coefficients_length + 1];
+    __m128i sum0 = _mm_setzero_si128();
+    __m128i sum1 = _mm_setzero_si128();
+    __m128i sum2 = _mm_setzero_si128();
+    __m128i sum3 = _mm_setzero_si128();
+    __m128i out_32x4;
+
+    for (k = 0; k < padded_length; k += 8) {
+      __m128i coef_16x8 = _mm_loadu_si128((const __m128i*)&reversed[k]);
+      sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(coef_16x8,
+          _mm_loadu_si128((const __m128i*)&window[k])));
+      sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(coef_16x8,
+          _mm_loadu_si128((const __m128i*)&window[k + factor])));
+      sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(coef_16x8,
+          _mm_loadu_si128((const __m128i*)&window[k + 2 * factor])));
+      sum3 = _mm_add_epi32(sum3, _mm_madd_epi16(coef_16x8,
+          _mm_loadu_si128((const __m128i*)&window[k + 3 * factor])));
+    }
+
+    // Transpose and add, to get the four sums in one vector.
+    sum0 = _mm_add_epi32(_mm_unpacklo_epi32(sum0, sum1),
+                         _mm_unpackhi_epi32(sum0, sum1));
+    sum2 = _mm_add_epi32(_mm_unpacklo_epi32(sum2, sum3),
+                         _mm_unpackhi_epi32(sum2, sum3));
+    out_32x4 = _mm_add_epi32(_mm_unpacklo_epi64(sum0, sum2),
+                             _mm_unpackhi_epi64(sum0, sum2));
+
+    out_32x4 = _mm_add_epi32(out_32x4, _mm_set1_epi32(2048));  // Q12.
+    out_32x4 = _mm_srai_epi32(out_32x4, 12);  // Q0.
+
+    // Saturate and store the output.
+    _mm_storel_epi64((__m128i*)data_out, _mm_packs_epi32(out_32x4, out_32x4));
+    data_out += 4;
+  }
+
+  for (; i < endpos; i += factor) {
+    out_s32 = 2048;  // Round value, 0.5 in Q12.
+
+    for (j = 0; j < coefficients_length; j++) {
+      out_s32 += coefficients[j] * data_in[i - j];  // Q12.
+    }
+
+    out_s32 >>= 12;  // Q0.
+
+    // Saturate and store the output.
+    *data_out++ = WebRtcSpl_SatW32ToW16(out_s32);
+  }
+
+  return 0;
+}
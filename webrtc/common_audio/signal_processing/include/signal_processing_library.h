@@ -108,8 +108,9 @@ extern "C" {
 // If the underlying platform is known to be ARM-Neon (WEBRTC_ARCH_ARM_NEON
 // defined), the pointers will be assigned to code optimized for Neon; otherwise
 // if run-time Neon detection (WEBRTC_DETECT_ARM_NEON) is enabled, the pointers
-// will be assigned to either Neon code or generic C code; otherwise, generic C
-// code will be assigned.
+// will be assigned to either Neon code or generic C code; on x86 the pointers
+// will be assigned to the SSE2, SSE4.1 or AVX2 code supported by the CPU;
+// otherwise, generic C code will be assigned.
 // Note that this function MUST be called in any application that uses SPL
 // functions.
 void WebRtcSpl_Init();
@@ -160,6 +161,10 @@ int16_t WebRtcSpl_MaxAbsValueW16Neon(const int16_t* vector, int length);
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxAbsValueW16_mips(const int16_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, int length);
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t* vector, int length);
+#endif
 
 // Returns the largest absolute value in a signed 32-bit vector.
 //
@@ -178,6 +183,9 @@ int32_t WebRtcSpl_MaxAbsValueW32Neon(const int32_t* vector, int length);
 #if defined(MIPS_DSP_R1_LE)
 int32_t WebRtcSpl_MaxAbsValueW32_mips(const int32_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MaxAbsValueW32SSE4_1(const int32_t* vector, int length);
+#endif
 
 // Returns the maximum value of a 16-bit vector.
 //
@@ -198,6 +206,9 @@ int16_t WebRtcSpl_MaxValueW16Neon(const int16_t* vector, int length);
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxValueW16_mips(const int16_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, int length);
+#endif
 
 // Returns the maximum value of a 32-bit vector.
 //
@@ -218,6 +229,9 @@ int32_t WebRtcSpl_MaxValueW32Neon(const int32_t* vector, int length);
 #if defined(MIPS32_LE)
 int32_t WebRtcSpl_MaxValueW32_mips(const int32_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MaxValueW32SSE4_1(const int32_t* vector, int length);
+#endif
 
 // Returns the minimum value of a 16-bit vector.
 //
@@ -238,6 +252,9 @@ int16_t WebRtcSpl_MinValueW16Neon(const int16_t* vector, int length);
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MinValueW16_mips(const int16_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, int length);
+#endif
 
 // Returns the minimum value of a 32-bit vector.
 //
@@ -258,6 +275,9 @@ int32_t WebRtcSpl_MinValueW32Neon(const int32_t* vector, int length);
 #if defined(MIPS32_LE)
 int32_t WebRtcSpl_MinValueW32_mips(const int32_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MinValueW32SSE4_1(const int32_t* vector, int length);
+#endif
 
 // Returns the vector index to the largest absolute value of a 16-bit vector.
 //
@@ -401,6 +421,15 @@ int WebRtcSpl_ScaleAndAddVectorsWithRound_mips(const int16_t* in_vector1,
                                                int16_t* out_vector,
                                                int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(const int16_t* in_vector1,
+                                              int16_t in_vector1_scale,
+                                              const int16_t* in_vector2,
+                                              int16_t in_vector2_scale,
+                                              int right_shifts,
+                                              int16_t* out_vector,
+                                              int length);
+#endif
 // End: Vector scaling operations.
 
 // iLBC specific functions. Implementations in ilbc_specific_functions.c.
@@ -581,6 +610,22 @@ void WebRtcSpl_CrossCorrelation_mips(int32_t* cross_correlation,
                                      int16_t right_shifts,
                                      int16_t step_seq2);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    int16_t dim_seq,
+                                    int16_t dim_cross_correlation,
+                                    int16_t right_shifts,
+                                    int16_t step_seq2);
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    int16_t dim_seq,
+                                    int16_t dim_cross_correlation,
+                                    int16_t right_shifts,
+                                    int16_t step_seq2);
+#endif
 
 // Creates (the first half of) a Hanning window. Size must be at least 1 and
 // at most 512.
@@ -641,10 +686,28 @@ int32_t WebRtcSpl_Energy(int16_t* vector, int vector_length, int* scale_factor);
 //                        output will be in Q(-|scaling|)
 //
 // Return value         : The dot product in Q(-scaling)
-int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
-                                      const int16_t* vector2,
-                                      int length,
-                                      int scaling);
+//
+// Points to the C version until WebRtcSpl_Init() is called, so it is safe to
+// use without WebRtcSpl_Init().
+typedef int32_t (*DotProductWithScale)(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       int length,
+                                       int scaling);
+extern DotProductWithScale WebRtcSpl_DotProductWithScale;
+int32_t WebRtcSpl_DotProductWithScaleC(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       int length,
+                                       int scaling);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          int length,
+                                          int scaling);
+int32_t WebRtcSpl_DotProductWithScaleAVX2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          int length,
+                                          int scaling);
+#endif
 
 // Filter operations.
 int WebRtcSpl_FilterAR(const int16_t* ar_coef,
@@ -734,6 +797,16 @@ int WebRtcSpl_DownsampleFast_mips(const int16_t* data_in,
                                   int factor,
                                   int delay);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 int data_in_length,
+                                 int16_t* data_out,
+                                 int data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 int coefficients_length,
+                                 int factor,
+                                 int delay);
+#endif
 
 // End: Filter operations.
 
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <immintrin.h>
+#include <stdlib.h>
+
+// AVX2 version of WebRtcSpl_MaxAbsValueW16() for x86 platforms. The absolute
+// values are compared as unsigned, so that abs(-32768) wraps to 0x8000 and is
+// still the largest one.
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t* vector, int length) {
+  int i = 0, absolute = 0, maximum = 0;
+  __m256i max_16x16 = _mm256_setzero_si256();
+  __m128i max_16x8;
+
+  if (vector == NULL || length <= 0) {
+    return -1;
+  }
+
+  for (i = 0; i + 16 <= length; i += 16) {
+    __m256i in_16x16 = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    max_16x16 = _mm256_max_epu16(max_16x16, _mm256_abs_epi16(in_16x16));
+  }
+  max_16x8 = _mm_max_epu16(_mm256_castsi256_si128(max_16x16),
+                           _mm256_extracti128_si256(max_16x16, 1));
+  max_16x8 = _mm_max_epu16(
+      max_16x8, _mm_shuffle_epi32(max_16x8, _MM_SHUFFLE(1, 0, 3, 2)));
+  max_16x8 = _mm_max_epu16(
+      max_16x8, _mm_shuffle_epi32(max_16x8, _MM_SHUFFLE(2, 3, 0, 1)));
+  max_16x8 = _mm_max_epu16(
+      max_16x8, _mm_shufflelo_epi16(max_16x8, _MM_SHUFFLE(2, 3, 0, 1)));
+  maximum = (uint16_t)_mm_extract_epi16(max_16x8, 0);
+
+  for (; i < length; i++) {
+    absolute = abs((int)vector[i]);
+
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+// Maximum and minimum of the lanes of a vector of eight 16-bit values.
+static inline int16_t HorizontalMaxW16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_max_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_extract_epi16(v, 0);
+}
+
+static inline int16_t HorizontalMinW16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_min_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_extract_epi16(v, 0);
+}
+
+// SSE2 version of WebRtcSpl_MaxAbsValueW16() for x86 platforms. SSE2 has no
+// 16-bit absolute value, so the maximum and minimum are tracked separately.
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, int length) {
+  int i = 0;
+  int maximum = 0;
+  int minimum = 0;
+  __m128i max_16x8 = _mm_setzero_si128();
+  __m128i min_16x8 = _mm_setzero_si128();
+
+  if (vector == NULL || length <= 0) {
+    return -1;
+  }
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    __m128i in_16x8 = _mm_loadu_si128((const __m128i*)&vector[i]);
+    max_16x8 = _mm_max_epi16(max_16x8, in_16x8);
+    min_16x8 = _mm_min_epi16(min_16x8, in_16x8);
+  }
+  maximum = HorizontalMaxW16(max_16x8);
+  minimum = HorizontalMinW16(min_16x8);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+
+  if (-minimum > maximum) {
+    maximum = -minimum;
+  }
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
+
+// SSE2 version of WebRtcSpl_MaxValueW16() for x86 platforms.
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, int length) {
+  int16_t maximum = WEBRTC_SPL_WORD16_MIN;
+  int i = 0;
+  __m128i max_16x8 = _mm_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+
+  if (vector == NULL || length <= 0) {
+    return maximum;
+  }
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    max_16x8 = _mm_max_epi16(max_16x8,
+                             _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = HorizontalMaxW16(max_16x8);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// SSE2 version of WebRtcSpl_MinValueW16() for x86 platforms.
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, int length) {
+  int16_t minimum = WEBRTC_SPL_WORD16_MAX;
+  int i = 0;
+  __m128i min_16x8 = _mm_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+
+  if (vector == NULL || length <= 0) {
+    return minimum;
+  }
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    min_16x8 = _mm_min_epi16(min_16x8,
+                             _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = HorizontalMinW16(min_16x8);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
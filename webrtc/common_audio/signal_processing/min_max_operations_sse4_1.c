@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <smmintrin.h>
+#include <stdlib.h>
+
+// Reduces the four 32-bit lanes of |v| with |op|.
+#define HORIZONTAL_REDUCE_W32(op, v)                                  \
+  (v = op(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2))),          \
+   v = op(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1))),          \
+   _mm_cvtsi128_si32(v))
+
+// SSE4.1 version of WebRtcSpl_MaxAbsValueW32() for x86 platforms.
+int32_t WebRtcSpl_MaxAbsValueW32SSE4_1(const int32_t* vector, int length) {
+  // The absolute values are compared as unsigned, to accommodate the value
+  // of abs(0x80000000), which is 0x80000000.
+  uint32_t absolute = 0, maximum = 0;
+  int i = 0;
+  __m128i max_32x4 = _mm_setzero_si128();
+
+  if (vector == NULL || length <= 0) {
+    return -1;
+  }
+
+  for (i = 0; i + 4 <= length; i += 4) {
+    __m128i in_32x4 = _mm_loadu_si128((const __m128i*)&vector[i]);
+    max_32x4 = _mm_max_epu32(max_32x4, _mm_abs_epi32(in_32x4));
+  }
+  maximum = (uint32_t)HORIZONTAL_REDUCE_W32(_mm_max_epu32, max_32x4);
+
+  for (; i < length; i++) {
+    absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  maximum = WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD32_MAX);
+
+  return (int32_t)maximum;
+}
+
+// SSE4.1 version of WebRtcSpl_MaxValueW32() for x86 platforms.
+int32_t WebRtcSpl_MaxValueW32SSE4_1(const int32_t* vector, int length) {
+  int32_t maximum = WEBRTC_SPL_WORD32_MIN;
+  int i = 0;
+  __m128i max_32x4 = _mm_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+
+  if (vector == NULL || length <= 0) {
+    return maximum;
+  }
+
+  for (i = 0; i + 4 <= length; i += 4) {
+    max_32x4 = _mm_max_epi32(max_32x4,
+                             _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = HORIZONTAL_REDUCE_W32(_mm_max_epi32, max_32x4);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// SSE4.1 version of WebRtcSpl_MinValueW32() for x86 platforms.
+int32_t WebRtcSpl_MinValueW32SSE4_1(const int32_t* vector, int length) {
+  int32_t minimum = WEBRTC_SPL_WORD32_MAX;
+  int i = 0;
+  __m128i min_32x4 = _mm_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+
+  if (vector == NULL || length <= 0) {
+    return minimum;
+  }
+
+  for (i = 0; i + 4 <= length; i += 4) {
+    min_32x4 = _mm_min_epi32(min_32x4,
+                             _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = HORIZONTAL_REDUCE_W32(_mm_min_epi32, min_32x4);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
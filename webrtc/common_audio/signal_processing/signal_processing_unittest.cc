@@ -8,8 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 static const int kVector16Size = 9;
 static const int16_t vector16[kVector16Size] = {1, -15511, 4323, 1963,
@@ -470,10 +475,10 @@ TEST_F(SplTest, CrossCorrelationTest) {
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
-  if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
+  if (WebRtcSpl_CrossCorrelation == WebRtcSpl_CrossCorrelationNeon) {
     expected = kExpectedNeon;
   }
 #endif
@@ -601,3 +606,326 @@ TEST_F(SplTest, Resample48WithSaturationTest) {
     EXPECT_EQ(kRefValue16kHz2, out_vector_w16[i]);
   }
 }
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+namespace {
+
+// Random samples, with the extreme values the vector versions must handle
+// the same way as the C versions mixed in.
+void FillRandomW16(int16_t* vector, int length) {
+  for (int i = 0; i < length; ++i) {
+    switch (rand() % 8) {
+      case 0:
+        vector[i] = WEBRTC_SPL_WORD16_MIN;
+        break;
+      case 1:
+        vector[i] = WEBRTC_SPL_WORD16_MAX;
+        break;
+      default:
+        vector[i] = static_cast<int16_t>(rand());
+    }
+  }
+}
+
+// WEBRTC_SPL_WORD32_MIN is left out, since the C version of
+// WebRtcSpl_MaxAbsValueW32() takes abs() of it; MinMaxOperationsTest checks
+// the clamping of that case.
+void FillRandomW32(int32_t* vector, int length) {
+  for (int i = 0; i < length; ++i) {
+    switch (rand() % 8) {
+      case 0:
+        vector[i] = WEBRTC_SPL_WORD32_MIN + 1;
+        break;
+      case 1:
+        vector[i] = WEBRTC_SPL_WORD32_MAX;
+        break;
+      default:
+        vector[i] = static_cast<int32_t>((rand() << 16) ^ rand());
+    }
+  }
+}
+
+}  // namespace
+
+TEST_F(SplTest, X86MinMaxOperationsAreBitExact) {
+  const int kMaxLength = 67;
+  int16_t vector16[kMaxLength];
+  int32_t vector32[kMaxLength];
+  const bool has_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  const bool has_sse4_1 = WebRtc_GetCPUInfo(kSSE4_1) != 0;
+  const bool has_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+
+  srand(17);
+  for (int length = 1; length <= kMaxLength; ++length) {
+    for (int trial = 0; trial < 20; ++trial) {
+      FillRandomW16(vector16, length);
+      FillRandomW32(vector32, length);
+      // Also cover vectors without any extreme values.
+      if (trial % 2 == 0) {
+        for (int i = 0; i < length; ++i) {
+          vector16[i] >>= 1;
+          vector32[i] >>= 1;
+        }
+      }
+      if (has_sse2) {
+        EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(vector16, length),
+                  WebRtcSpl_MaxAbsValueW16SSE2(vector16, length));
+        EXPECT_EQ(WebRtcSpl_MaxValueW16C(vector16, length),
+                  WebRtcSpl_MaxValueW16SSE2(vector16, length));
+        EXPECT_EQ(WebRtcSpl_MinValueW16C(vector16, length),
+                  WebRtcSpl_MinValueW16SSE2(vector16, length));
+      }
+      if (has_sse4_1) {
+        EXPECT_EQ(WebRtcSpl_MaxAbsValueW32C(vector32, length),
+                  WebRtcSpl_MaxAbsValueW32SSE4_1(vector32, length));
+        EXPECT_EQ(WebRtcSpl_MaxValueW32C(vector32, length),
+                  WebRtcSpl_MaxValueW32SSE4_1(vector32, length));
+        EXPECT_EQ(WebRtcSpl_MinValueW32C(vector32, length),
+                  WebRtcSpl_MinValueW32SSE4_1(vector32, length));
+      }
+      if (has_avx2) {
+        EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(vector16, length),
+                  WebRtcSpl_MaxAbsValueW16AVX2(vector16, length));
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, X86CrossCorrelationIsBitExact) {
+  const int kMaxSeqDimension = 70;
+  const int kCrossCorrelationDimension = 9;
+  int16_t seq1[kMaxSeqDimension];
+  // Room for |seq2| to be stepped either way.
+  int16_t seq2[kMaxSeqDimension + 2 * kCrossCorrelationDimension];
+  int32_t expected[kCrossCorrelationDimension];
+  int32_t actual[kCrossCorrelationDimension];
+  const bool has_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  const bool has_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+
+  srand(17);
+  for (int dim_seq = 1; dim_seq <= kMaxSeqDimension; ++dim_seq) {
+    for (int16_t shift = 0; shift <= 6; shift += 2) {
+      for (int16_t step = -1; step <= 1; step += 2) {
+        FillRandomW16(seq1, kMaxSeqDimension);
+        FillRandomW16(seq2, kMaxSeqDimension + 2 * kCrossCorrelationDimension);
+        const int16_t* seq2_start =
+            step > 0 ? seq2 : &seq2[kCrossCorrelationDimension];
+        WebRtcSpl_CrossCorrelationC(expected, seq1, seq2_start, dim_seq,
+                                    kCrossCorrelationDimension, shift, step);
+        if (has_sse2) {
+          WebRtcSpl_CrossCorrelationSSE2(actual, seq1, seq2_start, dim_seq,
+                                         kCrossCorrelationDimension, shift,
+                                         step);
+          for (int i = 0; i < kCrossCorrelationDimension; ++i) {
+            EXPECT_EQ(expected[i], actual[i]);
+          }
+        }
+        if (has_avx2) {
+          WebRtcSpl_CrossCorrelationAVX2(actual, seq1, seq2_start, dim_seq,
+                                         kCrossCorrelationDimension, shift,
+                                         step);
+          for (int i = 0; i < kCrossCorrelationDimension; ++i) {
+            EXPECT_EQ(expected[i], actual[i]);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, X86DotProductWithScaleIsBitExact) {
+  const int kMaxLength = 70;
+  int16_t vector1[kMaxLength];
+  int16_t vector2[kMaxLength];
+  const bool has_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  const bool has_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+
+  srand(17);
+  for (int length = 1; length <= kMaxLength; ++length) {
+    for (int scaling = 0; scaling <= 6; scaling += 2) {
+      FillRandomW16(vector1, length);
+      FillRandomW16(vector2, length);
+      const int32_t expected =
+          WebRtcSpl_DotProductWithScaleC(vector1, vector2, length, scaling);
+      if (has_sse2) {
+        EXPECT_EQ(expected, WebRtcSpl_DotProductWithScaleSSE2(
+            vector1, vector2, length, scaling));
+        // NetEq mostly uses it for energies.
+        EXPECT_EQ(WebRtcSpl_DotProductWithScaleC(vector1, vector1, length,
+                                                 scaling),
+                  WebRtcSpl_DotProductWithScaleSSE2(vector1, vector1, length,
+                                                    scaling));
+      }
+      if (has_avx2) {
+        EXPECT_EQ(expected, WebRtcSpl_DotProductWithScaleAVX2(
+            vector1, vector2, length, scaling));
+        EXPECT_EQ(WebRtcSpl_DotProductWithScaleC(vector1, vector1, length,
+                                                 scaling),
+                  WebRtcSpl_DotProductWithScaleAVX2(vector1, vector1, length,
+                                                    scaling));
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, X86DownsampleFastIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const int kMaxCoefficients = 70;
+  const int kDataLength = 240;
+  int16_t coefficients[kMaxCoefficients];
+  // The filter history is kept in front of the input.
+  int16_t data[kMaxCoefficients + kDataLength];
+  int16_t* data_in = &data[kMaxCoefficients];
+  int16_t expected[kDataLength];
+  int16_t actual[kDataLength];
+
+  srand(17);
+  for (int length = 1; length <= kMaxCoefficients;
+       length += (length < 17 ? 1 : 53)) {
+    for (int factor = 1; factor <= 12; ++factor) {
+      for (int delay = 0; delay <= 4; delay += 2) {
+        FillRandomW16(coefficients, length);
+        FillRandomW16(data, kMaxCoefficients + kDataLength);
+        const int data_out_length = (kDataLength - delay - 1) / factor + 1;
+        EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(data_in, kDataLength, expected,
+                                               data_out_length, coefficients,
+                                               length, factor, delay));
+        EXPECT_EQ(0, WebRtcSpl_DownsampleFastSSE2(data_in, kDataLength,
+                                                  actual, data_out_length,
+                                                  coefficients, length,
+                                                  factor, delay));
+        for (int i = 0; i < data_out_length; ++i) {
+          EXPECT_EQ(expected[i], actual[i]);
+        }
+      }
+    }
+  }
+  EXPECT_EQ(-1, WebRtcSpl_DownsampleFastSSE2(data_in, 10, actual, 10,
+                                             coefficients, 4, 2, 0));
+}
+
+TEST_F(SplTest, X86ScaleAndAddVectorsWithRoundIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const int kMaxLength = 67;
+  int16_t in1[kMaxLength];
+  int16_t in2[kMaxLength];
+  int16_t expected[kMaxLength];
+  int16_t actual[kMaxLength];
+
+  srand(17);
+  for (int length = 1; length <= kMaxLength; ++length) {
+    for (int right_shifts = 0; right_shifts <= 16; right_shifts += 4) {
+      FillRandomW16(in1, length);
+      FillRandomW16(in2, length);
+      int16_t scales[2];
+      FillRandomW16(scales, 2);
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundC(
+          in1, scales[0], in2, scales[1], right_shifts, expected, length));
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(
+          in1, scales[0], in2, scales[1], right_shifts, actual, length));
+      for (int i = 0; i < length; ++i) {
+        EXPECT_EQ(expected[i], actual[i]);
+      }
+    }
+  }
+  EXPECT_EQ(-1, WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(
+      in1, 1, in2, 1, -1, actual, kMaxLength));
+}
+
+// Runs |call| |iterations| times and sets |elapsed_us| to the time it took.
+#define TIME_SPL_CALL(call, iterations, elapsed_us)                     \
+  do {                                                                  \
+    webrtc::TickTime start = webrtc::TickTime::Now();                   \
+    for (int n = 0; n < (iterations); ++n) {                            \
+      call;                                                             \
+    }                                                                   \
+    elapsed_us = static_cast<double>(                                   \
+        (webrtc::TickTime::Now() - start).Microseconds());              \
+  } while (0)
+
+// Prints the time spent in the C version and in the version picked by
+// WebRtcSpl_Init(), for sizes as used by NetEq at 48 kHz.
+TEST_F(SplTest, DISABLED_X86OptimizationsBenchmark) {
+  const int kIterations = 20000;
+  const int kLength = 480;
+  const int kSeqDimension = 120;
+  const int kCrossCorrelationDimension = 60;
+  const int kFactor = 12;
+  const int kCoefficients = 7;
+  const int kDownsampledLength = (kLength - kCoefficients) / kFactor;
+  int16_t in1[kLength];
+  int16_t in2[kLength];
+  int16_t out[kLength];
+  int32_t in32[kLength];
+  int32_t correlation[kCrossCorrelationDimension];
+  int16_t coefficients[kCoefficients];
+  const int16_t* downsample_in = &in1[kCoefficients];
+  double c_us = 0;
+  double us = 0;
+
+  srand(17);
+  FillRandomW16(in1, kLength);
+  FillRandomW16(in2, kLength);
+  FillRandomW32(in32, kLength);
+  FillRandomW16(coefficients, kCoefficients);
+
+  printf("Benchmarking %d iterations, C vs. optimized:\n", kIterations);
+
+  TIME_SPL_CALL(WebRtcSpl_MaxAbsValueW16C(in1, kLength), kIterations, c_us);
+  TIME_SPL_CALL(WebRtcSpl_MaxAbsValueW16(in1, kLength), kIterations, us);
+  printf("MaxAbsValueW16 %.2fms vs. %.2fms.\n", c_us / 1000, us / 1000);
+
+  TIME_SPL_CALL(WebRtcSpl_MaxValueW16C(in1, kLength), kIterations, c_us);
+  TIME_SPL_CALL(WebRtcSpl_MaxValueW16(in1, kLength), kIterations, us);
+  printf("MaxValueW16 %.2fms vs. %.2fms.\n", c_us / 1000, us / 1000);
+
+  TIME_SPL_CALL(WebRtcSpl_MaxAbsValueW32C(in32, kLength), kIterations, c_us);
+  TIME_SPL_CALL(WebRtcSpl_MaxAbsValueW32(in32, kLength), kIterations, us);
+  printf("MaxAbsValueW32 %.2fms vs. %.2fms.\n", c_us / 1000, us / 1000);
+
+  TIME_SPL_CALL(WebRtcSpl_MinValueW32C(in32, kLength), kIterations, c_us);
+  TIME_SPL_CALL(WebRtcSpl_MinValueW32(in32, kLength), kIterations, us);
+  printf("MinValueW32 %.2fms vs. %.2fms.\n", c_us / 1000, us / 1000);
+
+  TIME_SPL_CALL(WebRtcSpl_CrossCorrelationC(correlation, in1, in2,
+                                            kSeqDimension,
+                                            kCrossCorrelationDimension, 2, 1),
+                kIterations, c_us);
+  TIME_SPL_CALL(WebRtcSpl_CrossCorrelation(correlation, in1, in2,
+                                           kSeqDimension,
+                                           kCrossCorrelationDimension, 2, 1),
+                kIterations, us);
+  printf("CrossCorrelation %.2fms vs. %.2fms.\n", c_us / 1000, us / 1000);
+
+  TIME_SPL_CALL(WebRtcSpl_DotProductWithScaleC(in1, in2, kLength, 2),
+                kIterations, c_us);
+  TIME_SPL_CALL(WebRtcSpl_DotProductWithScale(in1, in2, kLength, 2),
+                kIterations, us);
+  printf("DotProductWithScale %.2fms vs. %.2fms.\n", c_us / 1000, us / 1000);
+
+  TIME_SPL_CALL(WebRtcSpl_DownsampleFastC(downsample_in,
+                                          kLength - kCoefficients, out,
+                                          kDownsampledLength, coefficients,
+                                          kCoefficients, kFactor, 0),
+                kIterations, c_us);
+  TIME_SPL_CALL(WebRtcSpl_DownsampleFast(downsample_in,
+                                         kLength - kCoefficients, out,
+                                         kDownsampledLength, coefficients,
+                                         kCoefficients, kFactor, 0),
+                kIterations, us);
+  printf("DownsampleFast %.2fms vs. %.2fms.\n", c_us / 1000, us / 1000);
+
+  TIME_SPL_CALL(WebRtcSpl_ScaleAndAddVectorsWithRoundC(in1, 11000, in2, 5000,
+                                                       14, out, kLength),
+                kIterations, c_us);
+  TIME_SPL_CALL(WebRtcSpl_ScaleAndAddVectorsWithRound(in1, 11000, in2, 5000,
+                                                      14, out, kLength),
+                kIterations, us);
+  printf("ScaleAndAddVectorsWithRound %.2fms vs. %.2fms.\n", c_us / 1000,
+         us / 1000);
+}
+
+#undef TIME_SPL_CALL
+#endif  // WEBRTC_ARCH_X86_FAMILY
@@ -9,7 +9,7 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers for ARM, MIPS and x86 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
@@ -25,6 +25,10 @@ MaxValueW32 WebRtcSpl_MaxValueW32;
 MinValueW16 WebRtcSpl_MinValueW16;
 MinValueW32 WebRtcSpl_MinValueW32;
 CrossCorrelation WebRtcSpl_CrossCorrelation;
+/* Usable before WebRtcSpl_Init(), since it was a plain function and is still
+ * called by modules which never call WebRtcSpl_Init(). */
+DotProductWithScale WebRtcSpl_DotProductWithScale =
+    WebRtcSpl_DotProductWithScaleC;
 DownsampleFast WebRtcSpl_DownsampleFast;
 ScaleAndAddVectorsWithRound WebRtcSpl_ScaleAndAddVectorsWithRound;
 
@@ -39,6 +43,7 @@ static void InitPointersToC() {
   WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16C;
   WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32C;
   WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationC;
+  WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleC;
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
   WebRtcSpl_ScaleAndAddVectorsWithRound =
       WebRtcSpl_ScaleAndAddVectorsWithRoundC;
@@ -55,6 +60,7 @@ static void InitPointersToNeon() {
   WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16Neon;
   WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32Neon;
   WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationNeon;
+  WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleC;
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastNeon;
   /* TODO(henrik.lundin): re-enable NEON when the crash from bug 3243 is
      understood. */
@@ -72,6 +78,7 @@ static void InitPointersToMIPS() {
   WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16_mips;
   WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32_mips;
   WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelation_mips;
+  WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleC;
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFast_mips;
 #if defined(MIPS_DSP_R1_LE)
   WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32_mips;
@@ -85,6 +92,33 @@ static void InitPointersToMIPS() {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* Initialize function pointers to the fastest versions the CPU supports. */
+static void InitPointersToX86() {
+  InitPointersToC();
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16SSE2;
+    WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16SSE2;
+    WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16SSE2;
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+    WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleSSE2;
+    WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSSE2;
+    WebRtcSpl_ScaleAndAddVectorsWithRound =
+        WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2;
+  }
+  if (WebRtc_GetCPUInfo(kSSE4_1)) {
+    WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32SSE4_1;
+    WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32SSE4_1;
+    WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32SSE4_1;
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16AVX2;
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationAVX2;
+    WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleAVX2;
+  }
+}
+#endif
+
 static void InitFunctionPointers(void) {
 #if defined(WEBRTC_DETECT_ARM_NEON)
   if ((WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) != 0) {
@@ -96,6 +130,8 @@ static void InitFunctionPointers(void) {
   InitPointersToNeon();
 #elif defined(MIPS32_LE)
   InitPointersToMIPS();
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  InitPointersToX86();
 #else
   InitPointersToC();
 #endif  /* WEBRTC_DETECT_ARM_NEON */
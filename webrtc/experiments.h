@@ -11,9 +11,14 @@
 #ifndef WEBRTC_EXPERIMENTS_H_
 #define WEBRTC_EXPERIMENTS_H_
 
+#include <stddef.h>
+
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
+
+class VCMFramePayloadPool;
+
 struct RemoteBitrateEstimatorMinRate {
   RemoteBitrateEstimatorMinRate() : min_rate(30000) {}
   RemoteBitrateEstimatorMinRate(uint32_t min_rate) : min_rate(min_rate) {}
@@ -29,5 +34,86 @@ struct AimdRemoteRateControl {
 
   const bool enabled;
 };
+
+// Delivers captured frames to the encoder on the thread that produced them
+// instead of handing them over to a dedicated ViECapturer delivery thread.
+// Frames arriving while a previous frame is still being delivered replace
+// any frame waiting for delivery, i.e. the oldest pending frame is dropped.
+struct DirectCaptureDelivery {
+  DirectCaptureDelivery() : enabled(false) {}
+  explicit DirectCaptureDelivery(bool set_enabled)
+    : enabled(set_enabled) {}
+  virtual ~DirectCaptureDelivery() {}
+
+  const bool enabled;
+};
+
+// Encodes frames on a dedicated ViEEncoder thread instead of on the thread
+// delivering them, with up to |max_queued_frames| frames waiting in between.
+// When the encoder can't keep up, frames are dropped according to
+// |drop_policy|.
+struct QueuedEncoding {
+  enum DropPolicy {
+    // Drops the oldest queued frame to make room for a new one.
+    kDropOldest,
+    // Drops new frames while the queue is full. If a key frame has been
+    // requested, the queued frames are dropped instead, so that the key frame
+    // is encoded from the newest frame without delay.
+    kDropNewest,
+    // Drops new frames arriving faster than the encoder has been able to
+    // encode them while frames are waiting, which spreads the dropped frames
+    // evenly over time. Drops the oldest frame if the queue still fills up.
+    kDropRateBased,
+  };
+
+  QueuedEncoding()
+    : enabled(false), max_queued_frames(1), drop_policy(kDropOldest) {}
+  QueuedEncoding(int set_max_queued_frames, DropPolicy set_drop_policy)
+    : enabled(true),
+      max_queued_frames(set_max_queued_frames),
+      drop_policy(set_drop_policy) {}
+  virtual ~QueuedEncoding() {}
+
+  const bool enabled;
+  const int max_queued_frames;
+  const DropPolicy drop_policy;
+};
+
+// Gets the playout audio of the voice channels in parallel, on
+// |num_threads| worker threads of the output mixer. The per-channel playout
+// processing, such as VoEMediaProcess kPlaybackPerChannel callbacks, may then
+// run concurrently for different channels.
+struct ParallelPlayoutDecoding {
+  ParallelPlayoutDecoding() : num_threads(0) {}
+  explicit ParallelPlayoutDecoding(int set_num_threads)
+    : num_threads(set_num_threads) {}
+  virtual ~ParallelPlayoutDecoding() {}
+
+  const int num_threads;
+};
+
+// Records when each frame passes the stages of the send-side video pipeline.
+// The timings are read with ViECodec::WriteEncodePipelineTimings(). Tracing
+// is off by default, and then costs nothing per frame.
+struct EncodePipelineTracing {
+  EncodePipelineTracing() : enabled(false) {}
+  explicit EncodePipelineTracing(bool set_enabled)
+    : enabled(set_enabled) {}
+  virtual ~EncodePipelineTracing() {}
+
+  const bool enabled;
+};
+
+// Allocates the payloads of the frames received by all channels of a video
+// engine from |pool|, so that they share one memory budget. The pool must
+// outlive the engine. By default each channel allocates its own payloads.
+struct ReceiveFramePayloadPool {
+  ReceiveFramePayloadPool() : pool(NULL) {}
+  explicit ReceiveFramePayloadPool(VCMFramePayloadPool* set_pool)
+    : pool(set_pool) {}
+  virtual ~ReceiveFramePayloadPool() {}
+
+  VCMFramePayloadPool* const pool;
+};
 }  // namespace webrtc
 #endif  // WEBRTC_EXPERIMENTS_H_
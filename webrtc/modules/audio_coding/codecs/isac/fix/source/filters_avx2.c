@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/fix/source/codec.h"
+
+// Returns the sum of x[j] * y[j] for 0 <= j < length, in 64 bits. See
+// filters_sse2.c for how the pair sums of _mm256_madd_epi16() are extended.
+static int64_t DotProduct64(const int16_t* x, const int16_t* y, int length) {
+  const __m256i kInt32Min = _mm256_set1_epi32((int32_t)0x80000000);
+  __m256i sum_64x4 = _mm256_setzero_si256();
+  __m128i sum_64x2;
+  int64_t sum[2];
+  int64_t prod = 0;
+  int j = 0;
+
+  for (j = 0; j + 16 <= length; j += 16) {
+    __m256i x_16x16 = _mm256_loadu_si256((const __m256i*)&x[j]);
+    __m256i y_16x16 = _mm256_loadu_si256((const __m256i*)&y[j]);
+    __m256i madd_32x8 = _mm256_madd_epi16(x_16x16, y_16x16);
+    __m256i sign_32x8 = _mm256_andnot_si256(
+        _mm256_cmpeq_epi32(madd_32x8, kInt32Min),
+        _mm256_srai_epi32(madd_32x8, 31));
+    sum_64x4 = _mm256_add_epi64(sum_64x4,
+                                _mm256_unpacklo_epi32(madd_32x8, sign_32x8));
+    sum_64x4 = _mm256_add_epi64(sum_64x4,
+                                _mm256_unpackhi_epi32(madd_32x8, sign_32x8));
+  }
+  sum_64x2 = _mm_add_epi64(_mm256_castsi256_si128(sum_64x4),
+                           _mm256_extracti128_si256(sum_64x4, 1));
+  _mm_storeu_si128((__m128i*)sum, sum_64x2);
+  prod = sum[0] + sum[1];
+
+  for (; j < length; j++) {
+    prod += WEBRTC_SPL_MUL_16_16(x[j], y[j]);
+  }
+  return prod;
+}
+
+// AVX2 version of WebRtcIsacfix_AutocorrC(), bit-exact with it.
+int WebRtcIsacfix_AutocorrAVX2(int32_t* __restrict r,
+                               const int16_t* __restrict x,
+                               int16_t N,
+                               int16_t order,
+                               int16_t* __restrict scale) {
+  int i = 0;
+  int16_t scaling = 0;
+  uint32_t temp = 0;
+  int64_t prod = 0;
+
+  assert(N % 4 == 0);
+  assert(N >= 8);
+
+  // Calculate r[0] and the scaling (the value of shifting).
+  prod = DotProduct64(x, x, N);
+  temp = (uint32_t)(prod >> 31);
+  if (temp != 0) {
+    scaling = 32 - WebRtcSpl_NormU32(temp);
+  }
+  r[0] = (int32_t)(prod >> scaling);
+
+  // Perform the actual correlation calculation.
+  for (i = 1; i < order + 1; i++) {
+    r[i] = (int32_t)(DotProduct64(x, &x[i], N - i) >> scaling);
+  }
+
+  *scale = scaling;
+
+  return order + 1;
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <emmintrin.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/fix/source/codec.h"
+
+// Returns the sum of x[j] * y[j] for 0 <= j < length, in 64 bits.
+// _mm_madd_epi16() adds pairs of products into 32 bits, which only wraps when
+// both products are -32768 * -32768. The sum is then 2^31, read as INT32_MIN,
+// a value no other pair can give, so that value is sign extended as positive.
+static int64_t DotProduct64(const int16_t* x, const int16_t* y, int length) {
+  const __m128i kInt32Min = _mm_set1_epi32((int32_t)0x80000000);
+  __m128i sum_64x2 = _mm_setzero_si128();
+  int64_t sum[2];
+  int64_t prod = 0;
+  int j = 0;
+
+  for (j = 0; j + 8 <= length; j += 8) {
+    __m128i x_16x8 = _mm_loadu_si128((const __m128i*)&x[j]);
+    __m128i y_16x8 = _mm_loadu_si128((const __m128i*)&y[j]);
+    __m128i madd_32x4 = _mm_madd_epi16(x_16x8, y_16x8);
+    __m128i sign_32x4 = _mm_andnot_si128(_mm_cmpeq_epi32(madd_32x4, kInt32Min),
+                                         _mm_srai_epi32(madd_32x4, 31));
+    sum_64x2 = _mm_add_epi64(sum_64x2,
+                             _mm_unpacklo_epi32(madd_32x4, sign_32x4));
+    sum_64x2 = _mm_add_epi64(sum_64x2,
+                             _mm_unpackhi_epi32(madd_32x4, sign_32x4));
+  }
+  _mm_storeu_si128((__m128i*)sum, sum_64x2);
+  prod = sum[0] + sum[1];
+
+  for (; j < length; j++) {
+    prod += WEBRTC_SPL_MUL_16_16(x[j], y[j]);
+  }
+  return prod;
+}
+
+// SSE2 version of WebRtcIsacfix_AutocorrC(), bit-exact with it.
+int WebRtcIsacfix_AutocorrSSE2(int32_t* __restrict r,
+                               const int16_t* __restrict x,
+                               int16_t N,
+                               int16_t order,
+                               int16_t* __restrict scale) {
+  int i = 0;
+  int16_t scaling = 0;
+  uint32_t temp = 0;
+  int64_t prod = 0;
+
+  assert(N % 4 == 0);
+  assert(N >= 8);
+
+  // Calculate r[0] and the scaling (the value of shifting).
+  prod = DotProduct64(x, x, N);
+  temp = (uint32_t)(prod >> 31);
+  if (temp != 0) {
+    scaling = 32 - WebRtcSpl_NormU32(temp);
+  }
+  r[0] = (int32_t)(prod >> scaling);
+
+  // Perform the actual correlation calculation.
+  for (i = 1; i < order + 1; i++) {
+    r[i] = (int32_t)(DotProduct64(x, &x[i], N - i) >> scaling);
+  }
+
+  *scale = scaling;
+
+  return order + 1;
+}
@@ -7,8 +7,12 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+
+#include <algorithm>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "webrtc/modules/audio_coding/codecs/isac/fix/source/settings.h"
 #include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 #include "webrtc/typedefs.h"
 
@@ -66,4 +70,54 @@ TEST_F(FiltersTest, AutocorrFixTest) {
 #elif defined(WEBRTC_ARCH_ARM_NEON)
   FiltersTester(WebRtcIsacfix_AutocorrNeon);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    FiltersTester(WebRtcIsacfix_AutocorrSSE2);
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    FiltersTester(WebRtcIsacfix_AutocorrAVX2);
+  }
+#endif
 }
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Compares the x86 versions with the C version for the window length and
+// orders used by the encoder, with full-scale input that makes _mm_madd_epi16()
+// wrap.
+TEST_F(FiltersTest, AutocorrFixX86IsBitExact) {
+  const int kOrder = 12;
+  const AutocorrFix kFunctions[] = {
+    WebRtc_GetCPUInfo(kSSE2) ? WebRtcIsacfix_AutocorrSSE2 : NULL,
+    WebRtc_GetCPUInfo(kAVX2) ? WebRtcIsacfix_AutocorrAVX2 : NULL,
+  };
+  int16_t x[WINLEN];
+  uint32_t seed = 12345;
+  for (int test = 0; test < 3; test++) {
+    for (int i = 0; i < WINLEN; i++) {
+      seed = seed * 1664525 + 1013904223;
+      // All -32768, full-scale noise, and noise small enough not to scale.
+      x[i] = test == 0 ? -32768 :
+          static_cast<int16_t>(seed >> 16) >> (test == 1 ? 0 : 6);
+    }
+    for (int length = 8; length <= WINLEN; length += 4) {
+      int32_t r_expected[kOrder + 2];
+      int16_t scale_expected = 0;
+      int order = std::min(kOrder + 1, length - 1);
+      EXPECT_EQ(order + 1, WebRtcIsacfix_AutocorrC(r_expected, x, length,
+                                                   order, &scale_expected));
+      for (size_t f = 0; f < sizeof(kFunctions) / sizeof(*kFunctions); f++) {
+        if (!kFunctions[f])
+          continue;
+        int32_t r[kOrder + 2];
+        int16_t scale = 0;
+        EXPECT_EQ(order + 1, kFunctions[f](r, x, length, order, &scale));
+        EXPECT_EQ(scale_expected, scale);
+        for (int i = 0; i <= order; i++) {
+          EXPECT_EQ(r_expected[i], r[i]) << "length " << length << ", lag "
+                                          << i;
+        }
+      }
+    }
+  }
+}
+#endif
@@ -240,6 +240,26 @@ static void WebRtcIsacfix_InitMIPS(void) {
 }
 #endif
 
+/****************************************************************************
+ * WebRtcIsacfix_InitX86(...)
+ *
+ * This function initializes function pointers for x86 platforms, depending on
+ * the instruction sets supported by the CPU.
+ */
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static void WebRtcIsacfix_InitX86(void) {
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcIsacfix_AutocorrFix = WebRtcIsacfix_AutocorrSSE2;
+    WebRtcIsacfix_FilterMaLoopFix = WebRtcIsacfix_FilterMaLoopSSE2;
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcIsacfix_AutocorrFix = WebRtcIsacfix_AutocorrAVX2;
+    WebRtcIsacfix_FilterMaLoopFix = WebRtcIsacfix_FilterMaLoopAVX2;
+  }
+}
+#endif
+
 /****************************************************************************
  * WebRtcIsacfix_EncoderInit(...)
  *
@@ -342,6 +362,10 @@ int16_t WebRtcIsacfix_EncoderInit(ISACFIX_MainStruct *ISAC_main_inst,
   WebRtcIsacfix_InitMIPS();
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  WebRtcIsacfix_InitX86();
+#endif
+
   return statusInit;
 }
 
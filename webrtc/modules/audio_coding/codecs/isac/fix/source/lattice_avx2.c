@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "webrtc/modules/audio_coding/codecs/isac/fix/source/settings.h"
+
+// Same as in lattice.c.
+#define LATTICE_MUL_32_32_RSFT16(a32a, a32b, b32) \
+  ((int32_t)(WEBRTC_SPL_MUL(a32a, b32) +          \
+             (WEBRTC_SPL_MUL_16_32_RSFT16(a32b, b32))))
+
+// The helpers below are the 256-bit versions of those in lattice_sse2.c.
+typedef struct {
+  __m256i high;  // b >> 16.
+  __m256i half;  // (b & 0xffff) >> 1.
+  __m256i odd;   // All ones where b is odd.
+} Split32x8;
+
+static __inline Split32x8 Split(__m256i b) {
+  Split32x8 split;
+  split.high = _mm256_srai_epi32(b, 16);
+  split.half = _mm256_and_si256(_mm256_srli_epi32(b, 1),
+                                _mm256_set1_epi32(0x7fff));
+  split.odd = _mm256_srai_epi32(_mm256_slli_epi32(b, 31), 31);
+  return split;
+}
+
+static __inline __m256i MulRsft15(__m256i a, __m256i a_half,
+                                  const Split32x8* b) {
+  __m256i high = _mm256_madd_epi16(a, b->high);
+  __m256i low = _mm256_add_epi32(_mm256_madd_epi16(a, b->half),
+                                 _mm256_and_si256(b->odd, a_half));
+  return _mm256_add_epi32(
+      _mm256_slli_epi32(high, 1),
+      _mm256_srai_epi32(_mm256_add_epi32(low, _mm256_set1_epi32(0x2000)), 14));
+}
+
+static __inline __m256i LatticeMul(__m256i a32a, __m256i a32a_32,
+                                   __m256i a32b, const Split32x8* b) {
+  __m256i mul = _mm256_add_epi32(
+      _mm256_slli_epi32(_mm256_madd_epi16(a32a, b->high), 16),
+      _mm256_add_epi32(
+          _mm256_slli_epi32(_mm256_madd_epi16(a32a, b->half), 1),
+          _mm256_and_si256(b->odd, a32a_32)));
+  __m256i rsft16 = _mm256_add_epi32(
+      _mm256_madd_epi16(a32b, b->high),
+      _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(a32b, b->half),
+                                         _mm256_set1_epi32(0x4000)), 15));
+  return _mm256_add_epi32(mul, rsft16);
+}
+
+// AVX2 version of WebRtcIsacfix_FilterMaLoopC(), bit-exact with it, filtering
+// eight samples at a time.
+void WebRtcIsacfix_FilterMaLoopAVX2(int16_t input0,  // Filter coefficient
+                                    int16_t input1,  // Filter coefficient
+                                    int32_t input2,  // Inverse coeff (1/input1)
+                                    int32_t* ptr0,   // Sample buffer
+                                    int32_t* ptr1,   // Sample buffer
+                                    int32_t* ptr2) { // Sample buffer
+  int n = 0;
+  int16_t t16a = (int16_t)(input2 >> 16);
+  int16_t t16b = (int16_t)input2;
+  if (t16b < 0) t16a++;
+
+  {
+    const __m256i in0 = _mm256_set1_epi32((uint16_t)input0);
+    const __m256i in0_half = _mm256_set1_epi32(input0 >> 1);
+    const __m256i in1 = _mm256_set1_epi32((uint16_t)input1);
+    const __m256i in1_half = _mm256_set1_epi32(input1 >> 1);
+    const __m256i a32a = _mm256_set1_epi32((uint16_t)t16a);
+    const __m256i a32a_32 = _mm256_set1_epi32(t16a);
+    const __m256i a32b = _mm256_set1_epi32((uint16_t)t16b);
+
+    for (; n + 8 <= HALF_SUBFRAMELEN - 1; n += 8) {
+      __m256i p0 = _mm256_loadu_si256((const __m256i*)&ptr0[n]);
+      __m256i p2 = _mm256_loadu_si256((const __m256i*)&ptr2[n]);
+      Split32x8 p0_split = Split(p0);
+      Split32x8 tmp_split;
+      Split32x8 p2_split;
+
+      // *ptr2 = input2 * (*ptr2 + input0 * (*ptr0)).
+      __m256i tmp = _mm256_add_epi32(p2, MulRsft15(in0, in0_half, &p0_split));
+      tmp_split = Split(tmp);
+      p2 = LatticeMul(a32a, a32a_32, a32b, &tmp_split);
+      _mm256_storeu_si256((__m256i*)&ptr2[n], p2);
+
+      // *ptr1 = input1 * (*ptr0) + input0 * (*ptr2).
+      p2_split = Split(p2);
+      _mm256_storeu_si256(
+          (__m256i*)&ptr1[n],
+          _mm256_add_epi32(MulRsft15(in1, in1_half, &p0_split),
+                           MulRsft15(in0, in0_half, &p2_split)));
+    }
+  }
+
+  for (; n < HALF_SUBFRAMELEN - 1; n++) {
+    int32_t tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr0[n]);
+    int32_t tmp32b = ptr2[n] + tmp32a;
+    ptr2[n] = LATTICE_MUL_32_32_RSFT16(t16a, t16b, tmp32b);
+
+    tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input1, ptr0[n]);
+    tmp32b = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr2[n]);
+    ptr1[n] = tmp32a + tmp32b;
+  }
+}
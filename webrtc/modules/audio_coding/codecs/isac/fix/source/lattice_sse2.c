@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "webrtc/modules/audio_coding/codecs/isac/fix/source/settings.h"
+
+// Same as in lattice.c.
+#define LATTICE_MUL_32_32_RSFT16(a32a, a32b, b32) \
+  ((int32_t)(WEBRTC_SPL_MUL(a32a, b32) +          \
+             (WEBRTC_SPL_MUL_16_32_RSFT16(a32b, b32))))
+
+// A vector of 32-bit values b, split into 16-bit parts for _mm_madd_epi16(),
+// which multiplies them by 16-bit coefficients held in the low half of each
+// lane (with the high half zero).
+typedef struct {
+  __m128i high;  // b >> 16.
+  __m128i half;  // (b & 0xffff) >> 1.
+  __m128i odd;   // All ones where b is odd.
+} Split32x4;
+
+static __inline Split32x4 Split(__m128i b) {
+  Split32x4 split;
+  split.high = _mm_srai_epi32(b, 16);
+  split.half = _mm_and_si128(_mm_srli_epi32(b, 1), _mm_set1_epi32(0x7fff));
+  split.odd = _mm_srai_epi32(_mm_slli_epi32(b, 31), 31);
+  return split;
+}
+
+// WEBRTC_SPL_MUL_16_32_RSFT15(a, b), with |a_half| holding a >> 1. The product
+// a * (uint16_t)b, which does not fit in 16x16 bits, is formed as
+// 2 * a * ((b & 0xffff) >> 1) plus a for odd b.
+static __inline __m128i MulRsft15(__m128i a, __m128i a_half,
+                                  const Split32x4* b) {
+  __m128i high = _mm_madd_epi16(a, b->high);
+  __m128i low = _mm_add_epi32(_mm_madd_epi16(a, b->half),
+                              _mm_and_si128(b->odd, a_half));
+  return _mm_add_epi32(
+      _mm_slli_epi32(high, 1),
+      _mm_srai_epi32(_mm_add_epi32(low, _mm_set1_epi32(0x2000)), 14));
+}
+
+// LATTICE_MUL_32_32_RSFT16(a32a, a32b, b), with |a32a_32| holding a32a
+// sign-extended to 32 bits.
+static __inline __m128i LatticeMul(__m128i a32a, __m128i a32a_32,
+                                   __m128i a32b, const Split32x4* b) {
+  // The low 32 bits of a32a * b.
+  __m128i mul = _mm_add_epi32(
+      _mm_slli_epi32(_mm_madd_epi16(a32a, b->high), 16),
+      _mm_add_epi32(_mm_slli_epi32(_mm_madd_epi16(a32a, b->half), 1),
+                    _mm_and_si128(b->odd, a32a_32)));
+  // WEBRTC_SPL_MUL_16_32_RSFT16(a32b, b).
+  __m128i rsft16 = _mm_add_epi32(
+      _mm_madd_epi16(a32b, b->high),
+      _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(a32b, b->half),
+                                   _mm_set1_epi32(0x4000)), 15));
+  return _mm_add_epi32(mul, rsft16);
+}
+
+// SSE2 version of WebRtcIsacfix_FilterMaLoopC(), bit-exact with it. The
+// samples are independent of each other, so four are filtered at a time.
+void WebRtcIsacfix_FilterMaLoopSSE2(int16_t input0,  // Filter coefficient
+                                    int16_t input1,  // Filter coefficient
+                                    int32_t input2,  // Inverse coeff (1/input1)
+                                    int32_t* ptr0,   // Sample buffer
+                                    int32_t* ptr1,   // Sample buffer
+                                    int32_t* ptr2) { // Sample buffer
+  int n = 0;
+  int16_t t16a = (int16_t)(input2 >> 16);
+  int16_t t16b = (int16_t)input2;
+  if (t16b < 0) t16a++;
+
+  {
+    const __m128i in0 = _mm_set1_epi32((uint16_t)input0);
+    const __m128i in0_half = _mm_set1_epi32(input0 >> 1);
+    const __m128i in1 = _mm_set1_epi32((uint16_t)input1);
+    const __m128i in1_half = _mm_set1_epi32(input1 >> 1);
+    const __m128i a32a = _mm_set1_epi32((uint16_t)t16a);
+    const __m128i a32a_32 = _mm_set1_epi32(t16a);
+    const __m128i a32b = _mm_set1_epi32((uint16_t)t16b);
+
+    for (; n + 4 <= HALF_SUBFRAMELEN - 1; n += 4) {
+      __m128i p0 = _mm_loadu_si128((const __m128i*)&ptr0[n]);
+      __m128i p2 = _mm_loadu_si128((const __m128i*)&ptr2[n]);
+      Split32x4 p0_split = Split(p0);
+      Split32x4 tmp_split;
+      Split32x4 p2_split;
+
+      // *ptr2 = input2 * (*ptr2 + input0 * (*ptr0)).
+      __m128i tmp = _mm_add_epi32(p2, MulRsft15(in0, in0_half, &p0_split));
+      tmp_split = Split(tmp);
+      p2 = LatticeMul(a32a, a32a_32, a32b, &tmp_split);
+      _mm_storeu_si128((__m128i*)&ptr2[n], p2);
+
+      // *ptr1 = input1 * (*ptr0) + input0 * (*ptr2).
+      p2_split = Split(p2);
+      _mm_storeu_si128((__m128i*)&ptr1[n],
+                       _mm_add_epi32(MulRsft15(in1, in1_half, &p0_split),
+                                     MulRsft15(in0, in0_half, &p2_split)));
+    }
+  }
+
+  for (; n < HALF_SUBFRAMELEN - 1; n++) {
+    int32_t tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr0[n]);
+    int32_t tmp32b = ptr2[n] + tmp32a;
+    ptr2[n] = LATTICE_MUL_32_32_RSFT16(t16a, t16b, tmp32b);
+
+    tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input1, ptr0[n]);
+    tmp32b = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr2[n]);
+    ptr1[n] = tmp32a + tmp32b;
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "webrtc/modules/audio_coding/codecs/isac/fix/source/settings.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/typedefs.h"
+
+class LatticeTest : public testing::Test {
+ protected:
+  // Runs |function| and WebRtcIsacfix_FilterMaLoopC() on the same input, and
+  // expects bit-exact output.
+  void FilterMaLoopTester(FilterMaLoopFix function) {
+    // Coefficients as computed by WebRtcIsacfix_NormLatticeFilterMa(), and
+    // the extreme values.
+    const int16_t kSth[] = {-12345, 3, 23170, 32767, -32768};
+    const int16_t kCth[] = {29173, 32767, 23170, 1, 0};
+    const int32_t kInvCth[] = {73617, 65538, 92682, 2147483647, 2147418112};
+    const int kLength = HALF_SUBFRAMELEN - 1;
+    uint32_t seed = 4711;
+    for (size_t c = 0; c < sizeof(kSth) / sizeof(*kSth); c++) {
+      for (int shift = 0; shift < 32; shift += 7) {
+        int32_t ptr0[kLength];
+        int32_t ptr1_expected[kLength];
+        int32_t ptr2_expected[kLength];
+        int32_t ptr1[kLength];
+        int32_t ptr2[kLength];
+        for (int n = 0; n < kLength; n++) {
+          seed = seed * 1664525 + 1013904223;
+          ptr0[n] = static_cast<int32_t>(seed) >> shift;
+          seed = seed * 1664525 + 1013904223;
+          ptr2[n] = ptr2_expected[n] = static_cast<int32_t>(seed) >> shift;
+          ptr1[n] = ptr1_expected[n] = 0;
+        }
+        WebRtcIsacfix_FilterMaLoopC(kSth[c], kCth[c], kInvCth[c], ptr0,
+                                    ptr1_expected, ptr2_expected);
+        function(kSth[c], kCth[c], kInvCth[c], ptr0, ptr1, ptr2);
+        for (int n = 0; n < kLength; n++) {
+          EXPECT_EQ(ptr1_expected[n], ptr1[n]) << "sample " << n;
+          EXPECT_EQ(ptr2_expected[n], ptr2[n]) << "sample " << n;
+        }
+      }
+    }
+  }
+};
+
+TEST_F(LatticeTest, FilterMaLoopTest) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    FilterMaLoopTester(WebRtcIsacfix_FilterMaLoopSSE2);
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    FilterMaLoopTester(WebRtcIsacfix_FilterMaLoopAVX2);
+  }
+#endif
+}
@@ -11,6 +11,7 @@
 #include "webrtc/modules/audio_coding/codecs/isac/fix/interface/isacfix.h"
 #include "webrtc/modules/audio_coding/codecs/isac/fix/source/settings.h"
 #include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 using ::std::string;
 
@@ -98,6 +99,23 @@ TEST_P(IsacSpeedTest, IsacEncodeDecodeTest) {
   EncodeDecode(kDurationSec);
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Same as above with the generic C kernels, for comparison with the SSE2 and
+// AVX2 ones selected by default.
+TEST_P(IsacSpeedTest, IsacEncodeDecodeTestWithoutSimd) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  WebRtc_CPUInfo get_cpu_info = WebRtc_GetCPUInfo;
+  WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
+  EXPECT_EQ(0, WebRtcIsacfix_EncoderInit(ISACFIX_main_inst_, 1));
+  WebRtc_GetCPUInfo = get_cpu_info;
+  EXPECT_EQ(0, WebRtcIsacfix_Control(ISACFIX_main_inst_, bit_rate_,
+                                     block_duration_ms_));
+  EncodeDecode(kDurationSec);
+  // Select the default kernels again.
+  EXPECT_EQ(0, WebRtcIsacfix_EncoderInit(ISACFIX_main_inst_, 1));
+}
+#endif
+
 const coding_param param_set[] =
     {::std::tr1::make_tuple(1, 32000, string("audio_coding/speech_mono_16kHz"),
                             string("pcm"), true)};
@@ -43,7 +43,7 @@ AudioEncoderOpus::Config::Config()
 bool AudioEncoderOpus::Config::IsOk() const {
   if (frame_size_ms <= 0 || frame_size_ms % 10 != 0)
     return false;
-  if (num_channels <= 0)
+  if (num_channels <= 0 || num_channels > kWebRtcOpusMaxChannels)
     return false;
   return true;
 }
@@ -55,7 +55,15 @@ AudioEncoderOpus::AudioEncoderOpus(const Config& config)
       samples_per_10ms_frame_(DivExact(kSampleRateHz, 100) * num_channels_) {
   CHECK(config.IsOk());
   input_buffer_.reserve(num_10ms_frames_per_packet_ * samples_per_10ms_frame_);
-  CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, num_channels_));
+  if (num_channels_ <= 2) {
+    CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, num_channels_));
+  } else {
+    // Code the channels pairwise as stereo streams, with a mono stream for
+    // the last channel if the number of channels is odd.
+    CHECK_EQ(0, WebRtcOpus_MultistreamEncoderCreate(
+                    &inst_, num_channels_, (num_channels_ + 1) / 2,
+                    num_channels_ / 2, NULL));
+  }
 }
 
 AudioEncoderOpus::~AudioEncoderOpus() {
@@ -17,13 +17,48 @@
 extern "C" {
 #endif
 
+// Maximum number of channels of a multistream instance.
+enum { kWebRtcOpusMaxChannels = 255 };
+
 // Opaque wrapper types for the codec state.
 typedef struct WebRtcOpusEncInst OpusEncInst;
 typedef struct WebRtcOpusDecInst OpusDecInst;
+typedef struct WebRtcOpusBatchInst OpusBatchInst;
 
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst, int32_t channels);
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
 
+/****************************************************************************
+ * WebRtcOpus_MultistreamEncoderCreate(...)
+ *
+ * This function creates an encoder for more than two channels, which codes
+ * the channels as a number of mono and stereo (coupled) Opus streams in one
+ * packet. The instance is used and freed like one from
+ * WebRtcOpus_EncoderCreate().
+ *
+ * Input:
+ *      - channels           : Number of channels in the input audio (1-255)
+ *      - streams            : Total number of streams
+ *      - coupled_streams    : Number of streams coding two channels
+ *      - channel_mapping    : |channels| entries giving the coded channel
+ *                             of each input channel, where the coupled
+ *                             streams hold the first 2 * |coupled_streams|
+ *                             coded channels. If NULL, input channel i is
+ *                             coded channel i, which requires
+ *                             channels == streams + coupled_streams.
+ *
+ * Output:
+ *      - inst               : Encoder context
+ *
+ * Return value              :  0 - Success
+ *                             -1 - Error
+ */
+int16_t WebRtcOpus_MultistreamEncoderCreate(OpusEncInst** inst,
+                                            int32_t channels,
+                                            int32_t streams,
+                                            int32_t coupled_streams,
+                                            const uint8_t* channel_mapping);
+
 /****************************************************************************
  * WebRtcOpus_Encode(...)
  *
@@ -48,6 +83,61 @@ int16_t WebRtcOpus_Encode(OpusEncInst* inst,
                           int16_t length_encoded_buffer,
                           uint8_t* encoded);
 
+/****************************************************************************
+ * WebRtcOpus_BatchCreate(...)
+ *
+ * This function creates the state shared by the encoders of a batch, see
+ * WebRtcOpus_EncodeBatch().
+ *
+ * Input:
+ *      - channels           : Number of channels in the input audio (1-255)
+ *
+ * Output:
+ *      - inst               : Batch context
+ *
+ * Return value              :  0 - Success
+ *                             -1 - Error
+ */
+int16_t WebRtcOpus_BatchCreate(OpusBatchInst** inst, int channels);
+int16_t WebRtcOpus_BatchFree(OpusBatchInst* inst);
+
+/****************************************************************************
+ * WebRtcOpus_EncodeBatch(...)
+ *
+ * This function encodes the same audio with each of a number of encoders,
+ * such as the encoders of the receivers of one mix, and gives the same
+ * packets as WebRtcOpus_Encode() would. The input is converted for the codec
+ * once per batch rather than once per encoder. Each packet is encoded into a
+ * scratch buffer of the batch, which holds the largest possible packet, and
+ * then written back to back with the others into |encoded|. The output buffer
+ * therefore only needs to hold the packets, not a worst case for each one.
+ *
+ * Input:
+ *      - batch                  : Batch context
+ *      - insts                  : Encoder contexts, with as many channels as
+ *                                 the batch
+ *      - num_instances          : Number of encoders
+ *      - audio_in               : Input speech data buffer
+ *      - samples                : Samples per channel in audio_in
+ *      - length_encoded_buffer  : Output buffer size
+ *
+ * Output:
+ *      - encoded                : Output compressed data buffer
+ *      - encoded_lengths        : Length (in bytes) of the packet of each
+ *                                 encoder, or -1 if it failed
+ *
+ * Return value                  : >=0 - Total length (in bytes) of coded data
+ *                                 -1 - Error for at least one encoder
+ */
+int WebRtcOpus_EncodeBatch(OpusBatchInst* batch,
+                           OpusEncInst* const* insts,
+                           int num_instances,
+                           const int16_t* audio_in,
+                           int16_t samples,
+                           int length_encoded_buffer,
+                           uint8_t* encoded,
+                           int16_t* encoded_lengths);
+
 /****************************************************************************
  * WebRtcOpus_SetBitRate(...)
  *
@@ -174,6 +264,35 @@ int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity);
 int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, int channels);
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst);
 
+/****************************************************************************
+ * WebRtcOpus_MultistreamDecoderCreate(...)
+ *
+ * This function creates a decoder for packets from
+ * WebRtcOpus_MultistreamEncoderCreate(). The instance is used and freed like
+ * one from WebRtcOpus_DecoderCreate(), except that FEC is not decoded.
+ *
+ * Input:
+ *      - channels           : Number of channels in the output audio (1-255)
+ *      - streams            : Total number of streams
+ *      - coupled_streams    : Number of streams coding two channels
+ *      - channel_mapping    : |channels| entries giving the coded channel
+ *                             of each output channel, or 255 for silence.
+ *                             If NULL, output channel i is coded channel i,
+ *                             which requires
+ *                             channels == streams + coupled_streams.
+ *
+ * Output:
+ *      - inst               : Decoder context
+ *
+ * Return value              :  0 - Success
+ *                             -1 - Error
+ */
+int16_t WebRtcOpus_MultistreamDecoderCreate(OpusDecInst** inst,
+                                            int channels,
+                                            int streams,
+                                            int coupled_streams,
+                                            const uint8_t* channel_mapping);
+
 /****************************************************************************
  * WebRtcOpus_DecoderChannels(...)
  *
@@ -250,7 +369,8 @@ int16_t WebRtcOpus_DecodePlc(OpusDecInst* inst, int16_t* decoded,
  *      - decoded            : The decoded vector (previous frame)
  *
  * Return value              : >0 - Samples per channel in decoded vector
- *                              0 - No FEC data in the packet
+ *                              0 - No FEC data in the packet, or a
+ *                                  multistream decoder
  *                             -1 - Error
  */
 int16_t WebRtcOpus_DecodeFec(OpusDecInst* inst, const uint8_t* encoded,
@@ -12,18 +12,35 @@
 #define WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_INST_H_
 
 #include "opus.h"
+#include "opus_multistream.h"
 
+/* Exactly one of |encoder| and |multistream_encoder| is set. */
 struct WebRtcOpusEncInst {
   OpusEncoder* encoder;
+  OpusMSEncoder* multistream_encoder;
+  int channels;
+  int streams;
   int in_dtx_mode;
 };
 
+/* Exactly one of |decoder| and |multistream_decoder| is set. */
 struct WebRtcOpusDecInst {
   OpusDecoder* decoder;
+  OpusMSDecoder* multistream_decoder;
   int prev_decoded_samples;
   int channels;
+  int streams;
   int in_dtx_mode;
 };
 
+struct WebRtcOpusBatchInst {
+  int channels;
+  /* The input of a batch, converted to float. */
+  float* audio;
+  /* Holds the packet of one encoder at a time. */
+  uint8_t* packet;
+  int packet_size;
+};
+
 
 #endif  // WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_INST_H_
@@ -29,8 +29,62 @@ enum {
 
   /* Default frame size, 20 ms @ 48 kHz, in samples (for one channel). */
   kWebRtcOpusDefaultFrameSize = 960,
+
+  /* Bound on the packet size of one stream for frames of up to 60 ms. Such
+   * a packet has at most three frames of up to 1275 bytes each, plus the
+   * frame lengths and the TOC and self-delimiting bytes. */
+  kWebRtcOpusMaxStreamPacketBytes = 4000,
 };
 
+/* Applies a CTL to the single stream or multistream codec of |inst|. */
+#define ENCODER_CTL(inst, ...) \
+    ((inst)->encoder ? \
+        opus_encoder_ctl((inst)->encoder, __VA_ARGS__) : \
+        opus_multistream_encoder_ctl((inst)->multistream_encoder, __VA_ARGS__))
+#define DECODER_CTL(inst, ...) \
+    ((inst)->decoder ? \
+        opus_decoder_ctl((inst)->decoder, __VA_ARGS__) : \
+        opus_multistream_decoder_ctl((inst)->multistream_decoder, __VA_ARGS__))
+
+/* Returns |channel_mapping| if set. Otherwise fills in |default_mapping| to
+ * assign the channels pairwise to the coupled streams, followed by one channel
+ * per uncoupled stream, and returns it. Returns NULL if the channels don't
+ * fill the streams exactly. */
+static const unsigned char* ChannelMapping(
+    const uint8_t* channel_mapping, int channels, int streams,
+    int coupled_streams, unsigned char* default_mapping) {
+  int i;
+  if (channel_mapping != NULL)
+    return channel_mapping;
+  if (channels != streams + coupled_streams)
+    return NULL;
+  for (i = 0; i < channels; ++i)
+    default_mapping[i] = (unsigned char) i;
+  return default_mapping;
+}
+
+/* Returns 1 if the |length| bytes of |packet| are a DTX packet of an instance
+ * with |streams| streams, i.e. every stream has a single empty frame. All but
+ * the last stream are self-delimited, so they are a TOC byte followed by a
+ * zero frame length. The last stream is just a TOC byte. */
+static int IsDtxPacket(const uint8_t* packet, int length, int streams) {
+  int i;
+  if (length != 2 * (streams - 1) + 1)
+    return 0;
+  for (i = 0; i < streams - 1; ++i) {
+    if ((packet[2 * i] & 0x3) != 0 || packet[2 * i + 1] != 0)
+      return 0;
+  }
+  return 1;
+}
+
+/* The input is always 16 bit. opus_encode() tells the codec so, but
+ * WebRtcOpus_EncodeBatch() passes the input as float, which would be taken as
+ * 24 bit. Setting the depth on the encoder makes both give the same packets. */
+static void SetInputDepth(OpusEncInst* inst) {
+  ENCODER_CTL(inst, OPUS_SET_LSB_DEPTH(16));
+}
+
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst, int32_t channels) {
   OpusEncInst* state;
   if (inst != NULL) {
@@ -43,8 +97,11 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst, int32_t channels) {
 
       state->encoder = opus_encoder_create(48000, channels, application,
                                            &error);
+      state->channels = channels;
+      state->streams = 1;
       state->in_dtx_mode = 0;
       if (error == OPUS_OK && state->encoder != NULL) {
+        SetInputDepth(state);
         *inst = state;
         return 0;
       }
@@ -54,9 +111,48 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst, int32_t channels) {
   return -1;
 }
 
+int16_t WebRtcOpus_MultistreamEncoderCreate(OpusEncInst** inst,
+                                            int32_t channels,
+                                            int32_t streams,
+                                            int32_t coupled_streams,
+                                            const uint8_t* channel_mapping) {
+  unsigned char default_mapping[kWebRtcOpusMaxChannels];
+  const unsigned char* mapping;
+  OpusEncInst* state;
+  int error;
+
+  if (inst == NULL || channels <= 0 || channels > kWebRtcOpusMaxChannels)
+    return -1;
+  mapping = ChannelMapping(channel_mapping, channels, streams,
+                           coupled_streams, default_mapping);
+  if (mapping == NULL)
+    return -1;
+
+  state = (OpusEncInst*) calloc(1, sizeof(OpusEncInst));
+  if (state == NULL)
+    return -1;
+  state->multistream_encoder = opus_multistream_encoder_create(
+      48000, channels, streams, coupled_streams, mapping,
+      OPUS_APPLICATION_AUDIO, &error);
+  state->channels = channels;
+  state->streams = streams;
+  state->in_dtx_mode = 0;
+  if (error == OPUS_OK && state->multistream_encoder != NULL) {
+    SetInputDepth(state);
+    *inst = state;
+    return 0;
+  }
+  free(state);
+  return -1;
+}
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   if (inst) {
-    opus_encoder_destroy(inst->encoder);
+    if (inst->encoder) {
+      opus_encoder_destroy(inst->encoder);
+    } else {
+      opus_multistream_encoder_destroy(inst->multistream_encoder);
+    }
     free(inst);
     return 0;
   } else {
@@ -64,6 +160,29 @@ int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   }
 }
 
+/* Finishes the encoding of a packet of |length| bytes, or an error if
+ * |length| is not positive, and returns the length to send. */
+static int16_t FinishEncode(OpusEncInst* inst, const uint8_t* encoded,
+                            int length) {
+  if (length > 0 && IsDtxPacket(encoded, length, inst->streams)) {
+    // Indicates DTX since the packet has nothing but a header for each stream.
+    // In principle, there is no need to send this packet. However, we do
+    // transmit the first occurrence to let the decoder know that the encoder
+    // enters DTX mode.
+    if (inst->in_dtx_mode) {
+      return 0;
+    } else {
+      inst->in_dtx_mode = 1;
+      return length;
+    }
+  } else if (length > 0) {
+    inst->in_dtx_mode = 0;
+    return length;
+  }
+
+  return -1;
+}
+
 int16_t WebRtcOpus_Encode(OpusEncInst* inst,
                           const int16_t* audio_in,
                           int16_t samples,
@@ -75,33 +194,112 @@ int16_t WebRtcOpus_Encode(OpusEncInst* inst,
     return -1;
   }
 
-  res = opus_encode(inst->encoder,
-                    (const opus_int16*)audio_in,
-                    samples,
-                    encoded,
-                    length_encoded_buffer);
+  if (inst->encoder) {
+    res = opus_encode(inst->encoder,
+                      (const opus_int16*)audio_in,
+                      samples,
+                      encoded,
+                      length_encoded_buffer);
+  } else {
+    res = opus_multistream_encode(inst->multistream_encoder,
+                                  (const opus_int16*)audio_in,
+                                  samples,
+                                  encoded,
+                                  length_encoded_buffer);
+  }
 
-  if (res == 1) {
-    // Indicates DTX since the packet has nothing but a header. In principle,
-    // there is no need to send this packet. However, we do transmit the first
-    // occurrence to let the decoder know that the encoder enters DTX mode.
-    if (inst->in_dtx_mode) {
-      return 0;
-    } else {
-      inst->in_dtx_mode = 1;
-      return 1;
+  return FinishEncode(inst, encoded, res);
+}
+
+int16_t WebRtcOpus_BatchCreate(OpusBatchInst** inst, int channels) {
+  OpusBatchInst* state;
+
+  if (inst == NULL || channels <= 0 || channels > kWebRtcOpusMaxChannels)
+    return -1;
+
+  state = (OpusBatchInst*) calloc(1, sizeof(OpusBatchInst));
+  if (state == NULL)
+    return -1;
+  state->channels = channels;
+  /* There are at most as many streams as channels. */
+  state->packet_size = channels * kWebRtcOpusMaxStreamPacketBytes;
+  state->audio = (float*) malloc(
+      sizeof(float) * channels * 48 * kWebRtcOpusMaxEncodeFrameSizeMs);
+  state->packet = (uint8_t*) malloc(state->packet_size);
+  if (state->audio != NULL && state->packet != NULL) {
+    *inst = state;
+    return 0;
+  }
+  WebRtcOpus_BatchFree(state);
+  return -1;
+}
+
+int16_t WebRtcOpus_BatchFree(OpusBatchInst* inst) {
+  if (inst) {
+    free(inst->audio);
+    free(inst->packet);
+    free(inst);
+    return 0;
+  } else {
+    return -1;
+  }
+}
+
+int WebRtcOpus_EncodeBatch(OpusBatchInst* batch,
+                           OpusEncInst* const* insts,
+                           int num_instances,
+                           const int16_t* audio_in,
+                           int16_t samples,
+                           int length_encoded_buffer,
+                           uint8_t* encoded,
+                           int16_t* encoded_lengths) {
+  int total_length = 0;
+  int failed = 0;
+  int i;
+
+  if (samples > 48 * kWebRtcOpusMaxEncodeFrameSizeMs) {
+    for (i = 0; i < num_instances; ++i)
+      encoded_lengths[i] = -1;
+    return -1;
+  }
+
+  /* This is the conversion opus_encode() does for each call. */
+  for (i = 0; i < samples * batch->channels; ++i)
+    batch->audio[i] = (1.0f / 32768) * audio_in[i];
+
+  for (i = 0; i < num_instances; ++i) {
+    OpusEncInst* inst = insts[i];
+    int res = -1;
+    int16_t length;
+
+    if (inst->channels == batch->channels) {
+      if (inst->encoder) {
+        res = opus_encode_float(inst->encoder, batch->audio, samples,
+                                batch->packet, batch->packet_size);
+      } else {
+        res = opus_multistream_encode_float(inst->multistream_encoder,
+                                            batch->audio, samples,
+                                            batch->packet, batch->packet_size);
+      }
     }
-  } else if (res > 1) {
-    inst->in_dtx_mode = 0;
-    return res;
+    length = FinishEncode(inst, batch->packet, res);
+    if (length > length_encoded_buffer - total_length)
+      length = -1;
+    encoded_lengths[i] = length;
+    if (length < 0) {
+      failed = 1;
+      continue;
+    }
+    memcpy(&encoded[total_length], batch->packet, length);
+    total_length += length;
   }
 
-  return -1;
+  return failed ? -1 : total_length;
 }
 
 int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_BITRATE(rate));
+    return ENCODER_CTL(inst, OPUS_SET_BITRATE(rate));
   } else {
     return -1;
   }
@@ -109,8 +307,7 @@ int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
 
 int16_t WebRtcOpus_SetPacketLossRate(OpusEncInst* inst, int32_t loss_rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder,
-                            OPUS_SET_PACKET_LOSS_PERC(loss_rate));
+    return ENCODER_CTL(inst, OPUS_SET_PACKET_LOSS_PERC(loss_rate));
   } else {
     return -1;
   }
@@ -133,13 +330,12 @@ int16_t WebRtcOpus_SetMaxPlaybackRate(OpusEncInst* inst, int32_t frequency_hz) {
   } else {
     set_bandwidth = OPUS_BANDWIDTH_FULLBAND;
   }
-  return opus_encoder_ctl(inst->encoder,
-                          OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
+  return ENCODER_CTL(inst, OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
 }
 
 int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(1));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(1));
   } else {
     return -1;
   }
@@ -147,7 +343,7 @@ int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_DisableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(0));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(0));
   } else {
     return -1;
   }
@@ -155,7 +351,7 @@ int16_t WebRtcOpus_DisableFec(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_EnableDtx(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(1));
+    return ENCODER_CTL(inst, OPUS_SET_DTX(1));
   } else {
     return -1;
   }
@@ -163,7 +359,7 @@ int16_t WebRtcOpus_EnableDtx(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(0));
+    return ENCODER_CTL(inst, OPUS_SET_DTX(0));
   } else {
     return -1;
   }
@@ -171,7 +367,7 @@ int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_COMPLEXITY(complexity));
+    return ENCODER_CTL(inst, OPUS_SET_COMPLEXITY(complexity));
   } else {
     return -1;
   }
@@ -193,6 +389,7 @@ int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, int channels) {
     if (error == OPUS_OK && state->decoder != NULL) {
       /* Creation of memory all ok. */
       state->channels = channels;
+      state->streams = 1;
       state->prev_decoded_samples = kWebRtcOpusDefaultFrameSize;
       state->in_dtx_mode = 0;
       *inst = state;
@@ -208,9 +405,47 @@ int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, int channels) {
   return -1;
 }
 
+int16_t WebRtcOpus_MultistreamDecoderCreate(OpusDecInst** inst,
+                                            int channels,
+                                            int streams,
+                                            int coupled_streams,
+                                            const uint8_t* channel_mapping) {
+  unsigned char default_mapping[kWebRtcOpusMaxChannels];
+  const unsigned char* mapping;
+  OpusDecInst* state;
+  int error;
+
+  if (inst == NULL || channels <= 0 || channels > kWebRtcOpusMaxChannels)
+    return -1;
+  mapping = ChannelMapping(channel_mapping, channels, streams,
+                           coupled_streams, default_mapping);
+  if (mapping == NULL)
+    return -1;
+
+  state = (OpusDecInst*) calloc(1, sizeof(OpusDecInst));
+  if (state == NULL)
+    return -1;
+  state->multistream_decoder = opus_multistream_decoder_create(
+      48000, channels, streams, coupled_streams, mapping, &error);
+  if (error == OPUS_OK && state->multistream_decoder != NULL) {
+    state->channels = channels;
+    state->streams = streams;
+    state->prev_decoded_samples = kWebRtcOpusDefaultFrameSize;
+    state->in_dtx_mode = 0;
+    *inst = state;
+    return 0;
+  }
+  free(state);
+  return -1;
+}
+
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst) {
   if (inst) {
-    opus_decoder_destroy(inst->decoder);
+    if (inst->decoder) {
+      opus_decoder_destroy(inst->decoder);
+    } else {
+      opus_multistream_decoder_destroy(inst->multistream_decoder);
+    }
     free(inst);
     return 0;
   } else {
@@ -223,7 +458,7 @@ int WebRtcOpus_DecoderChannels(OpusDecInst* inst) {
 }
 
 int16_t WebRtcOpus_DecoderInit(OpusDecInst* inst) {
-  int error = opus_decoder_ctl(inst->decoder, OPUS_RESET_STATE);
+  int error = DECODER_CTL(inst, OPUS_RESET_STATE);
   if (error == OPUS_OK) {
     inst->in_dtx_mode = 0;
     return 0;
@@ -232,12 +467,14 @@ int16_t WebRtcOpus_DecoderInit(OpusDecInst* inst) {
 }
 
 /* For decoder to determine if it is to output speech or comfort noise. */
-static int16_t DetermineAudioType(OpusDecInst* inst, int16_t encoded_bytes) {
-  // Audio type becomes comfort noise if |encoded_byte| is 1 and keeps
-  // to be so if the following |encoded_byte| are 0 or 1.
+static int16_t DetermineAudioType(OpusDecInst* inst, const uint8_t* encoded,
+                                  int16_t encoded_bytes) {
+  // Audio type becomes comfort noise if |encoded| is a DTX packet and keeps
+  // to be so if the following packets are empty or DTX packets.
   if (encoded_bytes == 0 && inst->in_dtx_mode) {
     return 2;  // Comfort noise.
-  } else if (encoded_bytes == 1) {
+  } else if (encoded_bytes > 0 &&
+             IsDtxPacket(encoded, encoded_bytes, inst->streams)) {
     inst->in_dtx_mode = 1;
     return 2;  // Comfort noise.
   } else {
@@ -252,13 +489,20 @@ static int16_t DetermineAudioType(OpusDecInst* inst, int16_t encoded_bytes) {
 static int DecodeNative(OpusDecInst* inst, const uint8_t* encoded,
                         int16_t encoded_bytes, int frame_size,
                         int16_t* decoded, int16_t* audio_type, int decode_fec) {
-  int res = opus_decode(inst->decoder, encoded, encoded_bytes,
-                        (opus_int16*)decoded, frame_size, decode_fec);
+  int res;
+  if (inst->decoder) {
+    res = opus_decode(inst->decoder, encoded, encoded_bytes,
+                      (opus_int16*)decoded, frame_size, decode_fec);
+  } else {
+    res = opus_multistream_decode(inst->multistream_decoder, encoded,
+                                  encoded_bytes, (opus_int16*)decoded,
+                                  frame_size, decode_fec);
+  }
 
   if (res <= 0)
     return -1;
 
-  *audio_type = DetermineAudioType(inst, encoded_bytes);
+  *audio_type = DetermineAudioType(inst, encoded, encoded_bytes);
 
   return res;
 }
@@ -269,7 +513,7 @@ int16_t WebRtcOpus_Decode(OpusDecInst* inst, const uint8_t* encoded,
   int decoded_samples;
 
   if (encoded_bytes == 0) {
-    *audio_type = DetermineAudioType(inst, encoded_bytes);
+    *audio_type = DetermineAudioType(inst, encoded, encoded_bytes);
     decoded_samples = WebRtcOpus_DecodePlc(inst, decoded, 1);
   } else {
     decoded_samples = DecodeNative(inst,
@@ -317,6 +561,11 @@ int16_t WebRtcOpus_DecodeFec(OpusDecInst* inst, const uint8_t* encoded,
   int decoded_samples;
   int fec_samples;
 
+  /* WebRtcOpus_PacketHasFec() only parses single stream packets. */
+  if (inst->multistream_decoder) {
+    return 0;
+  }
+
   if (WebRtcOpus_PacketHasFec(encoded, encoded_bytes) != 1) {
     return 0;
   }
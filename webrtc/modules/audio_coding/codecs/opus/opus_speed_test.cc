@@ -101,6 +101,67 @@ ADD_TEST(2);
 ADD_TEST(1);
 ADD_TEST(0);
 
+// Encodes the test audio with a number of encoders, one by one and as a
+// batch, and reports how many streams one core can encode in real time.
+TEST_P(OpusSpeedTest, OpusBatchEncodeThroughput) {
+  const int kNumStreams = 16;
+  const size_t kDurationSec = 50;
+  const size_t block_samples = input_length_sample_ * channels_;
+  WebRtcOpusEncInst* single_encoders[kNumStreams];
+  WebRtcOpusEncInst* batch_encoders[kNumStreams];
+  int16_t encoded_lengths[kNumStreams];
+  OpusBatchInst* batch = NULL;
+  EXPECT_EQ(0, WebRtcOpus_BatchCreate(&batch, channels_));
+  for (int i = 0; i < kNumStreams; ++i) {
+    EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&single_encoders[i], channels_));
+    EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&batch_encoders[i], channels_));
+    EXPECT_EQ(0, WebRtcOpus_SetBitRate(single_encoders[i], bit_rate_));
+    EXPECT_EQ(0, WebRtcOpus_SetBitRate(batch_encoders[i], bit_rate_));
+  }
+  // One output buffer holds the packets of a batch.
+  scoped_ptr<uint8_t[]> bit_stream(new uint8_t[kNumStreams * max_bytes_]);
+
+  clock_t single_clocks = 0;
+  clock_t batch_clocks = 0;
+  size_t data_pointer = 0;
+  for (size_t time_now_ms = 0; time_now_ms < kDurationSec * 1000;
+       time_now_ms += block_duration_ms_) {
+    const int16_t* audio = &in_data_[data_pointer];
+    data_pointer = (data_pointer + block_samples) % loop_length_samples_;
+
+    clock_t start = clock();
+    for (int i = 0; i < kNumStreams; ++i) {
+      EXPECT_GE(WebRtcOpus_Encode(single_encoders[i], audio,
+                                  input_length_sample_, max_bytes_,
+                                  &bit_stream[i * max_bytes_]),
+                0);
+    }
+    single_clocks += clock() - start;
+
+    start = clock();
+    EXPECT_GE(WebRtcOpus_EncodeBatch(batch, batch_encoders, kNumStreams,
+                                     audio, input_length_sample_,
+                                     kNumStreams * max_bytes_, &bit_stream[0],
+                                     encoded_lengths),
+              0);
+    batch_clocks += clock() - start;
+  }
+
+  const double single_sec = static_cast<double>(single_clocks) /
+      CLOCKS_PER_SEC;
+  const double batch_sec = static_cast<double>(batch_clocks) / CLOCKS_PER_SEC;
+  printf("Encoding %d streams one by one: %.1f streams per core.\n",
+         kNumStreams, kDurationSec * kNumStreams / single_sec);
+  printf("Encoding %d streams as a batch: %.1f streams per core.\n",
+         kNumStreams, kDurationSec * kNumStreams / batch_sec);
+
+  for (int i = 0; i < kNumStreams; ++i) {
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(single_encoders[i]));
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(batch_encoders[i]));
+  }
+  EXPECT_EQ(0, WebRtcOpus_BatchFree(batch));
+}
+
 // List all test cases: (channel, bit rat, filename, extension).
 const coding_param param_set[] =
     {::std::tr1::make_tuple(1, 64000,
@@ -7,6 +7,8 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+#include <string.h>
+
 #include <string>
 
 #include "testing/gtest/include/gtest/gtest.h"
@@ -597,4 +599,214 @@ TEST_F(OpusTest, OpusDurationEstimation) {
   EXPECT_EQ(0, WebRtcOpus_DecoderFree(opus_stereo_decoder_));
 }
 
+// Test failing multistream Create.
+TEST_F(OpusTest, OpusMultistreamCreateFail) {
+  OpusEncInst* encoder = NULL;
+  OpusDecInst* decoder = NULL;
+  // Test to see that an invalid pointer is caught.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(NULL, 6, 3, 3, NULL));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(NULL, 6, 3, 3, NULL));
+  // No channels.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&encoder, 0, 1, 0, NULL));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(&decoder, 0, 1, 0, NULL));
+  // The default mapping needs the channels to fill the streams.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&encoder, 6, 2, 1, NULL));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(&decoder, 6, 2, 1, NULL));
+  // A mapping to a channel the streams don't have.
+  const uint8_t kMapping[] = {0, 1, 2, 3};
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&encoder, 4, 2, 0,
+                                                    kMapping));
+}
+
+// Six channels coded as three stereo streams.
+TEST_F(OpusTest, OpusEncodeDecodeMultistream) {
+  const int kChannels = 6;
+  PrepareSpeechData(kChannels, 20, 20);
+
+  // Create encoder memory.
+  OpusEncInst* encoder = NULL;
+  OpusDecInst* decoder = NULL;
+  EXPECT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(&encoder, kChannels, 3, 3,
+                                                   NULL));
+  EXPECT_EQ(0, WebRtcOpus_MultistreamDecoderCreate(&decoder, kChannels, 3, 3,
+                                                   NULL));
+  EXPECT_TRUE(encoder->multistream_encoder != NULL);
+  EXPECT_TRUE(decoder->multistream_decoder != NULL);
+
+  // The encoder settings apply to all streams.
+  EXPECT_EQ(0, WebRtcOpus_SetBitRate(encoder, 192000));
+  EXPECT_EQ(0, WebRtcOpus_SetComplexity(encoder, 9));
+  EXPECT_EQ(0, WebRtcOpus_EnableFec(encoder));
+  EXPECT_EQ(0, WebRtcOpus_SetPacketLossRate(encoder, 10));
+  EXPECT_EQ(0, WebRtcOpus_SetMaxPlaybackRate(encoder, 24000));
+  // The multistream encoder doesn't report the maximum bandwidth, so ask the
+  // encoder of the last stream.
+  OpusEncoder* stream_encoder = NULL;
+  EXPECT_EQ(OPUS_OK, opus_multistream_encoder_ctl(
+      encoder->multistream_encoder,
+      OPUS_MULTISTREAM_GET_ENCODER_STATE(2, &stream_encoder)));
+  opus_int32 bandwidth = 0;
+  opus_encoder_ctl(stream_encoder, OPUS_GET_MAX_BANDWIDTH(&bandwidth));
+  EXPECT_EQ(OPUS_BANDWIDTH_SUPERWIDEBAND, bandwidth);
+
+  // Check number of channels for decoder.
+  EXPECT_EQ(kChannels, WebRtcOpus_DecoderChannels(decoder));
+
+  // Encode & decode.
+  int16_t audio_type;
+  int16_t output_data_decode[kOpus20msFrameSamples * kChannels];
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(kOpus20msFrameSamples,
+              EncodeDecode(encoder, speech_data_.GetNextBlock(),
+                           kOpus20msFrameSamples, decoder,
+                           output_data_decode, &audio_type));
+    EXPECT_GT(encoded_bytes_, 3);
+    EXPECT_EQ(0, audio_type);  // Speech.
+    EXPECT_EQ(kOpus20msFrameSamples,
+              WebRtcOpus_DurationEst(decoder, bitstream_, encoded_bytes_));
+  }
+  EXPECT_EQ(0, WebRtcOpus_DecodeFec(decoder, bitstream_, encoded_bytes_,
+                                    output_data_decode, &audio_type));
+
+  // Call decoder PLC.
+  int16_t plc_buffer[kOpus20msFrameSamples * kChannels];
+  EXPECT_EQ(kOpus20msFrameSamples,
+            WebRtcOpus_DecodePlc(decoder, plc_buffer, 1));
+  EXPECT_EQ(0, WebRtcOpus_DecoderInit(decoder));
+
+  // Free memory.
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(encoder));
+  EXPECT_EQ(0, WebRtcOpus_DecoderFree(decoder));
+}
+
+// A multistream encoder in DTX sends a header for each of its streams, which
+// both ends must detect as DTX.
+TEST_F(OpusTest, OpusMultistreamDtx) {
+  const int kChannels = 4;
+  const int kStreams = 2;
+  PrepareSpeechData(kChannels, 20, 200);
+
+  // Create encoder memory.
+  OpusEncInst* encoder = NULL;
+  OpusDecInst* decoder = NULL;
+  EXPECT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(&encoder, kChannels,
+                                                   kStreams, kStreams, NULL));
+  EXPECT_EQ(0, WebRtcOpus_MultistreamDecoderCreate(&decoder, kChannels,
+                                                   kStreams, kStreams, NULL));
+  EXPECT_EQ(0, WebRtcOpus_EnableDtx(encoder));
+
+  int16_t silence[kOpus20msFrameSamples * kChannels] = {0};
+  int16_t audio_type;
+  int16_t output_data_decode[kOpus20msFrameSamples * kChannels];
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(kOpus20msFrameSamples,
+              EncodeDecode(encoder, speech_data_.GetNextBlock(),
+                           kOpus20msFrameSamples, decoder,
+                           output_data_decode, &audio_type));
+  }
+
+  // DTX may happen after a while. The DTX packet has a TOC byte and a zero
+  // frame length for the self-delimited first stream, and a TOC byte for the
+  // last stream.
+  bool entered_dtx = false;
+  for (int i = 0; i < 22 && !entered_dtx; ++i) {
+    EXPECT_EQ(kOpus20msFrameSamples,
+              EncodeDecode(encoder, silence, kOpus20msFrameSamples, decoder,
+                           output_data_decode, &audio_type));
+    entered_dtx = encoder->in_dtx_mode == 1;
+  }
+  ASSERT_TRUE(entered_dtx) << "Opus should have entered DTX mode.";
+  EXPECT_EQ(3, encoded_bytes_);
+  EXPECT_EQ(1, decoder->in_dtx_mode);
+  EXPECT_EQ(2, audio_type);  // Comfort noise.
+
+  // Nothing is sent while in DTX.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(kOpus20msFrameSamples,
+              EncodeDecode(encoder, silence, kOpus20msFrameSamples, decoder,
+                           output_data_decode, &audio_type));
+    EXPECT_EQ(0, encoded_bytes_);
+    EXPECT_EQ(1, encoder->in_dtx_mode);
+    EXPECT_EQ(1, decoder->in_dtx_mode);
+    EXPECT_EQ(2, audio_type);  // Comfort noise.
+  }
+
+  // Free memory.
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(encoder));
+  EXPECT_EQ(0, WebRtcOpus_DecoderFree(decoder));
+}
+
+// A batch encode gives the same packets as encoding with the encoders one by
+// one.
+TEST_F(OpusTest, OpusEncodeBatch) {
+  const int kEncoders = 3;
+  PrepareSpeechData(2, 20, 60);
+  OpusBatchInst* batch = NULL;
+  EXPECT_EQ(-1, WebRtcOpus_BatchCreate(NULL, 2));
+  EXPECT_EQ(-1, WebRtcOpus_BatchCreate(&batch, 0));
+  EXPECT_EQ(0, WebRtcOpus_BatchCreate(&batch, 2));
+
+  OpusEncInst* batch_encoders[kEncoders];
+  OpusEncInst* single_encoders[kEncoders];
+  for (int i = 0; i < kEncoders; ++i) {
+    EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&batch_encoders[i], 2));
+    EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&single_encoders[i], 2));
+    EXPECT_EQ(0, WebRtcOpus_SetBitRate(batch_encoders[i], 24000 * (i + 1)));
+    EXPECT_EQ(0, WebRtcOpus_SetBitRate(single_encoders[i], 24000 * (i + 1)));
+  }
+
+  // The output buffer holds the packets of one batch, but not a worst case
+  // packet for each encoder.
+  uint8_t batch_bitstream[kMaxBytes];
+  int16_t encoded_lengths[kEncoders];
+  for (int frame = 0; frame < 10; ++frame) {
+    const int16_t* audio = speech_data_.GetNextBlock();
+    int total_bytes = WebRtcOpus_EncodeBatch(batch, batch_encoders, kEncoders,
+                                             audio, kOpus20msFrameSamples,
+                                             kMaxBytes, batch_bitstream,
+                                             encoded_lengths);
+    int offset = 0;
+    for (int i = 0; i < kEncoders; ++i) {
+      encoded_bytes_ = WebRtcOpus_Encode(single_encoders[i], audio,
+                                         kOpus20msFrameSamples, kMaxBytes,
+                                         bitstream_);
+      ASSERT_GT(encoded_bytes_, 1);
+      ASSERT_EQ(encoded_bytes_, encoded_lengths[i]);
+      EXPECT_EQ(0, memcmp(bitstream_, &batch_bitstream[offset],
+                          encoded_bytes_)) << "Frame " << frame;
+      offset += encoded_bytes_;
+    }
+    EXPECT_EQ(offset, total_bytes);
+  }
+
+  // Packets which don't fit, frames which are too long and encoders with a
+  // different number of channels fail.
+  const int16_t* audio = speech_data_.GetNextBlock();
+  EXPECT_EQ(-1, WebRtcOpus_EncodeBatch(batch, batch_encoders, kEncoders, audio,
+                                       kOpus20msFrameSamples, 2,
+                                       batch_bitstream, encoded_lengths));
+  EXPECT_EQ(-1, encoded_lengths[0]);
+  EXPECT_EQ(-1, WebRtcOpus_EncodeBatch(batch, batch_encoders, kEncoders, audio,
+                                       kOpusRateKhz * 120, kMaxBytes,
+                                       batch_bitstream, encoded_lengths));
+  for (int i = 0; i < kEncoders; ++i)
+    EXPECT_EQ(-1, encoded_lengths[i]);
+  OpusEncInst* mono_encoder = NULL;
+  EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&mono_encoder, 1));
+  EXPECT_EQ(-1, WebRtcOpus_EncodeBatch(batch, &mono_encoder, 1, audio,
+                                       kOpus20msFrameSamples, kMaxBytes,
+                                       batch_bitstream, encoded_lengths));
+  EXPECT_EQ(-1, encoded_lengths[0]);
+
+  // Free memory.
+  for (int i = 0; i < kEncoders; ++i) {
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(batch_encoders[i]));
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(single_encoders[i]));
+  }
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(mono_encoder));
+  EXPECT_EQ(0, WebRtcOpus_BatchFree(batch));
+  EXPECT_EQ(-1, WebRtcOpus_BatchFree(NULL));
+}
+
 }  // namespace webrtc
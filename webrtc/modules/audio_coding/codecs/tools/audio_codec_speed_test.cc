@@ -95,6 +95,7 @@ void AudioCodecSpeedTest::TearDown() {
 
 void AudioCodecSpeedTest::EncodeDecode(size_t audio_duration_sec) {
   size_t time_now_ms = 0;
+  int num_blocks = 0;
   float time_ms;
 
   printf("Coding %d kHz-sampled %d-channel audio at %d bps ...\n",
@@ -114,11 +115,15 @@ void AudioCodecSpeedTest::EncodeDecode(size_t audio_duration_sec) {
     data_pointer_ = (data_pointer_ + input_length_sample_ * channels_) %
         loop_length_samples_;
     time_now_ms += block_duration_ms_;
+    ++num_blocks;
   }
 
   printf("Encoding: %.2f%% real time,\nDecoding: %.2f%% real time.\n",
          (encoding_time_ms_ / audio_duration_sec) / 10.0,
          (decoding_time_ms_ / audio_duration_sec) / 10.0);
+  printf("Per %d ms frame: encoding %.1f us, decoding %.1f us.\n",
+         block_duration_ms_, 1000.0 * encoding_time_ms_ / num_blocks,
+         1000.0 * decoding_time_ms_ / num_blocks);
 }
 
 }  // namespace webrtc
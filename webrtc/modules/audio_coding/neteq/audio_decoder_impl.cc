@@ -242,9 +242,17 @@ void AudioDecoderG722Stereo::SplitStereoPacket(const uint8_t* encoded,
 // Opus
 #ifdef WEBRTC_CODEC_OPUS
 AudioDecoderOpus::AudioDecoderOpus(int num_channels) {
-  DCHECK(num_channels == 1 || num_channels == 2);
+  DCHECK_GT(num_channels, 0);
   channels_ = num_channels;
-  WebRtcOpus_DecoderCreate(&dec_state_, static_cast<int>(channels_));
+  if (num_channels <= 2) {
+    WebRtcOpus_DecoderCreate(&dec_state_, num_channels);
+  } else {
+    // AudioEncoderOpus codes the channels pairwise as stereo streams, with a
+    // mono stream for the last channel if the number of channels is odd.
+    WebRtcOpus_MultistreamDecoderCreate(&dec_state_, num_channels,
+                                        (num_channels + 1) / 2,
+                                        num_channels / 2, NULL);
+  }
 }
 
 AudioDecoderOpus::~AudioDecoderOpus() {
@@ -293,6 +301,9 @@ int AudioDecoderOpus::PacketDurationRedundant(const uint8_t* encoded,
 
 bool AudioDecoderOpus::PacketHasFec(const uint8_t* encoded,
                                     size_t encoded_len) const {
+  // FEC is not decoded from multistream packets.
+  if (channels_ > 2)
+    return false;
   int fec;
   fec = WebRtcOpus_PacketHasFec(encoded, static_cast<int>(encoded_len));
   return (fec == 1);
@@ -465,6 +465,20 @@ class AudioDecoderOpusStereoTest : public AudioDecoderOpusTest {
   }
 };
 
+class AudioDecoderOpusMultichannelTest : public AudioDecoderOpusTest {
+ protected:
+  AudioDecoderOpusMultichannelTest() : AudioDecoderOpusTest() {
+    channels_ = 6;
+    delete decoder_;
+    decoder_ = new AudioDecoderOpus(6);
+    AudioEncoderOpus::Config config;
+    config.frame_size_ms = static_cast<int>(frame_size_) / 48;
+    config.num_channels = 6;
+    config.payload_type = payload_type_;
+    audio_encoder_.reset(new AudioEncoderOpus(config));
+  }
+};
+
 TEST_F(AudioDecoderPcmUTest, EncodeDecode) {
   int tolerance = 251;
   double mse = 1734.0;
@@ -590,6 +604,15 @@ TEST_F(AudioDecoderOpusStereoTest, EncodeDecode) {
   EXPECT_FALSE(decoder_->HasDecodePlc());
 }
 
+TEST_F(AudioDecoderOpusMultichannelTest, EncodeDecode) {
+  int tolerance = 6176;
+  double mse = 238630.0;
+  int delay = 22;  // Delay from input to output.
+  EncodeDecodeTest(0, tolerance, mse, delay);
+  ReInitTest();
+  EXPECT_FALSE(decoder_->HasDecodePlc());
+}
+
 TEST(AudioDecoder, CodecSampleRateHz) {
   EXPECT_EQ(8000, CodecSampleRateHz(kDecoderPCMu));
   EXPECT_EQ(8000, CodecSampleRateHz(kDecoderPCMa));
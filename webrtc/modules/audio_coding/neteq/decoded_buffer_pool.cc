@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/interface/decoded_buffer_pool.h"
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/ref_count.h"
+
+namespace webrtc {
+
+DecodedBufferPool* DecodedBufferPool::Create() {
+  return new RefCountImpl<DecodedBufferPool>();
+}
+
+DecodedBufferPool::DecodedBufferPool()
+    : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()) {}
+
+DecodedBufferPool::~DecodedBufferPool() {
+  for (BufferMap::iterator it = free_buffers_.begin();
+       it != free_buffers_.end(); ++it) {
+    delete [] it->second;
+  }
+}
+
+int16_t* DecodedBufferPool::Get(size_t length) {
+  {
+    CriticalSectionScoped lock(crit_sect_.get());
+    BufferMap::iterator it = free_buffers_.find(length);
+    if (it != free_buffers_.end()) {
+      int16_t* buffer = it->second;
+      free_buffers_.erase(it);
+      return buffer;
+    }
+  }
+  return new int16_t[length];
+}
+
+void DecodedBufferPool::Put(int16_t* buffer, size_t length) {
+  CriticalSectionScoped lock(crit_sect_.get());
+  free_buffers_.insert(std::make_pair(length, buffer));
+}
+
+size_t DecodedBufferPool::NumFreeBuffers() const {
+  CriticalSectionScoped lock(crit_sect_.get());
+  return free_buffers_.size();
+}
+
+}  // namespace webrtc
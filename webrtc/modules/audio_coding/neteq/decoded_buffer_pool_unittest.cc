@@ -0,0 +1,41 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Unit tests for DecodedBufferPool class.
+
+#include "webrtc/modules/audio_coding/neteq/interface/decoded_buffer_pool.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/scoped_refptr.h"
+
+namespace webrtc {
+
+TEST(DecodedBufferPool, ReusesBuffersOfSameLength) {
+  scoped_refptr<DecodedBufferPool> pool(DecodedBufferPool::Create());
+  int16_t* buffer = pool->Get(100);
+  pool->Put(buffer, 100);
+  EXPECT_EQ(1u, pool->NumFreeBuffers());
+  EXPECT_EQ(buffer, pool->Get(100));
+  EXPECT_EQ(0u, pool->NumFreeBuffers());
+  pool->Put(buffer, 100);
+}
+
+TEST(DecodedBufferPool, AllocatesBufferOfOtherLength) {
+  scoped_refptr<DecodedBufferPool> pool(DecodedBufferPool::Create());
+  int16_t* buffer = pool->Get(100);
+  pool->Put(buffer, 100);
+  int16_t* longer_buffer = pool->Get(200);
+  EXPECT_NE(buffer, longer_buffer);
+  EXPECT_EQ(1u, pool->NumFreeBuffers());
+  pool->Put(longer_buffer, 200);
+  EXPECT_EQ(2u, pool->NumFreeBuffers());
+}
+
+}  // namespace webrtc
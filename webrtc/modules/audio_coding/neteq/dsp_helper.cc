@@ -16,6 +16,10 @@
 #include <algorithm>  // Access to min, max.
 
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "webrtc/modules/audio_coding/neteq/dsp_helper_sse2.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#endif
 
 namespace webrtc {
 
@@ -235,9 +239,10 @@ void DspHelper::ParabolicFit(int16_t* signal_points, int fs_mult,
   }
 }
 
-int DspHelper::MinDistortion(const int16_t* signal, int min_lag,
-                             int max_lag, int length,
-                             int32_t* distortion_value) {
+namespace {
+
+int MinDistortionC(const int16_t* signal, int min_lag, int max_lag,
+                   int length, int32_t* distortion_value) {
   int best_index = -1;
   int32_t min_distortion = WEBRTC_SPL_WORD32_MAX;
   for (int i = min_lag; i <= max_lag; i++) {
@@ -257,6 +262,27 @@ int DspHelper::MinDistortion(const int16_t* signal, int min_lag,
   return best_index;
 }
 
+}  // namespace
+
+int DspHelper::MinDistortion(const int16_t* signal, int min_lag,
+                             int max_lag, int length,
+                             int32_t* distortion_value) {
+  static int (*min_distortion_proc)(const int16_t*, int, int, int,
+                                    int32_t*) = NULL;
+
+  if (!min_distortion_proc) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    min_distortion_proc = WebRtc_GetCPUInfo(kSSE2) ? &MinDistortionSSE2 :
+                                                     &MinDistortionC;
+#else
+    min_distortion_proc = &MinDistortionC;
+#endif
+  }
+
+  return min_distortion_proc(signal, min_lag, max_lag, length,
+                             distortion_value);
+}
+
 void DspHelper::CrossFade(const int16_t* input1, const int16_t* input2,
                           size_t length, int16_t* mix_factor,
                           int16_t factor_decrement, int16_t* output) {
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/dsp_helper_sse2.h"
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+namespace webrtc {
+
+int MinDistortionSSE2(const int16_t* signal, int min_lag, int max_lag,
+                      int length, int32_t* distortion_value) {
+  const __m128i zero = _mm_setzero_si128();
+  int best_index = -1;
+  int32_t min_distortion = WEBRTC_SPL_WORD32_MAX;
+  for (int i = min_lag; i <= max_lag; i++) {
+    const int16_t* data1 = signal;
+    const int16_t* data2 = signal - i;
+    __m128i sum_32x4 = zero;
+    int j = 0;
+    for (; j + 8 <= length; j += 8) {
+      __m128i data1_16x8 = _mm_loadu_si128((const __m128i*)&data1[j]);
+      __m128i data2_16x8 = _mm_loadu_si128((const __m128i*)&data2[j]);
+      // The absolute difference is at most 65535, so it fits in 16 bits when
+      // treated as unsigned, and is zero-extended before it is accumulated.
+      __m128i diff_16x8 = _mm_sub_epi16(_mm_max_epi16(data1_16x8, data2_16x8),
+                                        _mm_min_epi16(data1_16x8, data2_16x8));
+      sum_32x4 = _mm_add_epi32(sum_32x4, _mm_unpacklo_epi16(diff_16x8, zero));
+      sum_32x4 = _mm_add_epi32(sum_32x4, _mm_unpackhi_epi16(diff_16x8, zero));
+    }
+    sum_32x4 = _mm_add_epi32(
+        sum_32x4, _mm_shuffle_epi32(sum_32x4, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum_32x4 = _mm_add_epi32(
+        sum_32x4, _mm_shuffle_epi32(sum_32x4, _MM_SHUFFLE(2, 3, 0, 1)));
+    int32_t sum_diff = _mm_cvtsi128_si32(sum_32x4);
+    for (; j < length; j++) {
+      sum_diff += WEBRTC_SPL_ABS_W32(data1[j] - data2[j]);
+    }
+    // Compare with previous minimum.
+    if (sum_diff < min_distortion) {
+      min_distortion = sum_diff;
+      best_index = i;
+    }
+  }
+  *distortion_value = min_distortion;
+  return best_index;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,27 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This header file is used only by dsp_helper.cc. It declares the SSE2
+// versions of the DspHelper methods.
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_DSP_HELPER_SSE2_H_
+#define WEBRTC_MODULES_AUDIO_CODING_NETEQ_DSP_HELPER_SSE2_H_
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// SSE2 version of DspHelper::MinDistortion().
+int MinDistortionSSE2(const int16_t* signal, int min_lag, int max_lag,
+                      int length, int32_t* distortion_value);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_DSP_HELPER_SSE2_H_
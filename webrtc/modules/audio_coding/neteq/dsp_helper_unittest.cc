@@ -10,7 +10,10 @@
 
 #include "webrtc/modules/audio_coding/neteq/dsp_helper.h"
 
+#include <stdlib.h>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/modules/audio_coding/neteq/audio_multi_vector.h"
 #include "webrtc/typedefs.h"
 
@@ -86,4 +89,57 @@ TEST(DspHelper, RampSignalAudioMultiVector) {
     }
   }
 }
+
+TEST(DspHelper, MinDistortionFindsPeriod) {
+  const int kPeriod = 37;
+  const int kMaxLag = 60;
+  const int kLength = 100;
+  int16_t signal[kMaxLag + kLength];
+  for (int i = 0; i < kMaxLag + kLength; ++i) {
+    signal[i] = static_cast<int16_t>(((i % kPeriod) * 1783) % 20000 - 10000);
+  }
+  int32_t distortion = -1;
+  EXPECT_EQ(kPeriod, DspHelper::MinDistortion(&signal[kMaxLag], 20, kMaxLag,
+                                              kLength, &distortion));
+  EXPECT_EQ(0, distortion);
+}
+
+// The vector versions must give the same result as the plain sum of absolute
+// differences, also for samples at the ends of the 16-bit range.
+TEST(DspHelper, MinDistortionMatchesReference) {
+  const int kMaxLag = 40;
+  const int kMaxLength = 70;
+  int16_t signal[kMaxLag + kMaxLength];
+  srand(17);
+  for (int length = 1; length <= kMaxLength; ++length) {
+    for (int i = 0; i < kMaxLag + kMaxLength; ++i) {
+      switch (rand() % 8) {
+        case 0:
+          signal[i] = WEBRTC_SPL_WORD16_MIN;
+          break;
+        case 1:
+          signal[i] = WEBRTC_SPL_WORD16_MAX;
+          break;
+        default:
+          signal[i] = static_cast<int16_t>(rand());
+      }
+    }
+    const int16_t* data = &signal[kMaxLag];
+    int expected_index = -1;
+    int32_t expected_distortion = WEBRTC_SPL_WORD32_MAX;
+    for (int lag = 1; lag <= kMaxLag; ++lag) {
+      int32_t sum = 0;
+      for (int j = 0; j < length; ++j)
+        sum += abs(data[j] - data[j - lag]);
+      if (sum < expected_distortion) {
+        expected_distortion = sum;
+        expected_index = lag;
+      }
+    }
+    int32_t distortion = -1;
+    EXPECT_EQ(expected_index,
+              DspHelper::MinDistortion(data, 1, kMaxLag, length, &distortion));
+    EXPECT_EQ(expected_distortion, distortion);
+  }
+}
 }  // namespace webrtc
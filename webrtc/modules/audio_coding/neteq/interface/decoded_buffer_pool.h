@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_INTERFACE_DECODED_BUFFER_POOL_H_
+#define WEBRTC_MODULES_AUDIO_CODING_NETEQ_INTERFACE_DECODED_BUFFER_POOL_H_
+
+#include <stddef.h>
+
+#include <map>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+
+// Decode buffers for NetEq instances in compact memory mode. An instance only
+// borrows a buffer for the duration of a GetAudio() call, so a pool shared by
+// the instances decoding on a group of threads holds about as many buffers as
+// there are threads in the group. The pool is reference counted and is kept
+// alive by every instance using it.
+class DecodedBufferPool {
+ public:
+  // Creates a pool with no references, to be held by a scoped_refptr.
+  static DecodedBufferPool* Create();
+
+  virtual int32_t AddRef() = 0;
+  virtual int32_t Release() = 0;
+
+  // Returns a buffer of |length| samples.
+  int16_t* Get(size_t length);
+  // Returns |buffer| to the pool. |length| must be the length that |buffer|
+  // was obtained with.
+  void Put(int16_t* buffer, size_t length);
+
+  // Returns the number of buffers not in use.
+  size_t NumFreeBuffers() const;
+
+ protected:
+  DecodedBufferPool();
+  virtual ~DecodedBufferPool();
+
+ private:
+  typedef std::multimap<size_t, int16_t*> BufferMap;
+
+  scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  BufferMap free_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(DecodedBufferPool);
+};
+
+}  // namespace webrtc
+#endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_INTERFACE_DECODED_BUFFER_POOL_H_
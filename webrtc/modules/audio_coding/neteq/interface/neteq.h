@@ -23,6 +23,7 @@
 namespace webrtc {
 
 // Forward declarations.
+class DecodedBufferPool;
 struct WebRtcRTPHeader;
 
 struct NetEqNetworkStatistics {
@@ -75,7 +76,9 @@ class NetEq {
           // |max_delay_ms| has the same effect as calling SetMaximumDelay().
           max_delay_ms(2000),
           background_noise_mode(kBgnOff),
-          playout_mode(kPlayoutOn) {}
+          playout_mode(kPlayoutOn),
+          compact_memory(false),
+          decoded_buffer_pool(NULL) {}
 
     int sample_rate_hz;  // Initial vale. Will change with input data.
     bool enable_audio_classifier;
@@ -83,6 +86,16 @@ class NetEq {
     int max_delay_ms;
     BackgroundNoiseMode background_noise_mode;
     NetEqPlayoutMode playout_mode;
+    // Reduces the memory held by each instance, for servers decoding a large
+    // number of streams. The decode buffer is borrowed from
+    // |decoded_buffer_pool| for the duration of each GetAudio() call, and the
+    // sync buffer is sized after the current sample rate rather than the worst
+    // case. The output is the same as without compact memory.
+    bool compact_memory;
+    // Pool to borrow decode buffers from in compact memory mode, typically
+    // shared by the instances decoding on the same threads. The instance keeps
+    // a reference to the pool. If NULL, the instance gets a pool of its own.
+    DecodedBufferPool* decoded_buffer_pool;
   };
 
   enum ReturnCodes {
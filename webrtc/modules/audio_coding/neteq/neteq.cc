@@ -18,6 +18,7 @@
 #include "webrtc/modules/audio_coding/neteq/dtmf_buffer.h"
 #include "webrtc/modules/audio_coding/neteq/dtmf_tone_generator.h"
 #include "webrtc/modules/audio_coding/neteq/expand.h"
+#include "webrtc/modules/audio_coding/neteq/interface/decoded_buffer_pool.h"
 #include "webrtc/modules/audio_coding/neteq/neteq_impl.h"
 #include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 #include "webrtc/modules/audio_coding/neteq/payload_splitter.h"
@@ -44,6 +45,12 @@ NetEq* NetEq::Create(const NetEq::Config& config) {
   ExpandFactory* expand_factory = new ExpandFactory;
   PreemptiveExpandFactory* preemptive_expand_factory =
       new PreemptiveExpandFactory;
+  DecodedBufferPool* decoded_buffer_pool = NULL;
+  if (config.compact_memory) {
+    decoded_buffer_pool = config.decoded_buffer_pool
+                              ? config.decoded_buffer_pool
+                              : DecodedBufferPool::Create();
+  }
   return new NetEqImpl(config,
                        buffer_level_filter,
                        decoder_database,
@@ -56,7 +63,8 @@ NetEq* NetEq::Create(const NetEq::Config& config) {
                        timestamp_scaler,
                        accelerate_factory,
                        expand_factory,
-                       preemptive_expand_factory);
+                       preemptive_expand_factory,
+                       decoded_buffer_pool);
 }
 
 }  // namespace webrtc
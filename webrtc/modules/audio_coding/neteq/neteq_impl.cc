@@ -62,6 +62,7 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
                      AccelerateFactory* accelerate_factory,
                      ExpandFactory* expand_factory,
                      PreemptiveExpandFactory* preemptive_expand_factory,
+                     DecodedBufferPool* decoded_buffer_pool,
                      bool create_components)
     : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
       buffer_level_filter_(buffer_level_filter),
@@ -78,8 +79,11 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
       accelerate_factory_(accelerate_factory),
       preemptive_expand_factory_(preemptive_expand_factory),
       last_mode_(kModeNormal),
+      compact_memory_(config.compact_memory),
+      decoded_buffer_pool_(decoded_buffer_pool),
       decoded_buffer_length_(kMaxFrameSize),
-      decoded_buffer_(new int16_t[decoded_buffer_length_]),
+      decoded_buffer_(decoded_buffer_pool_.get()
+                          ? NULL : new int16_t[decoded_buffer_length_]),
       playout_timestamp_(0),
       new_codec_(false),
       timestamp_(0),
@@ -161,8 +165,15 @@ int NetEqImpl::GetAudio(size_t max_length, int16_t* output_audio,
                         NetEqOutputType* type) {
   CriticalSectionScoped lock(crit_sect_.get());
   LOG(LS_VERBOSE) << "GetAudio";
+  if (decoded_buffer_pool_.get()) {
+    decoded_buffer_.reset(decoded_buffer_pool_->Get(decoded_buffer_length_));
+  }
   int error = GetAudioInternal(max_length, output_audio, samples_per_channel,
                                num_channels);
+  if (decoded_buffer_pool_.get()) {
+    decoded_buffer_pool_->Put(decoded_buffer_.release(),
+                              decoded_buffer_length_);
+  }
   LOG(LS_VERBOSE) << "Produced " << *samples_per_channel <<
       " samples/channel for " << *num_channels << " channel(s)";
   if (error != 0) {
@@ -1880,7 +1891,12 @@ void NetEqImpl::SetSampleRateAndChannels(int fs_hz, size_t channels) {
   algorithm_buffer_.reset(new AudioMultiVector(channels));
 
   // Delete sync buffer and create a new one.
-  sync_buffer_.reset(new SyncBuffer(channels, kSyncBufferSize * fs_mult_));
+  size_t sync_buffer_length = kSyncBufferSize * fs_mult_;
+  if (compact_memory_) {
+    sync_buffer_length =
+        kMaxFrameSize + kCompactSyncBufferHistoryMs * 8 * fs_mult_;
+  }
+  sync_buffer_.reset(new SyncBuffer(channels, sync_buffer_length));
 
   // Delete BackgroundNoise object and create a new one.
   background_noise_.reset(new BackgroundNoise(channels));
@@ -1911,8 +1927,16 @@ void NetEqImpl::SetSampleRateAndChannels(int fs_hz, size_t channels) {
   // Verify that |decoded_buffer_| is long enough.
   if (decoded_buffer_length_ < kMaxFrameSize * channels) {
     // Reallocate to larger size.
+    if (!decoded_buffer_pool_.get()) {
+      decoded_buffer_.reset(new int16_t[kMaxFrameSize * channels]);
+    } else if (decoded_buffer_.get()) {
+      // Inside GetAudio(); swap the borrowed buffer for a larger one.
+      decoded_buffer_pool_->Put(decoded_buffer_.release(),
+                                decoded_buffer_length_);
+      decoded_buffer_.reset(
+          decoded_buffer_pool_->Get(kMaxFrameSize * channels));
+    }
     decoded_buffer_length_ = kMaxFrameSize * channels;
-    decoded_buffer_.reset(new int16_t[decoded_buffer_length_]);
   }
 
   // Create DecisionLogic if it is not created yet, then communicate new sample
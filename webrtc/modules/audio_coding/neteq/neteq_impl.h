@@ -17,12 +17,14 @@
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/audio_coding/neteq/audio_multi_vector.h"
 #include "webrtc/modules/audio_coding/neteq/defines.h"
+#include "webrtc/modules/audio_coding/neteq/interface/decoded_buffer_pool.h"
 #include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
 #include "webrtc/modules/audio_coding/neteq/packet.h"  // Declare PacketList.
 #include "webrtc/modules/audio_coding/neteq/random_vector.h"
 #include "webrtc/modules/audio_coding/neteq/rtcp.h"
 #include "webrtc/modules/audio_coding/neteq/statistics_calculator.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_refptr.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -57,7 +59,9 @@ struct PreemptiveExpandFactory;
 class NetEqImpl : public webrtc::NetEq {
  public:
   // Creates a new NetEqImpl object. The object will assume ownership of all
-  // injected dependencies, and will delete them when done.
+  // injected dependencies, and will delete them when done. The decode buffer
+  // is borrowed from |decoded_buffer_pool| if not NULL; the pool is reference
+  // counted and may be shared with other instances.
   NetEqImpl(const NetEq::Config& config,
             BufferLevelFilter* buffer_level_filter,
             DecoderDatabase* decoder_database,
@@ -71,6 +75,7 @@ class NetEqImpl : public webrtc::NetEq {
             AccelerateFactory* accelerate_factory,
             ExpandFactory* expand_factory,
             PreemptiveExpandFactory* preemptive_expand_factory,
+            DecodedBufferPool* decoded_buffer_pool,
             bool create_components = true);
 
   virtual ~NetEqImpl();
@@ -204,6 +209,9 @@ class NetEqImpl : public webrtc::NetEq {
   static const int kMaxFrameSize = 2880;  // 60 ms @ 48 kHz.
   // TODO(hlundin): Provide a better value for kSyncBufferSize.
   static const int kSyncBufferSize = 2 * kMaxFrameSize;
+  // In compact memory mode, the sync buffer holds one maximum-size decoded
+  // frame plus this much history at the current sample rate.
+  static const int kCompactSyncBufferHistoryMs = 120;
 
   // Inserts a new packet into NetEq. This is used by the InsertPacket method
   // above. Returns 0 on success, otherwise an error code.
@@ -373,7 +381,11 @@ class NetEqImpl : public webrtc::NetEq {
   int decoder_frame_length_ GUARDED_BY(crit_sect_);
   Modes last_mode_ GUARDED_BY(crit_sect_);
   scoped_ptr<int16_t[]> mute_factor_array_ GUARDED_BY(crit_sect_);
+  const bool compact_memory_;
+  const scoped_refptr<DecodedBufferPool> decoded_buffer_pool_;
   size_t decoded_buffer_length_ GUARDED_BY(crit_sect_);
+  // If |decoded_buffer_pool_| is set, this is only set during GetAudio(), with
+  // a buffer borrowed from the pool.
   scoped_ptr<int16_t[]> decoded_buffer_ GUARDED_BY(crit_sect_);
   uint32_t playout_timestamp_ GUARDED_BY(crit_sect_);
   bool new_codec_ GUARDED_BY(crit_sect_);
@@ -13,8 +13,10 @@
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/codecs/pcm16b/include/pcm16b.h"
 #include "webrtc/modules/audio_coding/neteq/accelerate.h"
 #include "webrtc/modules/audio_coding/neteq/expand.h"
+#include "webrtc/modules/audio_coding/neteq/interface/decoded_buffer_pool.h"
 #include "webrtc/modules/audio_coding/neteq/mock/mock_audio_decoder.h"
 #include "webrtc/modules/audio_coding/neteq/mock/mock_buffer_level_filter.h"
 #include "webrtc/modules/audio_coding/neteq/mock/mock_decoder_database.h"
@@ -27,6 +29,7 @@
 #include "webrtc/modules/audio_coding/neteq/preemptive_expand.h"
 #include "webrtc/modules/audio_coding/neteq/sync_buffer.h"
 #include "webrtc/modules/audio_coding/neteq/timestamp_scaler.h"
+#include "webrtc/system_wrappers/interface/scoped_refptr.h"
 
 using ::testing::Return;
 using ::testing::ReturnNull;
@@ -155,7 +158,8 @@ class NetEqImplTest : public ::testing::Test {
                            timestamp_scaler_,
                            accelerate_factory,
                            expand_factory,
-                           preemptive_expand_factory);
+                           preemptive_expand_factory,
+                           NULL);
     ASSERT_TRUE(neteq_ != NULL);
   }
 
@@ -234,6 +238,74 @@ TEST(NetEq, CreateAndDestroy) {
   delete neteq;
 }
 
+// Verifies that compact memory mode does not change the output, also when
+// packets are lost and the sample rate changes, and that the decode buffer is
+// returned to the injected pool.
+TEST(NetEq, CompactMemoryGivesSameOutput) {
+  const int kPayloadTypeNb = 93;
+  const int kPayloadTypeSwb = 95;
+  const int kPacketMs = 20;
+  const int kNumPackets = 200;
+  scoped_refptr<DecodedBufferPool> pool(DecodedBufferPool::Create());
+  NetEq* neteq[2];
+  for (int i = 0; i < 2; ++i) {
+    NetEq::Config config;
+    config.sample_rate_hz = 8000;
+    config.compact_memory = (i == 1);
+    config.decoded_buffer_pool = pool.get();
+    neteq[i] = NetEq::Create(config);
+    EXPECT_EQ(NetEq::kOK,
+              neteq[i]->RegisterPayloadType(kDecoderPCM16B, kPayloadTypeNb));
+    EXPECT_EQ(NetEq::kOK, neteq[i]->RegisterPayloadType(
+        kDecoderPCM16Bswb32kHz, kPayloadTypeSwb));
+  }
+
+  WebRtcRTPHeader rtp_header;
+  memset(&rtp_header, 0, sizeof(rtp_header));
+  uint32_t timestamp = 0;
+  int16_t input[kPacketMs * 32];
+  uint8_t payload[sizeof(input)];
+  for (int n = 0; n < kNumPackets; ++n) {
+    // Switch to 32 kHz for the second half.
+    const int samples_per_ms = n < kNumPackets / 2 ? 8 : 32;
+    const int packet_samples = kPacketMs * samples_per_ms;
+    for (int i = 0; i < packet_samples; ++i)
+      input[i] = static_cast<int16_t>(((n * 131 + i) * 997) % 8000 - 4000);
+    int16_t payload_length = WebRtcPcm16b_Encode(input, packet_samples,
+                                                 payload);
+    rtp_header.header.payloadType =
+        samples_per_ms == 8 ? kPayloadTypeNb : kPayloadTypeSwb;
+    rtp_header.header.sequenceNumber = n;
+    rtp_header.header.timestamp = timestamp;
+    timestamp += packet_samples;
+    // Lose every 7th packet.
+    if (n % 7 != 6) {
+      for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(NetEq::kOK, neteq[i]->InsertPacket(
+            rtp_header, payload, payload_length, timestamp));
+      }
+    }
+    for (int ms = 0; ms < kPacketMs; ms += 10) {
+      const size_t kMaxOutputLength = 10 * 32;
+      int16_t output[2][kMaxOutputLength];
+      int samples_per_channel[2];
+      int num_channels[2];
+      for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(NetEq::kOK, neteq[i]->GetAudio(kMaxOutputLength, output[i],
+                                                 &samples_per_channel[i],
+                                                 &num_channels[i], NULL));
+      }
+      ASSERT_EQ(samples_per_channel[0], samples_per_channel[1]);
+      ASSERT_EQ(num_channels[0], num_channels[1]);
+      for (int i = 0; i < samples_per_channel[0]; ++i)
+        ASSERT_EQ(output[0][i], output[1][i]) << "Packet " << n;
+      EXPECT_EQ(1u, pool->NumFreeBuffers());
+    }
+  }
+  delete neteq[0];
+  delete neteq[1];
+}
+
 TEST_F(NetEqImplTest, RegisterPayloadType) {
   CreateInstance();
   uint8_t rtp_payload_type = 0;
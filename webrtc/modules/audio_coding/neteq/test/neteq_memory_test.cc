@@ -0,0 +1,185 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Reports the heap memory held by a large number of NetEq instances, with and
+// without compact memory mode. All heap allocations go through the operator
+// new and delete below, which keep track of the number of bytes in use.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/modules/audio_coding/codecs/pcm16b/include/pcm16b.h"
+#include "webrtc/modules/audio_coding/neteq/interface/decoded_buffer_pool.h"
+#include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/scoped_refptr.h"
+#include "webrtc/typedefs.h"
+
+namespace {
+
+// 32 bits are enough for the few hundred MB this tool allocates.
+webrtc::Atomic32 bytes_in_use;
+
+// Keeps the size of each allocation in front of it, aligned for any type.
+const size_t kHeaderSize = 16;
+
+void* Allocate(size_t size) {
+  char* block = static_cast<char*>(malloc(size + kHeaderSize));
+  if (!block)
+    throw std::bad_alloc();
+  *reinterpret_cast<size_t*>(block) = size;
+  bytes_in_use += static_cast<int32_t>(size);
+  return block + kHeaderSize;
+}
+
+void Free(void* ptr) {
+  if (!ptr)
+    return;
+  char* block = static_cast<char*>(ptr) - kHeaderSize;
+  bytes_in_use -= static_cast<int32_t>(*reinterpret_cast<size_t*>(block));
+  free(block);
+}
+
+}  // namespace
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void operator delete(void* ptr) throw() { Free(ptr); }
+void operator delete[](void* ptr) throw() { Free(ptr); }
+
+// Flag validators.
+static bool ValidateInstances(const char* flagname, int value) {
+  if (value > 0)  // Value is ok.
+    return true;
+  printf("Invalid value for --%s: %d\n", flagname, static_cast<int>(value));
+  return false;
+}
+static bool ValidateSampleRate(const char* flagname, int value) {
+  if (value == 8000 || value == 16000 || value == 32000)  // Value is ok.
+    return true;
+  printf("Invalid value for --%s: %d\n", flagname, static_cast<int>(value));
+  return false;
+}
+
+// Define command line flags.
+DEFINE_int32(instances, 10000, "Number of NetEq instances.");
+static const bool instances_dummy =
+    google::RegisterFlagValidator(&FLAGS_instances, &ValidateInstances);
+DEFINE_int32(sample_rate, 8000,
+             "Sample rate of the received stream: 8000, 16000 or 32000 Hz.");
+static const bool sample_rate_dummy =
+    google::RegisterFlagValidator(&FLAGS_sample_rate, &ValidateSampleRate);
+
+namespace webrtc {
+namespace test {
+
+// Creates |num_instances| NetEq instances receiving a PCM16B stream at
+// |sample_rate_hz|, and returns the number of bytes they hold once they have
+// decoded a few packets. Returns -1 on error.
+int64_t MeasureMemory(int num_instances, int sample_rate_hz,
+                      bool compact_memory) {
+  NetEqDecoder decoder = kDecoderPCM16B;
+  if (sample_rate_hz == 16000) {
+    decoder = kDecoderPCM16Bwb;
+  } else if (sample_rate_hz == 32000) {
+    decoder = kDecoderPCM16Bswb32kHz;
+  }
+  const int kPayloadType = 95;
+  const int kPacketMs = 20;
+  const int kNumPackets = 3;
+  const int kSamplesPerMs = sample_rate_hz / 1000;
+  const int kPacketSamples = kPacketMs * kSamplesPerMs;
+
+  std::vector<int16_t> input(kPacketSamples);
+  for (int i = 0; i < kPacketSamples; ++i)
+    input[i] = static_cast<int16_t>((i * 997) % 4000 - 2000);
+  std::vector<uint8_t> payload(kPacketSamples * sizeof(int16_t));
+  const int payload_length =
+      WebRtcPcm16b_Encode(&input[0], kPacketSamples, &payload[0]);
+  std::vector<int16_t> output(10 * kSamplesPerMs);
+
+  // The instances decode on this thread only, so they share one pool.
+  scoped_refptr<DecodedBufferPool> pool(DecodedBufferPool::Create());
+  const int32_t bytes_before = bytes_in_use.Value();
+  std::vector<NetEq*> instances(num_instances);
+  bool ok = true;
+  for (int n = 0; n < num_instances && ok; ++n) {
+    NetEq::Config config;
+    config.sample_rate_hz = sample_rate_hz;
+    config.compact_memory = compact_memory;
+    config.decoded_buffer_pool = pool.get();
+    NetEq* neteq = NetEq::Create(config);
+    instances[n] = neteq;
+    ok = neteq->RegisterPayloadType(decoder, kPayloadType) == NetEq::kOK;
+
+    WebRtcRTPHeader rtp_header;
+    memset(&rtp_header, 0, sizeof(rtp_header));
+    rtp_header.header.payloadType = kPayloadType;
+    rtp_header.header.ssrc = n;
+    for (int i = 0; i < kNumPackets && ok; ++i) {
+      rtp_header.header.sequenceNumber = i;
+      rtp_header.header.timestamp = i * kPacketSamples;
+      ok = neteq->InsertPacket(rtp_header, &payload[0], payload_length,
+                               i * kPacketSamples) == NetEq::kOK;
+      for (int ms = 0; ms < kPacketMs && ok; ms += 10) {
+        int samples_per_channel;
+        int num_channels;
+        ok = neteq->GetAudio(output.size(), &output[0], &samples_per_channel,
+                             &num_channels, NULL) == NetEq::kOK;
+      }
+    }
+  }
+  const int64_t bytes = bytes_in_use.Value() - bytes_before;
+  for (int n = 0; n < num_instances; ++n)
+    delete instances[n];
+  return ok ? bytes : -1;
+}
+
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage = "Tool for measuring the memory used by NetEq.\n"
+      "Usage: " + program_name + " [options]\n\n"
+      "  --instances=N          number of NetEq instances; default is 10000\n"
+      "  --sample_rate=N        sample rate in Hz; default is 8000\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (argc != 1) {
+    // Print usage information.
+    std::cout << google::ProgramUsage();
+    return 0;
+  }
+
+  std::cout << FLAGS_instances << " instances at " << FLAGS_sample_rate <<
+      " Hz" << std::endl;
+  for (int compact = 0; compact <= 1; ++compact) {
+    int64_t bytes = webrtc::test::MeasureMemory(
+        FLAGS_instances, FLAGS_sample_rate, compact != 0);
+    if (bytes < 0) {
+      std::cout << "There was an error" << std::endl;
+      return -1;
+    }
+    std::cout << (compact ? "Compact memory: " : "Default:        ") <<
+        bytes / 1024 << " kB, " << bytes / FLAGS_instances <<
+        " bytes per instance" << std::endl;
+  }
+  return 0;
+}
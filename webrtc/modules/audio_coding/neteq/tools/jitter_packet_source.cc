@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/tools/jitter_packet_source.h"
+
+#include <assert.h>
+
+#include "webrtc/modules/audio_coding/neteq/tools/packet.h"
+
+namespace webrtc {
+namespace test {
+
+JitterPacketSource::JitterPacketSource(PacketSource* source,
+                                       int max_jitter_ms,
+                                       double loss_rate,
+                                       uint32_t seed)
+    : source_(source),
+      max_jitter_ms_(max_jitter_ms),
+      loss_rate_(loss_rate),
+      random_state_(seed),
+      last_read_time_ms_(0.0),
+      source_depleted_(false),
+      packets_lost_(0) {
+  assert(source);
+  assert(max_jitter_ms >= 0);
+}
+
+JitterPacketSource::~JitterPacketSource() {
+  for (std::multimap<double, Packet*>::iterator it = pending_packets_.begin();
+       it != pending_packets_.end(); ++it) {
+    delete it->second;
+  }
+}
+
+Packet* JitterPacketSource::NextPacket() {
+  // No packet arrives before its original arrival time. Hence, the first
+  // pending packet is the next one to arrive as soon as a packet with an
+  // original arrival time after that has been read.
+  while (!source_depleted_ &&
+         (pending_packets_.empty() ||
+          last_read_time_ms_ <= pending_packets_.begin()->first)) {
+    Packet* packet = source_->NextPacket();
+    if (!packet) {
+      source_depleted_ = true;
+      break;
+    }
+    last_read_time_ms_ = packet->time_ms();
+    if (Random() < loss_rate_) {
+      ++packets_lost_;
+      delete packet;
+      continue;
+    }
+    packet->set_time_ms(packet->time_ms() + Random() * max_jitter_ms_);
+    pending_packets_.insert(std::make_pair(packet->time_ms(), packet));
+  }
+  if (pending_packets_.empty())
+    return NULL;
+  Packet* packet = pending_packets_.begin()->second;
+  pending_packets_.erase(pending_packets_.begin());
+  return packet;
+}
+
+void JitterPacketSource::FilterOutPayloadType(uint8_t payload_type) {
+  source_->FilterOutPayloadType(payload_type);
+}
+
+void JitterPacketSource::SelectSsrc(uint32_t ssrc) {
+  source_->SelectSsrc(ssrc);
+}
+
+double JitterPacketSource::Random() {
+  // Linear congruential generator from Numerical Recipes.
+  random_state_ = random_state_ * 1664525 + 1013904223;
+  return random_state_ / 4294967296.0;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_JITTER_PACKET_SOURCE_H_
+#define WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_JITTER_PACKET_SOURCE_H_
+
+#include <map>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/audio_coding/neteq/tools/packet_source.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace test {
+
+// This class delivers the packets of another packet source, with the arrival
+// times modified to model a network with jitter and loss. Each packet is
+// delayed by a random time in [0, |max_jitter_ms|], and lost with probability
+// |loss_rate|. The packets are delivered in order of arrival, which means that
+// the jitter may reorder them. The same |seed| gives the same network.
+class JitterPacketSource : public PacketSource {
+ public:
+  // The new object takes ownership of |source|.
+  JitterPacketSource(PacketSource* source,
+                     int max_jitter_ms,
+                     double loss_rate,
+                     uint32_t seed);
+  virtual ~JitterPacketSource();
+
+  // Returns a pointer to the next packet. Returns NULL when |source| is
+  // depleted and all packets have been delivered.
+  virtual Packet* NextPacket() OVERRIDE;
+
+  // Filtering is done by the underlying source.
+  virtual void FilterOutPayloadType(uint8_t payload_type) OVERRIDE;
+  virtual void SelectSsrc(uint32_t ssrc) OVERRIDE;
+
+  int packets_lost() const { return packets_lost_; }
+
+ private:
+  // Returns a uniformly distributed random number in [0, 1).
+  double Random();
+
+  scoped_ptr<PacketSource> source_;
+  const int max_jitter_ms_;
+  const double loss_rate_;
+  uint32_t random_state_;
+  // Packets read from |source_| but not yet delivered, by arrival time.
+  std::multimap<double, Packet*> pending_packets_;
+  // The original arrival time of the last packet read from |source_|.
+  double last_read_time_ms_;
+  bool source_depleted_;
+  int packets_lost_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitterPacketSource);
+};
+
+}  // namespace test
+}  // namespace webrtc
+#endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_JITTER_PACKET_SOURCE_H_
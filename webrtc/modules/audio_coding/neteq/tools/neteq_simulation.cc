@@ -0,0 +1,300 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_simulation.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+#include "webrtc/modules/audio_coding/neteq/tools/packet.h"
+#include "webrtc/modules/audio_coding/neteq/tools/packet_source.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+// Converts a rate in Q14 to a fraction.
+double RateFromQ14(uint16_t rate_q14) {
+  return rate_q14 / 16384.0;
+}
+
+// Returns the mean of |get(x)| over all x in |stats|, or 0 if it is empty.
+template <typename Getter>
+double Mean(const std::vector<NetEqNetworkStatistics>& stats, Getter get) {
+  if (stats.empty())
+    return 0.0;
+  double sum = 0.0;
+  for (size_t i = 0; i < stats.size(); ++i)
+    sum += get(stats[i]);
+  return sum / stats.size();
+}
+
+double BufferSizeMs(const NetEqNetworkStatistics& s) {
+  return s.current_buffer_size_ms;
+}
+double PreferredBufferSizeMs(const NetEqNetworkStatistics& s) {
+  return s.preferred_buffer_size_ms;
+}
+double PacketLossRate(const NetEqNetworkStatistics& s) {
+  return RateFromQ14(s.packet_loss_rate);
+}
+double ExpandRate(const NetEqNetworkStatistics& s) {
+  return RateFromQ14(s.expand_rate);
+}
+double AccelerateRate(const NetEqNetworkStatistics& s) {
+  return RateFromQ14(s.accelerate_rate);
+}
+double PreemptiveRate(const NetEqNetworkStatistics& s) {
+  return RateFromQ14(s.preemptive_rate);
+}
+
+// Hands out the simulations to the threads of RunNetEqSimulations().
+class SimulationRunner {
+ public:
+  SimulationRunner(NetEqSimulationFactory* factory,
+                   int num_simulations,
+                   int max_time_ms,
+                   std::vector<NetEqSimulationStats>* stats)
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        done_cond_(ConditionVariableWrapper::CreateConditionVariable()),
+        stop_cond_(ConditionVariableWrapper::CreateConditionVariable()),
+        factory_(factory),
+        num_simulations_(num_simulations),
+        max_time_ms_(max_time_ms),
+        stats_(stats),
+        next_simulation_(0),
+        completed_simulations_(0),
+        failed_simulations_(0),
+        stopping_(false) {}
+
+  static bool ThreadFun(void* obj) {
+    return static_cast<SimulationRunner*>(obj)->Process();
+  }
+
+  // Runs the next simulation. When there are none left, waits for Stop()
+  // instead of letting the thread end by itself; ThreadWrapper::Stop() may not
+  // notice a thread that ends immediately after being started.
+  bool Process() {
+    if (RunNext())
+      return true;
+    CriticalSectionScoped cs(crit_.get());
+    while (!stopping_)
+      stop_cond_->SleepCS(*crit_);
+    return false;
+  }
+
+  // Runs the next simulation. Returns false if there was none left.
+  bool RunNext() {
+    int index;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      if (next_simulation_ == num_simulations_)
+        return false;
+      index = next_simulation_++;
+    }
+    scoped_ptr<NetEqSimulation> simulation(factory_->Create(index));
+    // Each simulation writes to its own element of |stats_|.
+    bool ok = simulation.get() && simulation->Run(max_time_ms_,
+                                                  &(*stats_)[index]);
+    CriticalSectionScoped cs(crit_.get());
+    if (!ok)
+      ++failed_simulations_;
+    if (++completed_simulations_ == num_simulations_)
+      done_cond_->WakeAll();
+    return true;
+  }
+
+  // Returns the number of failed simulations once all have completed.
+  int WaitForCompletion() {
+    CriticalSectionScoped cs(crit_.get());
+    while (completed_simulations_ < num_simulations_)
+      done_cond_->SleepCS(*crit_);
+    return failed_simulations_;
+  }
+
+  // Makes the threads in Process() return.
+  void Stop() {
+    CriticalSectionScoped cs(crit_.get());
+    stopping_ = true;
+    stop_cond_->WakeAll();
+  }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<ConditionVariableWrapper> done_cond_;
+  scoped_ptr<ConditionVariableWrapper> stop_cond_;
+  NetEqSimulationFactory* const factory_;
+  const int num_simulations_;
+  const int max_time_ms_;
+  std::vector<NetEqSimulationStats>* const stats_;
+  int next_simulation_;
+  int completed_simulations_;
+  int failed_simulations_;
+  bool stopping_;
+};
+
+}  // namespace
+
+double NetEqSimulationStats::MeanBufferSizeMs() const {
+  return Mean(network_stats, BufferSizeMs);
+}
+
+double NetEqSimulationStats::MeanPreferredBufferSizeMs() const {
+  return Mean(network_stats, PreferredBufferSizeMs);
+}
+
+double NetEqSimulationStats::MeanPacketLossRate() const {
+  return Mean(network_stats, PacketLossRate);
+}
+
+double NetEqSimulationStats::MeanExpandRate() const {
+  return Mean(network_stats, ExpandRate);
+}
+
+double NetEqSimulationStats::MeanAccelerateRate() const {
+  return Mean(network_stats, AccelerateRate);
+}
+
+double NetEqSimulationStats::MeanPreemptiveRate() const {
+  return Mean(network_stats, PreemptiveRate);
+}
+
+NetEqSimulation::NetEqSimulation(const NetEq::Config& config,
+                                 PacketSource* packet_source)
+    : neteq_(NetEq::Create(config)),
+      packet_source_(packet_source),
+      sample_rate_hz_(config.sample_rate_hz) {
+  assert(packet_source);
+}
+
+NetEqSimulation::~NetEqSimulation() {}
+
+bool NetEqSimulation::RegisterPayloadType(NetEqDecoder decoder,
+                                          uint8_t rtp_payload_type) {
+  return neteq_->RegisterPayloadType(decoder, rtp_payload_type) == NetEq::kOK;
+}
+
+bool NetEqSimulation::Run(int max_time_ms, NetEqSimulationStats* stats) {
+  static const int kMaxChannels = 5;
+  static const int kMaxSamplesPerMs = 48000 / 1000;
+  static const int kOutDataLen = kOutputBlockSizeMs * kMaxSamplesPerMs *
+      kMaxChannels;
+  assert(stats);
+  *stats = NetEqSimulationStats();
+
+  scoped_ptr<Packet> packet(packet_source_->NextPacket());
+  if (!packet)
+    return false;
+  // Start the simulation clock with the first packet.
+  int time_now_ms = static_cast<int>(packet->time_ms());
+  int next_output_time_ms = time_now_ms;
+  while (packet &&
+         (max_time_ms <= 0 || stats->simulated_time_ms < max_time_ms)) {
+    // Insert the packets that have arrived. Like the clock, the arrival times
+    // are truncated to whole ms.
+    while (packet && static_cast<int>(packet->time_ms()) <= time_now_ms) {
+      // Packets without payload (from RTP dummy files) cannot be decoded.
+      if (packet->payload_length_bytes() > 0) {
+        WebRtcRTPHeader rtp_header;
+        packet->ConvertHeader(&rtp_header);
+        uint32_t receive_timestamp =
+            static_cast<uint32_t>(packet->time_ms() * sample_rate_hz_ / 1000);
+        if (neteq_->InsertPacket(rtp_header, packet->payload(),
+                                 packet->payload_length_bytes(),
+                                 receive_timestamp) == NetEq::kOK) {
+          ++stats->packets_inserted;
+        } else {
+          ++stats->errors;
+        }
+      }
+      packet.reset(packet_source_->NextPacket());
+    }
+
+    // Get output audio, but don't do anything with it.
+    if (time_now_ms >= next_output_time_ms) {
+      int16_t out_data[kOutDataLen];
+      int num_channels;
+      int samples_per_channel;
+      if (neteq_->GetAudio(kOutDataLen, out_data, &samples_per_channel,
+                           &num_channels, NULL) == NetEq::kOK) {
+        sample_rate_hz_ = 1000 * samples_per_channel / kOutputBlockSizeMs;
+      } else {
+        ++stats->errors;
+      }
+      stats->simulated_time_ms += kOutputBlockSizeMs;
+      next_output_time_ms += kOutputBlockSizeMs;
+      if (stats->simulated_time_ms % kStatsIntervalMs == 0)
+        PollStatistics(stats);
+    }
+
+    // Advance time to the next event.
+    time_now_ms = next_output_time_ms;
+    if (packet)
+      time_now_ms = std::min(time_now_ms, static_cast<int>(packet->time_ms()));
+  }
+  if (stats->simulated_time_ms % kStatsIntervalMs != 0)
+    PollStatistics(stats);
+  return true;
+}
+
+void NetEqSimulation::PollStatistics(NetEqSimulationStats* stats) {
+  NetEqNetworkStatistics network_stats;
+  if (neteq_->NetworkStatistics(&network_stats) == NetEq::kOK) {
+    stats->network_stats.push_back(network_stats);
+  } else {
+    ++stats->errors;
+  }
+  std::vector<int> waiting_times;
+  neteq_->WaitingTimes(&waiting_times);
+  stats->waiting_times_ms.insert(stats->waiting_times_ms.end(),
+                                 waiting_times.begin(), waiting_times.end());
+}
+
+int RunNetEqSimulations(NetEqSimulationFactory* factory,
+                        int num_simulations,
+                        int num_threads,
+                        int max_time_ms,
+                        std::vector<NetEqSimulationStats>* stats) {
+  assert(factory);
+  assert(stats);
+  stats->assign(num_simulations, NetEqSimulationStats());
+  SimulationRunner runner(factory, num_simulations, max_time_ms, stats);
+
+  // The calling thread is one of the |num_threads| threads.
+  std::vector<ThreadWrapper*> threads;
+  for (int i = 1; i < std::min(num_threads, num_simulations); ++i) {
+    ThreadWrapper* thread = ThreadWrapper::CreateThread(
+        SimulationRunner::ThreadFun, &runner, kNormalPriority,
+        "NetEqSimulation");
+    unsigned int thread_id = 0;
+    if (!thread->Start(thread_id)) {
+      delete thread;
+      break;
+    }
+    threads.push_back(thread);
+  }
+  while (runner.RunNext()) {}
+  int failed_simulations = runner.WaitForCompletion();
+  runner.Stop();
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Stop();
+    delete threads[i];
+  }
+  return failed_simulations;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_SIMULATION_H_
+#define WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_SIMULATION_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace test {
+
+class PacketSource;
+
+// Statistics from one NetEqSimulation run.
+struct NetEqSimulationStats {
+  NetEqSimulationStats()
+      : simulated_time_ms(0),
+        packets_inserted(0),
+        errors(0) {}
+
+  // Averages over |network_stats|. The rates are fractions in [0, 1]. All
+  // return 0 if |network_stats| is empty.
+  double MeanBufferSizeMs() const;
+  double MeanPreferredBufferSizeMs() const;
+  double MeanPacketLossRate() const;
+  double MeanExpandRate() const;
+  double MeanAccelerateRate() const;
+  double MeanPreemptiveRate() const;
+
+  int simulated_time_ms;  // The duration of the audio pulled from NetEq.
+  int packets_inserted;
+  int errors;  // The number of failed InsertPacket() and GetAudio() calls.
+  // NetEq network statistics, polled every |kStatsIntervalMs| of simulated
+  // time.
+  std::vector<NetEqNetworkStatistics> network_stats;
+  // Packet waiting times in ms, as reported by NetEq::WaitingTimes().
+  std::vector<int> waiting_times_ms;
+};
+
+// This class runs a NetEq instance on the packets from a packet source, using
+// the arrival times of the packets as the network model. Time is simulated,
+// so the simulation runs as fast as the CPU allows.
+class NetEqSimulation {
+ public:
+  static const int kOutputBlockSizeMs = 10;
+  static const int kStatsIntervalMs = 500;
+
+  // The new object takes ownership of |packet_source|.
+  NetEqSimulation(const NetEq::Config& config, PacketSource* packet_source);
+  virtual ~NetEqSimulation();
+
+  // Registers |decoder| for |rtp_payload_type|. Returns false on error.
+  bool RegisterPayloadType(NetEqDecoder decoder, uint8_t rtp_payload_type);
+
+  // Runs until the packet source is depleted or, if |max_time_ms| is positive,
+  // until |max_time_ms| of audio has been produced. Writes the statistics to
+  // |stats|. Returns false if the packet source delivered no packets.
+  bool Run(int max_time_ms, NetEqSimulationStats* stats);
+
+ private:
+  void PollStatistics(NetEqSimulationStats* stats);
+
+  scoped_ptr<NetEq> neteq_;
+  scoped_ptr<PacketSource> packet_source_;
+  int sample_rate_hz_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetEqSimulation);
+};
+
+// Creates the simulations for RunNetEqSimulations().
+class NetEqSimulationFactory {
+ public:
+  virtual ~NetEqSimulationFactory() {}
+
+  // Returns simulation number |index|, or NULL on error. The caller takes
+  // ownership of the returned object. Must be thread-safe, since it is called
+  // from several threads.
+  virtual NetEqSimulation* Create(int index) = 0;
+};
+
+// Runs |num_simulations| simulations from |factory| in parallel on
+// |num_threads| threads, each with the |max_time_ms| limit of
+// NetEqSimulation::Run(). The statistics of simulation number i are written
+// to (*stats)[i]. Returns the number of simulations that failed.
+int RunNetEqSimulations(NetEqSimulationFactory* factory,
+                        int num_simulations,
+                        int num_threads,
+                        int max_time_ms,
+                        std::vector<NetEqSimulationStats>* stats);
+
+}  // namespace test
+}  // namespace webrtc
+#endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_SIMULATION_H_
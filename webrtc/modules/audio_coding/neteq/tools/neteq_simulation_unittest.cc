@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Unit tests for the NetEqSimulation and JitterPacketSource classes.
+
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_simulation.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/neteq/tools/constant_pcm_packet_source.h"
+#include "webrtc/modules/audio_coding/neteq/tools/jitter_packet_source.h"
+#include "webrtc/modules/audio_coding/neteq/tools/packet.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+const int kSampleRateHz = 16000;
+const int kPacketMs = 20;
+const int kPayloadType = 94;
+
+PacketSource* CreatePcmSource() {
+  return new ConstantPcmPacketSource(kPacketMs * kSampleRateHz / 1000, 1000,
+                                     kSampleRateHz, kPayloadType);
+}
+
+NetEqSimulation* CreateSimulation(PacketSource* packet_source) {
+  NetEq::Config config;
+  config.sample_rate_hz = kSampleRateHz;
+  NetEqSimulation* simulation = new NetEqSimulation(config, packet_source);
+  EXPECT_TRUE(simulation->RegisterPayloadType(kDecoderPCM16Bwb, kPayloadType));
+  return simulation;
+}
+
+class JitterSimulationFactory : public NetEqSimulationFactory {
+ public:
+  virtual NetEqSimulation* Create(int index) OVERRIDE {
+    return CreateSimulation(
+        new JitterPacketSource(CreatePcmSource(), 10 * index, 0.02, index));
+  }
+};
+}  // namespace
+
+TEST(JitterPacketSource, DelaysAndReordersPackets) {
+  const int kMaxJitterMs = 50;
+  const int kNumPackets = 1000;
+  JitterPacketSource source(CreatePcmSource(), kMaxJitterMs, 0.1, 17);
+  double last_time_ms = 0.0;
+  int num_reordered = 0;
+  int last_sequence_number = -1;
+  for (int i = 0; i < kNumPackets; ++i) {
+    scoped_ptr<Packet> packet(source.NextPacket());
+    ASSERT_TRUE(packet);
+    // The packets are delivered in arrival order.
+    EXPECT_GE(packet->time_ms(), last_time_ms);
+    last_time_ms = packet->time_ms();
+    // The original arrival time follows from the sequence number.
+    double original_time_ms = packet->header().sequenceNumber * kPacketMs;
+    EXPECT_GE(packet->time_ms(), original_time_ms);
+    EXPECT_LE(packet->time_ms(), original_time_ms + kMaxJitterMs);
+    if (packet->header().sequenceNumber < last_sequence_number)
+      ++num_reordered;
+    last_sequence_number = packet->header().sequenceNumber;
+  }
+  EXPECT_GT(num_reordered, 0);
+  // About 10% of the packets are lost.
+  EXPECT_NEAR(kNumPackets / 9, source.packets_lost(), kNumPackets / 30);
+}
+
+TEST(JitterPacketSource, SameSeedGivesSameArrivalTimes) {
+  JitterPacketSource source1(CreatePcmSource(), 30, 0.05, 4711);
+  JitterPacketSource source2(CreatePcmSource(), 30, 0.05, 4711);
+  for (int i = 0; i < 100; ++i) {
+    scoped_ptr<Packet> packet1(source1.NextPacket());
+    scoped_ptr<Packet> packet2(source2.NextPacket());
+    EXPECT_EQ(packet1->header().sequenceNumber,
+              packet2->header().sequenceNumber);
+    EXPECT_EQ(packet1->time_ms(), packet2->time_ms());
+  }
+}
+
+TEST(NetEqSimulation, RunsWithoutJitter) {
+  const int kMaxTimeMs = 2000;
+  scoped_ptr<NetEqSimulation> simulation(CreateSimulation(CreatePcmSource()));
+  NetEqSimulationStats stats;
+  ASSERT_TRUE(simulation->Run(kMaxTimeMs, &stats));
+  EXPECT_EQ(kMaxTimeMs, stats.simulated_time_ms);
+  EXPECT_EQ(0, stats.errors);
+  EXPECT_NEAR(kMaxTimeMs / kPacketMs, stats.packets_inserted, 1);
+  EXPECT_EQ(static_cast<size_t>(kMaxTimeMs / NetEqSimulation::kStatsIntervalMs),
+            stats.network_stats.size());
+  EXPECT_FALSE(stats.waiting_times_ms.empty());
+  EXPECT_EQ(0.0, stats.MeanPacketLossRate());
+  EXPECT_GT(stats.MeanBufferSizeMs(), 0.0);
+}
+
+TEST(NetEqSimulation, ParallelRunsGiveSameResults) {
+  const int kNumSimulations = 6;
+  const int kMaxTimeMs = 3000;
+  JitterSimulationFactory factory;
+  std::vector<NetEqSimulationStats> sequential;
+  std::vector<NetEqSimulationStats> parallel;
+  EXPECT_EQ(0, RunNetEqSimulations(&factory, kNumSimulations, 1, kMaxTimeMs,
+                                   &sequential));
+  EXPECT_EQ(0, RunNetEqSimulations(&factory, kNumSimulations, 4, kMaxTimeMs,
+                                   &parallel));
+  ASSERT_EQ(static_cast<size_t>(kNumSimulations), sequential.size());
+  ASSERT_EQ(static_cast<size_t>(kNumSimulations), parallel.size());
+  for (int i = 0; i < kNumSimulations; ++i) {
+    EXPECT_EQ(kMaxTimeMs, parallel[i].simulated_time_ms);
+    EXPECT_EQ(sequential[i].packets_inserted, parallel[i].packets_inserted);
+    EXPECT_EQ(sequential[i].waiting_times_ms, parallel[i].waiting_times_ms);
+    EXPECT_EQ(sequential[i].MeanBufferSizeMs(), parallel[i].MeanBufferSizeMs());
+    EXPECT_EQ(sequential[i].MeanExpandRate(), parallel[i].MeanExpandRate());
+  }
+  // More jitter makes NetEq hold more audio.
+  EXPECT_GT(parallel[kNumSimulations - 1].MeanPreferredBufferSizeMs(),
+            parallel[0].MeanPreferredBufferSizeMs());
+}
+
+}  // namespace test
+}  // namespace webrtc
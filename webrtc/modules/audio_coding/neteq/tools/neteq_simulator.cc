@@ -0,0 +1,229 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Replays a set of RTP dump files through NetEq, a number of times each with
+// modeled network jitter and loss, and reports the distributions of delay and
+// expand rate over all runs. The runs are independent and are spread over a
+// number of threads.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
+#include "webrtc/modules/audio_coding/neteq/tools/jitter_packet_source.h"
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_simulation.h"
+#include "webrtc/modules/audio_coding/neteq/tools/rtp_file_source.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/typedefs.h"
+
+// Flag validators.
+static bool ValidatePositive(const char* flagname, int32_t value) {
+  if (value > 0)  // Value is ok.
+    return true;
+  printf("Invalid value for --%s: %d\n", flagname, static_cast<int>(value));
+  return false;
+}
+static bool ValidateNonNegative(const char* flagname, int32_t value) {
+  if (value >= 0)  // Value is ok.
+    return true;
+  printf("Invalid value for --%s: %d\n", flagname, static_cast<int>(value));
+  return false;
+}
+static bool ValidateLossRate(const char* flagname, double value) {
+  if (value >= 0.0 && value < 1.0)  // Value is ok.
+    return true;
+  printf("Invalid value for --%s: %f\n", flagname, value);
+  return false;
+}
+
+// Define command line flags.
+DEFINE_int32(runs, 10, "Number of runs per input file, each with a different "
+             "realization of the network model.");
+static const bool runs_dummy =
+    google::RegisterFlagValidator(&FLAGS_runs, &ValidatePositive);
+DEFINE_int32(threads, 4, "Number of threads to run the simulations on.");
+static const bool threads_dummy =
+    google::RegisterFlagValidator(&FLAGS_threads, &ValidatePositive);
+DEFINE_int32(max_jitter_ms, 0, "Each packet is delayed by a random time in "
+             "[0, max_jitter_ms] on top of the recorded arrival time.");
+static const bool max_jitter_ms_dummy =
+    google::RegisterFlagValidator(&FLAGS_max_jitter_ms, &ValidateNonNegative);
+DEFINE_double(loss_rate, 0.0, "Probability of losing a packet.");
+static const bool loss_rate_dummy =
+    google::RegisterFlagValidator(&FLAGS_loss_rate, &ValidateLossRate);
+DEFINE_int32(max_time_ms, 0, "Maximum simulated time per run; 0 means the "
+             "whole file.");
+static const bool max_time_ms_dummy =
+    google::RegisterFlagValidator(&FLAGS_max_time_ms, &ValidateNonNegative);
+DEFINE_int32(max_packets_in_buffer, 50, "NetEq packet buffer size.");
+static const bool max_packets_in_buffer_dummy =
+    google::RegisterFlagValidator(&FLAGS_max_packets_in_buffer,
+                                  &ValidatePositive);
+DEFINE_int32(max_delay_ms, 2000, "NetEq maximum delay.");
+static const bool max_delay_ms_dummy =
+    google::RegisterFlagValidator(&FLAGS_max_delay_ms, &ValidateNonNegative);
+DEFINE_bool(print_runs, false, "Prints the statistics of each run.");
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// The same default payload types as neteq_rtpplay.
+const struct {
+  NetEqDecoder decoder;
+  uint8_t payload_type;
+} kPayloadTypes[] = {
+  {kDecoderPCMu, 0},
+  {kDecoderPCMa, 8},
+  {kDecoderILBC, 102},
+  {kDecoderISAC, 103},
+  {kDecoderISACswb, 104},
+  {kDecoderOpus, 111},
+  {kDecoderPCM16B, 93},
+  {kDecoderPCM16Bwb, 94},
+  {kDecoderPCM16Bswb32kHz, 95},
+  {kDecoderPCM16Bswb48kHz, 96},
+  {kDecoderG722, 9},
+  {kDecoderAVT, 106},
+  {kDecoderRED, 117},
+  {kDecoderCNGnb, 13},
+  {kDecoderCNGwb, 98},
+  {kDecoderCNGswb32kHz, 99},
+  {kDecoderCNGswb48kHz, 100},
+};
+
+class RtpFileSimulationFactory : public NetEqSimulationFactory {
+ public:
+  explicit RtpFileSimulationFactory(const std::vector<std::string>& files)
+      : files_(files) {}
+
+  // Simulation number |index| runs file number |index| modulo the number of
+  // files, with the network model seeded by |index|.
+  virtual NetEqSimulation* Create(int index) OVERRIDE {
+    const std::string& file_name = files_[index % files_.size()];
+    RtpFileSource* file_source = RtpFileSource::Create(file_name);
+    if (!file_source) {
+      fprintf(stderr, "Cannot open %s\n", file_name.c_str());
+      return NULL;
+    }
+    NetEq::Config config;
+    config.max_packets_in_buffer = FLAGS_max_packets_in_buffer;
+    config.max_delay_ms = FLAGS_max_delay_ms;
+    NetEqSimulation* simulation = new NetEqSimulation(
+        config, new JitterPacketSource(file_source, FLAGS_max_jitter_ms,
+                                       FLAGS_loss_rate, index + 1));
+    for (size_t i = 0; i < sizeof(kPayloadTypes) / sizeof(kPayloadTypes[0]);
+         ++i) {
+      // Not all codecs are necessarily built in.
+      simulation->RegisterPayloadType(kPayloadTypes[i].decoder,
+                                      kPayloadTypes[i].payload_type);
+    }
+    return simulation;
+  }
+
+ private:
+  const std::vector<std::string> files_;
+};
+
+// Prints the minimum, maximum and some percentiles of |values|.
+void PrintDistribution(const std::string& name, std::vector<double> values) {
+  if (values.empty())
+    return;
+  std::sort(values.begin(), values.end());
+  const int kPercentiles[] = {10, 50, 90, 99};
+  printf("%-28s min %8.2f", name.c_str(), values.front());
+  for (size_t i = 0; i < sizeof(kPercentiles) / sizeof(kPercentiles[0]); ++i) {
+    size_t rank = (values.size() - 1) * kPercentiles[i] / 100;
+    printf("  p%d %8.2f", kPercentiles[i], values[rank]);
+  }
+  printf("  max %8.2f\n", values.back());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage = "Tool for evaluating NetEq on a set of RTP dump files.\n"
+      "Run " + program_name + " --helpshort for usage.\n"
+      "Example usage:\n" + program_name +
+      " --runs=100 --max_jitter_ms=60 input1.rtp input2.rtp\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (argc < 2) {
+    // Print usage information.
+    std::cout << google::ProgramUsage();
+    return 0;
+  }
+
+  std::vector<std::string> files(argv + 1, argv + argc);
+  webrtc::test::RtpFileSimulationFactory factory(files);
+  const int num_simulations = static_cast<int>(files.size()) * FLAGS_runs;
+  std::vector<webrtc::test::NetEqSimulationStats> stats;
+  webrtc::Clock* clock = webrtc::Clock::GetRealTimeClock();
+  int64_t start_time_ms = clock->TimeInMilliseconds();
+  int failed_simulations = webrtc::test::RunNetEqSimulations(
+      &factory, num_simulations, FLAGS_threads, FLAGS_max_time_ms, &stats);
+  int64_t runtime_ms = clock->TimeInMilliseconds() - start_time_ms;
+
+  std::vector<double> buffer_size_ms;
+  std::vector<double> preferred_buffer_size_ms;
+  std::vector<double> loss_rate;
+  std::vector<double> expand_rate;
+  std::vector<double> accelerate_rate;
+  std::vector<double> preemptive_rate;
+  std::vector<double> waiting_time_ms;
+  int64_t simulated_time_ms = 0;
+  for (int i = 0; i < num_simulations; ++i) {
+    const webrtc::test::NetEqSimulationStats& s = stats[i];
+    if (s.simulated_time_ms == 0)
+      continue;
+    simulated_time_ms += s.simulated_time_ms;
+    buffer_size_ms.push_back(s.MeanBufferSizeMs());
+    preferred_buffer_size_ms.push_back(s.MeanPreferredBufferSizeMs());
+    loss_rate.push_back(100 * s.MeanPacketLossRate());
+    expand_rate.push_back(100 * s.MeanExpandRate());
+    accelerate_rate.push_back(100 * s.MeanAccelerateRate());
+    preemptive_rate.push_back(100 * s.MeanPreemptiveRate());
+    waiting_time_ms.insert(waiting_time_ms.end(), s.waiting_times_ms.begin(),
+                           s.waiting_times_ms.end());
+    if (FLAGS_print_runs) {
+      printf("Run %d (%s): %d ms, %d packets, %d errors, buffer %.1f ms, "
+             "expand %.2f%%\n", i, files[i % files.size()].c_str(),
+             s.simulated_time_ms, s.packets_inserted, s.errors,
+             buffer_size_ms.back(), expand_rate.back());
+    }
+  }
+
+  printf("%d runs, %d failed\n", num_simulations, failed_simulations);
+  double speed = static_cast<double>(simulated_time_ms) /
+      std::max<int64_t>(runtime_ms, 1);
+  printf("Simulated %.1f s of audio in %.1f s on %d threads (%.0fx real "
+         "time)\n", simulated_time_ms / 1000.0, runtime_ms / 1000.0,
+         FLAGS_threads, speed);
+  printf("Distributions over runs:\n");
+  webrtc::test::PrintDistribution("Buffer size (ms)", buffer_size_ms);
+  webrtc::test::PrintDistribution("Preferred buffer size (ms)",
+                                  preferred_buffer_size_ms);
+  webrtc::test::PrintDistribution("Packet loss rate (%)", loss_rate);
+  webrtc::test::PrintDistribution("Expand rate (%)", expand_rate);
+  webrtc::test::PrintDistribution("Accelerate rate (%)", accelerate_rate);
+  webrtc::test::PrintDistribution("Preemptive rate (%)", preemptive_rate);
+  printf("Distribution over packets:\n");
+  webrtc::test::PrintDistribution("Waiting time (ms)", waiting_time_ms);
+  return failed_simulations == 0 ? 0 : -1;
+}
@@ -77,6 +77,14 @@ public:
     // downsampling of audio contributing to the mixed audio.
     virtual int32_t SetMinimumMixingFrequency(Frequency freq) = 0;
 
+    // Set the number of worker threads used to get the audio of the
+    // participants. With worker threads the GetAudioFrame() calls of a mix
+    // iteration are made in parallel, and GetAudioFrame() may be called
+    // concurrently for different participants. The output is the same as
+    // with 0 worker threads, which is the default and makes all calls on the
+    // thread calling Process().
+    virtual int32_t SetNumWorkerThreads(int numThreads) = 0;
+
 protected:
     AudioConferenceMixer() {}
 };
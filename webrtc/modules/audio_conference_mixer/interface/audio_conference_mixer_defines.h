@@ -25,6 +25,10 @@ public:
     // audio every time it's called.
     //
     // If it returns -1, the frame will not be added to the mix.
+    //
+    // If the mixer has worker threads, this may be called on any of them and
+    // concurrently with the calls to other participants. It must not call
+    // back into the mixer.
     virtual int32_t GetAudioFrame(const int32_t id, AudioFrame& audioFrame) = 0;
 
     // mixed will be set to true if the participant was mixed this mix iteration
@@ -160,6 +160,8 @@ bool AudioConferenceMixerImpl::Init() {
     if(_audioFramePool == NULL)
         return false;
 
+    _frameFetcher.reset(new ParticipantFrameFetcher(0));
+
     if(SetOutputFrequency(kDefaultFrequency) == -1)
         return false;
 
@@ -556,6 +558,18 @@ int32_t AudioConferenceMixerImpl::SetAnonymousMixabilityStatus(
         0 : -1;
 }
 
+int32_t AudioConferenceMixerImpl::SetNumWorkerThreads(int numThreads) {
+    if(numThreads < 0) {
+        WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
+                     "SetNumWorkerThreads incorrect number of threads: %d",
+                     numThreads);
+        return -1;
+    }
+    CriticalSectionScoped cs(_cbCrit.get());
+    _frameFetcher.reset(new ParticipantFrameFetcher(numThreads));
+    return 0;
+}
+
 int32_t AudioConferenceMixerImpl::AnonymousMixabilityStatus(
     MixerParticipant& participant, bool& mixable) {
     CriticalSectionScoped cs(_cbCrit.get());
@@ -619,6 +633,46 @@ int32_t AudioConferenceMixerImpl::GetLowestMixingFrequencyFromList(
     return highestFreq;
 }
 
+bool AudioConferenceMixerImpl::FetchAudioFrames(
+    const MixerParticipantList& participantList,
+    std::vector<ParticipantFrameFetcher::Request>* requests) {
+    requests->clear();
+    requests->reserve(participantList.size());
+    for (MixerParticipantList::const_iterator participant =
+             participantList.begin();
+         participant != participantList.end();
+         ++participant) {
+        AudioFrame* audioFrame = NULL;
+        if(_audioFramePool->PopMemory(audioFrame) == -1) {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            for (size_t i = 0; i < requests->size(); ++i) {
+                _audioFramePool->PushMemory((*requests)[i].frame);
+            }
+            requests->clear();
+            return false;
+        }
+        audioFrame->sample_rate_hz_ = _outputFrequency;
+        ParticipantFrameFetcher::Request request = {*participant, audioFrame,
+                                                    0};
+        requests->push_back(request);
+    }
+
+    _frameFetcher->FetchFrames(_id, requests);
+
+    for (size_t i = 0; i < requests->size(); ++i) {
+        ParticipantFrameFetcher::Request& request = (*requests)[i];
+        if(request.result != 0) {
+            WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
+                         "failed to GetAudioFrame() from participant");
+            _audioFramePool->PushMemory(request.frame);
+            request.frame = NULL;
+        }
+    }
+    return true;
+}
+
 void AudioConferenceMixerImpl::UpdateToMix(
     AudioFrameList* mixList,
     AudioFrameList* rampOutList,
@@ -633,9 +687,17 @@ void AudioConferenceMixerImpl::UpdateToMix(
     // belongs to which MixerParticipant.
     ParticipantFramePairList passiveWasNotMixedList;
     ParticipantFramePairList passiveWasMixedList;
-    for (MixerParticipantList::iterator participant = _participantList.begin();
-         participant != _participantList.end();
-         ++participant) {
+    // All frames are fetched up front so that the participants can decode in
+    // parallel. The selection below only depends on the order of the list.
+    std::vector<ParticipantFrameFetcher::Request> requests;
+    if(!FetchAudioFrames(_participantList, &requests)) {
+        return;
+    }
+    for (std::vector<ParticipantFrameFetcher::Request>::iterator request =
+             requests.begin();
+         request != requests.end();
+         ++request) {
+        MixerParticipant* const participant = request->participant;
         // Stop keeping track of passive participants if there are already
         // enough participants available (they wont be mixed anyway).
         bool mustAddToPassiveList = (maxAudioFrameCounter >
@@ -644,20 +706,9 @@ void AudioConferenceMixerImpl::UpdateToMix(
                                      passiveWasNotMixedList.size()));
 
         bool wasMixed = false;
-        (*participant)->_mixHistory->WasMixed(wasMixed);
-        AudioFrame* audioFrame = NULL;
-        if(_audioFramePool->PopMemory(audioFrame) == -1) {
-            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
-                         "failed PopMemory() call");
-            assert(false);
-            return;
-        }
-        audioFrame->sample_rate_hz_ = _outputFrequency;
-
-        if((*participant)->GetAudioFrame(_id,*audioFrame) != 0) {
-            WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
-                         "failed to GetAudioFrame() from participant");
-            _audioFramePool->PushMemory(audioFrame);
+        participant->_mixHistory->WasMixed(wasMixed);
+        AudioFrame* audioFrame = request->frame;
+        if(audioFrame == NULL) {
             continue;
         }
         if (_participantList.size() != 1) {
@@ -714,7 +765,7 @@ void AudioConferenceMixerImpl::UpdateToMix(
                     activeList.erase(replaceItem);
 
                     activeList.push_front(audioFrame);
-                    (*mixParticipantList)[audioFrame->id_] = *participant;
+                    (*mixParticipantList)[audioFrame->id_] = participant;
                     assert(mixParticipantList->size() <=
                            kMaximumAmountOfMixedParticipants);
 
@@ -738,7 +789,7 @@ void AudioConferenceMixerImpl::UpdateToMix(
                 }
             } else {
                 activeList.push_front(audioFrame);
-                (*mixParticipantList)[audioFrame->id_] = *participant;
+                (*mixParticipantList)[audioFrame->id_] = participant;
                 assert(mixParticipantList->size() <=
                        kMaximumAmountOfMixedParticipants);
             }
@@ -746,13 +797,13 @@ void AudioConferenceMixerImpl::UpdateToMix(
             if(wasMixed) {
                 ParticipantFramePair* pair = new ParticipantFramePair;
                 pair->audioFrame  = audioFrame;
-                pair->participant = *participant;
+                pair->participant = participant;
                 passiveWasMixedList.push_back(pair);
             } else if(mustAddToPassiveList) {
                 RampIn(*audioFrame);
                 ParticipantFramePair* pair = new ParticipantFramePair;
                 pair->audioFrame  = audioFrame;
-                pair->participant = *participant;
+                pair->participant = participant;
                 passiveWasNotMixedList.push_back(pair);
             } else {
                 _audioFramePool->PushMemory(audioFrame);
@@ -809,31 +860,19 @@ void AudioConferenceMixerImpl::GetAdditionalAudio(
     AudioFrameList* additionalFramesList) {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
                  "GetAdditionalAudio(additionalFramesList)");
-    // The GetAudioFrame() callback may result in the participant being removed
-    // from additionalParticipantList_. If that happens it will invalidate any
-    // iterators. Create a copy of the participants list such that the list of
-    // participants can be traversed safely.
-    MixerParticipantList additionalParticipantList;
-    additionalParticipantList.insert(additionalParticipantList.begin(),
-                                     _additionalParticipantList.begin(),
-                                     _additionalParticipantList.end());
-
-    for (MixerParticipantList::iterator participant =
-             additionalParticipantList.begin();
-         participant != additionalParticipantList.end();
-         ++participant) {
-        AudioFrame* audioFrame = NULL;
-        if(_audioFramePool->PopMemory(audioFrame) == -1) {
-            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
-                         "failed PopMemory() call");
-            assert(false);
-            return;
-        }
-        audioFrame->sample_rate_hz_ = _outputFrequency;
-        if((*participant)->GetAudioFrame(_id, *audioFrame) != 0) {
-            WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
-                         "failed to GetAudioFrame() from participant");
-            _audioFramePool->PushMemory(audioFrame);
+    // The requests hold a copy of the participants, so that the list can
+    // change while the frames are fetched.
+    std::vector<ParticipantFrameFetcher::Request> requests;
+    if(!FetchAudioFrames(_additionalParticipantList, &requests)) {
+        return;
+    }
+
+    for (std::vector<ParticipantFrameFetcher::Request>::iterator request =
+             requests.begin();
+         request != requests.end();
+         ++request) {
+        AudioFrame* audioFrame = request->frame;
+        if(audioFrame == NULL) {
             continue;
         }
         if(audioFrame->samples_per_channel_ == 0) {
@@ -13,11 +13,13 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include "webrtc/engine_configurations.h"
 #include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer.h"
 #include "webrtc/modules/audio_conference_mixer/source/level_indicator.h"
 #include "webrtc/modules/audio_conference_mixer/source/memory_pool.h"
+#include "webrtc/modules/audio_conference_mixer/source/participant_frame_fetcher.h"
 #include "webrtc/modules/audio_conference_mixer/source/time_scheduler.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
@@ -85,6 +87,7 @@ public:
         MixerParticipant& participant, const bool mixable) OVERRIDE;
     virtual int32_t AnonymousMixabilityStatus(
         MixerParticipant& participant, bool& mixable) OVERRIDE;
+    virtual int32_t SetNumWorkerThreads(int numThreads) OVERRIDE;
 private:
     enum{DEFAULT_AUDIO_FRAME_POOLSIZE = 50};
 
@@ -92,6 +95,14 @@ private:
     int32_t SetOutputFrequency(const Frequency frequency);
     Frequency OutputFrequency() const;
 
+    // Gets an AudioFrame from each MixerParticipant in participantList, using
+    // the worker threads if there are any. On success requests contains one
+    // entry per participant, in list order. The frame of a participant that
+    // failed to deliver one is returned to the pool and set to NULL.
+    bool FetchAudioFrames(
+        const MixerParticipantList& participantList,
+        std::vector<ParticipantFrameFetcher::Request>* requests);
+
     // Fills mixList with the AudioFrames pointers that should be used when
     // mixing. Fills mixParticipantList with ParticipantStatistics for the
     // participants who's AudioFrames are inside mixList.
@@ -186,6 +197,9 @@ private:
     // Memory pool to avoid allocating/deallocating AudioFrames
     MemoryPool<AudioFrame>* _audioFramePool;
 
+    // Makes the GetAudioFrame() calls. Protected by _cbCrit.
+    scoped_ptr<ParticipantFrameFetcher> _frameFetcher;
+
     // List of all participants. Note all lists are disjunct
     MixerParticipantList _participantList;              // May be mixed.
     // Always mixed, anonomously.
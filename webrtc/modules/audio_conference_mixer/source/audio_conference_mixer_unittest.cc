@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer_defines.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 16000;
+const int kSamplesPerChannel = kSampleRateHz / 100;
+
+// Produces a frame that only depends on the participant id and the number of
+// frames produced so far. |decode_iterations| simulates the cost of decoding.
+class FakeParticipant : public MixerParticipant {
+ public:
+  FakeParticipant(int id, int decode_iterations)
+      : id_(id), decode_iterations_(decode_iterations), num_frames_(0) {}
+  virtual ~FakeParticipant() {}
+
+  virtual int32_t GetAudioFrame(const int32_t id,
+                                AudioFrame& audio_frame) OVERRIDE {
+    uint32_t state = id_ * 1000003 + num_frames_;
+    for (int i = 0; i < decode_iterations_; ++i)
+      state = state * 1664525 + 1013904223;
+    for (int i = 0; i < kSamplesPerChannel; ++i) {
+      state = state * 1664525 + 1013904223;
+      audio_frame.data_[i] = static_cast<int16_t>(state >> 16) >> (id_ % 4);
+    }
+    // The set of talking participants changes every 50 frames.
+    const bool active = (id_ + num_frames_ / 50) % 3 == 0;
+    audio_frame.UpdateFrame(id_, num_frames_ * kSamplesPerChannel, NULL,
+                            kSamplesPerChannel, kSampleRateHz,
+                            AudioFrame::kNormalSpeech,
+                            active ? AudioFrame::kVadActive :
+                                     AudioFrame::kVadPassive,
+                            1);
+    ++num_frames_;
+    return 0;
+  }
+
+  virtual int32_t NeededFrequency(const int32_t id) OVERRIDE {
+    return kSampleRateHz;
+  }
+
+ private:
+  const int id_;
+  const int decode_iterations_;
+  uint32_t num_frames_;
+};
+
+class MixedAudioRecorder : public AudioMixerOutputReceiver {
+ public:
+  virtual void NewMixedAudio(const int32_t id,
+                             const AudioFrame& general_audio_frame,
+                             const AudioFrame** unique_audio_frames,
+                             const uint32_t size) OVERRIDE {
+    samples_.insert(samples_.end(), general_audio_frame.data_,
+                    general_audio_frame.data_ +
+                        general_audio_frame.samples_per_channel_ *
+                        general_audio_frame.num_channels_);
+  }
+
+  const std::vector<int16_t>& samples() const { return samples_; }
+
+ private:
+  std::vector<int16_t> samples_;
+};
+
+class Conference {
+ public:
+  Conference(int num_participants, int num_anonymous, int decode_iterations,
+             int num_threads)
+      : mixer_(AudioConferenceMixer::Create(0)) {
+    EXPECT_EQ(0, mixer_->RegisterMixedStreamCallback(recorder_));
+    EXPECT_EQ(0, mixer_->SetNumWorkerThreads(num_threads));
+    for (int i = 0; i < num_participants + num_anonymous; ++i) {
+      participants_.push_back(new FakeParticipant(i, decode_iterations));
+      EXPECT_EQ(0, mixer_->SetMixabilityStatus(*participants_[i], true));
+      if (i >= num_participants) {
+        EXPECT_EQ(0, mixer_->SetAnonymousMixabilityStatus(*participants_[i],
+                                                          true));
+      }
+    }
+  }
+
+  ~Conference() {
+    for (size_t i = 0; i < participants_.size(); ++i) {
+      EXPECT_EQ(0, mixer_->SetMixabilityStatus(*participants_[i], false));
+      delete participants_[i];
+    }
+    EXPECT_EQ(0, mixer_->UnRegisterMixedStreamCallback());
+  }
+
+  AudioConferenceMixer* mixer() { return mixer_.get(); }
+  const std::vector<int16_t>& mixed_samples() const {
+    return recorder_.samples();
+  }
+
+ private:
+  scoped_ptr<AudioConferenceMixer> mixer_;
+  MixedAudioRecorder recorder_;
+  std::vector<FakeParticipant*> participants_;
+};
+
+TEST(AudioConferenceMixerTest, WorkerThreadsDoNotChangeOutput) {
+  const int kNumParticipants = 20;
+  const int kNumAnonymous = 2;
+  const int kNumFrames = 200;
+  Conference sequential(kNumParticipants, kNumAnonymous, 0, 0);
+  Conference parallel(kNumParticipants, kNumAnonymous, 0, 3);
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(0, sequential.mixer()->Process());
+    EXPECT_EQ(0, parallel.mixer()->Process());
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumFrames * kSamplesPerChannel),
+            sequential.mixed_samples().size());
+  EXPECT_TRUE(sequential.mixed_samples() == parallel.mixed_samples());
+}
+
+TEST(AudioConferenceMixerTest, ChangingWorkerThreadsDoesNotChangeOutput) {
+  const int kNumParticipants = 10;
+  const int kNumFrames = 150;
+  const int kNumThreads[] = {2, 0, 4, 1, 3};
+  const int kFramesPerSetting = kNumFrames /
+      static_cast<int>(sizeof(kNumThreads) / sizeof(*kNumThreads));
+  Conference sequential(kNumParticipants, 0, 0, 0);
+  Conference parallel(kNumParticipants, 0, 0, 0);
+  for (int i = 0; i < kNumFrames; ++i) {
+    if (i % kFramesPerSetting == 0) {
+      EXPECT_EQ(0, parallel.mixer()->SetNumWorkerThreads(
+          kNumThreads[i / kFramesPerSetting]));
+    }
+    EXPECT_EQ(0, sequential.mixer()->Process());
+    EXPECT_EQ(0, parallel.mixer()->Process());
+  }
+  EXPECT_TRUE(sequential.mixed_samples() == parallel.mixed_samples());
+  EXPECT_EQ(-1, parallel.mixer()->SetNumWorkerThreads(-1));
+}
+
+TEST(AudioConferenceMixerTest, DISABLED_ParallelDecodingBenchmark) {
+  const int kNumFrames = 100;
+  // Roughly the cost of decoding 10 ms of wideband audio.
+  const int kDecodeIterations = 20000;
+  const int kNumParticipants[] = {10, 50, 200};
+  const int kNumThreads[] = {0, 3};
+  for (size_t n = 0;
+       n < sizeof(kNumParticipants) / sizeof(*kNumParticipants); ++n) {
+    for (size_t t = 0; t < sizeof(kNumThreads) / sizeof(*kNumThreads); ++t) {
+      Conference conference(kNumParticipants[n], 0, kDecodeIterations,
+                            kNumThreads[t]);
+      int64_t max_us = 0;
+      TickTime start = TickTime::Now();
+      for (int i = 0; i < kNumFrames; ++i) {
+        TickTime tick_start = TickTime::Now();
+        EXPECT_EQ(0, conference.mixer()->Process());
+        max_us = std::max(max_us,
+                          (TickTime::Now() - tick_start).Microseconds());
+      }
+      int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+      printf("%3d participants, %d worker threads: %7.1f us per tick, "
+             "%7d us max\n",
+             kNumParticipants[n], kNumThreads[t],
+             static_cast<double>(elapsed_us) / kNumFrames,
+             static_cast<int>(max_us));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
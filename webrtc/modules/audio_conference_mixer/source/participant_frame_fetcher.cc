@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_conference_mixer/source/participant_frame_fetcher.h"
+
+#include <assert.h>
+
+#include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer_defines.h"
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/trace.h"
+
+namespace webrtc {
+
+ParticipantFrameFetcher::ParticipantFrameFetcher(int num_threads)
+    : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      work_cond_(ConditionVariableWrapper::CreateConditionVariable()),
+      done_cond_(ConditionVariableWrapper::CreateConditionVariable()),
+      id_(-1),
+      requests_(NULL),
+      next_request_(0),
+      completed_requests_(0),
+      stopping_(false) {
+  for (int i = 0; i < num_threads; ++i) {
+    // The workers decode for playout, like the thread calling FetchFrames().
+    ThreadWrapper* thread = ThreadWrapper::CreateThread(
+        WorkerThreadFun, this, kRealtimePriority, "AudioMixerDecodeThread");
+    unsigned int thread_id = 0;
+    if (!thread->Start(thread_id)) {
+      WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, -1,
+                   "%s: could not start worker thread", __FUNCTION__);
+      delete thread;
+      break;
+    }
+    threads_.push_back(thread);
+  }
+}
+
+ParticipantFrameFetcher::~ParticipantFrameFetcher() {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    stopping_ = true;
+    work_cond_->WakeAll();
+  }
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i]->SetNotAlive();
+    if (!threads_[i]->Stop()) {
+      WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, -1,
+                   "%s: not able to stop worker thread, leaking",
+                   __FUNCTION__);
+      assert(false);
+      continue;
+    }
+    delete threads_[i];
+  }
+}
+
+void ParticipantFrameFetcher::FetchFrames(int32_t id,
+                                          std::vector<Request>* requests) {
+  if (threads_.empty() || requests->size() < 2) {
+    for (size_t i = 0; i < requests->size(); ++i) {
+      Request& request = (*requests)[i];
+      request.result = request.participant->GetAudioFrame(id, *request.frame);
+    }
+    return;
+  }
+
+  CriticalSectionScoped cs(crit_.get());
+  assert(requests_ == NULL);
+  id_ = id;
+  requests_ = requests;
+  next_request_ = 0;
+  completed_requests_ = 0;
+  work_cond_->WakeAll();
+  RunRequests();
+  while (completed_requests_ < requests_->size())
+    done_cond_->SleepCS(*crit_);
+  requests_ = NULL;
+}
+
+bool ParticipantFrameFetcher::WorkerThreadFun(void* obj) {
+  return static_cast<ParticipantFrameFetcher*>(obj)->WorkerProcess();
+}
+
+bool ParticipantFrameFetcher::WorkerProcess() {
+  CriticalSectionScoped cs(crit_.get());
+  while (!stopping_ &&
+         (requests_ == NULL || next_request_ == requests_->size())) {
+    work_cond_->SleepCS(*crit_);
+  }
+  if (stopping_)
+    return false;
+  RunRequests();
+  return true;
+}
+
+void ParticipantFrameFetcher::RunRequests() {
+  while (requests_ != NULL && next_request_ < requests_->size()) {
+    Request& request = (*requests_)[next_request_++];
+    crit_->Leave();
+    request.result = request.participant->GetAudioFrame(id_, *request.frame);
+    crit_->Enter();
+    if (++completed_requests_ == requests_->size())
+      done_cond_->WakeAll();
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_PARTICIPANT_FRAME_FETCHER_H_
+#define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_PARTICIPANT_FRAME_FETCHER_H_
+
+#include <vector>
+
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+class AudioFrame;
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+class MixerParticipant;
+class ThreadWrapper;
+
+// Gets the audio frames of a number of participants, with the
+// GetAudioFrame() calls spread over a pool of worker threads and the calling
+// thread.
+class ParticipantFrameFetcher {
+ public:
+  struct Request {
+    MixerParticipant* participant;
+    AudioFrame* frame;
+    // The return value of GetAudioFrame().
+    int32_t result;
+  };
+
+  explicit ParticipantFrameFetcher(int num_threads);
+  ~ParticipantFrameFetcher();
+
+  // Calls GetAudioFrame(id, ...) for each request and returns when all calls
+  // have returned. Only one call may be outstanding at a time.
+  void FetchFrames(int32_t id, std::vector<Request>* requests);
+
+ private:
+  static bool WorkerThreadFun(void* obj);
+  bool WorkerProcess();
+
+  // Runs requests until none are left to start. Must be called with |crit_|
+  // held, which is released while calling the participants.
+  void RunRequests();
+
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  // Signaled when there are requests to run or the workers should stop.
+  scoped_ptr<ConditionVariableWrapper> work_cond_;
+  // Signaled when the last request has completed.
+  scoped_ptr<ConditionVariableWrapper> done_cond_;
+  std::vector<ThreadWrapper*> threads_;
+
+  // The FetchFrames() call in progress, if any.
+  int32_t id_;
+  std::vector<Request>* requests_;
+  size_t next_request_;
+  size_t completed_requests_;
+  bool stopping_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_PARTICIPANT_FRAME_FETCHER_H_
@@ -72,6 +72,7 @@
             'acm_receive_test',
             'acm_send_test',
             'audio_coding_module',
+            'audio_conference_mixer',
             'audio_processing',
             'bitrate_controller',
             'CNG',
@@ -79,6 +80,7 @@
             'iSACFix',
             'media_file',
             'neteq',
+            'neteq_test_support',
             'neteq_unittest_tools',
             'paced_sender',
             'PCM16B',  # Needed by NetEq tests.
@@ -87,6 +89,7 @@
             'rtp_rtcp',
             'video_codecs_test_framework',
             'video_processing',
+            'video_render_module',
             'webrtc_utility',
             'webrtc_video_coding',
             '<@(neteq_dependencies)',
@@ -116,6 +119,7 @@
             'audio_coding/codecs/cng/cng_unittest.cc',
             'audio_coding/codecs/isac/fix/source/filters_unittest.cc',
             'audio_coding/codecs/isac/fix/source/filterbanks_unittest.cc',
+            'audio_coding/codecs/isac/fix/source/lattice_unittest.cc',
             'audio_coding/codecs/isac/fix/source/lpc_masking_model_unittest.cc',
             'audio_coding/codecs/isac/fix/source/transform_unittest.cc',
             'audio_coding/codecs/isac/main/source/isac_unittest.cc',
@@ -128,6 +132,7 @@
             'audio_coding/neteq/buffer_level_filter_unittest.cc',
             'audio_coding/neteq/comfort_noise_unittest.cc',
             'audio_coding/neteq/decision_logic_unittest.cc',
+            'audio_coding/neteq/decoded_buffer_pool_unittest.cc',
             'audio_coding/neteq/decoder_database_unittest.cc',
             'audio_coding/neteq/delay_manager_unittest.cc',
             'audio_coding/neteq/delay_peak_detector_unittest.cc',
@@ -161,7 +166,9 @@
             'audio_coding/neteq/mock/mock_packet_buffer.h',
             'audio_coding/neteq/mock/mock_payload_splitter.h',
             'audio_coding/neteq/tools/input_audio_file_unittest.cc',
+            'audio_coding/neteq/tools/neteq_simulation_unittest.cc',
             'audio_coding/neteq/tools/packet_unittest.cc',
+            'audio_conference_mixer/source/audio_conference_mixer_unittest.cc',
             'audio_processing/aec/echo_cancellation_unittest.cc',
             'audio_processing/aec/system_delay_unittest.cc',
             # TODO(ajm): Fix to match new interface.
@@ -260,6 +267,7 @@
             'rtp_rtcp/test/testAPI/test_api_rtcp.cc',
             'rtp_rtcp/test/testAPI/test_api_video.cc',
             'utility/source/audio_frame_operations_unittest.cc',
+            'utility/source/audio_frame_pool_unittest.cc',
             'utility/source/file_player_unittests.cc',
             'video_coding/codecs/test/packet_manipulator_unittest.cc',
             'video_coding/codecs/test/stats_unittest.cc',
@@ -272,6 +280,7 @@
             'video_coding/codecs/vp8/simulcast_unittest.h',
             'video_coding/main/interface/mock/mock_vcm_callbacks.h',
             'video_coding/main/source/decoding_state_unittest.cc',
+            'video_coding/main/source/frame_payload_pool_unittest.cc',
             'video_coding/main/source/jitter_buffer_unittest.cc',
             'video_coding/main/source/jitter_estimator_tests.cc',
             'video_coding/main/source/media_optimization_unittest.cc',
@@ -291,6 +300,7 @@
             'video_processing/main/test/unit_test/deflickering_test.cc',
             'video_processing/main/test/unit_test/video_processing_unittest.cc',
             'video_processing/main/test/unit_test/video_processing_unittest.h',
+            'video_render/video_render_scheduler_unittest.cc',
           ],
           'conditions': [
             ['enable_bwe_test_logging==1', {
@@ -41,7 +41,7 @@ class RemoteNtpTimeEstimator {
  private:
   Clock* clock_;
   scoped_ptr<TimestampExtrapolator> ts_extrapolator_;
-  RtcpList rtcp_list_;
+  RtpToNtpEstimator rtp_to_ntp_;
   int64_t last_timing_log_ms_;
   DISALLOW_COPY_AND_ASSIGN(RemoteNtpTimeEstimator);
 };
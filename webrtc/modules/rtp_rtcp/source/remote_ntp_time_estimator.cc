@@ -18,8 +18,6 @@ namespace webrtc {
 
 static const int kTimingLogIntervalMs = 10000;
 
-// TODO(wu): Refactor this class so that it can be shared with
-// vie_sync_module.cc.
 RemoteNtpTimeEstimator::RemoteNtpTimeEstimator(Clock* clock)
     : clock_(clock),
       ts_extrapolator_(new TimestampExtrapolator(clock_->TimeInMilliseconds())),
@@ -33,8 +31,8 @@ bool RemoteNtpTimeEstimator::UpdateRtcpTimestamp(uint16_t rtt,
                                                  uint32_t ntp_frac,
                                                  uint32_t rtcp_timestamp) {
   bool new_rtcp_sr = false;
-  if (!UpdateRtcpList(
-      ntp_secs, ntp_frac, rtcp_timestamp, &rtcp_list_, &new_rtcp_sr)) {
+  if (!rtp_to_ntp_.UpdateMeasurements(
+      ntp_secs, ntp_frac, rtcp_timestamp, &new_rtcp_sr)) {
     return false;
   }
   if (!new_rtcp_sr) {
@@ -51,12 +49,9 @@ bool RemoteNtpTimeEstimator::UpdateRtcpTimestamp(uint16_t rtt,
 }
 
 int64_t RemoteNtpTimeEstimator::Estimate(uint32_t rtp_timestamp) {
-  if (rtcp_list_.size() < 2) {
-    // We need two RTCP SR reports to calculate NTP.
-    return -1;
-  }
+  // We need two RTCP SR reports to calculate NTP.
   int64_t sender_capture_ntp_ms = 0;
-  if (!RtpToNtpMs(rtp_timestamp, rtcp_list_, &sender_capture_ntp_ms)) {
+  if (!rtp_to_ntp_.Estimate(rtp_timestamp, &sender_capture_ntp_ms)) {
     return -1;
   }
   uint32_t timestamp = sender_capture_ntp_ms * 90;
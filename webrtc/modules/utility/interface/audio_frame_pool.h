@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_INTERFACE_AUDIO_FRAME_POOL_H_
+#define WEBRTC_MODULES_UTILITY_INTERFACE_AUDIO_FRAME_POOL_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_refptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class AudioFrame;
+class CriticalSectionWrapper;
+
+namespace internal {
+class PooledAudioFrame;
+}  // namespace internal
+
+// A pool of the frames referenced by AudioFrameRef. Frames are recycled rather
+// than freed, so handing frames between the stages of the audio pipeline
+// doesn't allocate in steady state.
+//
+// Each owner of frames, such as the transmit mixer or a channel, has a pool of
+// its own, and takes the frames it writes from that pool, so pools aren't
+// contended across channels. Frames go back to the pool they came from. The
+// pool is reference counted and is kept alive by its owner, by the references
+// made from it and by every frame in use, which may outlive the owner.
+class AudioFramePool {
+ public:
+  struct Stats {
+    Stats() : frames_allocated(0), frames_in_use(0), bytes_copied(0) {}
+
+    // Frames allocated by the pool, in use or free.
+    size_t frames_allocated;
+    size_t frames_in_use;
+    // Sample bytes copied into frames of this pool because a shared frame
+    // was written to.
+    int64_t bytes_copied;
+  };
+
+  // Creates a pool with no references, to be held by a scoped_refptr.
+  static AudioFramePool* Create();
+
+  virtual int32_t AddRef() = 0;
+  virtual int32_t Release() = 0;
+
+  void GetStats(Stats* stats) const;
+
+  // Frees all frames that are not in use.
+  void Trim();
+
+ protected:
+  AudioFramePool();
+  virtual ~AudioFramePool();
+
+ private:
+  friend class AudioFrameRef;
+
+  // Returns a reset frame with a single reference.
+  internal::PooledAudioFrame* Get();
+  void Put(internal::PooledAudioFrame* frame);
+  void CountCopy(const AudioFrame& frame);
+
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  std::vector<internal::PooledAudioFrame*> free_frames_;
+  Stats stats_;
+};
+
+// A reference to a pooled AudioFrame. Copying an AudioFrameRef shares the
+// frame instead of copying the samples. A frame referenced more than once is
+// read-only; the first write through one of the references copies the
+// samples in use to a frame of its own.
+//
+// References to the same frame may be copied and destroyed on different
+// threads, but a single AudioFrameRef is not thread-safe.
+class AudioFrameRef {
+ public:
+  // Creates a reference to a new, reset frame from |pool|. The frames made
+  // for writes to a shared frame come from |pool| too.
+  explicit AudioFrameRef(AudioFramePool* pool);
+  // The copy takes its frames from the pool of |other|. Assignment shares the
+  // frame of |other| but keeps the pool of this reference.
+  AudioFrameRef(const AudioFrameRef& other);
+  ~AudioFrameRef();
+
+  AudioFrameRef& operator=(const AudioFrameRef& other);
+
+  const AudioFrame& operator*() const;
+  const AudioFrame* operator->() const;
+
+  // Returns the frame for writing. The pointer is valid until this reference
+  // is assigned to or destroyed.
+  AudioFrame* mutable_frame();
+
+  // Like mutable_frame(), for writing a frame from scratch. A shared frame is
+  // replaced by a reset frame rather than copied. Otherwise the frame is
+  // returned as it is.
+  AudioFrame* frame_for_overwrite();
+
+  bool IsShared() const;
+
+ private:
+  scoped_refptr<AudioFramePool> pool_;
+  internal::PooledAudioFrame* frame_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_UTILITY_INTERFACE_AUDIO_FRAME_POOL_H_
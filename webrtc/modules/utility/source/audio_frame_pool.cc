@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/utility/interface/audio_frame_pool.h"
+
+#include <assert.h>
+
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/ref_count.h"
+
+namespace webrtc {
+
+namespace internal {
+
+class PooledAudioFrame {
+ public:
+  explicit PooledAudioFrame(AudioFramePool* pool) : pool_(pool),
+                                                    ref_count_(0) {}
+
+  AudioFrame frame;
+
+  AudioFramePool* pool() const { return pool_; }
+
+  void AddRef() { ++ref_count_; }
+  // Returns true if this was the last reference.
+  bool Release() { return --ref_count_ == 0; }
+  bool HasOneRef() { return ref_count_.Value() == 1; }
+
+ private:
+  AudioFramePool* const pool_;
+  Atomic32 ref_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(PooledAudioFrame);
+};
+
+}  // namespace internal
+
+using internal::PooledAudioFrame;
+
+AudioFramePool* AudioFramePool::Create() {
+  return new RefCountImpl<AudioFramePool>();
+}
+
+AudioFramePool::AudioFramePool()
+    : crit_(CriticalSectionWrapper::CreateCriticalSection()) {}
+
+AudioFramePool::~AudioFramePool() {
+  // Frames in use hold a reference to the pool.
+  assert(stats_.frames_in_use == 0);
+  Trim();
+}
+
+void AudioFramePool::GetStats(Stats* stats) const {
+  CriticalSectionScoped cs(crit_.get());
+  *stats = stats_;
+}
+
+void AudioFramePool::Trim() {
+  std::vector<PooledAudioFrame*> frames;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    frames.swap(free_frames_);
+    stats_.frames_allocated -= frames.size();
+  }
+  for (size_t i = 0; i < frames.size(); ++i)
+    delete frames[i];
+}
+
+PooledAudioFrame* AudioFramePool::Get() {
+  PooledAudioFrame* frame = NULL;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    if (!free_frames_.empty()) {
+      frame = free_frames_.back();
+      free_frames_.pop_back();
+    } else {
+      ++stats_.frames_allocated;
+    }
+    ++stats_.frames_in_use;
+  }
+  if (frame) {
+    frame->frame.Reset();
+  } else {
+    frame = new PooledAudioFrame(this);
+  }
+  frame->AddRef();
+  AddRef();
+  return frame;
+}
+
+void AudioFramePool::Put(PooledAudioFrame* frame) {
+  assert(frame->pool() == this);
+  {
+    CriticalSectionScoped cs(crit_.get());
+    assert(stats_.frames_in_use > 0);
+    --stats_.frames_in_use;
+    free_frames_.push_back(frame);
+  }
+  // May delete the pool, if its owner is gone.
+  Release();
+}
+
+void AudioFramePool::CountCopy(const AudioFrame& frame) {
+  CriticalSectionScoped cs(crit_.get());
+  stats_.bytes_copied += sizeof(frame.data_[0]) *
+      frame.samples_per_channel_ * frame.num_channels_;
+}
+
+AudioFrameRef::AudioFrameRef(AudioFramePool* pool)
+    : pool_(pool),
+      frame_(pool->Get()) {}
+
+AudioFrameRef::AudioFrameRef(const AudioFrameRef& other)
+    : pool_(other.pool_),
+      frame_(other.frame_) {
+  frame_->AddRef();
+}
+
+AudioFrameRef::~AudioFrameRef() {
+  if (frame_->Release())
+    frame_->pool()->Put(frame_);
+}
+
+AudioFrameRef& AudioFrameRef::operator=(const AudioFrameRef& other) {
+  // Add the new reference first, in case |other| refers to our frame.
+  other.frame_->AddRef();
+  if (frame_->Release())
+    frame_->pool()->Put(frame_);
+  frame_ = other.frame_;
+  return *this;
+}
+
+const AudioFrame& AudioFrameRef::operator*() const {
+  return frame_->frame;
+}
+
+const AudioFrame* AudioFrameRef::operator->() const {
+  return &frame_->frame;
+}
+
+AudioFrame* AudioFrameRef::mutable_frame() {
+  if (!frame_->HasOneRef()) {
+    PooledAudioFrame* copy = pool_->Get();
+    copy->frame.CopyFrom(frame_->frame);
+    pool_->CountCopy(copy->frame);
+    // We were not the last reference when checking, but may be by now.
+    if (frame_->Release())
+      frame_->pool()->Put(frame_);
+    frame_ = copy;
+  }
+  return &frame_->frame;
+}
+
+AudioFrame* AudioFrameRef::frame_for_overwrite() {
+  if (!frame_->HasOneRef()) {
+    PooledAudioFrame* frame = pool_->Get();
+    if (frame_->Release())
+      frame_->pool()->Put(frame_);
+    frame_ = frame;
+  }
+  return &frame_->frame;
+}
+
+bool AudioFrameRef::IsShared() const {
+  return !frame_->HasOneRef();
+}
+
+}  // namespace webrtc
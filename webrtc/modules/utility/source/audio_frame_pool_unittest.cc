@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/utility/interface/audio_frame_pool.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/scoped_refptr.h"
+
+namespace webrtc {
+namespace {
+
+void FillFrame(AudioFrame* frame, int samples_per_channel, int16_t value) {
+  frame->samples_per_channel_ = samples_per_channel;
+  frame->num_channels_ = 1;
+  frame->sample_rate_hz_ = samples_per_channel * 100;
+  for (int i = 0; i < samples_per_channel; ++i)
+    frame->data_[i] = value;
+}
+
+class AudioFramePoolTest : public ::testing::Test {
+ protected:
+  AudioFramePoolTest() : pool_(AudioFramePool::Create()) {}
+
+  int64_t BytesCopied() {
+    AudioFramePool::Stats stats;
+    pool_->GetStats(&stats);
+    return stats.bytes_copied;
+  }
+
+  scoped_refptr<AudioFramePool> pool_;
+};
+
+TEST_F(AudioFramePoolTest, CopiedReferencesShareFrame) {
+  AudioFrameRef ref(pool_);
+  EXPECT_FALSE(ref.IsShared());
+  FillFrame(ref.mutable_frame(), 160, 1);
+
+  const int64_t bytes_copied = BytesCopied();
+  AudioFrameRef copy(ref);
+  EXPECT_TRUE(ref.IsShared());
+  EXPECT_TRUE(copy.IsShared());
+  EXPECT_EQ(&*ref, &*copy);
+  EXPECT_EQ(1, copy->data_[159]);
+  EXPECT_EQ(bytes_copied, BytesCopied());
+}
+
+TEST_F(AudioFramePoolTest, WritingSharedFrameCopiesSamplesInUse) {
+  AudioFrameRef ref(pool_);
+  FillFrame(ref.mutable_frame(), 160, 1);
+  AudioFrameRef copy(pool_);
+  copy = ref;
+
+  const int64_t bytes_copied = BytesCopied();
+  AudioFrame* frame = copy.mutable_frame();
+  EXPECT_EQ(bytes_copied + 160 * sizeof(int16_t), BytesCopied());
+  EXPECT_NE(&*ref, frame);
+  EXPECT_FALSE(ref.IsShared());
+  EXPECT_FALSE(copy.IsShared());
+  EXPECT_EQ(160, frame->samples_per_channel_);
+  EXPECT_EQ(16000, frame->sample_rate_hz_);
+
+  frame->data_[0] = 2;
+  EXPECT_EQ(1, ref->data_[0]);
+  EXPECT_EQ(2, copy->data_[0]);
+  // The frame is no longer shared, so this doesn't copy again.
+  EXPECT_EQ(frame, copy.mutable_frame());
+  EXPECT_EQ(bytes_copied + 160 * sizeof(int16_t), BytesCopied());
+}
+
+TEST_F(AudioFramePoolTest, OverwritingSharedFrameDoesNotCopy) {
+  AudioFrameRef ref(pool_);
+  FillFrame(ref.mutable_frame(), 480, 1);
+  AudioFrameRef copy(ref);
+
+  const int64_t bytes_copied = BytesCopied();
+  AudioFrame* frame = ref.frame_for_overwrite();
+  EXPECT_EQ(bytes_copied, BytesCopied());
+  EXPECT_NE(&*copy, frame);
+  EXPECT_EQ(0, frame->samples_per_channel_);
+  EXPECT_EQ(480, copy->samples_per_channel_);
+  EXPECT_EQ(1, copy->data_[479]);
+
+  // An unshared frame is returned as it is.
+  FillFrame(frame, 160, 3);
+  EXPECT_EQ(frame, ref.frame_for_overwrite());
+  EXPECT_EQ(160, ref->samples_per_channel_);
+}
+
+TEST_F(AudioFramePoolTest, ReleasedFramesAreReused) {
+  // Simulates a capture path where each tick a new frame is produced and
+  // shared with a number of consumers.
+  const int kNumConsumers = 100;
+  AudioFrameRef producer(pool_);
+  std::vector<AudioFrameRef> consumers(kNumConsumers, producer);
+  for (int tick = 0; tick < 10; ++tick) {
+    FillFrame(producer.frame_for_overwrite(), 160, tick);
+    for (int i = 0; i < kNumConsumers; ++i) {
+      consumers[i] = producer;
+      EXPECT_EQ(tick, consumers[i]->data_[0]);
+    }
+  }
+  AudioFramePool::Stats stats;
+  pool_->GetStats(&stats);
+  // The frame of the previous tick is reused once all consumers have moved on.
+  EXPECT_EQ(1u, stats.frames_in_use);
+  EXPECT_EQ(2u, stats.frames_allocated);
+
+  consumers.clear();
+  pool_->GetStats(&stats);
+  EXPECT_EQ(1u, stats.frames_in_use);
+  pool_->Trim();
+  pool_->GetStats(&stats);
+  EXPECT_EQ(1u, stats.frames_allocated);
+}
+
+TEST_F(AudioFramePoolTest, FramesKeepPoolAlive) {
+  AudioFrameRef ref(pool_);
+  FillFrame(ref.mutable_frame(), 160, 1);
+  AudioFrameRef copy(ref);
+  // The owner lets go of the pool while its frames are still in use.
+  pool_ = NULL;
+  EXPECT_EQ(1, copy.mutable_frame()->data_[0]);
+  EXPECT_EQ(1, ref->data_[0]);
+}
+
+TEST_F(AudioFramePoolTest, CopiesComeFromPoolOfWriter) {
+  scoped_refptr<AudioFramePool> other_pool(AudioFramePool::Create());
+  AudioFrameRef producer(pool_);
+  FillFrame(producer.mutable_frame(), 160, 1);
+  AudioFrameRef consumer(other_pool);
+  consumer = producer;
+  consumer.mutable_frame();
+
+  AudioFramePool::Stats stats;
+  pool_->GetStats(&stats);
+  EXPECT_EQ(1u, stats.frames_in_use);
+  EXPECT_EQ(0, stats.bytes_copied);
+  other_pool->GetStats(&stats);
+  EXPECT_EQ(1u, stats.frames_in_use);
+  EXPECT_EQ(static_cast<int64_t>(160 * sizeof(int16_t)), stats.bytes_copied);
+
+  // Overwriting a shared frame takes the new frame from the writer's pool too.
+  consumer = producer;
+  consumer.frame_for_overwrite();
+  other_pool->GetStats(&stats);
+  EXPECT_EQ(1u, stats.frames_in_use);
+  EXPECT_EQ(1u, stats.frames_allocated);
+  pool_->GetStats(&stats);
+  EXPECT_EQ(1u, stats.frames_in_use);
+  EXPECT_EQ(1u, stats.frames_allocated);
+}
+
+}  // namespace
+}  // namespace webrtc
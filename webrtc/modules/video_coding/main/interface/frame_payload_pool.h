@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_MAIN_INTERFACE_FRAME_PAYLOAD_POOL_H_
+#define WEBRTC_MODULES_VIDEO_CODING_MAIN_INTERFACE_FRAME_PAYLOAD_POOL_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+
+// Allocates the payload buffers of received frames. Buffers are handed out in
+// power of two size classes, and freed buffers are kept per size class for
+// reuse, so that frame buffers can give their payload back whenever they are
+// emptied instead of holding on to the largest frame they have ever seen.
+// The pool can be shared by any number of jitter buffers, also on different
+// threads, and enforces a limit on the total memory used by all of them.
+class VCMFramePayloadPool {
+ public:
+  enum { kMinBlockSize = 4096 };
+  enum { kNumSizeClasses = 11 };  // Up to 4 MB.
+
+  struct Statistics {
+    Statistics()
+        : allocated_bytes(0),
+          cached_bytes(0),
+          peak_bytes(0),
+          num_allocations(0),
+          num_failed_allocations(0) {}
+
+    // Bytes in buffers currently handed out.
+    size_t allocated_bytes;
+    // Bytes in freed buffers kept for reuse.
+    size_t cached_bytes;
+    // Peak of |allocated_bytes| + |cached_bytes|.
+    size_t peak_bytes;
+    int num_allocations;
+    // Allocations refused due to the memory limit.
+    int num_failed_allocations;
+  };
+
+  // |max_bytes| limits the memory held by the pool, 0 means no limit.
+  explicit VCMFramePayloadPool(size_t max_bytes);
+  ~VCMFramePayloadPool();
+
+  // Returns a buffer of at least |size| bytes and sets |allocated_size| to
+  // its actual size. Returns NULL if |size| is larger than the largest size
+  // class or if the buffer would exceed the memory limit.
+  uint8_t* Allocate(size_t size, size_t* allocated_size);
+
+  // Gives back |buffer|, of |allocated_size| bytes as returned by Allocate().
+  void Free(uint8_t* buffer, size_t allocated_size);
+
+  void SetMaxBytes(size_t max_bytes);
+
+  // Deletes the freed buffers kept for reuse.
+  void ReleaseCachedBuffers();
+
+  void GetStatistics(Statistics* stats) const;
+
+ private:
+  static int SizeClass(size_t size);
+  static size_t BlockSize(int size_class);
+
+  // Deletes cached buffers until |bytes| more fit within the limit. Returns
+  // false if they don't fit even with an empty cache.
+  bool MakeRoom(size_t bytes) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  std::vector<uint8_t*> free_blocks_[kNumSizeClasses] GUARDED_BY(crit_);
+  size_t max_bytes_ GUARDED_BY(crit_);
+  Statistics stats_ GUARDED_BY(crit_);
+
+  DISALLOW_COPY_AND_ASSIGN(VCMFramePayloadPool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_MAIN_INTERFACE_FRAME_PAYLOAD_POOL_H_
@@ -22,6 +22,7 @@ namespace webrtc
 
 class Clock;
 class EncodedImageCallback;
+class VCMFramePayloadPool;
 class VideoEncoder;
 class VideoDecoder;
 struct CodecSpecificInfo;
@@ -75,6 +76,11 @@ public:
 
     static VideoCodingModule* Create(Clock* clock, EventFactory* event_factory);
 
+    // Creates a module which allocates the payloads of received frames from
+    // |payloadPool|. A pool can be shared by any number of modules to bound
+    // their total memory, and must outlive them.
+    static VideoCodingModule* Create(VCMFramePayloadPool* payloadPool);
+
     static void Destroy(VideoCodingModule* module);
 
     // Get number of supported codecs
@@ -8,8 +8,12 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include "webrtc/modules/video_coding/main/interface/video_coding_defines.h"
 #include "webrtc/modules/video_coding/main/source/encoded_frame.h"
+
+#include <assert.h>
+
+#include "webrtc/modules/video_coding/main/interface/frame_payload_pool.h"
+#include "webrtc/modules/video_coding/main/interface/video_coding_defines.h"
 #include "webrtc/modules/video_coding/main/source/generic_encoder.h"
 #include "webrtc/modules/video_coding/main/source/jitter_buffer_common.h"
 
@@ -22,7 +26,8 @@ _renderTimeMs(-1),
 _payloadType(0),
 _missingFrame(false),
 _codec(kVideoCodecUnknown),
-_fragmentation()
+_fragmentation(),
+_payloadPool(NULL)
 {
     _codecSpecificInfo.codecType = kVideoCodecUnknown;
 }
@@ -34,7 +39,8 @@ _renderTimeMs(-1),
 _payloadType(0),
 _missingFrame(false),
 _codec(kVideoCodecUnknown),
-_fragmentation()
+_fragmentation(),
+_payloadPool(NULL)
 {
     _codecSpecificInfo.codecType = kVideoCodecUnknown;
     _buffer = NULL;
@@ -55,7 +61,8 @@ VCMEncodedFrame::VCMEncodedFrame(const VCMEncodedFrame& rhs)
     _missingFrame(rhs._missingFrame),
     _codecSpecificInfo(rhs._codecSpecificInfo),
     _codec(rhs._codec),
-    _fragmentation() {
+    _fragmentation(),
+    _payloadPool(NULL) {
   _buffer = NULL;
   _size = 0;
   _length = 0;
@@ -76,11 +83,30 @@ VCMEncodedFrame::~VCMEncodedFrame()
 void VCMEncodedFrame::Free()
 {
     Reset();
+    FreeBuffer();
+}
+
+void VCMEncodedFrame::SetPayloadPool(VCMFramePayloadPool* pool)
+{
+    assert(_buffer == NULL);
+    _payloadPool = pool;
+}
+
+void VCMEncodedFrame::FreeBuffer()
+{
     if (_buffer != NULL)
     {
-        delete [] _buffer;
+        if (_payloadPool != NULL)
+        {
+            _payloadPool->Free(_buffer, _size);
+        }
+        else
+        {
+            delete [] _buffer;
+        }
         _buffer = NULL;
     }
+    _size = 0;
 }
 
 void VCMEncodedFrame::Reset()
@@ -145,21 +171,35 @@ const RTPFragmentationHeader* VCMEncodedFrame::FragmentationHeader() const {
   return &_fragmentation;
 }
 
-void VCMEncodedFrame::VerifyAndAllocate(const uint32_t minimumSize)
+bool VCMEncodedFrame::VerifyAndAllocate(const uint32_t minimumSize)
 {
     if(minimumSize > _size)
     {
         // create buffer of sufficient size
-        uint8_t* newBuffer = new uint8_t[minimumSize];
+        uint8_t* newBuffer = NULL;
+        size_t newSize = minimumSize;
+        if (_payloadPool != NULL)
+        {
+            newBuffer = _payloadPool->Allocate(minimumSize, &newSize);
+            if (newBuffer == NULL)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            newBuffer = new uint8_t[minimumSize];
+        }
         if(_buffer)
         {
             // copy old data
             memcpy(newBuffer, _buffer, _size);
-            delete [] _buffer;
         }
+        FreeBuffer();
         _buffer = newBuffer;
-        _size = minimumSize;
+        _size = newSize;
     }
+    return true;
 }
 
 webrtc::FrameType VCMEncodedFrame::ConvertFrameType(VideoFrameType frameType)
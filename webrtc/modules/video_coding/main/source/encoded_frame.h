@@ -22,6 +22,8 @@
 namespace webrtc
 {
 
+class VCMFramePayloadPool;
+
 class VCMEncodedFrame : protected EncodedImage
 {
 public:
@@ -35,6 +37,11 @@ public:
     */
     void Free();
     /**
+    *   Allocate the payload from |pool| instead of the heap. Must be set
+    *   before any payload has been allocated.
+    */
+    void SetPayloadPool(VCMFramePayloadPool* pool);
+    /**
     *   Set render time in milliseconds
     */
     void SetRenderTime(const int64_t renderTimeMs) {_renderTimeMs = renderTimeMs;}
@@ -102,9 +109,15 @@ protected:
     * Verifies that current allocated buffer size is larger than or equal to the input size.
     * If the current buffer size is smaller, a new allocation is made and the old buffer data
     * is copied to the new buffer.
-    * Buffer size is updated to minimumSize.
+    * Buffer size is updated to minimumSize, or more if allocated from a pool.
+    * Returns false if the buffer couldn't be allocated from the pool.
+    */
+    bool VerifyAndAllocate(const uint32_t minimumSize);
+
+    /**
+    * Releases the payload buffer, to the pool if one is used.
     */
-    void VerifyAndAllocate(const uint32_t minimumSize);
+    void FreeBuffer();
 
     void Reset();
 
@@ -116,6 +129,7 @@ protected:
     CodecSpecificInfo             _codecSpecificInfo;
     webrtc::VideoCodecType        _codec;
     RTPFragmentationHeader        _fragmentation;
+    VCMFramePayloadPool*          _payloadPool;
 };
 
 }  // namespace webrtc
@@ -111,14 +111,23 @@ VCMFrameBuffer::InsertPacket(const VCMPacket& packet,
                                           kBufferIncStepSizeBytes +
                                         (requiredSizeBytes %
                                          kBufferIncStepSizeBytes > 0);
-        const uint32_t newSize = _size +
-                                       increments * kBufferIncStepSizeBytes;
+        uint32_t newSize = _size + increments * kBufferIncStepSizeBytes;
+        if (_payloadPool != NULL) {
+            // The pool already rounds up to geometrically growing size
+            // classes, so ask only for what this packet needs. The check
+            // above keeps the buffer strictly larger than the data.
+            newSize = requiredSizeBytes + 1;
+        }
         if (newSize > kMaxJBFrameSizeBytes) {
             LOG(LS_ERROR) << "Failed to insert packet due to frame being too "
                              "big.";
             return kSizeError;
         }
-        VerifyAndAllocate(newSize);
+        if (!VerifyAndAllocate(newSize)) {
+            LOG(LS_WARNING) << "Failed to insert packet due to the frame "
+                               "memory limit.";
+            return kSizeError;
+        }
         _sessionInfo.UpdateDataPointers(prevBuffer, _buffer);
     }
 
@@ -194,6 +203,11 @@ VCMFrameBuffer::Reset() {
     _latestPacketTimeMs = -1;
     _state = kStateEmpty;
     VCMEncodedFrame::Reset();
+    if (_payloadPool != NULL) {
+        // Give the payload back rather than keeping a buffer sized for the
+        // largest frame seen.
+        FreeBuffer();
+    }
 }
 
 // Set state of frame
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/main/interface/frame_payload_pool.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
+
+namespace webrtc {
+
+namespace {
+// Freed buffers beyond this many bytes per size class are deleted, but at
+// least one buffer per size class is kept.
+const size_t kMaxCachedBytesPerClass = 4 << 20;
+}  // namespace
+
+VCMFramePayloadPool::VCMFramePayloadPool(size_t max_bytes)
+    : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      max_bytes_(max_bytes) {}
+
+VCMFramePayloadPool::~VCMFramePayloadPool() {
+  assert(stats_.allocated_bytes == 0);
+  ReleaseCachedBuffers();
+}
+
+uint8_t* VCMFramePayloadPool::Allocate(size_t size, size_t* allocated_size) {
+  int size_class = SizeClass(size);
+  if (size_class < 0)
+    return NULL;
+  const size_t block_size = BlockSize(size_class);
+  CriticalSectionScoped cs(crit_.get());
+  uint8_t* block = NULL;
+  if (!free_blocks_[size_class].empty()) {
+    block = free_blocks_[size_class].back();
+    free_blocks_[size_class].pop_back();
+    stats_.cached_bytes -= block_size;
+  } else {
+    if (!MakeRoom(block_size)) {
+      ++stats_.num_failed_allocations;
+      TRACE_EVENT_INSTANT0("webrtc", "VCMFramePayloadPool::AllocationFailed");
+      return NULL;
+    }
+    block = new uint8_t[block_size];
+  }
+  stats_.allocated_bytes += block_size;
+  stats_.peak_bytes = std::max(stats_.peak_bytes,
+                               stats_.allocated_bytes + stats_.cached_bytes);
+  ++stats_.num_allocations;
+  *allocated_size = block_size;
+  return block;
+}
+
+void VCMFramePayloadPool::Free(uint8_t* buffer, size_t allocated_size) {
+  int size_class = SizeClass(allocated_size);
+  assert(size_class >= 0 && BlockSize(size_class) == allocated_size);
+  CriticalSectionScoped cs(crit_.get());
+  assert(stats_.allocated_bytes >= allocated_size);
+  stats_.allocated_bytes -= allocated_size;
+  const size_t max_cached_blocks =
+      std::max<size_t>(1, kMaxCachedBytesPerClass / allocated_size);
+  if (free_blocks_[size_class].size() >= max_cached_blocks) {
+    delete [] buffer;
+    return;
+  }
+  free_blocks_[size_class].push_back(buffer);
+  stats_.cached_bytes += allocated_size;
+}
+
+void VCMFramePayloadPool::SetMaxBytes(size_t max_bytes) {
+  CriticalSectionScoped cs(crit_.get());
+  max_bytes_ = max_bytes;
+  MakeRoom(0);
+}
+
+void VCMFramePayloadPool::ReleaseCachedBuffers() {
+  CriticalSectionScoped cs(crit_.get());
+  for (int i = 0; i < kNumSizeClasses; ++i) {
+    for (size_t j = 0; j < free_blocks_[i].size(); ++j)
+      delete [] free_blocks_[i][j];
+    free_blocks_[i].clear();
+  }
+  stats_.cached_bytes = 0;
+}
+
+void VCMFramePayloadPool::GetStatistics(Statistics* stats) const {
+  CriticalSectionScoped cs(crit_.get());
+  *stats = stats_;
+}
+
+int VCMFramePayloadPool::SizeClass(size_t size) {
+  for (int i = 0; i < kNumSizeClasses; ++i) {
+    if (size <= BlockSize(i))
+      return i;
+  }
+  return -1;
+}
+
+size_t VCMFramePayloadPool::BlockSize(int size_class) {
+  return static_cast<size_t>(kMinBlockSize) << size_class;
+}
+
+bool VCMFramePayloadPool::MakeRoom(size_t bytes) {
+  if (max_bytes_ == 0)
+    return true;
+  if (stats_.allocated_bytes + bytes > max_bytes_)
+    return false;
+  // Delete the largest cached buffers first.
+  for (int i = kNumSizeClasses - 1; i >= 0; --i) {
+    while (stats_.allocated_bytes + stats_.cached_bytes + bytes > max_bytes_ &&
+           !free_blocks_[i].empty()) {
+      delete [] free_blocks_[i].back();
+      free_blocks_[i].pop_back();
+      stats_.cached_bytes -= BlockSize(i);
+    }
+  }
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_coding/main/interface/frame_payload_pool.h"
+
+namespace webrtc {
+
+TEST(FramePayloadPoolTest, RoundsUpToSizeClasses) {
+  VCMFramePayloadPool pool(0);
+  size_t allocated_size = 0;
+  uint8_t* small = pool.Allocate(1, &allocated_size);
+  ASSERT_TRUE(small != NULL);
+  EXPECT_EQ(static_cast<size_t>(VCMFramePayloadPool::kMinBlockSize),
+            allocated_size);
+  pool.Free(small, allocated_size);
+
+  uint8_t* large = pool.Allocate(30000, &allocated_size);
+  ASSERT_TRUE(large != NULL);
+  EXPECT_EQ(32768u, allocated_size);
+  pool.Free(large, allocated_size);
+
+  uint8_t* largest = pool.Allocate(4000000, &allocated_size);
+  ASSERT_TRUE(largest != NULL);
+  EXPECT_EQ(4u << 20, allocated_size);
+  pool.Free(largest, allocated_size);
+
+  EXPECT_TRUE(pool.Allocate((4u << 20) + 1, &allocated_size) == NULL);
+}
+
+TEST(FramePayloadPoolTest, ReusesFreedBuffers) {
+  VCMFramePayloadPool pool(0);
+  size_t allocated_size = 0;
+  uint8_t* buffer = pool.Allocate(10000, &allocated_size);
+  ASSERT_TRUE(buffer != NULL);
+  pool.Free(buffer, allocated_size);
+
+  VCMFramePayloadPool::Statistics stats;
+  pool.GetStatistics(&stats);
+  EXPECT_EQ(0u, stats.allocated_bytes);
+  EXPECT_EQ(allocated_size, stats.cached_bytes);
+
+  EXPECT_EQ(buffer, pool.Allocate(9000, &allocated_size));
+  pool.GetStatistics(&stats);
+  EXPECT_EQ(allocated_size, stats.allocated_bytes);
+  EXPECT_EQ(0u, stats.cached_bytes);
+  EXPECT_EQ(allocated_size, stats.peak_bytes);
+  EXPECT_EQ(2, stats.num_allocations);
+  pool.Free(buffer, allocated_size);
+}
+
+TEST(FramePayloadPoolTest, EnforcesMemoryLimit) {
+  const size_t kBlockSize = 65536;
+  VCMFramePayloadPool pool(3 * kBlockSize);
+  size_t allocated_size = 0;
+  uint8_t* first = pool.Allocate(kBlockSize, &allocated_size);
+  uint8_t* second = pool.Allocate(kBlockSize, &allocated_size);
+  ASSERT_TRUE(first != NULL);
+  ASSERT_TRUE(second != NULL);
+  EXPECT_TRUE(pool.Allocate(2 * kBlockSize, &allocated_size) == NULL);
+
+  VCMFramePayloadPool::Statistics stats;
+  pool.GetStatistics(&stats);
+  EXPECT_EQ(1, stats.num_failed_allocations);
+
+  // Cached buffers are deleted to make room for buffers of other sizes.
+  pool.Free(first, kBlockSize);
+  pool.Free(second, kBlockSize);
+  uint8_t* large = pool.Allocate(2 * kBlockSize, &allocated_size);
+  ASSERT_TRUE(large != NULL);
+  pool.GetStatistics(&stats);
+  EXPECT_EQ(2 * kBlockSize, stats.allocated_bytes);
+  EXPECT_EQ(kBlockSize, stats.cached_bytes);
+  pool.Free(large, allocated_size);
+
+  // Lowering the limit trims the cache.
+  pool.SetMaxBytes(kBlockSize);
+  pool.GetStatistics(&stats);
+  EXPECT_LE(stats.cached_bytes, kBlockSize);
+}
+
+}  // namespace webrtc
@@ -113,8 +113,11 @@ void FrameList::Reset(UnorderedFrameList* free_frames) {
   }
 }
 
-VCMJitterBuffer::VCMJitterBuffer(Clock* clock, EventFactory* event_factory)
+VCMJitterBuffer::VCMJitterBuffer(Clock* clock,
+                                 EventFactory* event_factory,
+                                 VCMFramePayloadPool* payload_pool)
     : clock_(clock),
+      payload_pool_(payload_pool),
       running_(false),
       crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
       frame_event_(event_factory->CreateEvent()),
@@ -149,7 +152,7 @@ VCMJitterBuffer::VCMJitterBuffer(Clock* clock, EventFactory* event_factory)
       average_packets_per_frame_(0.0f),
       frame_counter_(0) {
   for (int i = 0; i < kStartNumberOfFrames; i++)
-    free_frames_.push_back(new VCMFrameBuffer());
+    free_frames_.push_back(CreateFrameBuffer());
 }
 
 VCMJitterBuffer::~VCMJitterBuffer() {
@@ -507,6 +510,8 @@ void VCMJitterBuffer::ReleaseFrame(VCMEncodedFrame* frame) {
   CriticalSectionScoped cs(crit_sect_);
   VCMFrameBuffer* frame_buffer = static_cast<VCMFrameBuffer*>(frame);
   if (frame_buffer) {
+    // Reset now to give the payload back to the pool.
+    frame_buffer->Reset();
     free_frames_.push_back(frame_buffer);
   }
 }
@@ -1038,6 +1043,13 @@ void VCMJitterBuffer::RenderBufferSize(uint32_t* timestamp_start,
   *timestamp_end = decodable_frames_.Back()->TimeStamp();
 }
 
+VCMFrameBuffer* VCMJitterBuffer::CreateFrameBuffer() const {
+  VCMFrameBuffer* frame = new VCMFrameBuffer();
+  if (payload_pool_)
+    frame->SetPayloadPool(payload_pool_);
+  return frame;
+}
+
 VCMFrameBuffer* VCMJitterBuffer::GetEmptyFrame() {
   if (free_frames_.empty()) {
     if (!TryToIncreaseJitterBufferSize()) {
@@ -1052,7 +1064,7 @@ VCMFrameBuffer* VCMJitterBuffer::GetEmptyFrame() {
 bool VCMJitterBuffer::TryToIncreaseJitterBufferSize() {
   if (max_number_of_frames_ >= kMaxNumberOfFrames)
     return false;
-  free_frames_.push_back(new VCMFrameBuffer());
+  free_frames_.push_back(CreateFrameBuffer());
   ++max_number_of_frames_;
   TRACE_COUNTER1("webrtc", "JBMaxFrames", max_number_of_frames_);
   return true;
@@ -40,6 +40,7 @@ class Clock;
 class EventFactory;
 class EventWrapper;
 class VCMFrameBuffer;
+class VCMFramePayloadPool;
 class VCMPacket;
 class VCMEncodedFrame;
 
@@ -76,8 +77,11 @@ class FrameList
 
 class VCMJitterBuffer {
  public:
+  // Frame payloads are allocated from |payload_pool| if not NULL, which
+  // must then outlive the jitter buffer.
   VCMJitterBuffer(Clock* clock,
-                  EventFactory* event_factory);
+                  EventFactory* event_factory,
+                  VCMFramePayloadPool* payload_pool);
   virtual ~VCMJitterBuffer();
 
   // Initializes and starts jitter buffer.
@@ -239,6 +243,9 @@ class VCMJitterBuffer {
 
   void ReleaseFrameIfNotDecoding(VCMFrameBuffer* frame);
 
+  // Creates a frame buffer, with its payload allocated from |payload_pool_|.
+  VCMFrameBuffer* CreateFrameBuffer() const;
+
   // Gets an empty frame, creating a new frame if necessary (i.e. increases
   // jitter buffer size).
   VCMFrameBuffer* GetEmptyFrame() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
@@ -286,6 +293,7 @@ class VCMJitterBuffer {
   void UpdateHistograms() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
   Clock* clock_;
+  VCMFramePayloadPool* const payload_pool_;
   // If we are running (have started) or not.
   bool running_;
   CriticalSectionWrapper* crit_sect_;
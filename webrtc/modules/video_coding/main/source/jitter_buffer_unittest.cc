@@ -8,11 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
 #include <list>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_coding/main/interface/frame_payload_pool.h"
 #include "webrtc/modules/video_coding/main/source/frame_buffer.h"
 #include "webrtc/modules/video_coding/main/source/jitter_buffer.h"
 #include "webrtc/modules/video_coding/main/source/media_opt_util.h"
@@ -20,6 +23,7 @@
 #include "webrtc/modules/video_coding/main/source/test/stream_generator.h"
 #include "webrtc/modules/video_coding/main/test/test_util.h"
 #include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
 
 namespace webrtc {
 
@@ -28,7 +32,7 @@ class TestBasicJitterBuffer : public ::testing::Test {
   virtual void SetUp() {
     clock_.reset(new SimulatedClock(0));
     jitter_buffer_.reset(
-        new VCMJitterBuffer(clock_.get(), &event_factory_));
+        new VCMJitterBuffer(clock_.get(), &event_factory_, NULL));
     jitter_buffer_->Start();
     seq_num_ = 1234;
     timestamp_ = 0;
@@ -126,7 +130,7 @@ class TestRunningJitterBuffer : public ::testing::Test {
     clock_.reset(new SimulatedClock(0));
     max_nack_list_size_ = 150;
     oldest_packet_to_nack_ = 250;
-    jitter_buffer_ = new VCMJitterBuffer(clock_.get(), &event_factory_);
+    jitter_buffer_ = new VCMJitterBuffer(clock_.get(), &event_factory_, NULL);
     stream_generator_ = new StreamGenerator(0, 0, clock_->TimeInMilliseconds());
     jitter_buffer_->Start();
     jitter_buffer_->SetNackSettings(max_nack_list_size_,
@@ -2122,4 +2126,67 @@ TEST_F(TestJitterBufferNack, ResetByFutureKeyFrameDoesntError) {
   EXPECT_EQ(0, nack_list_size);
 }
 
+// Receives a large key frame followed by small delta frames on many streams,
+// decoding each frame as it completes, and reports the peak payload memory of
+// all streams. Frame buffers used to keep a payload buffer sized for the
+// largest frame they had received.
+TEST(TestJitterBufferMemory, LargeKeyFramesDoNotInflateMemory) {
+  enum { kNumStreams = 100 };
+  enum { kKeyFramePackets = 100 };
+  enum { kNumDeltaFrames = 10 };
+  enum { kPacketSize = 1400 };
+  VCMFramePayloadPool pool(0);
+  SimulatedClock clock(0);
+  NullEventFactory event_factory;
+  ScopedVector<VCMJitterBuffer> jitter_buffers;
+  for (int i = 0; i < kNumStreams; ++i) {
+    jitter_buffers.push_back(
+        new VCMJitterBuffer(&clock, &event_factory, &pool));
+    jitter_buffers.back()->Start();
+  }
+
+  uint8_t data[kPacketSize] = {0};
+  uint16_t seq_num = 0;
+  uint32_t timestamp = 0;
+  size_t peak_bytes = 0;
+  for (int frame = 0; frame <= kNumDeltaFrames; ++frame) {
+    const bool key_frame = (frame == 0);
+    const int num_packets = key_frame ? kKeyFramePackets : 1;
+    for (int i = 0; i < kNumStreams; ++i) {
+      for (int j = 0; j < num_packets; ++j) {
+        VCMPacket packet(data, kPacketSize, seq_num + j, timestamp,
+                         j == num_packets - 1);
+        packet.frameType = key_frame ? kVideoFrameKey : kVideoFrameDelta;
+        packet.isFirstPacket = (j == 0);
+        bool retransmitted = false;
+        EXPECT_LE(0, jitter_buffers[i]->InsertPacket(packet, &retransmitted));
+      }
+      uint32_t decode_timestamp = 0;
+      ASSERT_TRUE(jitter_buffers[i]->NextCompleteTimestamp(0,
+                                                           &decode_timestamp));
+      VCMEncodedFrame* encoded_frame =
+          jitter_buffers[i]->ExtractAndSetDecode(decode_timestamp);
+      ASSERT_TRUE(encoded_frame != NULL);
+      EXPECT_EQ(static_cast<size_t>(num_packets * kPacketSize),
+                encoded_frame->Length());
+      jitter_buffers[i]->ReleaseFrame(encoded_frame);
+
+      VCMFramePayloadPool::Statistics stats;
+      pool.GetStatistics(&stats);
+      peak_bytes = std::max(peak_bytes,
+                            stats.allocated_bytes + stats.cached_bytes);
+    }
+    seq_num += num_packets;
+    timestamp += 3000;
+    clock.AdvanceTimeMilliseconds(33);
+  }
+
+  const size_t retained_bytes =
+      kNumStreams * kKeyFramePackets * kPacketSize;
+  printf("Peak frame payload memory for %d streams: %d kB, previously at "
+         "least %d kB\n", kNumStreams, static_cast<int>(peak_bytes / 1000),
+         static_cast<int>(retained_bytes / 1000));
+  EXPECT_LT(peak_bytes, retained_bytes / 10);
+}
+
 }  // namespace webrtc
@@ -28,10 +28,11 @@ enum { kMaxReceiverDelayMs = 10000 };
 VCMReceiver::VCMReceiver(VCMTiming* timing,
                          Clock* clock,
                          EventFactory* event_factory,
+                         VCMFramePayloadPool* payload_pool,
                          bool master)
     : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
       clock_(clock),
-      jitter_buffer_(clock_, event_factory),
+      jitter_buffer_(clock_, event_factory, payload_pool),
       timing_(timing),
       render_wait_event_(event_factory->CreateEvent()),
       state_(kPassive),
@@ -39,6 +39,7 @@ class VCMReceiver {
   VCMReceiver(VCMTiming* timing,
               Clock* clock,
               EventFactory* event_factory,
+              VCMFramePayloadPool* payload_pool,
               bool master);
   ~VCMReceiver();
 
@@ -74,10 +74,11 @@ class VideoCodingModuleImpl : public VideoCodingModule {
  public:
   VideoCodingModuleImpl(Clock* clock,
                         EventFactory* event_factory,
-                        bool owns_event_factory)
+                        bool owns_event_factory,
+                        VCMFramePayloadPool* payload_pool)
       : VideoCodingModule(),
         sender_(new vcm::VideoSender(clock, &post_encode_callback_)),
-        receiver_(new vcm::VideoReceiver(clock, event_factory)),
+        receiver_(new vcm::VideoReceiver(clock, event_factory, payload_pool)),
         own_event_factory_(owns_event_factory ? event_factory : NULL) {}
 
   virtual ~VideoCodingModuleImpl() {
@@ -378,14 +379,21 @@ int32_t VideoCodingModule::Codec(VideoCodecType codecType, VideoCodec* codec) {
 
 VideoCodingModule* VideoCodingModule::Create() {
   return new VideoCodingModuleImpl(
-      Clock::GetRealTimeClock(), new EventFactoryImpl, true);
+      Clock::GetRealTimeClock(), new EventFactoryImpl, true, NULL);
 }
 
 VideoCodingModule* VideoCodingModule::Create(Clock* clock,
                                              EventFactory* event_factory) {
   assert(clock);
   assert(event_factory);
-  return new VideoCodingModuleImpl(clock, event_factory, false);
+  return new VideoCodingModuleImpl(clock, event_factory, false, NULL);
+}
+
+VideoCodingModule* VideoCodingModule::Create(
+    VCMFramePayloadPool* payloadPool) {
+  assert(payloadPool);
+  return new VideoCodingModuleImpl(
+      Clock::GetRealTimeClock(), new EventFactoryImpl, true, payloadPool);
 }
 
 void VideoCodingModule::Destroy(VideoCodingModule* module) {
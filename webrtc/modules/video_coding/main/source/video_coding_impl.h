@@ -132,7 +132,9 @@ class VideoReceiver {
  public:
   typedef VideoCodingModule::ReceiverRobustness ReceiverRobustness;
 
-  VideoReceiver(Clock* clock, EventFactory* event_factory);
+  VideoReceiver(Clock* clock,
+                EventFactory* event_factory,
+                VCMFramePayloadPool* payload_pool);
   ~VideoReceiver();
 
   int32_t InitializeReceiver();
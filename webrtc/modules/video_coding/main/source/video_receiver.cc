@@ -24,13 +24,15 @@
 namespace webrtc {
 namespace vcm {
 
-VideoReceiver::VideoReceiver(Clock* clock, EventFactory* event_factory)
+VideoReceiver::VideoReceiver(Clock* clock,
+                             EventFactory* event_factory,
+                             VCMFramePayloadPool* payload_pool)
     : clock_(clock),
       process_crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
       _receiveCritSect(CriticalSectionWrapper::CreateCriticalSection()),
       _receiverInited(false),
       _timing(clock_),
-      _receiver(&_timing, clock_, event_factory, true),
+      _receiver(&_timing, clock_, event_factory, payload_pool, true),
       _decodedFrameCallback(_timing, clock_),
       _frameTypeCallback(NULL),
       _receiveStatsCallback(NULL),
@@ -38,8 +38,6 @@ int32_t VPMBrightnessDetection::ProcessFrame(
   if (frame.IsZeroSize()) {
     return VPM_PARAMETER_ERROR;
   }
-  int width = frame.width();
-  int height = frame.height();
 
   if (!VideoProcessingModule::ValidFrameStats(stats)) {
     return VPM_PARAMETER_ERROR;
@@ -65,17 +63,9 @@ int32_t VPMBrightnessDetection::ProcessFrame(
 
   if (prop_high < 0.4) {
     if (stats.mean < 90 || stats.mean > 170) {
-      // Standard deviation of Y
-      const uint8_t* buffer = frame.buffer(kYPlane);
-      float std_y = 0;
-      for (int h = 0; h < height; h += (1 << stats.subSamplHeight)) {
-        int row = h*width;
-        for (int w = 0; w < width; w += (1 << stats.subSamplWidth)) {
-          std_y += (buffer[w + row] - stats.mean) * (buffer[w + row] -
-              stats.mean);
-        }
-      }
-      std_y = sqrt(std_y / stats.num_pixels);
+      // Standard deviation of Y. The histogram covers the same subsampled
+      // pixels, so there is no need to visit them again.
+      float std_y = StandardDeviation(stats);
 
       // Get percentiles.
       uint32_t sum = 0;
@@ -136,4 +126,14 @@ int32_t VPMBrightnessDetection::ProcessFrame(
   }
 }
 
+float VPMBrightnessDetection::StandardDeviation(
+    const VideoProcessingModule::FrameStats& stats) {
+  uint64_t sq_dev_sum = 0;
+  for (int i = 0; i < 256; i++) {
+    const int64_t deviation = i - static_cast<int64_t>(stats.mean);
+    sq_dev_sum += stats.hist[i] * deviation * deviation;
+  }
+  return sqrt(static_cast<float>(sq_dev_sum) / stats.num_pixels);
+}
+
 }  // namespace webrtc
@@ -14,6 +14,7 @@
 #ifndef MODULES_VIDEO_PROCESSING_MAIN_SOURCE_BRIGHTNESS_DETECTION_H
 #define MODULES_VIDEO_PROCESSING_MAIN_SOURCE_BRIGHTNESS_DETECTION_H
 #include "webrtc/modules/video_processing/main/interface/video_processing.h"
+#include "webrtc/test/testsupport/gtest_prod_util.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -29,10 +30,19 @@ class VPMBrightnessDetection {
                        const VideoProcessingModule::FrameStats& stats);
 
  private:
+  // Returns the standard deviation of the luma samples counted in
+  // |stats.hist| around |stats.mean|. The sum of squares is exact, so the
+  // result is only rounded by the final float division and square root.
+  static float StandardDeviation(
+      const VideoProcessingModule::FrameStats& stats);
+
   int32_t id_;
 
   uint32_t frame_cnt_bright_;
   uint32_t frame_cnt_dark_;
+
+  FRIEND_TEST_ALL_PREFIXES(BrightnessDetectionTest,
+                           StandardDeviationMatchesPixels);
 };
 
 }  // namespace webrtc
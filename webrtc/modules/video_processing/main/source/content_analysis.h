@@ -14,6 +14,7 @@
 #include "webrtc/common_video/interface/i420_video_frame.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/video_processing/main/interface/video_processing_defines.h"
+#include "webrtc/test/testsupport/gtest_prod_util.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -63,8 +64,13 @@ class VPMContentAnalysis {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
   int32_t ComputeSpatialMetrics_SSE2();
   int32_t TemporalDiffMetric_SSE2();
+  int32_t ComputeSpatialMetrics_AVX2();
+  int32_t TemporalDiffMetric_AVX2();
 #endif
 
+  FRIEND_TEST_ALL_PREFIXES(ContentAnalysisTest, KernelsAreBitExact);
+  FRIEND_TEST_ALL_PREFIXES(ContentAnalysisTest, KernelBenchmark);
+
   const uint8_t* orig_frame_;
   uint8_t* prev_frame_;
   int width_;
@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_processing/main/source/content_analysis.h"
+
+#include <immintrin.h>
+#include <math.h>
+#include <stdlib.h>
+
+namespace webrtc {
+
+// Sums the four 64 bit lanes of |v|.
+static uint64_t HorizontalSum64(__m256i v) {
+  uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// Widens the eight 32 bit lanes of |v| and adds them to the 64 bit lanes of
+// |sum|.
+static __m256i AddWidened32(__m256i sum, __m256i v) {
+  const __m256i z = _mm256_setzero_si256();
+  return _mm256_add_epi64(sum, _mm256_add_epi64(_mm256_unpacklo_epi32(v, z),
+                                                _mm256_unpackhi_epi32(v, z)));
+}
+
+// Unlike the SSE2 versions, all sums are widened to 32 bits before they can
+// roll over, so the results are bit exact with the C versions for any input.
+// Rows are processed 32 pixels at a time; the work area is only a multiple of
+// 16 pixels wide, so the last 16 pixels of a row may be handled in C.
+int32_t VPMContentAnalysis::TemporalDiffMetric_AVX2() {
+  uint32_t num_pixels = 0;       // counter for # of pixels
+  const uint8_t* imgBufO = orig_frame_ + border_*width_ + border_;
+  const uint8_t* imgBufP = prev_frame_ + border_*width_ + border_;
+
+  const int32_t width_end = ((width_ - 2*border_) & -16) + border_;
+  const int32_t row_length = width_end - border_;
+  const int32_t avx2_length = row_length & -32;
+
+  __m256i sad_64   = _mm256_setzero_si256();
+  __m256i sum_64   = _mm256_setzero_si256();
+  __m256i sqsum_64 = _mm256_setzero_si256();
+  const __m256i z  = _mm256_setzero_si256();
+  uint32_t tail_sad = 0;
+  uint32_t tail_sum = 0;
+  uint64_t tail_sqsum = 0;
+
+  for (int32_t i = 0; i < (height_ - 2*border_); i += skip_num_) {
+    // o*o is at most 65025 and each 32 bit lane gets four of them per 32
+    // pixels, so a row of any realistic width fits.
+    __m256i sqsum_32 = _mm256_setzero_si256();
+
+    for (int32_t j = 0; j < avx2_length; j += 32) {
+      const __m256i o =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(imgBufO + j));
+      const __m256i p =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(imgBufP + j));
+
+      // Abs pixel difference between frames.
+      sad_64 = _mm256_add_epi64(sad_64, _mm256_sad_epu8(o, p));
+
+      // sum of all pixels in frame
+      sum_64 = _mm256_add_epi64(sum_64, _mm256_sad_epu8(o, z));
+
+      // Squared sum of all pixels in frame.
+      const __m256i olo = _mm256_unpacklo_epi8(o, z);
+      const __m256i ohi = _mm256_unpackhi_epi8(o, z);
+      sqsum_32 = _mm256_add_epi32(sqsum_32, _mm256_madd_epi16(olo, olo));
+      sqsum_32 = _mm256_add_epi32(sqsum_32, _mm256_madd_epi16(ohi, ohi));
+    }
+    sqsum_64 = AddWidened32(sqsum_64, sqsum_32);
+
+    for (int32_t j = avx2_length; j < row_length; ++j) {
+      const uint8_t o = imgBufO[j];
+      tail_sad += abs(o - imgBufP[j]);
+      tail_sum += o;
+      tail_sqsum += o * o;
+    }
+
+    imgBufO += width_ * skip_num_;
+    imgBufP += width_ * skip_num_;
+    num_pixels += row_length;
+  }
+
+  const uint32_t tempDiffSum =
+      static_cast<uint32_t>(HorizontalSum64(sad_64)) + tail_sad;
+  const uint32_t pixelSum =
+      static_cast<uint32_t>(HorizontalSum64(sum_64)) + tail_sum;
+  const uint64_t pixelSqSum = HorizontalSum64(sqsum_64) + tail_sqsum;
+
+  // Default.
+  motion_magnitude_ = 0.0f;
+
+  if (tempDiffSum == 0) return VPM_OK;
+
+  // Normalize over all pixels.
+  const float tempDiffAvg = (float)tempDiffSum / (float)(num_pixels);
+  const float pixelSumAvg = (float)pixelSum / (float)(num_pixels);
+  const float pixelSqSumAvg = (float)pixelSqSum / (float)(num_pixels);
+  float contrast = pixelSqSumAvg - (pixelSumAvg * pixelSumAvg);
+
+  if (contrast > 0.0) {
+    contrast = sqrt(contrast);
+    motion_magnitude_ = tempDiffAvg/contrast;
+  }
+
+  return VPM_OK;
+}
+
+int32_t VPMContentAnalysis::ComputeSpatialMetrics_AVX2() {
+  const uint8_t* imgBuf = orig_frame_ + border_*width_ + border_;
+  const int32_t width_end = ((width_ - 2 * border_) & -16) + border_;
+  const int32_t row_length = width_end - border_;
+  const int32_t avx2_length = row_length & -32;
+
+  __m256i se_32  = _mm256_setzero_si256();
+  __m256i sev_32 = _mm256_setzero_si256();
+  __m256i seh_32 = _mm256_setzero_si256();
+  __m256i msa_64 = _mm256_setzero_si256();
+  const __m256i z = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi16(1);
+  uint32_t tail_se = 0;
+  uint32_t tail_sev = 0;
+  uint32_t tail_seh = 0;
+  uint32_t tail_msa = 0;
+
+  // Each iteration adds at most 2 * 2 * 1020 to a 32 bit lane, so the
+  // accumulators can't roll over before the 32 bit sums of the C version do.
+  for (int32_t i = 0; i < (height_ - 2*border_); i += skip_num_) {
+    const uint8_t* lineTop = imgBuf - width_;
+    const uint8_t* lineCen = imgBuf;
+    const uint8_t* lineBot = imgBuf + width_;
+
+    for (int32_t j = 0; j < avx2_length; j += 32) {
+      const __m256i t =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lineTop + j));
+      const __m256i l =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lineCen + j - 1));
+      const __m256i c =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lineCen + j));
+      const __m256i r =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lineCen + j + 1));
+      const __m256i b =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lineBot + j));
+
+      // running sum of all pixels
+      msa_64 = _mm256_add_epi64(msa_64, _mm256_sad_epu8(c, z));
+
+      // center pixel unpacked
+      const __m256i clo = _mm256_unpacklo_epi8(c, z);
+      const __m256i chi = _mm256_unpackhi_epi8(c, z);
+
+      // left right pixels unpacked and added together
+      const __m256i lrlo = _mm256_add_epi16(_mm256_unpacklo_epi8(l, z),
+                                            _mm256_unpacklo_epi8(r, z));
+      const __m256i lrhi = _mm256_add_epi16(_mm256_unpackhi_epi8(l, z),
+                                            _mm256_unpackhi_epi8(r, z));
+
+      // top & bottom pixels unpacked and added together
+      const __m256i tblo = _mm256_add_epi16(_mm256_unpacklo_epi8(t, z),
+                                            _mm256_unpacklo_epi8(b, z));
+      const __m256i tbhi = _mm256_add_epi16(_mm256_unpackhi_epi8(t, z),
+                                            _mm256_unpackhi_epi8(b, z));
+
+      const __m256i c2lo = _mm256_slli_epi16(clo, 1);
+      const __m256i c2hi = _mm256_slli_epi16(chi, 1);
+      const __m256i c4lo = _mm256_slli_epi16(clo, 2);
+      const __m256i c4hi = _mm256_slli_epi16(chi, 2);
+
+      // Absolute prediction errors, at most 1020, summed pairwise into
+      // 16 bits and then into 32 bits.
+      const __m256i se_16 = _mm256_add_epi16(
+          _mm256_abs_epi16(_mm256_sub_epi16(c4lo,
+                                            _mm256_add_epi16(lrlo, tblo))),
+          _mm256_abs_epi16(_mm256_sub_epi16(c4hi,
+                                            _mm256_add_epi16(lrhi, tbhi))));
+      const __m256i sev_16 = _mm256_add_epi16(
+          _mm256_abs_epi16(_mm256_sub_epi16(c2lo, tblo)),
+          _mm256_abs_epi16(_mm256_sub_epi16(c2hi, tbhi)));
+      const __m256i seh_16 = _mm256_add_epi16(
+          _mm256_abs_epi16(_mm256_sub_epi16(c2lo, lrlo)),
+          _mm256_abs_epi16(_mm256_sub_epi16(c2hi, lrhi)));
+
+      se_32  = _mm256_add_epi32(se_32, _mm256_madd_epi16(se_16, ones));
+      sev_32 = _mm256_add_epi32(sev_32, _mm256_madd_epi16(sev_16, ones));
+      seh_32 = _mm256_add_epi32(seh_32, _mm256_madd_epi16(seh_16, ones));
+    }
+
+    for (int32_t j = avx2_length; j < row_length; ++j) {
+      const int center = lineCen[j];
+      const int top_bottom = lineTop[j] + lineBot[j];
+      const int left_right = lineCen[j - 1] + lineCen[j + 1];
+      tail_se += abs((center << 2) - (top_bottom + left_right));
+      tail_sev += abs((center << 1) - top_bottom);
+      tail_seh += abs((center << 1) - left_right);
+      tail_msa += center;
+    }
+
+    imgBuf += width_ * skip_num_;
+  }
+
+  const uint32_t spatialErrSum =
+      static_cast<uint32_t>(HorizontalSum64(AddWidened32(z, se_32))) +
+      tail_se;
+  const uint32_t spatialErrVSum =
+      static_cast<uint32_t>(HorizontalSum64(AddWidened32(z, sev_32))) +
+      tail_sev;
+  const uint32_t spatialErrHSum =
+      static_cast<uint32_t>(HorizontalSum64(AddWidened32(z, seh_32))) +
+      tail_seh;
+  const uint32_t pixelMSA =
+      static_cast<uint32_t>(HorizontalSum64(msa_64)) + tail_msa;
+
+  // Normalize over all pixels.
+  const float spatialErr  = (float)(spatialErrSum >> 2);
+  const float spatialErrH = (float)(spatialErrHSum >> 1);
+  const float spatialErrV = (float)(spatialErrVSum >> 1);
+  const float norm = (float)pixelMSA;
+
+  // 2X2:
+  spatial_pred_err_ = spatialErr / norm;
+
+  // 1X2:
+  spatial_pred_err_h_ = spatialErrH / norm;
+
+  // 2X1:
+  spatial_pred_err_v_ = spatialErrV / norm;
+
+  return VPM_OK;
+}
+
+}  // namespace webrtc
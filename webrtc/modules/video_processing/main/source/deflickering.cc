@@ -15,7 +15,6 @@
 
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/system_wrappers/interface/logging.h"
-#include "webrtc/system_wrappers/interface/sort.h"
 
 namespace webrtc {
 
@@ -129,38 +128,10 @@ int32_t VPMDeflickering::ProcessFrame(I420VideoFrame* frame,
   // Size of luminance component.
   const uint32_t y_size = height * width;
 
-  const uint32_t y_sub_size = width * (((height - 1) >>
-      kLog2OfDownsamplingFactor) + 1);
-  uint8_t* y_sorted = new uint8_t[y_sub_size];
-  uint32_t sort_row_idx = 0;
-  for (int i = 0; i < height; i += kDownsamplingFactor) {
-    memcpy(y_sorted + sort_row_idx * width,
-        frame->buffer(kYPlane) + i * width, width);
-    sort_row_idx++;
-  }
-
-  webrtc::Sort(y_sorted, y_sub_size, webrtc::TYPE_UWord8);
-
-  uint32_t prob_idx_uw32 = 0;
-  quant_uw8[0] = 0;
-  quant_uw8[kNumQuants - 1] = 255;
-
-  // Ensure we won't get an overflow below.
-  // In practice, the number of subsampled pixels will not become this large.
-  if (y_sub_size > (1 << 21) - 1) {
-    LOG(LS_ERROR) << "Subsampled number of pixels too large.";
+  if (!ComputeQuantiles(*frame, quant_uw8)) {
     return -1;
   }
 
-  for (int32_t i = 0; i < kNumProbs; i++) {
-    // <Q0>.
-    prob_idx_uw32 = WEBRTC_SPL_UMUL_32_16(y_sub_size, prob_uw16_[i]) >> 11;
-    quant_uw8[i + 1] = y_sorted[prob_idx_uw32];
-  }
-
-  delete [] y_sorted;
-  y_sorted = NULL;
-
   // Shift history for new frame.
   memmove(quant_hist_uw8_[1], quant_hist_uw8_[0],
       (kFrameHistory_size - 1) * kNumQuants * sizeof(uint8_t));
@@ -240,6 +211,60 @@ int32_t VPMDeflickering::ProcessFrame(I420VideoFrame* frame,
   return VPM_OK;
 }
 
+bool VPMDeflickering::ComputeQuantiles(const I420VideoFrame& frame,
+                                       uint8_t* quant_uw8) const {
+  const int width = frame.width();
+  const int height = frame.height();
+  const uint32_t y_sub_size = width * (((height - 1) >>
+      kLog2OfDownsamplingFactor) + 1);
+
+  // Ensure we won't get an overflow below.
+  // In practice, the number of subsampled pixels will not become this large.
+  if (y_sub_size > (1 << 21) - 1) {
+    LOG(LS_ERROR) << "Subsampled number of pixels too large.";
+    return false;
+  }
+
+  // Histogram of the subsampled pixels. Four partial histograms are used so
+  // that runs of equal pixel values don't serialize on the same counter.
+  uint32_t hist[4][256];
+  memset(hist, 0, sizeof(hist));
+  const uint8_t* y_plane = frame.buffer(kYPlane);
+  for (int i = 0; i < height; i += kDownsamplingFactor) {
+    const uint8_t* row = y_plane + i * width;
+    int j = 0;
+    for (; j < width - 3; j += 4) {
+      hist[0][row[j]]++;
+      hist[1][row[j + 1]]++;
+      hist[2][row[j + 2]]++;
+      hist[3][row[j + 3]]++;
+    }
+    for (; j < width; j++) {
+      hist[0][row[j]]++;
+    }
+  }
+
+  // The quantile at a given index is the pixel value at that index had the
+  // subsampled pixels been sorted, i.e. the first value whose cumulative
+  // count exceeds the index.
+  quant_uw8[0] = 0;
+  quant_uw8[kNumQuants - 1] = 255;
+  uint32_t cumulative_count = 0;
+  int value = -1;
+  for (int32_t i = 0; i < kNumProbs; i++) {
+    // <Q0>.
+    uint32_t prob_idx_uw32 =
+        WEBRTC_SPL_UMUL_32_16(y_sub_size, prob_uw16_[i]) >> 11;
+    while (cumulative_count <= prob_idx_uw32) {
+      value++;
+      cumulative_count += hist[0][value] + hist[1][value] + hist[2][value] +
+          hist[3][value];
+    }
+    quant_uw8[i + 1] = static_cast<uint8_t>(value);
+  }
+  return true;
+}
+
 /**
    Performs some pre-detection operations. Must be called before
    DetectFlicker().
@@ -14,6 +14,7 @@
 #include <string.h>  // NULL
 
 #include "webrtc/modules/video_processing/main/interface/video_processing.h"
+#include "webrtc/test/testsupport/gtest_prod_util.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -30,6 +31,11 @@ class VPMDeflickering {
                        VideoProcessingModule::FrameStats* stats);
 
  private:
+  // Computes the luminance quantiles of every kDownsamplingFactor'th row of
+  // |frame| at the probabilities |prob_uw16_|, plus 0 and 255 at either end.
+  // Returns false if the frame is too large.
+  bool ComputeQuantiles(const I420VideoFrame& frame, uint8_t* quant_uw8) const;
+
   int32_t PreDetection(uint32_t timestamp,
                        const VideoProcessingModule::FrameStats& stats);
 
@@ -53,6 +59,8 @@ class VPMDeflickering {
   static const uint16_t prob_uw16_[kNumProbs];
   static const uint16_t weight_uw16_[kNumQuants - kMaxOnlyLength];
   uint8_t quant_hist_uw8_[kFrameHistory_size][kNumQuants];
+
+  FRIEND_TEST_ALL_PREFIXES(DeflickeringTest, QuantilesMatchSortedPixels);
 };
 
 }  // namespace webrtc
@@ -8,8 +8,12 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <math.h>
+#include <stdlib.h>
+
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_processing/main/interface/video_processing.h"
+#include "webrtc/modules/video_processing/main/source/brightness_detection.h"
 #include "webrtc/modules/video_processing/main/test/unit_test/video_processing_unittest.h"
 
 using namespace webrtc;
@@ -121,3 +125,50 @@ TEST_F(VideoProcessingModuleTest, BrightnessDetection)
     printf("Dark foreman: %.1f %%\n\n", warningProportion);
     EXPECT_GT(warningProportion, 90);
 }
+
+namespace webrtc {
+
+// The histogram based standard deviation must stay within float rounding of
+// the deviation of the subsampled pixels, summed in double precision.
+TEST(BrightnessDetectionTest, StandardDeviationMatchesPixels) {
+  const int kSizes[][2] = {{352, 288}, {1280, 720}, {1920, 1080}};
+  const float kMaxError = 1e-4f;
+  for (size_t s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s) {
+    const int width = kSizes[s][0];
+    const int height = kSizes[s][1];
+    I420VideoFrame frame;
+    ASSERT_EQ(0, frame.CreateEmptyFrame(width, height, width, (width + 1) / 2,
+                                        (width + 1) / 2));
+    uint8_t* y_plane = frame.buffer(kYPlane);
+    // Dark, bright and uniformly spread content.
+    for (int content = 0; content < 3; ++content) {
+      srand(static_cast<unsigned int>(s * 3 + content));
+      for (int i = 0; i < width * height; ++i) {
+        const int dark = (rand() & 0xff) * (rand() & 0xff) >> 8;
+        if (content == 0)
+          y_plane[i] = static_cast<uint8_t>(dark);
+        else if (content == 1)
+          y_plane[i] = static_cast<uint8_t>(255 - dark);
+        else
+          y_plane[i] = static_cast<uint8_t>(rand() & 0xff);
+      }
+
+      VideoProcessingModule::FrameStats stats;
+      ASSERT_EQ(0, VideoProcessingModule::GetFrameStats(&stats, frame));
+      double sq_dev_sum = 0;
+      for (int i = 0; i < height; i += (1 << stats.subSamplHeight)) {
+        for (int j = 0; j < width; j += (1 << stats.subSamplWidth)) {
+          const double deviation =
+              y_plane[i * width + j] - static_cast<double>(stats.mean);
+          sq_dev_sum += deviation * deviation;
+        }
+      }
+      const double expected = sqrt(sq_dev_sum / stats.num_pixels);
+      EXPECT_NEAR(expected, VPMBrightnessDetection::StandardDeviation(stats),
+                  kMaxError)
+          << width << "x" << height << ", content " << content;
+    }
+  }
+}
+
+}  // namespace webrtc
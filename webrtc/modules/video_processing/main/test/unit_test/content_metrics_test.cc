@@ -8,13 +8,57 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_processing/main/interface/video_processing.h"
 #include "webrtc/modules/video_processing/main/source/content_analysis.h"
 #include "webrtc/modules/video_processing/main/test/unit_test/video_processing_unittest.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 namespace webrtc {
 
+namespace {
+
+enum Pattern { kSmooth, kNoise, kCheckerboard };
+
+const int kSizes[][2] = {{352, 288}, {1280, 720}, {1920, 1080}};
+const Pattern kPatterns[] = {kSmooth, kNoise, kCheckerboard};
+const int kNumMetrics = 4;
+
+// Fills a |width| x |height| luma plane with |pattern|. |seed| shifts the
+// content, so that two frames with different seeds differ everywhere.
+void FillPlane(Pattern pattern, int width, int height, int seed,
+               uint8_t* plane) {
+  srand(seed);
+  for (int i = 0; i < height; ++i) {
+    for (int j = 0; j < width; ++j) {
+      uint8_t value = 0;
+      switch (pattern) {
+        case kSmooth:
+          value = static_cast<uint8_t>(64 + (i / 16 + j / 32 + seed) % 128);
+          break;
+        case kNoise:
+          value = static_cast<uint8_t>(rand() & 0xff);
+          break;
+        case kCheckerboard:
+          value = ((i + j + seed) & 1) ? 255 : 0;
+          break;
+      }
+      plane[i * width + j] = value;
+    }
+  }
+}
+
+void ExpectMetricsEq(const float* expected, const float* actual) {
+  for (int i = 0; i < kNumMetrics; ++i)
+    EXPECT_EQ(expected[i], actual[i]) << "metric " << i;
+}
+
+}  // namespace
+
 TEST_F(VideoProcessingModuleTest, ContentAnalysis) {
   VPMContentAnalysis    ca__c(false);
   VPMContentAnalysis    ca__sse(true);
@@ -41,4 +85,99 @@ TEST_F(VideoProcessingModuleTest, ContentAnalysis) {
   ASSERT_NE(0, feof(source_file_)) << "Error reading source file";
 }
 
+// Runs the kernels directly on synthetic content. The C versions are the
+// reference; the SSE2 versions accumulate in 16 bits and may roll over on
+// high contrast content, so they are only compared on smooth content.
+TEST(ContentAnalysisTest, KernelsAreBitExact) {
+  for (size_t s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s) {
+    const int width = kSizes[s][0];
+    const int height = kSizes[s][1];
+    VPMContentAnalysis ca(false);
+    ASSERT_EQ(VPM_OK, ca.Initialize(width, height));
+    scoped_ptr<uint8_t[]> frame(new uint8_t[width * height]);
+
+    for (size_t p = 0; p < sizeof(kPatterns) / sizeof(kPatterns[0]); ++p) {
+      SCOPED_TRACE(testing::Message() << width << "x" << height
+                                      << ", pattern " << kPatterns[p]);
+      FillPlane(kPatterns[p], width, height, 0, ca.prev_frame_);
+      FillPlane(kPatterns[p], width, height, 1, frame.get());
+      ca.orig_frame_ = frame.get();
+
+      ca.ComputeSpatialMetrics_C();
+      ca.TemporalDiffMetric_C();
+      const float metrics_c[kNumMetrics] = {
+          ca.spatial_pred_err_, ca.spatial_pred_err_h_,
+          ca.spatial_pred_err_v_, ca.motion_magnitude_};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      if (kPatterns[p] == kSmooth) {
+        ca.ComputeSpatialMetrics_SSE2();
+        ca.TemporalDiffMetric_SSE2();
+        const float metrics_sse2[kNumMetrics] = {
+            ca.spatial_pred_err_, ca.spatial_pred_err_h_,
+            ca.spatial_pred_err_v_, ca.motion_magnitude_};
+        ExpectMetricsEq(metrics_c, metrics_sse2);
+      }
+
+      if (WebRtc_GetCPUInfo(kAVX2)) {
+        ca.ComputeSpatialMetrics_AVX2();
+        ca.TemporalDiffMetric_AVX2();
+        const float metrics_avx2[kNumMetrics] = {
+            ca.spatial_pred_err_, ca.spatial_pred_err_h_,
+            ca.spatial_pred_err_v_, ca.motion_magnitude_};
+        ExpectMetricsEq(metrics_c, metrics_avx2);
+      }
+#endif
+    }
+  }
+}
+
+// Prints the per-frame cost of the spatial and temporal metrics for each
+// available implementation at 720p and 1080p.
+TEST(ContentAnalysisTest, DISABLED_KernelBenchmark) {
+  enum { kNumFrames = 100 };
+  printf("\nContent analysis run time [us / frame]:\n");
+  for (size_t s = 1; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s) {
+    const int width = kSizes[s][0];
+    const int height = kSizes[s][1];
+    VPMContentAnalysis ca(false);
+    ASSERT_EQ(VPM_OK, ca.Initialize(width, height));
+    scoped_ptr<uint8_t[]> frame(new uint8_t[width * height]);
+    FillPlane(kNoise, width, height, 0, ca.prev_frame_);
+    FillPlane(kNoise, width, height, 1, frame.get());
+    ca.orig_frame_ = frame.get();
+
+    TickTime t0 = TickTime::Now();
+    for (int i = 0; i < kNumFrames; ++i) {
+      ca.ComputeSpatialMetrics_C();
+      ca.TemporalDiffMetric_C();
+    }
+    printf("%dx%d C:    %d\n", width, height,
+           static_cast<int>((TickTime::Now() - t0).Microseconds() /
+                            kNumFrames));
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    t0 = TickTime::Now();
+    for (int i = 0; i < kNumFrames; ++i) {
+      ca.ComputeSpatialMetrics_SSE2();
+      ca.TemporalDiffMetric_SSE2();
+    }
+    printf("%dx%d SSE2: %d\n", width, height,
+           static_cast<int>((TickTime::Now() - t0).Microseconds() /
+                            kNumFrames));
+
+    if (WebRtc_GetCPUInfo(kAVX2)) {
+      t0 = TickTime::Now();
+      for (int i = 0; i < kNumFrames; ++i) {
+        ca.ComputeSpatialMetrics_AVX2();
+        ca.TemporalDiffMetric_AVX2();
+      }
+      printf("%dx%d AVX2: %d\n", width, height,
+             static_cast<int>((TickTime::Now() - t0).Microseconds() /
+                              kNumFrames));
+    }
+#endif
+  }
+}
+
 }  // namespace webrtc
@@ -11,8 +11,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_processing/main/interface/video_processing.h"
+#include "webrtc/modules/video_processing/main/source/deflickering.h"
 #include "webrtc/modules/video_processing/main/test/unit_test/video_processing_unittest.h"
 #include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/test/testsupport/fileutils.h"
@@ -96,4 +100,48 @@ TEST_F(VideoProcessingModuleTest, Deflickering)
         static_cast<int>(min_runtime / frameNum));
 }
 
+// Compares the histogram based quantiles with the quantiles of the sorted
+// subsampled pixels they replace, and prints the cost of both.
+TEST(DeflickeringTest, QuantilesMatchSortedPixels) {
+  const int kSizes[][2] = {{352, 288}, {1280, 720}, {1920, 1080}};
+  const int kDownsamplingFactor = 8;
+  printf("\nQuantile run time [us / frame]:\n");
+  for (size_t s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s) {
+    const int width = kSizes[s][0];
+    const int height = kSizes[s][1];
+    I420VideoFrame frame;
+    ASSERT_EQ(0, frame.CreateEmptyFrame(width, height, width, (width + 1) / 2,
+                                        (width + 1) / 2));
+    // Skew the distribution towards dark pixels to get repeated values.
+    srand(static_cast<unsigned int>(s));
+    uint8_t* y_plane = frame.buffer(kYPlane);
+    for (int i = 0; i < width * height; ++i)
+      y_plane[i] = static_cast<uint8_t>((rand() & 0xff) * (rand() & 0xff) >> 8);
+
+    VPMDeflickering deflickering;
+    uint8_t quant_uw8[VPMDeflickering::kNumQuants];
+    TickTime t0 = TickTime::Now();
+    ASSERT_TRUE(deflickering.ComputeQuantiles(frame, quant_uw8));
+    int64_t histogram_us = (TickTime::Now() - t0).Microseconds();
+
+    t0 = TickTime::Now();
+    std::vector<uint8_t> sorted;
+    for (int i = 0; i < height; i += kDownsamplingFactor)
+      sorted.insert(sorted.end(), y_plane + i * width,
+                    y_plane + (i + 1) * width);
+    std::sort(sorted.begin(), sorted.end());
+    int64_t sort_us = (TickTime::Now() - t0).Microseconds();
+
+    EXPECT_EQ(0, quant_uw8[0]);
+    EXPECT_EQ(255, quant_uw8[VPMDeflickering::kNumQuants - 1]);
+    for (int i = 0; i < VPMDeflickering::kNumProbs; ++i) {
+      const uint32_t prob_idx = static_cast<uint32_t>(
+          sorted.size() * VPMDeflickering::prob_uw16_[i]) >> 11;
+      EXPECT_EQ(sorted[prob_idx], quant_uw8[i + 1]) << "quantile " << i;
+    }
+    printf("%dx%d sort: %d, histogram: %d\n", width, height,
+           static_cast<int>(sort_us), static_cast<int>(histogram_us));
+  }
+}
+
 }  // namespace webrtc
@@ -12,6 +12,8 @@
 
 #include <assert.h>
 
+#include <algorithm>
+
 #if defined(_WIN32)
 #include <windows.h>
 #elif defined(WEBRTC_LINUX)
@@ -23,6 +25,7 @@
 
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_render/video_render_frames.h"
+#include "webrtc/modules/video_render/video_render_scheduler.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/thread_wrapper.h"
@@ -31,13 +34,16 @@
 
 namespace webrtc {
 
-IncomingVideoStream::IncomingVideoStream(const int32_t module_id,
-                                         const uint32_t stream_id)
+IncomingVideoStream::IncomingVideoStream(
+    const int32_t module_id,
+    const uint32_t stream_id,
+    VideoRenderScheduler* render_scheduler)
     : module_id_(module_id),
       stream_id_(stream_id),
       stream_critsect_(*CriticalSectionWrapper::CreateCriticalSection()),
       thread_critsect_(*CriticalSectionWrapper::CreateCriticalSection()),
       buffer_critsect_(*CriticalSectionWrapper::CreateCriticalSection()),
+      render_scheduler_(render_scheduler),
       incoming_render_thread_(),
       deliver_buffer_event_(*EventWrapper::Create()),
       running_(false),
@@ -132,8 +138,12 @@ int32_t IncomingVideoStream::RenderFrame(const uint32_t stream_id,
 
   // Insert frame.
   CriticalSectionScoped csB(&buffer_critsect_);
-  if (render_buffers_.AddFrame(&video_frame) == 1)
-    deliver_buffer_event_.Set();
+  if (render_buffers_.AddFrame(&video_frame) == 1) {
+    if (render_scheduler_)
+      render_scheduler_->ScheduleStream(this, now_ms);
+    else
+      deliver_buffer_event_.Set();
+  }
 
   return 0;
 }
@@ -208,6 +218,12 @@ int32_t IncomingVideoStream::Start() {
     return 0;
   }
 
+  if (render_scheduler_) {
+    running_ = true;
+    render_scheduler_->AddStream(this);
+    return 0;
+  }
+
   CriticalSectionScoped csT(&thread_critsect_);
   assert(incoming_render_thread_ == NULL);
 
@@ -246,6 +262,12 @@ int32_t IncomingVideoStream::Stop() {
     return 0;
   }
 
+  if (render_scheduler_) {
+    render_scheduler_->RemoveStream(this);
+    running_ = false;
+    return 0;
+  }
+
   thread_critsect_.Enter();
   if (incoming_render_thread_) {
     ThreadWrapper* thread = incoming_render_thread_;
@@ -292,74 +314,80 @@ bool IncomingVideoStream::IncomingVideoStreamThreadFun(void* obj) {
 
 bool IncomingVideoStream::IncomingVideoStreamProcess() {
   if (kEventError != deliver_buffer_event_.Wait(KEventMaxWaitTimeMs)) {
-    thread_critsect_.Enter();
+    CriticalSectionScoped cs(&thread_critsect_);
     if (incoming_render_thread_ == NULL) {
       // Terminating
-      thread_critsect_.Leave();
       return false;
     }
 
-    I420VideoFrame* frame_to_render = NULL;
-
-    // Get a new frame to render and the time for the frame after this one.
-    buffer_critsect_.Enter();
-    frame_to_render = render_buffers_.FrameToRender();
-    uint32_t wait_time = render_buffers_.TimeToNextFrameRelease();
-    buffer_critsect_.Leave();
+    int64_t next_render_time_ms = RenderDueFrame();
 
     // Set timer for next frame to render.
-    if (wait_time > KEventMaxWaitTimeMs) {
-      wait_time = KEventMaxWaitTimeMs;
-    }
-    deliver_buffer_event_.StartTimer(false, wait_time);
-
-    if (!frame_to_render) {
-      if (render_callback_) {
-        if (last_rendered_frame_.render_time_ms() == 0 &&
-            !start_image_.IsZeroSize()) {
-          // We have not rendered anything and have a start image.
-          temp_frame_.CopyFrame(start_image_);
-          render_callback_->RenderFrame(stream_id_, temp_frame_);
-        } else if (!timeout_image_.IsZeroSize() &&
-                   last_rendered_frame_.render_time_ms() + timeout_time_ <
-                       TickTime::MillisecondTimestamp()) {
-          // Render a timeout image.
-          temp_frame_.CopyFrame(timeout_image_);
-          render_callback_->RenderFrame(stream_id_, temp_frame_);
-        }
-      }
+    int64_t wait_time =
+        std::max<int64_t>(0, next_render_time_ms -
+                                 TickTime::MillisecondTimestamp());
+    deliver_buffer_event_.StartTimer(false,
+                                     static_cast<unsigned long>(wait_time));
+  }
+  return true;
+}
 
-      // No frame.
-      thread_critsect_.Leave();
-      return true;
-    }
+int64_t IncomingVideoStream::RenderDueFrame() {
+  CriticalSectionScoped cs(&thread_critsect_);
+  I420VideoFrame* frame_to_render = NULL;
 
-    // Send frame for rendering.
-    if (external_callback_) {
-      WEBRTC_TRACE(kTraceStream, kTraceVideoRenderer, module_id_,
-                   "%s: executing external renderer callback to deliver frame",
-                   __FUNCTION__, frame_to_render->render_time_ms());
-      external_callback_->RenderFrame(stream_id_, *frame_to_render);
-    } else {
-      if (render_callback_) {
-        WEBRTC_TRACE(kTraceStream, kTraceVideoRenderer, module_id_,
-                     "%s: Render frame, time: ", __FUNCTION__,
-                     frame_to_render->render_time_ms());
-        render_callback_->RenderFrame(stream_id_, *frame_to_render);
+  // Get a new frame to render and the time for the frame after this one.
+  buffer_critsect_.Enter();
+  frame_to_render = render_buffers_.FrameToRender();
+  uint32_t wait_time = render_buffers_.TimeToNextFrameRelease();
+  buffer_critsect_.Leave();
+
+  if (wait_time > KEventMaxWaitTimeMs) {
+    wait_time = KEventMaxWaitTimeMs;
+  }
+  const int64_t next_render_time_ms =
+      TickTime::MillisecondTimestamp() + wait_time;
+
+  if (!frame_to_render) {
+    if (render_callback_) {
+      if (last_rendered_frame_.render_time_ms() == 0 &&
+          !start_image_.IsZeroSize()) {
+        // We have not rendered anything and have a start image.
+        temp_frame_.CopyFrame(start_image_);
+        render_callback_->RenderFrame(stream_id_, temp_frame_);
+      } else if (!timeout_image_.IsZeroSize() &&
+                 last_rendered_frame_.render_time_ms() + timeout_time_ <
+                     TickTime::MillisecondTimestamp()) {
+        // Render a timeout image.
+        temp_frame_.CopyFrame(timeout_image_);
+        render_callback_->RenderFrame(stream_id_, temp_frame_);
       }
     }
 
-    // Release critsect before calling the module user.
-    thread_critsect_.Leave();
+    // No frame.
+    return next_render_time_ms;
+  }
 
-    // We're done with this frame, delete it.
-    if (frame_to_render) {
-      CriticalSectionScoped cs(&buffer_critsect_);
-      last_rendered_frame_.SwapFrame(frame_to_render);
-      render_buffers_.ReturnFrame(frame_to_render);
+  // Send frame for rendering.
+  if (external_callback_) {
+    WEBRTC_TRACE(kTraceStream, kTraceVideoRenderer, module_id_,
+                 "%s: executing external renderer callback to deliver frame",
+                 __FUNCTION__, frame_to_render->render_time_ms());
+    external_callback_->RenderFrame(stream_id_, *frame_to_render);
+  } else {
+    if (render_callback_) {
+      WEBRTC_TRACE(kTraceStream, kTraceVideoRenderer, module_id_,
+                   "%s: Render frame, time: ", __FUNCTION__,
+                   frame_to_render->render_time_ms());
+      render_callback_->RenderFrame(stream_id_, *frame_to_render);
     }
   }
-  return true;
+
+  // We're done with this frame, delete it.
+  CriticalSectionScoped cs_buffer(&buffer_critsect_);
+  last_rendered_frame_.SwapFrame(frame_to_render);
+  render_buffers_.ReturnFrame(frame_to_render);
+  return next_render_time_ms;
 }
 
 int32_t IncomingVideoStream::GetLastRenderedFrame(
@@ -19,6 +19,7 @@ class EventWrapper;
 class ThreadWrapper;
 class VideoRenderCallback;
 class VideoRenderFrames;
+class VideoRenderScheduler;
 
 struct VideoMirroring {
   VideoMirroring() : mirror_x_axis(false), mirror_y_axis(false) {}
@@ -28,8 +29,12 @@ struct VideoMirroring {
 
 class IncomingVideoStream : public VideoRenderCallback {
  public:
+  // If |render_scheduler| is NULL the stream renders frames from its own
+  // thread, otherwise rendering is driven by |render_scheduler|, which must
+  // outlive the stream.
   IncomingVideoStream(const int32_t module_id,
-                      const uint32_t stream_id);
+                      const uint32_t stream_id,
+                      VideoRenderScheduler* render_scheduler);
   ~IncomingVideoStream();
 
   int32_t ChangeModuleId(const int32_t id);
@@ -69,6 +74,11 @@ class IncomingVideoStream : public VideoRenderCallback {
 
   int32_t SetExpectedRenderDelay(int32_t delay_ms);
 
+  // Renders the next frame if it is due, or the start or timeout image if
+  // there is no frame. Returns the time, in TickTime milliseconds, when this
+  // should be called again.
+  int64_t RenderDueFrame();
+
  protected:
   static bool IncomingVideoStreamThreadFun(void* obj);
   bool IncomingVideoStreamProcess();
@@ -84,6 +94,7 @@ class IncomingVideoStream : public VideoRenderCallback {
   CriticalSectionWrapper& stream_critsect_;
   CriticalSectionWrapper& thread_critsect_;
   CriticalSectionWrapper& buffer_critsect_;
+  VideoRenderScheduler* const render_scheduler_;
   ThreadWrapper* incoming_render_thread_;
   EventWrapper& deliver_buffer_event_;
   bool running_;
@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <time.h>
+
+#include <sstream>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_render/incoming_video_stream.h"
+#include "webrtc/modules/video_render/video_render_scheduler.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/statistics.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kFrameIntervalMs = 33;
+const int kRenderDelayMs = 50;
+const int kRunTimeMs = 5000;
+const int kWidth = 160;
+const int kHeight = 120;
+
+// Measures how late each frame is rendered compared to its render time.
+class RenderTimingObserver : public VideoRenderCallback {
+ public:
+  RenderTimingObserver()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()) {}
+
+  virtual int32_t RenderFrame(const uint32_t stream_id,
+                              I420VideoFrame& video_frame) OVERRIDE {
+    int64_t error_ms =
+        TickTime::MillisecondTimestamp() - video_frame.render_time_ms();
+    CriticalSectionScoped cs(crit_.get());
+    render_error_ms_.AddSample(static_cast<double>(error_ms));
+    return 0;
+  }
+
+  test::Statistics RenderError() const {
+    CriticalSectionScoped cs(crit_.get());
+    return render_error_ms_;
+  }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  test::Statistics render_error_ms_;
+};
+
+void RunRenderTiming(int num_streams, bool shared_scheduler) {
+  scoped_ptr<VideoRenderScheduler> scheduler(
+      shared_scheduler ? new VideoRenderScheduler(0) : NULL);
+  RenderTimingObserver observer;
+  ScopedVector<IncomingVideoStream> streams;
+  for (int i = 0; i < num_streams; ++i) {
+    IncomingVideoStream* stream =
+        new IncomingVideoStream(0, i, scheduler.get());
+    stream->SetRenderCallback(&observer);
+    ASSERT_EQ(0, stream->Start());
+    streams.push_back(stream);
+  }
+
+  I420VideoFrame frame;
+  frame.CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+  const int64_t start_ms = TickTime::MillisecondTimestamp();
+  const clock_t start_cpu = clock();
+  int64_t next_frame_ms = start_ms;
+  while (next_frame_ms < start_ms + kRunTimeMs) {
+    for (int i = 0; i < num_streams; ++i) {
+      frame.set_render_time_ms(next_frame_ms + kRenderDelayMs);
+      streams[i]->RenderFrame(i, frame);
+    }
+    next_frame_ms += kFrameIntervalMs;
+    int64_t sleep_ms = next_frame_ms - TickTime::MillisecondTimestamp();
+    if (sleep_ms > 0)
+      SleepMs(static_cast<int>(sleep_ms));
+  }
+  const double cpu_ms =
+      1000.0 * static_cast<double>(clock() - start_cpu) / CLOCKS_PER_SEC;
+  for (int i = 0; i < num_streams; ++i)
+    streams[i]->Stop();
+
+  test::Statistics render_error = observer.RenderError();
+  std::stringstream trace;
+  trace << num_streams << "_streams";
+  std::string modifier = shared_scheduler ? "_shared_scheduler" : "";
+  std::stringstream mean_and_error;
+  mean_and_error << render_error.Mean() << ","
+                 << render_error.StandardDeviation();
+  test::PrintResultMeanAndError("render_timing_error", modifier, trace.str(),
+                                mean_and_error.str(), "ms", false);
+  test::PrintResult("render_cpu_time", modifier, trace.str(),
+                    static_cast<size_t>(cpu_ms * 1000 / kRunTimeMs),
+                    "ms_per_s", false);
+}
+
+}  // namespace
+
+TEST(RenderTimingTest, PerStreamThreads) {
+  RunRenderTiming(4, false);
+  RunRenderTiming(25, false);
+  RunRenderTiming(49, false);
+}
+
+TEST(RenderTimingTest, SharedScheduler) {
+  RunRenderTiming(4, true);
+  RunRenderTiming(25, true);
+  RunRenderTiming(49, true);
+}
+
+}  // namespace webrtc
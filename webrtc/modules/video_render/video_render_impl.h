@@ -15,11 +15,13 @@
 
 #include "webrtc/engine_configurations.h"
 #include "webrtc/modules/video_render/include/video_render.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
 
 namespace webrtc {
 class CriticalSectionWrapper;
 class IncomingVideoStream;
 class IVideoRender;
+class VideoRenderScheduler;
 
 // Class definitions
 class ModuleVideoRenderImpl: public VideoRender
@@ -221,6 +223,8 @@ private:
     IVideoRender* _ptrRenderer;
     typedef std::map<uint32_t, IncomingVideoStream*> IncomingVideoStreamMap;
     IncomingVideoStreamMap _streamRenderMap;
+    // Drives rendering of all streams in |_streamRenderMap|.
+    scoped_ptr<VideoRenderScheduler> _renderScheduler;
 };
 
 }  // namespace webrtc
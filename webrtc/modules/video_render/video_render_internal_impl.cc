@@ -15,6 +15,7 @@
 #include "webrtc/modules/video_render/include/video_render_defines.h"
 #include "webrtc/modules/video_render/incoming_video_stream.h"
 #include "webrtc/modules/video_render/video_render_impl.h"
+#include "webrtc/modules/video_render/video_render_scheduler.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
@@ -88,7 +89,8 @@ ModuleVideoRenderImpl::ModuleVideoRenderImpl(
                                              void* window,
                                              const bool fullscreen) :
     _id(id), _moduleCrit(*CriticalSectionWrapper::CreateCriticalSection()),
-    _ptrWindow(window), _fullScreen(fullscreen), _ptrRenderer(NULL)
+    _ptrWindow(window), _fullScreen(fullscreen), _ptrRenderer(NULL),
+    _renderScheduler(new VideoRenderScheduler(id))
 {
 
     // Create platform specific renderer
@@ -435,8 +437,8 @@ ModuleVideoRenderImpl::AddIncomingRenderStream(const uint32_t streamId,
     }
 
     // Create platform independant code
-    IncomingVideoStream* ptrIncomingStream = new IncomingVideoStream(_id,
-                                                                     streamId);
+    IncomingVideoStream* ptrIncomingStream =
+        new IncomingVideoStream(_id, streamId, _renderScheduler.get());
     if (ptrIncomingStream == NULL)
     {
         WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
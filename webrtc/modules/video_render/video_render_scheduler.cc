@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_render/video_render_scheduler.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+#include "webrtc/modules/video_render/incoming_video_stream.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/trace.h"
+
+namespace webrtc {
+
+namespace {
+const int64_t kMaxWaitTimeMs = 100;
+}  // namespace
+
+VideoRenderScheduler::VideoRenderScheduler(int32_t module_id)
+    : module_id_(module_id),
+      render_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
+      queue_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
+      wake_event_(EventWrapper::Create()),
+      thread_(ThreadWrapper::CreateThread(SchedulerThreadFun, this,
+                                          kRealtimePriority,
+                                          "VideoRenderSchedulerThread")) {
+  unsigned int t_id = 0;
+  if (thread_->Start(t_id)) {
+    WEBRTC_TRACE(kTraceInfo, kTraceVideoRenderer, module_id_,
+                 "%s: thread started: %u", __FUNCTION__, t_id);
+  } else {
+    WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, module_id_,
+                 "%s: Could not start render thread", __FUNCTION__);
+    assert(false);
+  }
+}
+
+VideoRenderScheduler::~VideoRenderScheduler() {
+  thread_->SetNotAlive();
+  wake_event_->Set();
+  if (!thread_->Stop()) {
+    assert(false);
+    WEBRTC_TRACE(kTraceWarning, kTraceVideoRenderer, module_id_,
+                 "%s: Not able to stop thread, leaking", __FUNCTION__);
+    thread_.release();
+  }
+  assert(streams_.empty());
+}
+
+void VideoRenderScheduler::AddStream(IncomingVideoStream* stream) {
+  {
+    CriticalSectionScoped cs(queue_critsect_.get());
+    assert(streams_.find(stream) == streams_.end());
+    streams_[stream] = queue_.end();
+  }
+  ScheduleStream(stream, TickTime::MillisecondTimestamp());
+}
+
+void VideoRenderScheduler::RemoveStream(IncomingVideoStream* stream) {
+  // Wait for any ongoing rendering to finish.
+  CriticalSectionScoped cs_render(render_critsect_.get());
+  CriticalSectionScoped cs(queue_critsect_.get());
+  StreamMap::iterator it = streams_.find(stream);
+  if (it == streams_.end())
+    return;
+  if (it->second != queue_.end())
+    queue_.erase(it->second);
+  streams_.erase(it);
+}
+
+void VideoRenderScheduler::ScheduleStream(IncomingVideoStream* stream,
+                                          int64_t time_ms) {
+  CriticalSectionScoped cs(queue_critsect_.get());
+  StreamMap::iterator it = streams_.find(stream);
+  if (it == streams_.end())
+    return;
+  if (it->second != queue_.end()) {
+    if (it->second->first <= time_ms)
+      return;  // Already scheduled early enough.
+    queue_.erase(it->second);
+  }
+  it->second = queue_.insert(std::make_pair(time_ms, stream));
+  if (it->second == queue_.begin())
+    wake_event_->Set();
+}
+
+bool VideoRenderScheduler::SchedulerThreadFun(void* obj) {
+  return static_cast<VideoRenderScheduler*>(obj)->SchedulerProcess();
+}
+
+bool VideoRenderScheduler::SchedulerProcess() {
+  int64_t wait_time_ms = 0;
+  while (true) {
+    CriticalSectionScoped cs(render_critsect_.get());
+    int64_t now_ms = TickTime::MillisecondTimestamp();
+    IncomingVideoStream* stream = PopDueStream(now_ms, &wait_time_ms);
+    if (stream == NULL)
+      break;
+    int64_t next_time_ms = stream->RenderDueFrame();
+    ScheduleStream(stream, next_time_ms);
+  }
+  wake_event_->Wait(static_cast<unsigned long>(wait_time_ms));
+  return true;
+}
+
+IncomingVideoStream* VideoRenderScheduler::PopDueStream(
+    int64_t now_ms, int64_t* wait_time_ms) {
+  CriticalSectionScoped cs(queue_critsect_.get());
+  if (queue_.empty()) {
+    *wait_time_ms = kMaxWaitTimeMs;
+    return NULL;
+  }
+  StreamQueue::iterator first = queue_.begin();
+  if (first->first > now_ms) {
+    *wait_time_ms = std::min(first->first - now_ms, kMaxWaitTimeMs);
+    return NULL;
+  }
+  IncomingVideoStream* stream = first->second;
+  queue_.erase(first);
+  streams_[stream] = queue_.end();
+  return stream;
+}
+
+}  // namespace webrtc
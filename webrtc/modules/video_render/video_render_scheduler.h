@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_RENDER_VIDEO_RENDER_SCHEDULER_H_
+#define WEBRTC_MODULES_VIDEO_RENDER_VIDEO_RENDER_SCHEDULER_H_
+
+#include <map>
+
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+class CriticalSectionWrapper;
+class EventWrapper;
+class IncomingVideoStream;
+class ThreadWrapper;
+
+// Renders frames for all IncomingVideoStreams of a render module from a single
+// thread. Each stream is kept in one time-ordered queue by the time its next
+// frame is due, so the number of threads and timers does not grow with the
+// number of streams.
+class VideoRenderScheduler {
+ public:
+  explicit VideoRenderScheduler(int32_t module_id);
+  ~VideoRenderScheduler();
+
+  // Starts rendering |stream|. The stream is processed as soon as possible.
+  void AddStream(IncomingVideoStream* stream);
+
+  // Stops rendering |stream|. When this returns the stream is not being
+  // rendered and will not be rendered again.
+  void RemoveStream(IncomingVideoStream* stream);
+
+  // Makes sure |stream| is processed no later than |time_ms|, given in
+  // TickTime milliseconds. Ignored for streams which haven't been added.
+  void ScheduleStream(IncomingVideoStream* stream, int64_t time_ms);
+
+ private:
+  typedef std::multimap<int64_t, IncomingVideoStream*> StreamQueue;
+  typedef std::map<IncomingVideoStream*, StreamQueue::iterator> StreamMap;
+
+  static bool SchedulerThreadFun(void* obj);
+  bool SchedulerProcess();
+
+  // Pops the first stream from the queue if it is due. Returns NULL and sets
+  // |wait_time_ms| to the time until the first stream is due otherwise.
+  IncomingVideoStream* PopDueStream(int64_t now_ms, int64_t* wait_time_ms);
+
+  const int32_t module_id_;
+  // Held while a stream is rendered. Taken before |queue_critsect_|.
+  scoped_ptr<CriticalSectionWrapper> render_critsect_;
+  scoped_ptr<CriticalSectionWrapper> queue_critsect_;
+  scoped_ptr<EventWrapper> wake_event_;
+  scoped_ptr<ThreadWrapper> thread_;
+
+  // Streams ordered by the time they should be processed next.
+  StreamQueue queue_;
+  // All added streams and their position in |queue_|, or queue_.end() while
+  // being rendered.
+  StreamMap streams_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_RENDER_VIDEO_RENDER_SCHEDULER_H_
@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <utility>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_render/incoming_video_stream.h"
+#include "webrtc/modules/video_render/video_render_scheduler.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+namespace {
+
+const int64_t kStartTimeMs = 123456;
+const int kWidth = 16;
+const int kHeight = 16;
+// Frames are released this long before their render time.
+const int kRenderDelayMs = 10;
+// Real time to wait for a frame to be rendered. The scheduler thread checks
+// the fake clock at least every 100 ms.
+const unsigned long kWaitForFrameMs = 1000;
+// Real time to wait for making sure no frame is rendered.
+const unsigned long kWaitForNoFrameMs = 300;
+
+typedef std::pair<uint32_t, int64_t> RenderedFrame;
+
+class RenderObserver : public VideoRenderCallback {
+ public:
+  RenderObserver()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        frame_rendered_(EventWrapper::Create()) {}
+
+  virtual int32_t RenderFrame(const uint32_t stream_id,
+                              I420VideoFrame& video_frame) OVERRIDE {
+    {
+      CriticalSectionScoped cs(crit_.get());
+      frames_.push_back(
+          std::make_pair(stream_id, video_frame.render_time_ms()));
+    }
+    frame_rendered_->Set();
+    return 0;
+  }
+
+  // Returns true if at least |num_frames| have been rendered, false if no
+  // frame is rendered for |max_time_ms| of real time before that.
+  bool WaitForFrames(size_t num_frames, unsigned long max_time_ms) {
+    while (NumFrames() < num_frames) {
+      if (frame_rendered_->Wait(max_time_ms) != kEventSignaled)
+        return false;
+    }
+    return true;
+  }
+
+  size_t NumFrames() const {
+    CriticalSectionScoped cs(crit_.get());
+    return frames_.size();
+  }
+
+  std::vector<RenderedFrame> frames() const {
+    CriticalSectionScoped cs(crit_.get());
+    return frames_;
+  }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<EventWrapper> frame_rendered_;
+  std::vector<RenderedFrame> frames_;
+};
+
+}  // namespace
+
+class VideoRenderSchedulerTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    TickTime::UseFakeClock(kStartTimeMs);
+    scheduler_.reset(new VideoRenderScheduler(0));
+  }
+
+  virtual void TearDown() OVERRIDE {
+    for (size_t i = 0; i < streams_.size(); ++i)
+      streams_[i]->Stop();
+    streams_.clear();
+    scheduler_.reset();
+    TickTime::UseRealClock();
+  }
+
+  void CreateStreams(int num_streams) {
+    for (int i = 0; i < num_streams; ++i) {
+      IncomingVideoStream* stream =
+          new IncomingVideoStream(0, i, scheduler_.get());
+      stream->SetRenderCallback(&observer_);
+      ASSERT_EQ(0, stream->Start());
+      streams_.push_back(stream);
+    }
+  }
+
+  // Delivers a frame to be rendered at |render_time_ms| on |stream_id|.
+  void DeliverFrame(uint32_t stream_id, int64_t render_time_ms) {
+    I420VideoFrame frame;
+    frame.CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+    frame.set_render_time_ms(render_time_ms);
+ASSERT_EQ(0, streams_[stream_id]->RenderFrame(stream_id, frame));
+  }
+
+  RenderObserver observer_;
+  scoped_ptr<VideoRenderScheduler> scheduler_;
+  ScopedVector<IncomingVideoStream> streams_;
+};
+
+TEST_F(VideoRenderSchedulerTest, HoldsEarlyFrameUntilDue) {
+  CreateStreams(1);
+  DeliverFrame(0, kStartTimeMs + 100);
+
+  EXPECT_FALSE(observer_.WaitForFrames(1, kWaitForNoFrameMs));
+  TickTime::AdvanceFakeClock(100 - kRenderDelayMs - 1);
+  EXPECT_FALSE(observer_.WaitForFrames(1, kWaitForNoFrameMs));
+
+  TickTime::AdvanceFakeClock(1);
+  ASSERT_TRUE(observer_.WaitForFrames(1, kWaitForFrameMs));
+  EXPECT_EQ(RenderedFrame(0, kStartTimeMs + 100), observer_.frames()[0]);
+}
+
+TEST_F(VideoRenderSchedulerTest, DropsLateFramesWhenNewerFrameIsDue) {
+  CreateStreams(1);
+  DeliverFrame(0, kStartTimeMs + 50);
+  DeliverFrame(0, kStartTimeMs + 60);
+  DeliverFrame(0, kStartTimeMs + 70);
+
+  // All three frames are due when the stream is processed, only the newest
+  // one is rendered.
+  TickTime::AdvanceFakeClock(100);
+  ASSERT_TRUE(observer_.WaitForFrames(1, kWaitForFrameMs));
+  EXPECT_FALSE(observer_.WaitForFrames(2, kWaitForNoFrameMs));
+  EXPECT_EQ(RenderedFrame(0, kStartTimeMs + 70), observer_.frames()[0]);
+}
+
+TEST_F(VideoRenderSchedulerTest, DropsTooOldFrameWhenOthersAreQueued) {
+  CreateStreams(1);
+  DeliverFrame(0, kStartTimeMs + 100);
+  // Too old to be queued behind a frame which is not yet rendered.
+  I420VideoFrame frame;
+  frame.CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+  frame.set_render_time_ms(kStartTimeMs - 1000);
+  streams_[0]->RenderFrame(0, frame);
+
+  TickTime::AdvanceFakeClock(100);
+  ASSERT_TRUE(observer_.WaitForFrames(1, kWaitForFrameMs));
+  EXPECT_FALSE(observer_.WaitForFrames(2, kWaitForNoFrameMs));
+  EXPECT_EQ(RenderedFrame(0, kStartTimeMs + 100), observer_.frames()[0]);
+}
+
+TEST_F(VideoRenderSchedulerTest, RendersFramesOfStreamInOrder) {
+  CreateStreams(1);
+  DeliverFrame(0, kStartTimeMs + 100);
+  DeliverFrame(0, kStartTimeMs + 200);
+  DeliverFrame(0, kStartTimeMs + 300);
+
+  for (size_t i = 1; i <= 3; ++i) {
+    TickTime::AdvanceFakeClock(100);
+    ASSERT_TRUE(observer_.WaitForFrames(i, kWaitForFrameMs));
+  }
+  std::vector<RenderedFrame> frames = observer_.frames();
+  ASSERT_EQ(3u, frames.size());
+  EXPECT_EQ(RenderedFrame(0, kStartTimeMs + 100), frames[0]);
+  EXPECT_EQ(RenderedFrame(0, kStartTimeMs + 200), frames[1]);
+  EXPECT_EQ(RenderedFrame(0, kStartTimeMs + 300), frames[2]);
+}
+
+TEST_F(VideoRenderSchedulerTest, RendersStreamsInDueOrder) {
+  CreateStreams(3);
+  DeliverFrame(0, kStartTimeMs + 90);
+  DeliverFrame(1, kStartTimeMs + 30);
+  DeliverFrame(2, kStartTimeMs + 60);
+  EXPECT_FALSE(observer_.WaitForFrames(1, kWaitForNoFrameMs));
+
+  // All streams become due at once and are processed in the order their
+  // frames are due.
+  TickTime::AdvanceFakeClock(100);
+  ASSERT_TRUE(observer_.WaitForFrames(3, kWaitForFrameMs));
+  std::vector<RenderedFrame> frames = observer_.frames();
+  ASSERT_EQ(3u, frames.size());
+  EXPECT_EQ(RenderedFrame(1, kStartTimeMs + 30), frames[0]);
+  EXPECT_EQ(RenderedFrame(2, kStartTimeMs + 60), frames[1]);
+  EXPECT_EQ(RenderedFrame(0, kStartTimeMs + 90), frames[2]);
+}
+
+TEST_F(VideoRenderSchedulerTest, RemovedStreamIsNotRendered) {
+  CreateStreams(2);
+  DeliverFrame(0, kStartTimeMs + 100);
+  DeliverFrame(1, kStartTimeMs + 100);
+  streams_[0]->Stop();
+
+  TickTime::AdvanceFakeClock(100);
+  ASSERT_TRUE(observer_.WaitForFrames(1, kWaitForFrameMs));
+  EXPECT_FALSE(observer_.WaitForFrames(2, kWaitForNoFrameMs));
+  EXPECT_EQ(RenderedFrame(1, kStartTimeMs + 100), observer_.frames()[0]);
+}
+
+}  // namespace webrtc
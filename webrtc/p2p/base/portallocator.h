@@ -38,6 +38,10 @@ enum {
   PORTALLOCATOR_ENABLE_SHARED_UFRAG = 0x80,
   PORTALLOCATOR_ENABLE_SHARED_SOCKET = 0x100,
   PORTALLOCATOR_ENABLE_STUN_RETRANSMIT_ATTRIBUTE = 0x200,
+  // Runs every allocation phase of a network in one step instead of one phase
+  // per step delay. Combine with max_concurrent_server_requests() to keep the
+  // STUN/TURN traffic paced.
+  PORTALLOCATOR_ENABLE_PARALLEL_PHASES = 0x400,
 };
 
 const uint32 kDefaultPortAllocatorFlags = 0;
@@ -111,6 +115,7 @@ class PortAllocator : public sigslot::has_slots<> {
       min_port_(0),
       max_port_(0),
       step_delay_(kDefaultStepDelay),
+      max_concurrent_server_requests_(0),
       allow_tcp_listen_(true),
       candidate_filter_(CF_ALL) {
     // This will allow us to have old behavior on non webrtc clients.
@@ -155,6 +160,16 @@ class PortAllocator : public sigslot::has_slots<> {
     step_delay_ = delay;
   }
 
+  // Limits how many ports of a session may have STUN or TURN requests in
+  // flight at once; further ports wait until one of them completes. 0 means
+  // no limit.
+  uint32 max_concurrent_server_requests() const {
+    return max_concurrent_server_requests_;
+  }
+  void set_max_concurrent_server_requests(uint32 max_requests) {
+    max_concurrent_server_requests_ = max_requests;
+  }
+
   bool allow_tcp_listen() const { return allow_tcp_listen_; }
   void set_allow_tcp_listen(bool allow_tcp_listen) {
     allow_tcp_listen_ = allow_tcp_listen;
@@ -182,6 +197,7 @@ class PortAllocator : public sigslot::has_slots<> {
   int min_port_;
   int max_port_;
   uint32 step_delay_;
+  uint32 max_concurrent_server_requests_;
   SessionMuxerMap muxers_;
   bool allow_tcp_listen_;
   uint32 candidate_filter_;
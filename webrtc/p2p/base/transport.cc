@@ -446,7 +446,8 @@ bool Transport::VerifyCandidate(const Candidate& cand, std::string* error) {
 
 
 bool Transport::GetStats(TransportStats* stats) {
-  ASSERT(signaling_thread()->IsCurrent());
+  // Also allowed on the worker thread, where the call below runs inline.
+  ASSERT(signaling_thread()->IsCurrent() || worker_thread()->IsCurrent());
   return worker_thread_->Invoke<bool>(Bind(
       &Transport::GetStats_w, this, stats));
 }
@@ -10,6 +10,7 @@
 
 #include "webrtc/p2p/client/basicportallocator.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -228,7 +229,8 @@ BasicPortAllocatorSession::BasicPortAllocatorSession(
       allocation_started_(false),
       network_manager_started_(false),
       running_(false),
-      allocation_sequences_created_(false) {
+      allocation_sequences_created_(false),
+      outstanding_server_requests_(0) {
   allocator_->network_manager()->SignalNetworksChanged.connect(
       this, &BasicPortAllocatorSession::OnNetworksChanged);
   allocator_->network_manager()->StartUpdating();
@@ -467,7 +469,8 @@ void BasicPortAllocatorSession::DisableEquivalentPhases(
 
 void BasicPortAllocatorSession::AddAllocatedPort(Port* port,
                                                  AllocationSequence * seq,
-                                                 bool prepare_address) {
+                                                 bool prepare_address,
+                                                 bool server_port) {
   if (!port)
     return;
 
@@ -496,8 +499,50 @@ void BasicPortAllocatorSession::AddAllocatedPort(Port* port,
       this, &BasicPortAllocatorSession::OnPortError);
   LOG_J(LS_INFO, port) << "Added port to allocator";
 
-  if (prepare_address)
+  if (!prepare_address)
+    return;
+
+  if (server_port) {
+    uint32 max_requests = allocator_->max_concurrent_server_requests();
+    if (max_requests > 0 && outstanding_server_requests_ >= max_requests) {
+      LOG_J(LS_INFO, port) << "Queuing port, " << outstanding_server_requests_
+                           << " server requests outstanding";
+      queued_ports_.push_back(port);
+      return;
+    }
+    ++outstanding_server_requests_;
+    ports_.back().set_holds_request_slot(true);
+  }
+  port->PrepareAddress();
+}
+
+void BasicPortAllocatorSession::ReleaseRequestSlot(Port* port) {
+  PortData* data = FindPort(port);
+  if (!data || !data->holds_request_slot())
+    return;
+
+  data->set_holds_request_slot(false);
+  ASSERT(outstanding_server_requests_ > 0);
+  --outstanding_server_requests_;
+  PrepareQueuedPorts();
+}
+
+void BasicPortAllocatorSession::PrepareQueuedPorts() {
+  uint32 max_requests = allocator_->max_concurrent_server_requests();
+  while (!queued_ports_.empty() &&
+         (max_requests == 0 || outstanding_server_requests_ < max_requests)) {
+    Port* port = queued_ports_.front();
+    queued_ports_.pop_front();
+    PortData* data = FindPort(port);
+    // Ports given up on by StopGettingPorts() are not started any more.
+    if (!data || data->complete())
+      continue;
+
+    ++outstanding_server_requests_;
+    data->set_holds_request_slot(true);
+    // May complete synchronously and re-enter through ReleaseRequestSlot().
     port->PrepareAddress();
+  }
 }
 
 void BasicPortAllocatorSession::OnAllocationSequenceObjectsCreated() {
@@ -545,6 +590,9 @@ void BasicPortAllocatorSession::OnPortComplete(Port* port) {
   ASSERT(rtc::Thread::Current() == network_thread_);
   PortData* data = FindPort(port);
   ASSERT(data != NULL);
+  // Let a queued port start first, so that only the last port to finish
+  // signals allocation done.
+  ReleaseRequestSlot(port);
 
   // Ignore any late signals.
   if (data->complete())
@@ -560,6 +608,7 @@ void BasicPortAllocatorSession::OnPortError(Port* port) {
   ASSERT(rtc::Thread::Current() == network_thread_);
   PortData* data = FindPort(port);
   ASSERT(data != NULL);
+  ReleaseRequestSlot(port);
   // We might have already given up on this port and stopped it.
   if (data->complete())
     return;
@@ -657,12 +706,22 @@ void BasicPortAllocatorSession::MaybeSignalCandidatesAllocationDone() {
 void BasicPortAllocatorSession::OnPortDestroyed(
     PortInterface* port) {
   ASSERT(rtc::Thread::Current() == network_thread_);
+  std::deque<Port*>::iterator queued =
+      std::find(queued_ports_.begin(), queued_ports_.end(), port);
+  if (queued != queued_ports_.end())
+    queued_ports_.erase(queued);
+
   for (std::vector<PortData>::iterator iter = ports_.begin();
        iter != ports_.end(); ++iter) {
     if (port == iter->port()) {
+      bool holds_request_slot = iter->holds_request_slot();
       ports_.erase(iter);
       LOG_J(LS_INFO, port) << "Removed port from allocator ("
                            << static_cast<int>(ports_.size()) << " remaining)";
+      if (holds_request_slot) {
+        --outstanding_server_requests_;
+        PrepareQueuedPorts();
+      }
       return;
     }
   }
@@ -818,33 +877,42 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
     "Udp", "Relay", "Tcp", "SslTcp"
   };
 
-  // Perform all of the phases in the current step.
-  LOG_J(LS_INFO, network_) << "Allocation Phase="
-                           << PHASE_NAMES[phase_];
+  // Perform all of the phases in the current step. With parallel phases the
+  // remaining phases run right away rather than one per step delay.
+  for (;;) {
+    LOG_J(LS_INFO, network_) << "Allocation Phase="
+                             << PHASE_NAMES[phase_];
+
+    switch (phase_) {
+      case PHASE_UDP:
+        CreateUDPPorts();
+        CreateStunPorts();
+        EnableProtocol(PROTO_UDP);
+        break;
 
-  switch (phase_) {
-    case PHASE_UDP:
-      CreateUDPPorts();
-      CreateStunPorts();
-      EnableProtocol(PROTO_UDP);
-      break;
+      case PHASE_RELAY:
+        CreateRelayPorts();
+        break;
 
-    case PHASE_RELAY:
-      CreateRelayPorts();
-      break;
+      case PHASE_TCP:
+        CreateTCPPorts();
+        EnableProtocol(PROTO_TCP);
+        break;
 
-    case PHASE_TCP:
-      CreateTCPPorts();
-      EnableProtocol(PROTO_TCP);
-      break;
+      case PHASE_SSLTCP:
+        state_ = kCompleted;
+        EnableProtocol(PROTO_SSLTCP);
+        break;
 
-    case PHASE_SSLTCP:
-      state_ = kCompleted;
-      EnableProtocol(PROTO_SSLTCP);
-      break;
+      default:
+        ASSERT(false);
+    }
 
-    default:
-      ASSERT(false);
+    if (state() != kRunning ||
+        !IsFlagSet(PORTALLOCATOR_ENABLE_PARALLEL_PHASES)) {
+      break;
+    }
+    ++phase_;
   }
 
   if (state() == kRunning) {
@@ -923,7 +991,8 @@ void AllocationSequence::CreateUDPPorts() {
       }
     }
 
-    session_->AddAllocatedPort(port, this, true);
+    session_->AddAllocatedPort(port, this, true,
+                               !port->server_addresses().empty());
     port->SignalDestroyed.connect(this, &AllocationSequence::OnPortDestroyed);
   }
 }
@@ -942,7 +1011,7 @@ void AllocationSequence::CreateTCPPorts() {
                                session_->username(), session_->password(),
                                session_->allocator()->allow_tcp_listen());
   if (port) {
-    session_->AddAllocatedPort(port, this, true);
+    session_->AddAllocatedPort(port, this, true, false);
     // Since TCPPort is not created using shared socket, |port| will not be
     // added to the dequeue.
   }
@@ -975,7 +1044,7 @@ void AllocationSequence::CreateStunPorts() {
                                 session_->username(), session_->password(),
                                 config_->StunServers());
   if (port) {
-    session_->AddAllocatedPort(port, this, true);
+    session_->AddAllocatedPort(port, this, true, true);
     // Since StunPort is not created using shared socket, |port| will not be
     // added to the dequeue.
   }
@@ -1025,7 +1094,7 @@ void AllocationSequence::CreateGturnPort(const RelayServerConfig& config) {
     //       settings.  However, we also can't prepare the address (normally
     //       done by AddAllocatedPort) until we have these addresses.  So we
     //       wait to do that until below.
-    session_->AddAllocatedPort(port, this, false);
+    session_->AddAllocatedPort(port, this, false, false);
 
     // Add the addresses of this protocol.
     PortList::const_iterator relay_port;
@@ -1072,7 +1141,7 @@ void AllocationSequence::CreateTurnPort(const RelayServerConfig& config) {
                               *relay_port, config.credentials, config.priority);
     }
     ASSERT(port != NULL);
-    session_->AddAllocatedPort(port, this, true);
+    session_->AddAllocatedPort(port, this, true, true);
   }
 }
 
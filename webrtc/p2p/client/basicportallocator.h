@@ -11,6 +11,7 @@
 #ifndef WEBRTC_P2P_CLIENT_BASICPORTALLOCATOR_H_
 #define WEBRTC_P2P_CLIENT_BASICPORTALLOCATOR_H_
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -128,14 +129,20 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
  private:
   class PortData {
    public:
-    PortData() : port_(NULL), sequence_(NULL), state_(STATE_INIT) {}
+    PortData()
+        : port_(NULL), sequence_(NULL), state_(STATE_INIT),
+          holds_request_slot_(false) {}
     PortData(Port* port, AllocationSequence* seq)
-    : port_(port), sequence_(seq), state_(STATE_INIT) {
+    : port_(port), sequence_(seq), state_(STATE_INIT),
+      holds_request_slot_(false) {
     }
 
     Port* port() { return port_; }
     AllocationSequence* sequence() { return sequence_; }
     bool ready() const { return state_ == STATE_READY; }
+    // True while the port counts against max_concurrent_server_requests().
+    bool holds_request_slot() const { return holds_request_slot_; }
+    void set_holds_request_slot(bool holds) { holds_request_slot_ = holds; }
     bool complete() const {
       // Returns true if candidate allocation has completed one way or another.
       return ((state_ == STATE_COMPLETE) || (state_ == STATE_ERROR));
@@ -160,6 +167,7 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
     Port* port_;
     AllocationSequence* sequence_;
     State state_;
+    bool holds_request_slot_;
   };
 
   void OnConfigReady(PortConfiguration* config);
@@ -171,8 +179,12 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
   void OnAllocationSequenceObjectsCreated();
   void DisableEquivalentPhases(rtc::Network* network,
                                PortConfiguration* config, uint32* flags);
+  // |server_port| marks ports whose PrepareAddress() sends STUN or TURN
+  // requests; those are subject to max_concurrent_server_requests().
   void AddAllocatedPort(Port* port, AllocationSequence* seq,
-                        bool prepare_address);
+                        bool prepare_address, bool server_port);
+  void ReleaseRequestSlot(Port* port);
+  void PrepareQueuedPorts();
   void OnCandidateReady(Port* port, const Candidate& c);
   void OnPortComplete(Port* port);
   void OnPortError(Port* port);
@@ -196,6 +208,9 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
   std::vector<PortConfiguration*> configs_;
   std::vector<AllocationSequence*> sequences_;
   std::vector<PortData> ports_;
+  // Server ports waiting for a request slot, in allocation order.
+  std::deque<Port*> queued_ports_;
+  uint32 outstanding_server_requests_;
 
   friend class AllocationSequence;
 };
@@ -29,6 +29,7 @@
 #include "webrtc/base/socketaddress.h"
 #include "webrtc/base/ssladapter.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/base/virtualsocketserver.h"
 
 using cricket::ServerAddresses;
@@ -65,6 +66,7 @@ static const char kIcePwd0[] = "TESTICEPWD00000000000000";
 static const char kContentName[] = "test content";
 
 static const int kDefaultAllocationTimeout = 1000;
+static const int kGatheringTimeout = 10000;
 static const char kTurnUsername[] = "test";
 static const char kTurnPassword[] = "test";
 
@@ -147,6 +149,50 @@ class PortAllocatorTest : public testing::Test, public sigslot::has_slots<> {
     allocator_->AddRelay(relay_server);
   }
 
+  // Create a BasicPortAllocator without GTURN, using the STUN server and
+  // |num_turn_servers| UDP TURN servers, all served by |turn_server_|.
+  void ResetWithStunAndTurnServers(int num_turn_servers) {
+    ServerAddresses stun_servers;
+    stun_servers.insert(kStunAddr);
+    allocator_.reset(new cricket::BasicPortAllocator(
+        &network_manager_, stun_servers,
+        SocketAddress(), SocketAddress(), SocketAddress()));
+    allocator().set_step_delay(cricket::kMinimumStepDelay);
+    for (int i = 0; i < num_turn_servers; ++i) {
+      SocketAddress turn_addr(kTurnUdpIntAddr.ipaddr(),
+                              kTurnUdpIntAddr.port() + i);
+      if (i > 0)
+        turn_server_.AddInternalSocket(turn_addr, cricket::PROTO_UDP);
+      cricket::RelayServerConfig relay_server(cricket::RELAY_TURN);
+      relay_server.credentials =
+          cricket::RelayCredentials(kTurnUsername, kTurnPassword);
+      relay_server.ports.push_back(cricket::ProtocolAddress(
+          turn_addr, cricket::PROTO_UDP, false));
+      allocator_->AddRelay(relay_server);
+    }
+  }
+
+  // Gathers candidates with a new session and returns the time until the
+  // first candidate and until SignalCandidatesAllocationDone, in ms.
+  void MeasureGatheringTime(int* first_candidate_ms, int* done_ms) {
+    candidates_.clear();
+    ports_.clear();
+    candidate_allocation_done_ = false;
+    *first_candidate_ms = -1;
+    EXPECT_TRUE(CreateSession(cricket::ICE_CANDIDATE_COMPONENT_RTP));
+    uint32 start = rtc::Time();
+    session_->StartGettingPorts();
+    while (!candidate_allocation_done_ &&
+           rtc::TimeSince(start) < kGatheringTimeout) {
+      Thread::Current()->ProcessMessages(1);
+      if (*first_candidate_ms < 0 && !candidates_.empty())
+        *first_candidate_ms = rtc::TimeSince(start);
+    }
+    *done_ms = rtc::TimeSince(start);
+    // Release the network manager before the next session starts it again.
+    session_.reset();
+  }
+
   bool CreateSession(int component) {
     session_.reset(CreateSession("session", component));
     if (!session_)
@@ -995,6 +1041,81 @@ TEST_F(PortAllocatorTest, TestEnableIPv6Addresses) {
   EXPECT_EQ(4U, candidates_.size());
 }
 
+// Tests that with parallel phases all phases run in the first step, and that
+// server ports waiting for a request slot are prepared once one frees up.
+TEST_F(PortAllocatorTest, TestParallelPhasesWithServerRequestCap) {
+  AddInterface(kClientAddr);
+  ResetWithStunAndTurnServers(2);
+  allocator().set_step_delay(cricket::kDefaultStepDelay);
+  allocator().set_flags(allocator().flags() |
+                        cricket::PORTALLOCATOR_ENABLE_PARALLEL_PHASES);
+  allocator().set_max_concurrent_server_requests(1);
+  EXPECT_TRUE(CreateSession(cricket::ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  // Stepped phases would not reach the relay phase for a whole step delay.
+  ASSERT_EQ_WAIT(5U, candidates_.size(), cricket::kDefaultStepDelay / 2);
+  EXPECT_TRUE_WAIT(candidate_allocation_done_, cricket::kDefaultStepDelay / 2);
+  EXPECT_EQ(5U, ports_.size());
+  EXPECT_PRED5(CheckCandidate, candidates_[0],
+      cricket::ICE_CANDIDATE_COMPONENT_RTP, "local", "udp", kClientAddr);
+  EXPECT_PRED5(CheckCandidate, candidates_[1],
+      cricket::ICE_CANDIDATE_COMPONENT_RTP, "local", "tcp", kClientAddr);
+  EXPECT_PRED5(CheckCandidate, candidates_[2],
+      cricket::ICE_CANDIDATE_COMPONENT_RTP, "stun", "udp", kClientAddr);
+  EXPECT_PRED5(CheckCandidate, candidates_[3],
+      cricket::ICE_CANDIDATE_COMPONENT_RTP, "relay", "udp",
+      rtc::SocketAddress(kTurnUdpExtAddr.ipaddr(), 0));
+  EXPECT_PRED5(CheckCandidate, candidates_[4],
+      cricket::ICE_CANDIDATE_COMPONENT_RTP, "relay", "udp",
+      rtc::SocketAddress(kTurnUdpExtAddr.ipaddr(), 0));
+}
+
+// Compares the time to the first candidate and to allocation done over several
+// interfaces and TURN servers, for stepped phases, parallel phases, and
+// parallel phases with a cap on outstanding STUN/TURN requests.
+TEST_F(PortAllocatorTest, DISABLED_ParallelPhasesGatheringTimePerf) {
+  const int kNumInterfaces = 4;
+  const int kNumTurnServers = 3;
+  for (int i = 0; i < kNumInterfaces; ++i)
+    AddInterface(SocketAddress(kClientAddr.ip() + i, 0));
+  ResetWithStunAndTurnServers(kNumTurnServers);
+  // 20 ms each way to every server.
+  vss_->set_delay_mean(20);
+  vss_->UpdateDelayDistribution();
+
+  const struct {
+    const char* name;
+    uint32 flags;
+    uint32 max_server_requests;
+  } kModes[] = {
+    { "stepped", 0, 0 },
+    { "parallel", cricket::PORTALLOCATOR_ENABLE_PARALLEL_PHASES, 0 },
+    { "parallel, 4 requests",
+      cricket::PORTALLOCATOR_ENABLE_PARALLEL_PHASES, 4 },
+  };
+  size_t num_candidates = 0;
+  for (int i = 0; i < ARRAY_SIZE(kModes); ++i) {
+    allocator().set_flags(kModes[i].flags);
+    allocator().set_max_concurrent_server_requests(
+        kModes[i].max_server_requests);
+    int first_candidate_ms = 0;
+    int done_ms = 0;
+    MeasureGatheringTime(&first_candidate_ms, &done_ms);
+    EXPECT_TRUE(candidate_allocation_done_);
+    if (i == 0)
+      num_candidates = candidates_.size();
+    EXPECT_EQ(num_candidates, candidates_.size());
+    LOG(LS_INFO) << kModes[i].name << ": " << candidates_.size()
+                 << " candidates from " << kNumInterfaces << " interfaces and "
+                 << kNumTurnServers << " TURN servers, first after "
+                 << first_candidate_ms << " ms, done after " << done_ms
+                 << " ms";
+  }
+  // Host, STUN and one relay candidate per TURN server on each interface.
+  EXPECT_EQ(static_cast<size_t>(kNumInterfaces * (3 + kNumTurnServers)),
+            num_candidates);
+}
+
 // Test that the httpportallocator correctly maintains its lists of stun and
 // relay servers, by never allowing an empty list.
 TEST(HttpPortAllocatorTest, TestHttpPortAllocatorHostLists) {
@@ -11,6 +11,7 @@
 #ifndef SYSTEM_WRAPPERS_INTERFACE_RTP_TO_NTP_H_
 #define SYSTEM_WRAPPERS_INTERFACE_RTP_TO_NTP_H_
 
+#include <deque>
 #include <list>
 
 #include "webrtc/typedefs.h"
@@ -41,6 +42,54 @@ bool UpdateRtcpList(uint32_t ntp_secs,
 bool RtpToNtpMs(int64_t rtp_timestamp, const RtcpList& rtcp,
                 int64_t* timestamp_in_ms);
 
+// Estimates the mapping from the RTP timestamps of a stream to the NTP clock
+// of its sender, using the (NTP, RTP) timestamp pairs of the stream's RTCP
+// SRs. The mapping is a least squares fit to the latest reports, which is
+// only updated when a new report arrives, so converting RTP timestamps is
+// cheap.
+class RtpToNtpEstimator {
+ public:
+  RtpToNtpEstimator();
+  ~RtpToNtpEstimator();
+
+  // Updates the estimator with timestamps from the latest RTCP SR.
+  // |new_rtcp_sr| will be set to true if these timestamps are from a report
+  // which hasn't been used before. Returns false if the timestamps are
+  // invalid.
+  bool UpdateMeasurements(uint32_t ntp_secs,
+                          uint32_t ntp_frac,
+                          uint32_t rtp_timestamp,
+                          bool* new_rtcp_sr);
+
+  // Converts |rtp_timestamp| to the NTP time base in milliseconds. Returns
+  // false if there are less than two reports to estimate the mapping from.
+  bool Estimate(uint32_t rtp_timestamp, int64_t* rtp_timestamp_in_ms) const;
+
+  // Returns the number of reports the current mapping is estimated from.
+  int NumMeasurements() const;
+
+ private:
+  struct Measurement {
+    Measurement(uint32_t ntp_secs, uint32_t ntp_frac, int64_t ntp_ms,
+                int64_t unwrapped_rtp_timestamp);
+    uint32_t ntp_secs;
+    uint32_t ntp_frac;
+    int64_t ntp_ms;
+    int64_t unwrapped_rtp_timestamp;
+  };
+
+  // Unwraps |rtp_timestamp| relative to the latest report.
+  int64_t Unwrap(uint32_t rtp_timestamp) const;
+  void UpdateParameters();
+
+  std::deque<Measurement> measurements_;
+  bool params_valid_;
+  // The fitted line passes through the mean of the measurements.
+  double frequency_khz_;
+  double mean_ntp_ms_;
+  double mean_rtp_timestamp_;
+};
+
 // Returns 1 there has been a forward wrap around, 0 if there has been no wrap
 // around and -1 if there has been a backwards wrap around (i.e. reordering).
 int CheckForWrapArounds(uint32_t rtp_timestamp, uint32_t rtcp_rtp_timestamp);
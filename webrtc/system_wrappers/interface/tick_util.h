@@ -70,6 +70,9 @@ class TickTime {
   // Advance the fake clock. Must be called after UseFakeClock.
   static void AdvanceFakeClock(int64_t milliseconds);
 
+  // Disengage the fake clock, e.g. when a test using it is torn down.
+  static void UseRealClock();
+
  private:
   static int64_t QueryOsForTicks();
 
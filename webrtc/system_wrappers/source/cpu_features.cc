@@ -36,6 +36,15 @@ static inline void __cpuid(int cpu_info[4], int info_type) {
     : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
     : "a"(info_type));
 }
+static inline void __cpuidex(int cpu_info[4], int info_type,
+                             int info_index) {
+  __asm__ volatile(
+    "mov %%ebx, %%edi\n"
+    "cpuid\n"
+    "xchg %%edi, %%ebx\n"
+    : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(info_index));
+}
 #else
 static inline void __cpuid(int cpu_info[4], int info_type) {
   __asm__ volatile(
@@ -43,7 +52,25 @@ static inline void __cpuid(int cpu_info[4], int info_type) {
     : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
     : "a"(info_type));
 }
+static inline void __cpuidex(int cpu_info[4], int info_type,
+                             int info_index) {
+  __asm__ volatile(
+    "cpuid\n"
+    : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(info_index));
+}
 #endif
+
+// Reads the extended control register |xcr|, i.e. which register states the
+// OS saves on context switches.
+static inline uint64_t _xgetbv(uint32_t xcr) {
+  uint32_t eax, edx;
+  __asm__ volatile(
+    "xgetbv\n"
+    : "=a"(eax), "=d"(edx)
+    : "c"(xcr));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
 #endif  // _MSC_VER
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
@@ -58,6 +85,19 @@ static int GetCPUInfo(CPUFeature feature) {
   if (feature == kSSE3) {
     return 0 != (cpu_info[2] & 0x00000001);
   }
+  if (feature == kSSE4_1) {
+    return 0 != (cpu_info[2] & 0x00080000);
+  }
+  if (feature == kAVX2) {
+    // AVX2 also requires the OS to save the YMM registers, as reported by
+    // OSXSAVE and XCR0.
+    if ((cpu_info[2] & 0x18000000) != 0x18000000 ||
+        (_xgetbv(0) & 0x6) != 0x6) {
+      return 0;
+    }
+    __cpuidex(cpu_info, 7, 0);
+    return 0 != (cpu_info[1] & 0x00000020);
+  }
   return 0;
 }
 #else
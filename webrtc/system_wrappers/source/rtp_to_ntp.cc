@@ -13,9 +13,20 @@
 #include "webrtc/system_wrappers/interface/clock.h"
 
 #include <assert.h>
+#include <math.h>
 
 namespace webrtc {
 
+namespace {
+// More reports make the estimate less sensitive to the millisecond resolution
+// of the NTP timestamps, while a limited window still follows a drifting RTP
+// clock.
+const size_t kMaxMeasurements = 20;
+// A report further off than this from the current mapping means the sender
+// has restarted its RTP clock, and the older reports are discarded.
+const double kMaxDeviationMs = 1000.0;
+}  // namespace
+
 RtcpMeasurement::RtcpMeasurement()
     : ntp_secs(0), ntp_frac(0), rtp_timestamp(0) {}
 
@@ -130,6 +141,126 @@ bool RtpToNtpMs(int64_t rtp_timestamp,
   return true;
 }
 
+RtpToNtpEstimator::Measurement::Measurement(uint32_t ntp_secs,
+                                            uint32_t ntp_frac,
+                                            int64_t ntp_ms,
+                                            int64_t unwrapped_rtp_timestamp)
+    : ntp_secs(ntp_secs),
+      ntp_frac(ntp_frac),
+      ntp_ms(ntp_ms),
+      unwrapped_rtp_timestamp(unwrapped_rtp_timestamp) {}
+
+RtpToNtpEstimator::RtpToNtpEstimator()
+    : params_valid_(false),
+      frequency_khz_(0.0),
+      mean_ntp_ms_(0.0),
+      mean_rtp_timestamp_(0.0) {}
+
+RtpToNtpEstimator::~RtpToNtpEstimator() {}
+
+bool RtpToNtpEstimator::UpdateMeasurements(uint32_t ntp_secs,
+                                           uint32_t ntp_frac,
+                                           uint32_t rtp_timestamp,
+                                           bool* new_rtcp_sr) {
+  *new_rtcp_sr = false;
+  if (ntp_secs == 0 && ntp_frac == 0) {
+    return false;
+  }
+  int64_t ntp_ms = Clock::NtpToMs(ntp_secs, ntp_frac);
+  int64_t unwrapped_rtp_timestamp = rtp_timestamp;
+  if (!measurements_.empty()) {
+    const Measurement& latest = measurements_.back();
+    if (ntp_secs == latest.ntp_secs && ntp_frac == latest.ntp_frac) {
+      // This RTCP has already been added.
+      return true;
+    }
+    if (ntp_ms <= latest.ntp_ms) {
+      // Reordered or too close to the latest report to be of any use.
+      return true;
+    }
+    unwrapped_rtp_timestamp = Unwrap(rtp_timestamp);
+    bool restarted = unwrapped_rtp_timestamp < latest.unwrapped_rtp_timestamp;
+    if (!restarted && params_valid_) {
+      double estimated_ntp_ms = mean_ntp_ms_ +
+          (unwrapped_rtp_timestamp - mean_rtp_timestamp_) / frequency_khz_;
+      restarted = fabs(estimated_ntp_ms - ntp_ms) > kMaxDeviationMs;
+    }
+    if (restarted) {
+      measurements_.clear();
+      unwrapped_rtp_timestamp = rtp_timestamp;
+    }
+  }
+  if (measurements_.size() == kMaxMeasurements) {
+    measurements_.pop_front();
+  }
+  measurements_.push_back(
+      Measurement(ntp_secs, ntp_frac, ntp_ms, unwrapped_rtp_timestamp));
+  UpdateParameters();
+  *new_rtcp_sr = true;
+  return true;
+}
+
+bool RtpToNtpEstimator::Estimate(uint32_t rtp_timestamp,
+                                 int64_t* rtp_timestamp_in_ms) const {
+  if (!params_valid_) {
+    return false;
+  }
+  double rtp_timestamp_ntp_ms = mean_ntp_ms_ +
+      (Unwrap(rtp_timestamp) - mean_rtp_timestamp_) / frequency_khz_ + 0.5;
+  if (rtp_timestamp_ntp_ms < 0) {
+    return false;
+  }
+  *rtp_timestamp_in_ms = static_cast<int64_t>(rtp_timestamp_ntp_ms);
+  return true;
+}
+
+int RtpToNtpEstimator::NumMeasurements() const {
+  return static_cast<int>(measurements_.size());
+}
+
+int64_t RtpToNtpEstimator::Unwrap(uint32_t rtp_timestamp) const {
+  assert(!measurements_.empty());
+  int64_t latest = measurements_.back().unwrapped_rtp_timestamp;
+  return latest + static_cast<int32_t>(
+      rtp_timestamp - static_cast<uint32_t>(latest));
+}
+
+void RtpToNtpEstimator::UpdateParameters() {
+  params_valid_ = false;
+  size_t n = measurements_.size();
+  if (n < 2) {
+    return;
+  }
+  // Work relative to the latest report to keep the sums small.
+  const Measurement& latest = measurements_.back();
+  double mean_x = 0.0;
+  double mean_y = 0.0;
+  for (std::deque<Measurement>::const_iterator it = measurements_.begin();
+       it != measurements_.end(); ++it) {
+    mean_x += it->ntp_ms - latest.ntp_ms;
+    mean_y += it->unwrapped_rtp_timestamp - latest.unwrapped_rtp_timestamp;
+  }
+  mean_x /= n;
+  mean_y /= n;
+  double sum_xy = 0.0;
+  double sum_xx = 0.0;
+  for (std::deque<Measurement>::const_iterator it = measurements_.begin();
+       it != measurements_.end(); ++it) {
+    double x = it->ntp_ms - latest.ntp_ms - mean_x;
+    double y = it->unwrapped_rtp_timestamp - latest.unwrapped_rtp_timestamp -
+        mean_y;
+    sum_xy += x * y;
+    sum_xx += x * x;
+  }
+  if (sum_xx <= 0.0 || sum_xy <= 0.0) {
+    return;
+  }
+  frequency_khz_ = sum_xy / sum_xx;
+  mean_ntp_ms_ = latest.ntp_ms + mean_x;
+  mean_rtp_timestamp_ = latest.unwrapped_rtp_timestamp + mean_y;
+  params_valid_ = true;
+}
+
 int CheckForWrapArounds(uint32_t new_timestamp, uint32_t old_timestamp) {
   if (new_timestamp < old_timestamp) {
     // This difference should be less than -2^31 if we have had a wrap around
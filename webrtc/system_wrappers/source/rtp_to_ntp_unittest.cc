@@ -9,6 +9,7 @@
  */
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/rtp_to_ntp.h"
 
 namespace webrtc {
@@ -143,4 +144,108 @@ TEST(WrapAroundTests, OldRtp_OldRtcpWrapped) {
   int64_t timestamp_in_ms = -1;
   EXPECT_FALSE(RtpToNtpMs(timestamp, rtcp, &timestamp_in_ms));
 }
-};  // namespace webrtc
+
+class RtpToNtpEstimatorTest : public ::testing::Test {
+ protected:
+  static const uint32_t kOneMsInNtpFrac = 4294967;
+  static const uint32_t kTimestampTicksPerMs = 90;
+
+  RtpToNtpEstimatorTest() : ntp_sec_(1000), ntp_frac_(0) {}
+
+  // Adds a report with the current NTP time and |rtp_timestamp|, and advances
+  // the NTP time by |interval_ms|.
+  bool UpdateMeasurements(uint32_t rtp_timestamp, uint32_t interval_ms) {
+    bool new_rtcp_sr = false;
+    EXPECT_TRUE(estimator_.UpdateMeasurements(ntp_sec_, ntp_frac_,
+                                              rtp_timestamp, &new_rtcp_sr));
+    ntp_sec_ += interval_ms / 1000;
+    ntp_frac_ += (interval_ms % 1000) * kOneMsInNtpFrac;
+    return new_rtcp_sr;
+  }
+
+  int64_t NowMs() const { return Clock::NtpToMs(ntp_sec_, ntp_frac_); }
+
+  uint32_t ntp_sec_;
+  uint32_t ntp_frac_;
+  RtpToNtpEstimator estimator_;
+};
+
+TEST_F(RtpToNtpEstimatorTest, NeedsTwoReports) {
+  int64_t timestamp_in_ms = -1;
+  EXPECT_FALSE(estimator_.Estimate(0, &timestamp_in_ms));
+  EXPECT_TRUE(UpdateMeasurements(0, 1000));
+  EXPECT_FALSE(estimator_.Estimate(0, &timestamp_in_ms));
+  EXPECT_TRUE(UpdateMeasurements(1000 * kTimestampTicksPerMs, 1000));
+  EXPECT_TRUE(estimator_.Estimate(0, &timestamp_in_ms));
+  EXPECT_EQ(NowMs() - 2000, timestamp_in_ms);
+}
+
+TEST_F(RtpToNtpEstimatorTest, IgnoresDuplicateAndOldReports) {
+  bool new_rtcp_sr = true;
+  EXPECT_FALSE(estimator_.UpdateMeasurements(0, 0, 0, &new_rtcp_sr));
+  EXPECT_FALSE(new_rtcp_sr);
+  EXPECT_TRUE(UpdateMeasurements(0, 0));
+  EXPECT_FALSE(UpdateMeasurements(0, 0));
+  EXPECT_EQ(1, estimator_.NumMeasurements());
+  EXPECT_TRUE(estimator_.UpdateMeasurements(ntp_sec_ - 1, 0, 0, &new_rtcp_sr));
+  EXPECT_FALSE(new_rtcp_sr);
+  EXPECT_EQ(1, estimator_.NumMeasurements());
+}
+
+TEST_F(RtpToNtpEstimatorTest, RtpWrapped) {
+  uint32_t timestamp = 0xFFFFFFFF - 500 * kTimestampTicksPerMs;
+  const int64_t first_ms = NowMs();
+  EXPECT_TRUE(UpdateMeasurements(timestamp, 1000));
+  timestamp += 1000 * kTimestampTicksPerMs;
+  EXPECT_TRUE(UpdateMeasurements(timestamp, 1000));
+  timestamp += 1000 * kTimestampTicksPerMs;
+  EXPECT_TRUE(UpdateMeasurements(timestamp, 1000));
+
+  int64_t timestamp_in_ms = -1;
+  EXPECT_TRUE(estimator_.Estimate(0xFFFFFFFF - 500 * kTimestampTicksPerMs,
+                                  &timestamp_in_ms));
+  EXPECT_EQ(first_ms, timestamp_in_ms);
+  EXPECT_TRUE(estimator_.Estimate(timestamp + 10 * kTimestampTicksPerMs,
+                                  &timestamp_in_ms));
+  EXPECT_EQ(first_ms + 2010, timestamp_in_ms);
+}
+
+TEST_F(RtpToNtpEstimatorTest, AveragesReports) {
+  // Reports with the RTP timestamps alternately 2 ms early and late.
+  const int64_t first_ms = NowMs();
+  for (int i = 0; i < 20; ++i) {
+    uint32_t timestamp = (i * 1000 + (i % 2 == 0 ? -2 : 2)) *
+        kTimestampTicksPerMs;
+    EXPECT_TRUE(UpdateMeasurements(timestamp, 1000));
+  }
+  EXPECT_EQ(20, estimator_.NumMeasurements());
+  int64_t timestamp_in_ms = -1;
+  EXPECT_TRUE(estimator_.Estimate(20000 * kTimestampTicksPerMs,
+                                  &timestamp_in_ms));
+  EXPECT_NEAR(first_ms + 20000, timestamp_in_ms, 1);
+
+  // Only the latest reports are kept.
+  EXPECT_TRUE(UpdateMeasurements(20000 * kTimestampTicksPerMs, 1000));
+  EXPECT_EQ(20, estimator_.NumMeasurements());
+}
+
+TEST_F(RtpToNtpEstimatorTest, ResetsOnRtpClockRestart) {
+  EXPECT_TRUE(UpdateMeasurements(0, 1000));
+  EXPECT_TRUE(UpdateMeasurements(1000 * kTimestampTicksPerMs, 1000));
+  EXPECT_TRUE(UpdateMeasurements(2000 * kTimestampTicksPerMs, 1000));
+  EXPECT_EQ(3, estimator_.NumMeasurements());
+
+  // The sender restarts with a new random RTP timestamp.
+  const int64_t restart_ms = NowMs();
+  const uint32_t kRestartTimestamp = 123456789;
+  EXPECT_TRUE(UpdateMeasurements(kRestartTimestamp, 1000));
+  EXPECT_EQ(1, estimator_.NumMeasurements());
+  int64_t timestamp_in_ms = -1;
+  EXPECT_FALSE(estimator_.Estimate(kRestartTimestamp, &timestamp_in_ms));
+
+  EXPECT_TRUE(
+      UpdateMeasurements(kRestartTimestamp + 1000 * kTimestampTicksPerMs, 0));
+  EXPECT_TRUE(estimator_.Estimate(kRestartTimestamp, &timestamp_in_ms));
+  EXPECT_EQ(restart_ms, timestamp_in_ms);
+}
+}  // namespace webrtc
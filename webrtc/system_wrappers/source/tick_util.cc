@@ -27,6 +27,10 @@ void TickTime::AdvanceFakeClock(int64_t milliseconds) {
   fake_ticks_ += MillisecondsToTicks(milliseconds);
 }
 
+void TickTime::UseRealClock() {
+  use_fake_clock_ = false;
+}
+
 int64_t TickTime::QueryOsForTicks() {
   TickTime result;
 #if _WIN32
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "webrtc/tools/simple_command_line_parser.h"
+
+namespace {
+
+const int kMaxLineLength = 1024;
+const int kPercentiles[] = {50, 90, 95, 99, 100};
+const size_t kNumPercentiles = sizeof(kPercentiles) / sizeof(kPercentiles[0]);
+
+std::vector<std::string> SplitLine(const std::string& line) {
+  std::vector<std::string> fields;
+  std::stringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, ','))
+    fields.push_back(field);
+  return fields;
+}
+
+// Returns the |percentile|th percentile of the sorted |values|, using the
+// nearest-rank method.
+int Percentile(const std::vector<int>& values, int percentile) {
+  size_t rank = (percentile * values.size() + 99) / 100;
+  rank = std::max<size_t>(rank, 1);
+  return values[rank - 1];
+}
+
+void PrintStageRow(const std::string& name, std::vector<int>* values) {
+  std::sort(values->begin(), values->end());
+  printf("%-24s", name.c_str());
+  for (size_t i = 0; i < kNumPercentiles; ++i) {
+    if (values->empty())
+      printf("%8s", "-");
+    else
+      printf("%8d", Percentile(*values, kPercentiles[i]));
+  }
+  printf("\n");
+}
+
+}  // namespace
+
+/*
+ * A tool summarizing the per-frame encode pipeline timings written by
+ * ViECodec::WriteEncodePipelineTimings, which requires the video engine to be
+ * created with the EncodePipelineTracing config option. For every stage it
+ * prints the percentiles of the time spent in the stage, i.e. since the
+ * previous stage the frame reached, and of the total time since capture.
+ * Stages a frame skipped, e.g. preprocessing on the direct pacer path, are
+ * left out of the statistics of that stage.
+ *
+ * Usage:
+ * encode_pipeline_analyzer --input_file=<name_of_file>
+ */
+int main(int argc, char** argv) {
+  std::string program_name = argv[0];
+  std::string usage = "Prints latency percentiles of the send-side video "
+      "pipeline stages.\n"
+      "Example usage:\n" + program_name + " --input_file=timings.csv\n"
+      "Command line flags:\n"
+      "  - input_file(string): The file written by "
+      "ViECodec::WriteEncodePipelineTimings. Default: timings.csv\n";
+
+  webrtc::test::CommandLineParser parser;
+
+  // Init the parser and set the usage message
+  parser.Init(argc, argv);
+  parser.SetUsageMessage(usage);
+
+  parser.SetFlag("input_file", "timings.csv");
+  parser.SetFlag("help", "false");
+
+  parser.ProcessFlags();
+  if (parser.GetFlag("help") == "true") {
+    parser.PrintUsageMessage();
+    return 0;
+  }
+
+  FILE* input_file = fopen(parser.GetFlag("input_file").c_str(), "r");
+  if (input_file == NULL) {
+    fprintf(stderr, "Error: could not open %s\n",
+            parser.GetFlag("input_file").c_str());
+    return -1;
+  }
+
+  char line[kMaxLineLength];
+  if (fgets(line, kMaxLineLength, input_file) == NULL) {
+    fprintf(stderr, "Error: empty input file.\n");
+    fclose(input_file);
+    return -1;
+  }
+  // The first column holds the capture time, the others the time of each
+  // stage relative to capture, or a negative value if the frame didn't reach
+  // the stage.
+  std::vector<std::string> stage_names = SplitLine(line);
+  if (stage_names.size() < 2) {
+    fprintf(stderr, "Error: no stages in input file.\n");
+    fclose(input_file);
+    return -1;
+  }
+  stage_names.back().erase(stage_names.back().find_last_not_of("\r\n") + 1);
+  const size_t num_stages = stage_names.size() - 1;
+
+  std::vector<std::vector<int> > stage_times(num_stages);
+  std::vector<std::vector<int> > total_times(num_stages);
+  int num_frames = 0;
+  while (fgets(line, kMaxLineLength, input_file) != NULL) {
+    std::vector<std::string> fields = SplitLine(line);
+    if (fields.size() != stage_names.size())
+      continue;
+    int previous_offset_ms = 0;
+    for (size_t i = 0; i < num_stages; ++i) {
+      int offset_ms = atoi(fields[i + 1].c_str());
+      if (offset_ms < 0)
+        continue;
+      stage_times[i].push_back(offset_ms - previous_offset_ms);
+      total_times[i].push_back(offset_ms);
+      previous_offset_ms = offset_ms;
+    }
+    ++num_frames;
+  }
+  fclose(input_file);
+
+  if (num_frames == 0) {
+    fprintf(stderr, "Error: no frames in input file.\n");
+    return -1;
+  }
+
+  printf("%d frames, times in ms\n", num_frames);
+  printf("%-24s", "stage");
+  for (size_t i = 0; i < kNumPercentiles; ++i) {
+    char label[8];
+    snprintf(label, sizeof(label), "p%d", kPercentiles[i]);
+    printf("%8s", label);
+  }
+  printf("\n");
+  for (size_t i = 0; i < num_stages; ++i)
+    PrintStageRow(stage_names[i + 1], &stage_times[i]);
+  printf("\nSince capture:\n");
+  for (size_t i = 0; i < num_stages; ++i)
+    PrintStageRow(stage_names[i + 1], &total_times[i]);
+  return 0;
+}
@@ -86,6 +86,16 @@
         'frame_editing/frame_editing.cc',
       ],
     }, # frame_editing
+    {
+      'target_name': 'encode_pipeline_analyzer',
+      'type': 'executable',
+      'dependencies': [
+        '<(webrtc_root)/tools/internal_tools.gyp:command_line_parser',
+      ],
+      'sources': [
+        'encode_pipeline_analyzer/encode_pipeline_analyzer.cc',
+      ],
+    }, # encode_pipeline_analyzer
     {
       'target_name': 'force_mic_volume_max',
       'type': 'executable',
@@ -17,12 +17,15 @@
 
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/call.h"
+#include "webrtc/common.h"
+#include "webrtc/experiments.h"
 #include "webrtc/modules/audio_coding/main/interface/audio_coding_module.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/rtp_to_ntp.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
 #include "webrtc/test/call_test.h"
 #include "webrtc/test/direct_transport.h"
 #include "webrtc/test/encoder_settings.h"
@@ -32,6 +35,7 @@
 #include "webrtc/test/frame_generator.h"
 #include "webrtc/test/frame_generator_capturer.h"
 #include "webrtc/test/rtp_rtcp_observer.h"
+#include "webrtc/test/statistics.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/test/testsupport/perf_test.h"
 #include "webrtc/video/transport_adapter.h"
@@ -51,6 +55,11 @@ class CallPerfTest : public test::CallTest {
 
   void TestMinTransmitBitrate(bool pad_to_min_bitrate);
 
+  void TestCaptureToEncodeLatency(bool direct_capture_delivery);
+
+  void TestSlowEncoder(bool queued_encoding,
+                       QueuedEncoding::DropPolicy drop_policy);
+
   void TestCaptureNtpTime(const FakeNetworkPipe::Config& net_config,
                           int threshold_ms,
                           int start_time_ms,
@@ -684,4 +693,209 @@ TEST_F(CallPerfTest, KeepsHighBitrateWhenReconfiguringSender) {
   RunBaseTest(&test);
 }
 
+void CallPerfTest::TestCaptureToEncodeLatency(bool direct_capture_delivery) {
+  static const int kNumFramesToMeasure = 300;
+
+  class CaptureToEncodeObserver : public test::SendTest,
+                                  public test::FakeEncoder {
+   public:
+    explicit CaptureToEncodeObserver(bool direct_capture_delivery)
+        : SendTest(kLongTimeoutMs),
+          FakeEncoder(Clock::GetRealTimeClock()),
+          direct_capture_delivery_(direct_capture_delivery),
+          clock_(Clock::GetRealTimeClock()),
+          num_measured_frames_(0) {
+      webrtc_config_.Set<DirectCaptureDelivery>(
+          new DirectCaptureDelivery(direct_capture_delivery));
+    }
+
+   private:
+    virtual int32_t Encode(
+        const I420VideoFrame& input_image,
+        const CodecSpecificInfo* codec_specific_info,
+        const std::vector<VideoFrameType>* frame_types) OVERRIDE {
+      int32_t result =
+          FakeEncoder::Encode(input_image, codec_specific_info, frame_types);
+      // FrameGeneratorCapturer stamps frames with the NTP capture time.
+      int64_t latency_ms =
+          clock_->CurrentNtpInMilliseconds() - input_image.render_time_ms();
+      if (num_measured_frames_ < kNumFramesToMeasure) {
+        latency_ms_.AddSample(static_cast<double>(latency_ms));
+        if (++num_measured_frames_ == kNumFramesToMeasure)
+          observation_complete_->Set();
+      }
+      return result;
+    }
+
+    virtual Call::Config GetSenderCallConfig() OVERRIDE {
+      Call::Config config = SendTest::GetSenderCallConfig();
+      config.webrtc_config = &webrtc_config_;
+      return config;
+    }
+
+    virtual void ModifyConfigs(
+        VideoSendStream::Config* send_config,
+        std::vector<VideoReceiveStream::Config>* receive_configs,
+        VideoEncoderConfig* encoder_config) OVERRIDE {
+      send_config->encoder_settings.encoder = this;
+    }
+
+    virtual void PerformTest() OVERRIDE {
+      EXPECT_EQ(kEventSignaled, Wait())
+          << "Timed out while waiting for frames to be encoded.";
+      std::stringstream mean_and_error;
+      mean_and_error << latency_ms_.Mean() << ","
+                     << latency_ms_.StandardDeviation();
+      webrtc::test::PrintResultMeanAndError(
+          "capture_to_encode_latency",
+          direct_capture_delivery_ ? "_direct_delivery" : "",
+          "frame_generator_capturer", mean_and_error.str(), "ms", false);
+    }
+
+    const bool direct_capture_delivery_;
+    Clock* const clock_;
+    webrtc::Config webrtc_config_;
+    int num_measured_frames_;
+    test::Statistics latency_ms_;
+  } test(direct_capture_delivery);
+
+  RunBaseTest(&test);
+}
+
+TEST_F(CallPerfTest, CaptureToEncodeLatency) {
+  TestCaptureToEncodeLatency(false);
+}
+
+TEST_F(CallPerfTest, CaptureToEncodeLatencyWithDirectDelivery) {
+  TestCaptureToEncodeLatency(true);
+}
+
+void CallPerfTest::TestSlowEncoder(bool queued_encoding,
+                                   QueuedEncoding::DropPolicy drop_policy) {
+  static const int kNumFramesToMeasure = 150;
+  static const int kMaxQueuedFrames = 4;
+  // Most frames are encoded in time, but every |kSlowFrameInterval|th frame
+  // takes several frame intervals to encode.
+  static const int kEncodeTimeMs = 10;
+  static const int kSlowEncodeTimeMs = 150;
+  static const int kSlowFrameInterval = 10;
+
+  class SlowEncoderObserver : public test::SendTest, public test::FakeEncoder {
+   public:
+    SlowEncoderObserver(bool queued_encoding,
+                        QueuedEncoding::DropPolicy drop_policy)
+        : SendTest(kLongTimeoutMs),
+          FakeEncoder(Clock::GetRealTimeClock()),
+          clock_(Clock::GetRealTimeClock()),
+          num_encoded_frames_(0),
+          first_capture_time_ms_(-1),
+          last_capture_time_ms_(-1),
+          max_capture_gap_ms_(0) {
+      // Deliver frames on the capturing thread, so that the encoder blocks
+      // the capturer unless frames are queued.
+      webrtc_config_.Set<DirectCaptureDelivery>(
+          new DirectCaptureDelivery(true));
+      if (queued_encoding) {
+        webrtc_config_.Set<QueuedEncoding>(
+            new QueuedEncoding(kMaxQueuedFrames, drop_policy));
+        switch (drop_policy) {
+          case QueuedEncoding::kDropOldest:
+            modifier_ = "_drop_oldest";
+            break;
+          case QueuedEncoding::kDropNewest:
+            modifier_ = "_drop_newest";
+            break;
+          case QueuedEncoding::kDropRateBased:
+            modifier_ = "_drop_rate_based";
+            break;
+        }
+      }
+    }
+
+   private:
+    virtual int32_t Encode(
+        const I420VideoFrame& input_image,
+        const CodecSpecificInfo* codec_specific_info,
+        const std::vector<VideoFrameType>* frame_types) OVERRIDE {
+      // FrameGeneratorCapturer stamps frames with the NTP capture time.
+      int64_t capture_time_ms = input_image.render_time_ms();
+      latency_ms_.AddSample(static_cast<double>(
+          clock_->CurrentNtpInMilliseconds() - capture_time_ms));
+      if (first_capture_time_ms_ == -1)
+        first_capture_time_ms_ = capture_time_ms;
+      if (last_capture_time_ms_ != -1) {
+        max_capture_gap_ms_ = std::max(
+            max_capture_gap_ms_, capture_time_ms - last_capture_time_ms_);
+      }
+      last_capture_time_ms_ = capture_time_ms;
+
+      SleepMs(num_encoded_frames_ % kSlowFrameInterval == 0 ? kSlowEncodeTimeMs
+                                                           : kEncodeTimeMs);
+      if (++num_encoded_frames_ == kNumFramesToMeasure)
+        observation_complete_->Set();
+      return FakeEncoder::Encode(input_image, codec_specific_info,
+                                 frame_types);
+    }
+
+    virtual Call::Config GetSenderCallConfig() OVERRIDE {
+      Call::Config config = SendTest::GetSenderCallConfig();
+      config.webrtc_config = &webrtc_config_;
+      return config;
+    }
+
+    virtual void ModifyConfigs(
+        VideoSendStream::Config* send_config,
+        std::vector<VideoReceiveStream::Config>* receive_configs,
+        VideoEncoderConfig* encoder_config) OVERRIDE {
+      send_config->encoder_settings.encoder = this;
+    }
+
+    virtual void PerformTest() OVERRIDE {
+      EXPECT_EQ(kEventSignaled, Wait())
+          << "Timed out while waiting for frames to be encoded.";
+      std::stringstream mean_and_error;
+      mean_and_error << latency_ms_.Mean() << ","
+                     << latency_ms_.StandardDeviation();
+      webrtc::test::PrintResultMeanAndError(
+          "capture_to_encode_latency", modifier_, "slow_encoder",
+          mean_and_error.str(), "ms", false);
+      int64_t duration_ms = last_capture_time_ms_ - first_capture_time_ms_;
+      webrtc::test::PrintResult(
+          "encoded_frame_rate", modifier_, "slow_encoder",
+          static_cast<size_t>((kNumFramesToMeasure - 1) * 1000 / duration_ms),
+          "fps", false);
+      webrtc::test::PrintResult(
+          "max_capture_gap", modifier_, "slow_encoder",
+          static_cast<size_t>(max_capture_gap_ms_), "ms", false);
+    }
+
+    Clock* const clock_;
+    webrtc::Config webrtc_config_;
+    std::string modifier_;
+    int num_encoded_frames_;
+    int64_t first_capture_time_ms_;
+    int64_t last_capture_time_ms_;
+    int64_t max_capture_gap_ms_;
+    test::Statistics latency_ms_;
+  } test(queued_encoding, drop_policy);
+
+  RunBaseTest(&test);
+}
+
+TEST_F(CallPerfTest, SlowEncoder) {
+  TestSlowEncoder(false, QueuedEncoding::kDropOldest);
+}
+
+TEST_F(CallPerfTest, SlowEncoderWithQueueDropOldest) {
+  TestSlowEncoder(true, QueuedEncoding::kDropOldest);
+}
+
+TEST_F(CallPerfTest, SlowEncoderWithQueueDropNewest) {
+  TestSlowEncoder(true, QueuedEncoding::kDropNewest);
+}
+
+TEST_F(CallPerfTest, SlowEncoderWithQueueDropRateBased) {
+  TestSlowEncoder(true, QueuedEncoding::kDropRateBased);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/encode_pipeline_tracer.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
+
+namespace webrtc {
+
+namespace {
+// Marks a stage which the frame has not reached yet.
+const int32_t kNotReached = -1;
+
+// Number of recent frames searched when a stage is reported. Frames older
+// than this are considered lost in the pipeline, e.g. dropped by the encoder.
+const int kMaxFramesInFlight = 64;
+
+void StoreValue(Atomic32* value, int32_t new_value) {
+  int32_t old_value = value->Value();
+  while (!value->CompareExchange(new_value, old_value))
+    old_value = value->Value();
+}
+}  // namespace
+
+EncodePipelineTracer::EncodePipelineTracer(Clock* clock)
+    : clock_(clock),
+      next_slot_(0),
+      slots_(new Slot[kNumSlots]) {
+  // The slot index is derived from a wrapping 32-bit counter.
+  assert((kNumSlots & (kNumSlots - 1)) == 0);
+  for (int i = 0; i < kNumSlots; ++i) {
+    for (int j = 0; j < kNumStages; ++j)
+      StoreValue(&slots_[i].stage_offset_ms[j], kNotReached);
+  }
+}
+
+EncodePipelineTracer::~EncodePipelineTracer() {}
+
+void EncodePipelineTracer::FrameCaptured(int64_t capture_time_ms) {
+  uint32_t index = static_cast<uint32_t>(++next_slot_) % kNumSlots;
+  Slot* slot = &slots_[index];
+  // Invalidate the slot before reusing it so that it isn't matched by
+  // FindSlot() while being reset.
+  StoreValue(&slot->stage_offset_ms[kCaptured], kNotReached);
+  for (int i = kCaptured + 1; i < kNumStages; ++i)
+    StoreValue(&slot->stage_offset_ms[i], kNotReached);
+  StoreValue(&slot->capture_time_ms, static_cast<int32_t>(capture_time_ms));
+  StoreValue(&slot->stage_offset_ms[kCaptured], 0);
+  TRACE_EVENT_ASYNC_BEGIN0("webrtc", "EncodePipeline", capture_time_ms);
+}
+
+void EncodePipelineTracer::OnFrameStage(int64_t capture_time_ms,
+                                        Stage stage) {
+  assert(stage > kCaptured && stage < kNumStages);
+  Slot* slot = FindSlot(static_cast<uint32_t>(capture_time_ms));
+  if (slot == NULL)
+    return;
+  int64_t offset_ms = clock_->TimeInMilliseconds() - capture_time_ms;
+  offset_ms = std::max<int64_t>(0, offset_ms);
+  offset_ms = std::min<int64_t>(std::numeric_limits<int32_t>::max(),
+                                offset_ms);
+  if (!slot->stage_offset_ms[stage].CompareExchange(
+          static_cast<int32_t>(offset_ms), kNotReached)) {
+    // Stage already reported, e.g. for a later packet of the same frame.
+    return;
+  }
+  if (stage == kSent) {
+    TRACE_EVENT_ASYNC_END0("webrtc", "EncodePipeline", capture_time_ms);
+  } else {
+    TRACE_EVENT_ASYNC_STEP0("webrtc", "EncodePipeline", capture_time_ms,
+                            StageName(stage));
+  }
+}
+
+void EncodePipelineTracer::GetCompletedFrames(
+    std::vector<FrameTimings>* frames) {
+  frames->clear();
+  uint32_t newest = static_cast<uint32_t>(next_slot_.Value());
+  for (int i = kNumSlots - 1; i >= 0; --i) {
+    Slot* slot = &slots_[(newest - i) % kNumSlots];
+    if (slot->stage_offset_ms[kCaptured].Value() != 0 ||
+        slot->stage_offset_ms[kSent].Value() == kNotReached) {
+      continue;
+    }
+    FrameTimings timings;
+    timings.capture_time_ms =
+        static_cast<uint32_t>(slot->capture_time_ms.Value());
+    for (int j = 0; j < kNumStages; ++j)
+      timings.stage_offset_ms[j] = slot->stage_offset_ms[j].Value();
+    frames->push_back(timings);
+  }
+}
+
+void EncodePipelineTracer::WriteCompletedFrames(FILE* file) {
+  std::vector<FrameTimings> frames;
+  GetCompletedFrames(&frames);
+  fprintf(file, "capture_time_ms");
+  for (int i = kCaptured + 1; i < kNumStages; ++i)
+    fprintf(file, ",%s", StageName(static_cast<Stage>(i)));
+  fprintf(file, "\n");
+  for (size_t i = 0; i < frames.size(); ++i) {
+    fprintf(file, "%u", frames[i].capture_time_ms);
+    for (int j = kCaptured + 1; j < kNumStages; ++j)
+      fprintf(file, ",%d", frames[i].stage_offset_ms[j]);
+    fprintf(file, "\n");
+  }
+}
+
+const char* EncodePipelineTracer::StageName(Stage stage) {
+  switch (stage) {
+    case kCaptured:
+      return "captured";
+    case kDelivered:
+      return "delivered";
+    case kPreprocessed:
+      return "preprocessed";
+    case kEncodeStarted:
+      return "encode_started";
+    case kEncoded:
+      return "encoded";
+    case kPacketized:
+      return "packetized";
+    case kSent:
+      return "sent";
+    case kNumStages:
+      break;
+  }
+  assert(false);
+  return "";
+}
+
+EncodePipelineTracer::Slot* EncodePipelineTracer::FindSlot(
+    uint32_t capture_time_ms) {
+  uint32_t newest = static_cast<uint32_t>(next_slot_.Value());
+  for (int i = 0; i < kMaxFramesInFlight; ++i) {
+    Slot* slot = &slots_[(newest - i) % kNumSlots];
+    if (slot->stage_offset_ms[kCaptured].Value() == 0 &&
+        static_cast<uint32_t>(slot->capture_time_ms.Value()) ==
+            capture_time_ms) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+}  // namespace webrtc
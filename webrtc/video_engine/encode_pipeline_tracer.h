@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_ENGINE_ENCODE_PIPELINE_TRACER_H_
+#define WEBRTC_VIDEO_ENGINE_ENCODE_PIPELINE_TRACER_H_
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class Clock;
+
+// Records when each frame passes the stages of the send-side video pipeline.
+// Frames are identified by their capture time, which is expected to be in the
+// same time base as |clock|. The stages may be reported from different threads
+// without taking any locks; the timings are kept in a fixed size ring buffer
+// of atomic slots, so only the most recent kNumSlots frames are retained.
+class EncodePipelineTracer {
+ public:
+  enum Stage {
+    kCaptured = 0,     // The capture time of the frame.
+    kDelivered,        // The frame was delivered to the encoder.
+    kPreprocessed,     // Frame preprocessing (scaling, decimation) is done.
+    kEncodeStarted,    // The frame was handed to the encoder.
+    kEncoded,          // The encoded image was returned by the encoder.
+    kPacketized,       // All packets were handed to the pacer.
+    kSent,             // The first packet of the frame was sent.
+    kNumStages
+  };
+
+  // Stage times of a frame, in ms relative to the capture time, or -1 for
+  // stages the frame skipped.
+  struct FrameTimings {
+    uint32_t capture_time_ms;
+    int stage_offset_ms[kNumStages];
+  };
+
+  static const int kNumSlots = 512;
+
+  explicit EncodePipelineTracer(Clock* clock);
+  ~EncodePipelineTracer();
+
+  // Starts tracking a new frame. Must be called before the other stages are
+  // reported for the frame.
+  void FrameCaptured(int64_t capture_time_ms);
+
+  // Reports that the frame captured at |capture_time_ms| reached |stage|,
+  // which must come after kCaptured. Only the first report of each stage is
+  // kept. Reports for frames which are no longer, or never were, tracked are
+  // ignored.
+  void OnFrameStage(int64_t capture_time_ms, Stage stage);
+
+  // Returns the timings of all tracked frames that have reached kSent, oldest
+  // first.
+  void GetCompletedFrames(std::vector<FrameTimings>* frames);
+
+  // Writes the timings of all completed frames to |file| as comma separated
+  // values, one frame per line, preceded by a header line naming the stages.
+  void WriteCompletedFrames(FILE* file);
+
+  static const char* StageName(Stage stage);
+
+ private:
+  struct Slot {
+    Atomic32 capture_time_ms;
+    Atomic32 stage_offset_ms[kNumStages];
+  };
+
+  // Returns the slot tracking |capture_time_ms|, or NULL if not found.
+  Slot* FindSlot(uint32_t capture_time_ms);
+
+  Clock* const clock_;
+  Atomic32 next_slot_;
+  scoped_ptr<Slot[]> slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(EncodePipelineTracer);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_ENCODE_PIPELINE_TRACER_H_
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <vector>
+
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/video_engine/encode_pipeline_tracer.h"
+
+namespace webrtc {
+namespace {
+const int kFrameIntervalMs = 33;
+const int64_t kStartTimeMs = 10000;
+}  // namespace
+
+class EncodePipelineTracerTest : public ::testing::Test {
+ protected:
+  EncodePipelineTracerTest()
+      : clock_(kStartTimeMs),
+        tracer_(&clock_) {}
+
+  // Captures a frame and passes it through all stages, spending
+  // |stage_time_ms| in each of them.
+  int64_t RunFrameThroughPipeline(int stage_time_ms) {
+    int64_t capture_time_ms = clock_.TimeInMilliseconds();
+    tracer_.FrameCaptured(capture_time_ms);
+    for (int i = EncodePipelineTracer::kCaptured + 1;
+         i < EncodePipelineTracer::kNumStages; ++i) {
+      clock_.AdvanceTimeMilliseconds(stage_time_ms);
+      tracer_.OnFrameStage(capture_time_ms,
+                           static_cast<EncodePipelineTracer::Stage>(i));
+    }
+    return capture_time_ms;
+  }
+
+  SimulatedClock clock_;
+  EncodePipelineTracer tracer_;
+};
+
+TEST_F(EncodePipelineTracerTest, StagesAreOrdered) {
+  const int kNumFrames = 10;
+  for (int i = 0; i < kNumFrames; ++i) {
+    RunFrameThroughPipeline(i + 1);
+    clock_.AdvanceTimeMilliseconds(kFrameIntervalMs);
+  }
+
+  std::vector<EncodePipelineTracer::FrameTimings> frames;
+  tracer_.GetCompletedFrames(&frames);
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), frames.size());
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(0, frames[i].stage_offset_ms[EncodePipelineTracer::kCaptured]);
+    for (int j = EncodePipelineTracer::kCaptured + 1;
+         j < EncodePipelineTracer::kNumStages; ++j) {
+      EXPECT_GT(frames[i].stage_offset_ms[j],
+                frames[i].stage_offset_ms[j - 1]);
+      EXPECT_EQ(j * (i + 1), frames[i].stage_offset_ms[j]);
+    }
+    if (i > 0)
+      EXPECT_GT(frames[i].capture_time_ms, frames[i - 1].capture_time_ms);
+  }
+}
+
+TEST_F(EncodePipelineTracerTest, OnlyFirstReportOfStageIsKept) {
+  int64_t capture_time_ms = clock_.TimeInMilliseconds();
+  tracer_.FrameCaptured(capture_time_ms);
+  clock_.AdvanceTimeMilliseconds(5);
+  tracer_.OnFrameStage(capture_time_ms, EncodePipelineTracer::kSent);
+  clock_.AdvanceTimeMilliseconds(5);
+  tracer_.OnFrameStage(capture_time_ms, EncodePipelineTracer::kSent);
+
+  std::vector<EncodePipelineTracer::FrameTimings> frames;
+  tracer_.GetCompletedFrames(&frames);
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(5, frames[0].stage_offset_ms[EncodePipelineTracer::kSent]);
+}
+
+TEST_F(EncodePipelineTracerTest, IncompleteAndUnknownFramesAreIgnored) {
+  int64_t capture_time_ms = clock_.TimeInMilliseconds();
+  tracer_.FrameCaptured(capture_time_ms);
+  tracer_.OnFrameStage(capture_time_ms, EncodePipelineTracer::kEncoded);
+  // Never captured.
+  tracer_.OnFrameStage(capture_time_ms + 1, EncodePipelineTracer::kSent);
+
+  std::vector<EncodePipelineTracer::FrameTimings> frames;
+  tracer_.GetCompletedFrames(&frames);
+  EXPECT_TRUE(frames.empty());
+}
+
+TEST_F(EncodePipelineTracerTest, KeepsMostRecentFrames) {
+  const int kNumFrames = EncodePipelineTracer::kNumSlots + 10;
+  int64_t last_capture_time_ms = 0;
+  for (int i = 0; i < kNumFrames; ++i) {
+    last_capture_time_ms = RunFrameThroughPipeline(1);
+    clock_.AdvanceTimeMilliseconds(kFrameIntervalMs);
+  }
+
+  std::vector<EncodePipelineTracer::FrameTimings> frames;
+  tracer_.GetCompletedFrames(&frames);
+  ASSERT_EQ(static_cast<size_t>(EncodePipelineTracer::kNumSlots),
+            frames.size());
+  EXPECT_EQ(static_cast<uint32_t>(last_capture_time_ms),
+            frames.back().capture_time_ms);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/encode_queue.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+#include "webrtc/base/exp_filter.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
+#include "webrtc/video_frame.h"
+
+namespace webrtc {
+
+namespace {
+const float kEncodeTimeWeightFactor = 0.9f;
+}  // namespace
+
+EncodeQueue::EncodeQueue(Clock* clock,
+                         int max_queued_frames,
+                         DropPolicy drop_policy)
+    : clock_(clock),
+      max_queued_frames_(std::max(max_queued_frames, 1)),
+      drop_policy_(drop_policy),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      key_frame_requested_(false),
+      last_accepted_frame_ms_(0),
+      encode_start_ms_(0),
+      encode_time_ms_(new rtc::ExpFilter(kEncodeTimeWeightFactor)),
+      num_inserted_frames_(0),
+      num_dropped_frames_(0),
+      num_dequeued_frames_(0),
+      sum_queue_delay_ms_(0),
+      max_queue_delay_ms_(0) {}
+
+EncodeQueue::~EncodeQueue() {}
+
+bool EncodeQueue::InsertFrame(const I420VideoFrame& frame) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  CriticalSectionScoped cs(crit_.get());
+  ++num_inserted_frames_;
+  if (DropIncomingFrame(now_ms)) {
+    TRACE_EVENT_INSTANT0("webrtc", "EncodeQueue::DropIncomingFrame");
+    ++num_dropped_frames_;
+    return false;
+  }
+  if (drop_policy_ == QueuedEncoding::kDropNewest && key_frame_requested_ &&
+      queued_frames_.size() >= max_queued_frames_) {
+    while (!queued_frames_.empty())
+      DropOldestFrame();
+  }
+  while (queued_frames_.size() >= max_queued_frames_)
+    DropOldestFrame();
+
+  I420VideoFrame* queued_frame = GetFreeFrame();
+  if (queued_frame->CopyFrame(frame) != 0) {
+    free_frames_.push_back(queued_frame);
+    ++num_dropped_frames_;
+    return false;
+  }
+  queued_frames_.push_back(QueuedFrame(queued_frame, now_ms));
+  last_accepted_frame_ms_ = now_ms;
+  TRACE_COUNTER1("webrtc", "EncodeQueueSize", queued_frames_.size());
+  return true;
+}
+
+I420VideoFrame* EncodeQueue::NextFrame() {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  CriticalSectionScoped cs(crit_.get());
+  if (queued_frames_.empty())
+    return NULL;
+  QueuedFrame next = queued_frames_.front();
+  queued_frames_.pop_front();
+  TRACE_COUNTER1("webrtc", "EncodeQueueSize", queued_frames_.size());
+
+  int queue_delay_ms = static_cast<int>(now_ms - next.insert_time_ms);
+  ++num_dequeued_frames_;
+  sum_queue_delay_ms_ += queue_delay_ms;
+  max_queue_delay_ms_ = std::max(max_queue_delay_ms_, queue_delay_ms);
+
+  // The pending key frame request applies to this frame.
+  key_frame_requested_ = false;
+  encode_start_ms_ = now_ms;
+  return next.frame;
+}
+
+void EncodeQueue::ReturnFrame(I420VideoFrame* frame) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  CriticalSectionScoped cs(crit_.get());
+  encode_time_ms_->Apply(1.0f, static_cast<float>(now_ms - encode_start_ms_));
+  free_frames_.push_back(frame);
+}
+
+void EncodeQueue::OnKeyFrameRequest() {
+  CriticalSectionScoped cs(crit_.get());
+  key_frame_requested_ = true;
+}
+
+int EncodeQueue::NumQueuedFrames() const {
+  CriticalSectionScoped cs(crit_.get());
+  return static_cast<int>(queued_frames_.size());
+}
+
+void EncodeQueue::GetStatistics(Statistics* stats) const {
+  CriticalSectionScoped cs(crit_.get());
+  stats->num_inserted_frames = num_inserted_frames_;
+  stats->num_dropped_frames = num_dropped_frames_;
+  stats->avg_queue_delay_ms =
+      num_dequeued_frames_ > 0
+          ? static_cast<int>(sum_queue_delay_ms_ / num_dequeued_frames_)
+          : 0;
+  stats->max_queue_delay_ms = max_queue_delay_ms_;
+}
+
+bool EncodeQueue::DropIncomingFrame(int64_t now_ms) {
+  switch (drop_policy_) {
+    case QueuedEncoding::kDropOldest:
+      return false;
+    case QueuedEncoding::kDropNewest:
+      return queued_frames_.size() >= max_queued_frames_ &&
+             !key_frame_requested_;
+    case QueuedEncoding::kDropRateBased: {
+      // Only drop while the encoder is behind, i.e. frames are waiting.
+      float encode_time_ms = encode_time_ms_->filtered();
+      if (queued_frames_.empty() ||
+          encode_time_ms == rtc::ExpFilter::kValueUndefined) {
+        return false;
+      }
+      return now_ms - last_accepted_frame_ms_ < encode_time_ms;
+    }
+  }
+  assert(false);
+  return false;
+}
+
+void EncodeQueue::DropOldestFrame() {
+  assert(!queued_frames_.empty());
+  TRACE_EVENT_INSTANT0("webrtc", "EncodeQueue::DropOldestFrame");
+  free_frames_.push_back(queued_frames_.front().frame);
+  queued_frames_.pop_front();
+  ++num_dropped_frames_;
+}
+
+I420VideoFrame* EncodeQueue::GetFreeFrame() {
+  if (free_frames_.empty()) {
+    I420VideoFrame* frame = new I420VideoFrame();
+    frame_pool_.push_back(frame);
+    return frame;
+  }
+  I420VideoFrame* frame = free_frames_.back();
+  free_frames_.pop_back();
+  return frame;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_ENGINE_ENCODE_QUEUE_H_
+#define WEBRTC_VIDEO_ENGINE_ENCODE_QUEUE_H_
+
+#include <list>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/experiments.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/typedefs.h"
+
+namespace rtc {
+class ExpFilter;
+}  // namespace rtc
+
+namespace webrtc {
+
+class Clock;
+class CriticalSectionWrapper;
+class I420VideoFrame;
+
+// Holds frames waiting to be encoded, decoupling the thread delivering frames
+// from the thread encoding them. Frames are copied into a pool of reused
+// buffers when inserted and handed out in the order they were inserted. At
+// most one frame at a time is expected to be taken out for encoding.
+class EncodeQueue {
+ public:
+  typedef QueuedEncoding::DropPolicy DropPolicy;
+
+  struct Statistics {
+    Statistics()
+        : num_inserted_frames(0),
+          num_dropped_frames(0),
+          avg_queue_delay_ms(0),
+          max_queue_delay_ms(0) {}
+
+    int num_inserted_frames;
+    int num_dropped_frames;
+    // Time from insertion until a frame was taken out for encoding.
+    int avg_queue_delay_ms;
+    int max_queue_delay_ms;
+  };
+
+  EncodeQueue(Clock* clock, int max_queued_frames, DropPolicy drop_policy);
+  ~EncodeQueue();
+
+  // Copies |frame| into the queue, dropping frames according to the drop
+  // policy. Returns false if |frame| itself was dropped.
+  bool InsertFrame(const I420VideoFrame& frame);
+
+  // Returns the oldest queued frame, or NULL if the queue is empty. The frame
+  // must be handed back with ReturnFrame() when done.
+  I420VideoFrame* NextFrame();
+  void ReturnFrame(I420VideoFrame* frame);
+
+  // Signals that the next encoded frame will be a key frame.
+  void OnKeyFrameRequest();
+
+  int NumQueuedFrames() const;
+
+  void GetStatistics(Statistics* stats) const;
+
+ private:
+  struct QueuedFrame {
+    QueuedFrame(I420VideoFrame* frame, int64_t insert_time_ms)
+        : frame(frame), insert_time_ms(insert_time_ms) {}
+
+    I420VideoFrame* frame;
+    int64_t insert_time_ms;
+  };
+
+  // Returns true if the frame inserted at |now_ms| should be dropped.
+  bool DropIncomingFrame(int64_t now_ms) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void DropOldestFrame() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  I420VideoFrame* GetFreeFrame() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  Clock* const clock_;
+  const size_t max_queued_frames_;
+  const DropPolicy drop_policy_;
+  scoped_ptr<CriticalSectionWrapper> crit_;
+
+  ScopedVector<I420VideoFrame> frame_pool_ GUARDED_BY(crit_);
+  std::vector<I420VideoFrame*> free_frames_ GUARDED_BY(crit_);
+  std::list<QueuedFrame> queued_frames_ GUARDED_BY(crit_);
+
+  bool key_frame_requested_ GUARDED_BY(crit_);
+  int64_t last_accepted_frame_ms_ GUARDED_BY(crit_);
+  int64_t encode_start_ms_ GUARDED_BY(crit_);
+  scoped_ptr<rtc::ExpFilter> encode_time_ms_ GUARDED_BY(crit_);
+
+  int num_inserted_frames_ GUARDED_BY(crit_);
+  int num_dropped_frames_ GUARDED_BY(crit_);
+  int num_dequeued_frames_ GUARDED_BY(crit_);
+  int64_t sum_queue_delay_ms_ GUARDED_BY(crit_);
+  int max_queue_delay_ms_ GUARDED_BY(crit_);
+
+  DISALLOW_COPY_AND_ASSIGN(EncodeQueue);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_ENCODE_QUEUE_H_
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/video_engine/encode_queue.h"
+#include "webrtc/video_frame.h"
+
+namespace webrtc {
+namespace {
+const int kWidth = 16;
+const int kHeight = 16;
+const int kFrameIntervalMs = 33;
+const int kMaxQueuedFrames = 3;
+}  // namespace
+
+class EncodeQueueTest : public ::testing::Test {
+ protected:
+  EncodeQueueTest() : clock_(1000) {
+    frame_.CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+  }
+
+  // Inserts a frame identified by the current time.
+  bool InsertFrame() {
+    frame_.set_render_time_ms(clock_.TimeInMilliseconds());
+    bool inserted = queue_->InsertFrame(frame_);
+    clock_.AdvanceTimeMilliseconds(kFrameIntervalMs);
+    return inserted;
+  }
+
+  // Takes out the next frame, spending |encode_time_ms| encoding it, and
+  // returns its render time.
+  int64_t EncodeFrame(int encode_time_ms) {
+    I420VideoFrame* frame = queue_->NextFrame();
+    EXPECT_TRUE(frame != NULL);
+    if (frame == NULL)
+      return -1;
+    int64_t render_time_ms = frame->render_time_ms();
+    clock_.AdvanceTimeMilliseconds(encode_time_ms);
+    queue_->ReturnFrame(frame);
+    return render_time_ms;
+  }
+
+  void CreateQueue(EncodeQueue::DropPolicy drop_policy) {
+    queue_.reset(new EncodeQueue(&clock_, kMaxQueuedFrames, drop_policy));
+  }
+
+  SimulatedClock clock_;
+  I420VideoFrame frame_;
+  scoped_ptr<EncodeQueue> queue_;
+};
+
+TEST_F(EncodeQueueTest, FramesAreReturnedInOrder) {
+  CreateQueue(QueuedEncoding::kDropOldest);
+  int64_t first_time_ms = clock_.TimeInMilliseconds();
+  EXPECT_TRUE(queue_->NextFrame() == NULL);
+  EXPECT_TRUE(InsertFrame());
+  EXPECT_TRUE(InsertFrame());
+  EXPECT_EQ(2, queue_->NumQueuedFrames());
+
+  EXPECT_EQ(first_time_ms, EncodeFrame(0));
+  EXPECT_EQ(first_time_ms + kFrameIntervalMs, EncodeFrame(0));
+  EXPECT_TRUE(queue_->NextFrame() == NULL);
+
+  EncodeQueue::Statistics stats;
+  queue_->GetStatistics(&stats);
+  EXPECT_EQ(2, stats.num_inserted_frames);
+  EXPECT_EQ(0, stats.num_dropped_frames);
+  // The first frame waited for two frame intervals, the second for one.
+  EXPECT_EQ(3 * kFrameIntervalMs / 2, stats.avg_queue_delay_ms);
+  EXPECT_EQ(2 * kFrameIntervalMs, stats.max_queue_delay_ms);
+}
+
+TEST_F(EncodeQueueTest, DropOldest) {
+  CreateQueue(QueuedEncoding::kDropOldest);
+  int64_t first_time_ms = clock_.TimeInMilliseconds();
+  for (int i = 0; i < kMaxQueuedFrames + 2; ++i)
+    EXPECT_TRUE(InsertFrame());
+  EXPECT_EQ(kMaxQueuedFrames, queue_->NumQueuedFrames());
+  EXPECT_EQ(first_time_ms + 2 * kFrameIntervalMs, EncodeFrame(0));
+
+  EncodeQueue::Statistics stats;
+  queue_->GetStatistics(&stats);
+  EXPECT_EQ(kMaxQueuedFrames + 2, stats.num_inserted_frames);
+  EXPECT_EQ(2, stats.num_dropped_frames);
+}
+
+TEST_F(EncodeQueueTest, DropNewest) {
+  CreateQueue(QueuedEncoding::kDropNewest);
+  int64_t first_time_ms = clock_.TimeInMilliseconds();
+  for (int i = 0; i < kMaxQueuedFrames; ++i)
+    EXPECT_TRUE(InsertFrame());
+  EXPECT_FALSE(InsertFrame());
+  EXPECT_EQ(kMaxQueuedFrames, queue_->NumQueuedFrames());
+  EXPECT_EQ(first_time_ms, EncodeFrame(0));
+
+  EncodeQueue::Statistics stats;
+  queue_->GetStatistics(&stats);
+  EXPECT_EQ(1, stats.num_dropped_frames);
+}
+
+TEST_F(EncodeQueueTest, DropNewestFlushesQueueOnKeyFrameRequest) {
+  CreateQueue(QueuedEncoding::kDropNewest);
+  for (int i = 0; i < kMaxQueuedFrames; ++i)
+    EXPECT_TRUE(InsertFrame());
+  queue_->OnKeyFrameRequest();
+  int64_t key_frame_time_ms = clock_.TimeInMilliseconds();
+  EXPECT_TRUE(InsertFrame());
+  EXPECT_EQ(1, queue_->NumQueuedFrames());
+  EXPECT_EQ(key_frame_time_ms, EncodeFrame(0));
+
+  // The request has been served, new frames are dropped again.
+  for (int i = 0; i < kMaxQueuedFrames; ++i)
+    EXPECT_TRUE(InsertFrame());
+  EXPECT_FALSE(InsertFrame());
+}
+
+TEST_F(EncodeQueueTest, DropRateBasedSpreadsDrops) {
+  CreateQueue(QueuedEncoding::kDropRateBased);
+  // Let the encoder take two frame intervals per frame.
+  const int kEncodeTimeMs = 2 * kFrameIntervalMs;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(InsertFrame());
+    EncodeFrame(kEncodeTimeMs);
+  }
+
+  // With a frame waiting, every other frame is dropped rather than the queue
+  // filling up.
+  EXPECT_TRUE(InsertFrame());
+  EXPECT_FALSE(InsertFrame());
+  EXPECT_TRUE(InsertFrame());
+  EXPECT_FALSE(InsertFrame());
+  EXPECT_EQ(2, queue_->NumQueuedFrames());
+}
+
+TEST_F(EncodeQueueTest, ReusesFrameBuffers) {
+  CreateQueue(QueuedEncoding::kDropOldest);
+  EXPECT_TRUE(InsertFrame());
+  I420VideoFrame* frame = queue_->NextFrame();
+  ASSERT_TRUE(frame != NULL);
+  queue_->ReturnFrame(frame);
+  EXPECT_TRUE(InsertFrame());
+  EXPECT_EQ(frame, queue_->NextFrame());
+  queue_->ReturnFrame(frame);
+}
+
+}  // namespace webrtc
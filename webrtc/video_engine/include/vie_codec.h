@@ -198,6 +198,12 @@ class WEBRTC_DLLEXPORT ViECodec {
   // Disables recording of debugging information.
   virtual int StopDebugRecording(int video_channel) = 0;
 
+  // Writes the per-stage encode pipeline timings of recently sent frames to
+  // |file_name_utf8|, as comma separated values. Requires the
+  // EncodePipelineTracing config option to be enabled.
+  virtual int WriteEncodePipelineTimings(int video_channel,
+                                         const char* file_name_utf8) = 0;
+
   // Lets the sender suspend video when the rate drops below
   // |threshold_bps|, and turns back on when the rate goes back up above
   // |threshold_bps| + |window_bps|.
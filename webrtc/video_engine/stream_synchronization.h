@@ -23,8 +23,9 @@ struct ViESyncDelay;
 class StreamSynchronization {
  public:
   struct Measurements {
-    Measurements() : rtcp(), latest_receive_time_ms(0), latest_timestamp(0) {}
-    RtcpList rtcp;
+    Measurements()
+        : rtp_to_ntp(), latest_receive_time_ms(0), latest_timestamp(0) {}
+    RtpToNtpEstimator rtp_to_ntp;
     int64_t latest_receive_time_ms;
     uint32_t latest_timestamp;
   };
@@ -10,8 +10,12 @@
 
 #include <algorithm>
 #include <math.h>
+#include <stdio.h>
+
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/video_engine/stream_synchronization.h"
 
 namespace webrtc {
@@ -81,6 +85,14 @@ class StreamSynchronizationTest : public ::testing::Test {
     delete receive_time_;
   }
 
+  void UpdateRtcp(StreamSynchronization::Measurements* stream,
+                  const RtcpMeasurement& rtcp) {
+    bool new_rtcp_sr = false;
+    EXPECT_TRUE(stream->rtp_to_ntp.UpdateMeasurements(
+        rtcp.ntp_secs, rtcp.ntp_frac, rtcp.rtp_timestamp, &new_rtcp_sr));
+    EXPECT_TRUE(new_rtcp_sr);
+  }
+
   // Generates the necessary RTCP measurements and RTP timestamps and computes
   // the audio and video delays needed to get the two streams in sync.
   // |audio_delay_ms| and |video_delay_ms| are the number of milliseconds after
@@ -101,20 +113,16 @@ class StreamSynchronizationTest : public ::testing::Test {
     StreamSynchronization::Measurements audio;
     StreamSynchronization::Measurements video;
     // Generate NTP/RTP timestamp pair for both streams corresponding to RTCP.
-    audio.rtcp.push_front(send_time_->GenerateRtcp(audio_frequency,
-                                                   audio_offset));
+    UpdateRtcp(&audio, send_time_->GenerateRtcp(audio_frequency, audio_offset));
     send_time_->IncreaseTimeMs(100);
     receive_time_->IncreaseTimeMs(100);
-    video.rtcp.push_front(send_time_->GenerateRtcp(video_frequency,
-                                                   video_offset));
+    UpdateRtcp(&video, send_time_->GenerateRtcp(video_frequency, video_offset));
     send_time_->IncreaseTimeMs(900);
     receive_time_->IncreaseTimeMs(900);
-    audio.rtcp.push_front(send_time_->GenerateRtcp(audio_frequency,
-                                                   audio_offset));
+    UpdateRtcp(&audio, send_time_->GenerateRtcp(audio_frequency, audio_offset));
     send_time_->IncreaseTimeMs(100);
     receive_time_->IncreaseTimeMs(100);
-    video.rtcp.push_front(send_time_->GenerateRtcp(video_frequency,
-                                                   video_offset));
+    UpdateRtcp(&video, send_time_->GenerateRtcp(video_frequency, video_offset));
     send_time_->IncreaseTimeMs(900);
     receive_time_->IncreaseTimeMs(900);
 
@@ -559,4 +567,71 @@ TEST_F(StreamSynchronizationTest,
   BothDelayedVideoLaterTest(base_target_delay_ms);
 }
 
+// Prints the cost of computing the relative delay of an audio/video pair, as
+// done once per pair and second by a receiver synchronizing many pairs. The
+// previous approach of fitting the two latest reports on every call is timed
+// for comparison.
+TEST_F(StreamSynchronizationTest, DISABLED_RelativeDelayCostPerPair) {
+  enum { kNumPairs = 500 };
+  enum { kNumReports = 10 };
+  enum { kNumRuns = 100 };
+  std::vector<StreamSynchronization::Measurements> audio(kNumPairs);
+  std::vector<StreamSynchronization::Measurements> video(kNumPairs);
+  std::vector<RtcpList> audio_rtcp(kNumPairs);
+  std::vector<RtcpList> video_rtcp(kNumPairs);
+  for (int i = 0; i < kNumReports; ++i) {
+    for (int j = 0; j < kNumPairs; ++j) {
+      RtcpMeasurement rtcp =
+          send_time_->GenerateRtcp(kDefaultAudioFrequency, j * 1000);
+      UpdateRtcp(&audio[j], rtcp);
+      audio_rtcp[j].push_front(rtcp);
+      rtcp = send_time_->GenerateRtcp(kDefaultVideoFrequency, j * 1000);
+      UpdateRtcp(&video[j], rtcp);
+      video_rtcp[j].push_front(rtcp);
+      if (audio_rtcp[j].size() > 2) {
+        audio_rtcp[j].pop_back();
+        video_rtcp[j].pop_back();
+      }
+    }
+    send_time_->IncreaseTimeMs(1000);
+  }
+  for (int j = 0; j < kNumPairs; ++j) {
+    audio[j].latest_timestamp =
+        send_time_->NowRtp(kDefaultAudioFrequency, j * 1000);
+    video[j].latest_timestamp =
+        send_time_->NowRtp(kDefaultVideoFrequency, j * 1000);
+    audio[j].latest_receive_time_ms = receive_time_->time_now_ms();
+    video[j].latest_receive_time_ms = receive_time_->time_now_ms();
+  }
+
+  int relative_delay_ms = -1;
+  TickTime t0 = TickTime::Now();
+  for (int i = 0; i < kNumRuns; ++i) {
+    for (int j = 0; j < kNumPairs; ++j) {
+      ASSERT_TRUE(StreamSynchronization::ComputeRelativeDelay(
+          audio[j], video[j], &relative_delay_ms));
+      ASSERT_EQ(0, relative_delay_ms);
+    }
+  }
+  int64_t estimator_us = (TickTime::Now() - t0).Microseconds();
+
+  t0 = TickTime::Now();
+  for (int i = 0; i < kNumRuns; ++i) {
+    for (int j = 0; j < kNumPairs; ++j) {
+      int64_t audio_ms = 0;
+      int64_t video_ms = 0;
+      ASSERT_TRUE(RtpToNtpMs(audio[j].latest_timestamp, audio_rtcp[j],
+                             &audio_ms));
+      ASSERT_TRUE(RtpToNtpMs(video[j].latest_timestamp, video_rtcp[j],
+                             &video_ms));
+      ASSERT_EQ(audio_ms, video_ms);
+    }
+  }
+  int64_t rtcp_list_us = (TickTime::Now() - t0).Microseconds();
+
+  printf("Relative delay [ns / pair]: estimator %d, two reports %d\n",
+         static_cast<int>(estimator_us * 1000 / (kNumRuns * kNumPairs)),
+         static_cast<int>(rtcp_list_us * 1000 / (kNumRuns * kNumPairs)));
+}
+
 }  // namespace webrtc
@@ -10,8 +10,10 @@
 
 #include "webrtc/video_engine/vie_capturer.h"
 
+#include "webrtc/common.h"
 #include "webrtc/common_video/interface/texture_video_frame.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/experiments.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/utility/interface/process_thread.h"
 #include "webrtc/modules/video_capture/include/video_capture_factory.h"
@@ -44,11 +46,11 @@ ViECapturer::ViECapturer(int capture_id,
       module_process_thread_(module_process_thread),
       capture_id_(capture_id),
       incoming_frame_cs_(CriticalSectionWrapper::CreateCriticalSection()),
-      capture_thread_(*ThreadWrapper::CreateThread(ViECaptureThreadFunction,
-                                                   this, kHighPriority,
-                                                   "ViECaptureThread")),
+      direct_delivery_(config.Get<DirectCaptureDelivery>().enabled),
       capture_event_(*EventWrapper::Create()),
       deliver_event_(*EventWrapper::Create()),
+      delivering_(false),
+      num_dropped_frames_(0),
       effect_filter_(NULL),
       image_proc_module_(NULL),
       image_proc_module_ref_counter_(0),
@@ -59,9 +61,14 @@ ViECapturer::ViECapturer(int capture_id,
       observer_cs_(CriticalSectionWrapper::CreateCriticalSection()),
       observer_(NULL),
       overuse_detector_(new OveruseFrameDetector(Clock::GetRealTimeClock())) {
-  unsigned int t_id = 0;
-  if (!capture_thread_.Start(t_id)) {
-    assert(false);
+  if (!direct_delivery_) {
+    capture_thread_.reset(ThreadWrapper::CreateThread(ViECaptureThreadFunction,
+                                                      this, kHighPriority,
+                                                      "ViECaptureThread"));
+    unsigned int t_id = 0;
+    if (!capture_thread_->Start(t_id)) {
+      assert(false);
+    }
   }
   module_process_thread_.RegisterModule(overuse_detector_.get());
 }
@@ -72,7 +79,8 @@ ViECapturer::~ViECapturer() {
   // Stop the thread.
   deliver_cs_->Enter();
   capture_cs_->Enter();
-  capture_thread_.SetNotAlive();
+  if (capture_thread_)
+    capture_thread_->SetNotAlive();
   capture_event_.Set();
   capture_cs_->Leave();
   deliver_cs_->Leave();
@@ -84,14 +92,17 @@ ViECapturer::~ViECapturer() {
     capture_module_->Release();
     capture_module_ = NULL;
   }
-  if (capture_thread_.Stop()) {
-    // Thread stopped.
-    delete &capture_thread_;
-    delete &capture_event_;
-    delete &deliver_event_;
-  } else {
+  if (capture_thread_ && !capture_thread_->Stop()) {
     assert(false);
   }
+  capture_thread_.reset();
+  delete &capture_event_;
+  delete &deliver_event_;
+
+  if (num_dropped_frames_ > 0) {
+    LOG(LS_INFO) << "Dropped " << num_dropped_frames_
+                 << " captured frames while delivering directly.";
+  }
 
   if (image_proc_module_) {
     VideoProcessingModule::Destroy(image_proc_module_);
@@ -337,27 +348,54 @@ void ViECapturer::SwapFrame(I420VideoFrame* frame) {
 
 void ViECapturer::OnIncomingCapturedFrame(const int32_t capture_id,
                                           I420VideoFrame& video_frame) {
-  CriticalSectionScoped cs(capture_cs_.get());
-  // Make sure we render this frame earlier since we know the render time set
-  // is slightly off since it's being set when the frame has been received from
-  // the camera, and not when the camera actually captured the frame.
-  video_frame.set_render_time_ms(video_frame.render_time_ms() - FrameDelay());
-
-  overuse_detector_->FrameCaptured(video_frame.width(),
-                                   video_frame.height(),
-                                   video_frame.render_time_ms());
-
-  TRACE_EVENT_ASYNC_BEGIN1("webrtc", "Video", video_frame.render_time_ms(),
-                           "render_time", video_frame.render_time_ms());
+  {
+    CriticalSectionScoped cs(capture_cs_.get());
+    // Make sure we render this frame earlier since we know the render time
+    // set is slightly off since it's being set when the frame has been
+    // received from the camera, and not when the camera actually captured the
+    // frame.
+    video_frame.set_render_time_ms(video_frame.render_time_ms() - FrameDelay());
+
+    overuse_detector_->FrameCaptured(video_frame.width(),
+                                     video_frame.height(),
+                                     video_frame.render_time_ms());
+
+    TRACE_EVENT_ASYNC_BEGIN1("webrtc", "Video", video_frame.render_time_ms(),
+                             "render_time", video_frame.render_time_ms());
+
+    if (direct_delivery_ && CapturedFrameAvailable()) {
+      // The previous frame has not been picked up yet, drop it in favor of the
+      // newest one.
+      ++num_dropped_frames_;
+      TRACE_EVENT_INSTANT0("webrtc", "ViECapturer::DroppedPendingFrame");
+    }
+    if (video_frame.native_handle() != NULL) {
+      captured_frame_.reset(video_frame.CloneFrame());
+    } else {
+      if (captured_frame_ == NULL || captured_frame_->native_handle() != NULL)
+        captured_frame_.reset(new I420VideoFrame());
+      captured_frame_->SwapFrame(&video_frame);
+    }
+    if (!direct_delivery_) {
+      capture_event_.Set();
+      return;
+    }
+    // Another thread is already delivering, it will pick up this frame when
+    // done with the current one.
+    if (delivering_)
+      return;
+    delivering_ = true;
+  }
 
-  if (video_frame.native_handle() != NULL) {
-    captured_frame_.reset(video_frame.CloneFrame());
-  } else {
-    if (captured_frame_ == NULL || captured_frame_->native_handle() != NULL)
-      captured_frame_.reset(new I420VideoFrame());
-    captured_frame_->SwapFrame(&video_frame);
+  // Deliver on this thread until no more frames are pending.
+  while (true) {
+    DeliverCapturedFrame();
+    CriticalSectionScoped cs(capture_cs_.get());
+    if (!CapturedFrameAvailable()) {
+      delivering_ = false;
+      return;
+    }
   }
-  capture_event_.Set();
 }
 
 void ViECapturer::OnCaptureDelayChanged(const int32_t id,
@@ -452,37 +490,43 @@ bool ViECapturer::ViECaptureThreadFunction(void* obj) {
 }
 
 bool ViECapturer::ViECaptureProcess() {
-  int64_t capture_time = -1;
   if (capture_event_.Wait(kThreadWaitTimeMs) == kEventSignaled) {
-    overuse_detector_->FrameProcessingStarted();
-    int64_t encode_start_time = -1;
-    deliver_cs_->Enter();
-    if (SwapCapturedAndDeliverFrameIfAvailable()) {
-      capture_time = deliver_frame_->render_time_ms();
-      encode_start_time = Clock::GetRealTimeClock()->TimeInMilliseconds();
-      DeliverI420Frame(deliver_frame_.get());
-      if (deliver_frame_->native_handle() != NULL)
-        deliver_frame_.reset();  // Release the texture so it can be reused.
-    }
-    deliver_cs_->Leave();
-    if (current_brightness_level_ != reported_brightness_level_) {
-      CriticalSectionScoped cs(observer_cs_.get());
-      if (observer_) {
-        observer_->BrightnessAlarm(id_, current_brightness_level_);
-        reported_brightness_level_ = current_brightness_level_;
-      }
-    }
-    // Update the overuse detector with the duration.
-    if (encode_start_time != -1) {
-      overuse_detector_->FrameEncoded(
-          Clock::GetRealTimeClock()->TimeInMilliseconds() - encode_start_time);
+    DeliverCapturedFrame();
+  }
+  return true;
+}
+
+bool ViECapturer::DeliverCapturedFrame() {
+  int64_t capture_time = -1;
+  overuse_detector_->FrameProcessingStarted();
+  int64_t encode_start_time = -1;
+  deliver_cs_->Enter();
+  if (SwapCapturedAndDeliverFrameIfAvailable()) {
+    capture_time = deliver_frame_->render_time_ms();
+    encode_start_time = Clock::GetRealTimeClock()->TimeInMilliseconds();
+    DeliverI420Frame(deliver_frame_.get());
+    if (deliver_frame_->native_handle() != NULL)
+      deliver_frame_.reset();  // Release the texture so it can be reused.
+  }
+  deliver_cs_->Leave();
+  if (current_brightness_level_ != reported_brightness_level_) {
+    CriticalSectionScoped cs(observer_cs_.get());
+    if (observer_) {
+      observer_->BrightnessAlarm(id_, current_brightness_level_);
+      reported_brightness_level_ = current_brightness_level_;
     }
   }
+  // Update the overuse detector with the duration.
+  if (encode_start_time != -1) {
+    overuse_detector_->FrameEncoded(
+        Clock::GetRealTimeClock()->TimeInMilliseconds() - encode_start_time);
+  }
   // We're done!
   if (capture_time != -1) {
     overuse_detector_->FrameSent(capture_time);
+    return true;
   }
-  return true;
+  return false;
 }
 
 void ViECapturer::DeliverI420Frame(I420VideoFrame* video_frame) {
@@ -599,6 +643,13 @@ void ViECapturer::OnNoPictureAlarm(const int32_t id,
   observer_->NoPictureAlarm(id, vie_alarm);
 }
 
+bool ViECapturer::CapturedFrameAvailable() const {
+  if (captured_frame_ == NULL)
+    return false;
+  return captured_frame_->native_handle() != NULL ||
+         !captured_frame_->IsZeroSize();
+}
+
 bool ViECapturer::SwapCapturedAndDeliverFrameIfAvailable() {
   CriticalSectionScoped cs(capture_cs_.get());
   if (captured_frame_ == NULL)
@@ -145,11 +145,16 @@ class ViECapturer
   static bool ViECaptureThreadFunction(void* obj);
   bool ViECaptureProcess();
 
+  // Delivers the most recently captured frame, if any, to all registered
+  // frame callbacks. Returns true if a frame was delivered.
+  bool DeliverCapturedFrame();
+
   void DeliverI420Frame(I420VideoFrame* video_frame);
   void DeliverCodedFrame(VideoFrame* video_frame);
 
  private:
   bool SwapCapturedAndDeliverFrameIfAvailable();
+  bool CapturedFrameAvailable() const EXCLUSIVE_LOCKS_REQUIRED(capture_cs_);
 
   // Never take capture_cs_ before deliver_cs_!
   scoped_ptr<CriticalSectionWrapper> capture_cs_;
@@ -163,11 +168,17 @@ class ViECapturer
   scoped_ptr<CriticalSectionWrapper> incoming_frame_cs_;
   I420VideoFrame incoming_frame_;
 
-  // Capture thread.
-  ThreadWrapper& capture_thread_;
+  // Capture thread, only used when frames are not delivered directly on the
+  // capturing thread.
+  const bool direct_delivery_;
+  scoped_ptr<ThreadWrapper> capture_thread_;
   EventWrapper& capture_event_;
   EventWrapper& deliver_event_;
 
+  // Set while a capturing thread delivers frames in direct delivery mode.
+  bool delivering_ GUARDED_BY(capture_cs_);
+  uint32_t num_dropped_frames_ GUARDED_BY(capture_cs_);
+
   scoped_ptr<I420VideoFrame> captured_frame_;
   scoped_ptr<I420VideoFrame> deliver_frame_;
 
@@ -19,6 +19,7 @@
 #include "webrtc/common.h"
 #include "webrtc/common_video/interface/native_handle.h"
 #include "webrtc/common_video/interface/texture_video_frame.h"
+#include "webrtc/experiments.h"
 #include "webrtc/modules/utility/interface/mock/mock_process_thread.h"
 #include "webrtc/modules/video_capture/include/mock/mock_video_capture.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
@@ -195,6 +196,34 @@ TEST_F(ViECapturerTest, TestTextureFrameAfterI420Frame) {
   EXPECT_TRUE(EqualFramesVector(input_frames_, output_frames_));
 }
 
+TEST_F(ViECapturerTest, TestDirectDeliveryOnCapturingThread) {
+  // Replace the default capturer with one delivering frames directly.
+  vie_capturer_.reset();
+  Config config;
+  config.Set<DirectCaptureDelivery>(new DirectCaptureDelivery(true));
+  vie_capturer_.reset(
+      ViECapturer::CreateViECapture(
+          0, 0, config, mock_capture_module_.get(), *mock_process_thread_));
+  vie_capturer_->RegisterFrameCallback(0, mock_frame_callback_.get());
+
+  const int kNumFrame = 3;
+  ScopedVector<I420VideoFrame> copied_input_frames;
+  std::vector<uint8_t*> ybuffer_pointers;
+  for (int i = 0; i < kNumFrame; ++i) {
+    input_frames_.push_back(CreateI420VideoFrame(static_cast<uint8_t>(i + 1)));
+    ybuffer_pointers.push_back(input_frames_[i]->buffer(kYPlane));
+    copied_input_frames.push_back(input_frames_[i]->CloneFrame());
+    AddInputFrame(input_frames_[i]);
+    // The frame has been delivered before the capture callback returns.
+    EXPECT_EQ(static_cast<size_t>(i + 1), output_frames_.size());
+  }
+
+  EXPECT_TRUE(EqualFramesVector(copied_input_frames, output_frames_));
+  // Make sure the buffer is swapped and not copied.
+  for (int i = 0; i < kNumFrame; ++i)
+    EXPECT_EQ(ybuffer_pointers[i], output_frame_ybuffers_[i]);
+}
+
 bool EqualFrames(const I420VideoFrame& frame1,
                  const I420VideoFrame& frame2) {
   if (frame1.native_handle() != NULL || frame2.native_handle() != NULL)
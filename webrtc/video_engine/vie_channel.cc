@@ -123,7 +123,10 @@ ViEChannel::ViEChannel(int32_t channel_id,
       callback_cs_(CriticalSectionWrapper::CreateCriticalSection()),
       rtp_rtcp_cs_(CriticalSectionWrapper::CreateCriticalSection()),
       default_rtp_rtcp_(default_rtp_rtcp),
-      vcm_(VideoCodingModule::Create()),
+      vcm_(config.Get<ReceiveFramePayloadPool>().pool != NULL ?
+               VideoCodingModule::Create(
+                   config.Get<ReceiveFramePayloadPool>().pool) :
+               VideoCodingModule::Create()),
       vie_receiver_(channel_id, vcm_, remote_bitrate_estimator, this),
       vie_sender_(channel_id),
       vie_sync_(vcm_, this),
@@ -585,6 +585,17 @@ int ViECodecImpl::StopDebugRecording(int video_channel) {
   return vie_encoder->StopDebugRecording();
 }
 
+int ViECodecImpl::WriteEncodePipelineTimings(int video_channel,
+                                             const char* file_name_utf8) {
+  LOG(LS_INFO) << "WriteEncodePipelineTimings for channel " << video_channel;
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEEncoder* vie_encoder = cs.Encoder(video_channel);
+  if (!vie_encoder) {
+    return -1;
+  }
+  return vie_encoder->WriteEncodePipelineTimings(file_name_utf8);
+}
+
 void ViECodecImpl::SuspendBelowMinBitrate(int video_channel) {
   LOG(LS_INFO) << "SuspendBelowMinBitrate for channel " << video_channel;
   ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
@@ -14,8 +14,10 @@
 
 #include <algorithm>
 
+#include "webrtc/common.h"
 #include "webrtc/common_video/interface/video_image.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/experiments.h"
 #include "webrtc/frame_callback.h"
 #include "webrtc/modules/pacing/include/paced_sender.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp.h"
@@ -26,11 +28,15 @@
 #include "webrtc/modules/video_coding/main/source/encoded_frame.h"
 #include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
 #include "webrtc/system_wrappers/interface/metrics.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 #include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/system_wrappers/interface/trace_event.h"
 #include "webrtc/video/send_statistics_proxy.h"
+#include "webrtc/video_engine/encode_pipeline_tracer.h"
+#include "webrtc/video_engine/encode_queue.h"
 #include "webrtc/video_engine/include/vie_codec.h"
 #include "webrtc/video_engine/include/vie_image_process.h"
 #include "webrtc/video_engine/vie_defines.h"
@@ -52,6 +58,10 @@ static const int kTransmissionMaxBitrateMultiplier = 2;
 
 static const float kStopPaddingThresholdMs = 2000;
 
+// Max time the encode thread waits for a frame before checking if it should
+// stop.
+static const int kEncodeThreadMaxWaitMs = 100;
+
 std::vector<uint32_t> AllocateStreamBitrates(
     uint32_t total_bitrate,
     const SimulcastStream* stream_configs,
@@ -139,6 +149,9 @@ ViEEncoder::ViEEncoder(int32_t engine_id,
                                                             channel_id))),
     callback_cs_(CriticalSectionWrapper::CreateCriticalSection()),
     data_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+    pipeline_tracer_(config.Get<EncodePipelineTracing>().enabled ?
+                     new EncodePipelineTracer(Clock::GetRealTimeClock()) :
+                     NULL),
     bitrate_controller_(bitrate_controller),
     time_of_last_incoming_frame_ms_(0),
     send_padding_(false),
@@ -174,6 +187,21 @@ ViEEncoder::ViEEncoder(int32_t engine_id,
       kDefaultStartBitrateKbps,
       PacedSender::kDefaultPaceMultiplier * kDefaultStartBitrateKbps,
       0));
+
+  const QueuedEncoding& queued_encoding = config.Get<QueuedEncoding>();
+  if (queued_encoding.enabled) {
+    encode_queue_.reset(new EncodeQueue(Clock::GetRealTimeClock(),
+                                        queued_encoding.max_queued_frames,
+                                        queued_encoding.drop_policy));
+    encode_event_.reset(EventWrapper::Create());
+    encode_thread_.reset(ThreadWrapper::CreateThread(EncodeThreadFunction,
+                                                     this, kHighPriority,
+                                                     "ViEEncodeThread"));
+    unsigned int t_id = 0;
+    if (!encode_thread_->Start(t_id)) {
+      assert(false);
+    }
+  }
 }
 
 bool ViEEncoder::Init() {
@@ -229,6 +257,13 @@ bool ViEEncoder::Init() {
 }
 
 ViEEncoder::~ViEEncoder() {
+  if (encode_thread_) {
+    encode_thread_->SetNotAlive();
+    encode_event_->Set();
+    if (!encode_thread_->Stop()) {
+      assert(false);
+    }
+  }
   UpdateHistograms();
   if (bitrate_controller_) {
     bitrate_controller_->RemoveBitrateObserver(bitrate_observer_.get());
@@ -258,6 +293,17 @@ void ViEEncoder::UpdateHistograms() {
         static_cast<int>(
             (frames.numKeyFrames * 1000.0f / total_frames) + 0.5f));
   }
+  if (encode_queue_) {
+    EncodeQueue::Statistics stats;
+    encode_queue_->GetStatistics(&stats);
+    if (stats.num_inserted_frames > 0) {
+      RTC_HISTOGRAM_COUNTS_1000("WebRTC.Video.EncodeQueueDelayInMs",
+                                stats.avg_queue_delay_ms);
+      RTC_HISTOGRAM_PERCENTAGE(
+          "WebRTC.Video.EncodeQueueDroppedFramesInPercent",
+          stats.num_dropped_frames * 100 / stats.num_inserted_frames);
+    }
+  }
 }
 
 int ViEEncoder::Owner() const {
@@ -440,8 +486,13 @@ bool ViEEncoder::TimeToSendPacket(uint32_t ssrc,
                                   uint16_t sequence_number,
                                   int64_t capture_time_ms,
                                   bool retransmission) {
-  return default_rtp_rtcp_->TimeToSendPacket(ssrc, sequence_number,
-                                             capture_time_ms, retransmission);
+  bool sent = default_rtp_rtcp_->TimeToSendPacket(ssrc, sequence_number,
+                                                 capture_time_ms,
+                                                 retransmission);
+  if (sent && !retransmission && pipeline_tracer_)
+    pipeline_tracer_->OnFrameStage(capture_time_ms,
+                                   EncodePipelineTracer::kSent);
+  return sent;
 }
 
 size_t ViEEncoder::TimeToSendPadding(size_t bytes) {
@@ -516,6 +567,11 @@ void ViEEncoder::DeliverFrame(int id,
     }
     TraceFrameDropEnd();
   }
+  if (pipeline_tracer_) {
+    pipeline_tracer_->FrameCaptured(video_frame->render_time_ms());
+    pipeline_tracer_->OnFrameStage(video_frame->render_time_ms(),
+                                   EncodePipelineTracer::kDelivered);
+  }
 
   // Convert render time, in ms, to RTP timestamp.
   const int kMsToRtpTimestamp = 90;
@@ -540,6 +596,16 @@ void ViEEncoder::DeliverFrame(int id,
     default_rtp_rtcp_->SetCsrcs(temp_csrcs);
   }
 
+  // Texture frames are not copied into the queue.
+  if (encode_queue_ && video_frame->native_handle() == NULL) {
+    if (encode_queue_->InsertFrame(*video_frame))
+      encode_event_->Set();
+    return;
+  }
+  EncodeFrame(video_frame);
+}
+
+void ViEEncoder::EncodeFrame(I420VideoFrame* video_frame) {
   I420VideoFrame* decimated_frame = NULL;
   // TODO(wuchengli): support texture frames.
   if (video_frame->native_handle() == NULL) {
@@ -568,6 +634,10 @@ void ViEEncoder::DeliverFrame(int id,
     if (ret != VPM_OK) {
       return;
     }
+    if (pipeline_tracer_) {
+      pipeline_tracer_->OnFrameStage(video_frame->render_time_ms(),
+                                     EncodePipelineTracer::kPreprocessed);
+    }
   }
   // If the frame was not resampled or scaled => use original.
   if (decimated_frame == NULL)  {
@@ -603,14 +673,36 @@ void ViEEncoder::DeliverFrame(int id,
       has_received_rpsi_ = false;
     }
 
+    if (pipeline_tracer_) {
+      pipeline_tracer_->OnFrameStage(video_frame->render_time_ms(),
+                                     EncodePipelineTracer::kEncodeStarted);
+    }
     vcm_.AddVideoFrame(*decimated_frame, vpm_.ContentMetrics(),
                        &codec_specific_info);
     return;
   }
 #endif
+  if (pipeline_tracer_) {
+    pipeline_tracer_->OnFrameStage(video_frame->render_time_ms(),
+                                   EncodePipelineTracer::kEncodeStarted);
+  }
   vcm_.AddVideoFrame(*decimated_frame);
 }
 
+bool ViEEncoder::EncodeThreadFunction(void* obj) {
+  return static_cast<ViEEncoder*>(obj)->EncodeThreadProcess();
+}
+
+bool ViEEncoder::EncodeThreadProcess() {
+  encode_event_->Wait(kEncodeThreadMaxWaitMs);
+  I420VideoFrame* video_frame = NULL;
+  while ((video_frame = encode_queue_->NextFrame()) != NULL) {
+    EncodeFrame(video_frame);
+    encode_queue_->ReturnFrame(video_frame);
+  }
+  return true;
+}
+
 void ViEEncoder::DelayChanged(int id, int frame_delay) {
   default_rtp_rtcp_->SetCameraDelay(frame_delay);
 }
@@ -631,6 +723,8 @@ int ViEEncoder::GetPreferedFrameSettings(int* width,
 }
 
 int ViEEncoder::SendKeyFrame() {
+  if (encode_queue_)
+    encode_queue_->OnKeyFrameRequest();
   return vcm_.IntraFrameRequest(0);
 }
 
@@ -733,12 +827,26 @@ int32_t ViEEncoder::SendData(
   if (send_statistics_proxy_ != NULL) {
     send_statistics_proxy_->OnSendEncodedImage(encoded_image, rtp_video_hdr);
   }
+  if (pipeline_tracer_) {
+    pipeline_tracer_->OnFrameStage(encoded_image.capture_time_ms_,
+                                   EncodePipelineTracer::kEncoded);
+  }
   // New encoded data, hand over to the rtp module.
-  return default_rtp_rtcp_->SendOutgoingData(
+  int32_t ret = default_rtp_rtcp_->SendOutgoingData(
       VCMEncodedFrame::ConvertFrameType(encoded_image._frameType), payload_type,
       encoded_image._timeStamp, encoded_image.capture_time_ms_,
       encoded_image._buffer, encoded_image._length, &fragmentation_header,
       rtp_video_hdr);
+  if (pipeline_tracer_) {
+    pipeline_tracer_->OnFrameStage(encoded_image.capture_time_ms_,
+                                   EncodePipelineTracer::kPacketized);
+    if (!paced_sender_->Enabled()) {
+      // Without pacing the packets have been sent by SendOutgoingData().
+      pipeline_tracer_->OnFrameStage(encoded_image.capture_time_ms_,
+                                     EncodePipelineTracer::kSent);
+    }
+  }
+  return ret;
 }
 
 int32_t ViEEncoder::ProtectionRequest(
@@ -813,6 +921,8 @@ void ViEEncoder::OnReceivedIntraFrameRequest(uint32_t ssrc) {
     idx = stream_it->second;
   }
   // Release the critsect before triggering key frame.
+  if (encode_queue_)
+    encode_queue_->OnKeyFrameRequest();
   vcm_.IntraFrameRequest(idx);
 }
 
@@ -960,6 +1070,21 @@ int ViEEncoder::StopDebugRecording() {
   return vcm_.StopDebugRecording();
 }
 
+int ViEEncoder::WriteEncodePipelineTimings(const char* fileNameUTF8) {
+  if (!pipeline_tracer_) {
+    LOG_F(LS_ERROR) << "Encode pipeline tracing is not enabled.";
+    return -1;
+  }
+  FILE* file = fopen(fileNameUTF8, "w");
+  if (file == NULL) {
+    LOG_F(LS_ERROR) << "Could not open " << fileNameUTF8;
+    return -1;
+  }
+  pipeline_tracer_->WriteCompletedFrames(file);
+  fclose(file);
+  return 0;
+}
+
 void ViEEncoder::SuspendBelowMinBitrate() {
   vcm_.SuspendBelowMinBitrate();
   bitrate_controller_->EnforceMinBitrate(false);
@@ -31,11 +31,15 @@ namespace webrtc {
 class Config;
 class CriticalSectionWrapper;
 class EncodedImageCallback;
+class EncodePipelineTracer;
+class EncodeQueue;
+class EventWrapper;
 class PacedSender;
 class ProcessThread;
 class QMVideoSettingsCallback;
 class RtpRtcp;
 class SendStatisticsProxy;
+class ThreadWrapper;
 class ViEBitrateObserver;
 class ViEEffectFilter;
 class ViEEncoderObserver;
@@ -161,6 +165,11 @@ class ViEEncoder
   // Disables recording of debugging information.
   int StopDebugRecording();
 
+  // Writes the per-stage timings of recently sent frames to |fileNameUTF8|,
+  // see EncodePipelineTracer::WriteCompletedFrames. Fails unless tracing was
+  // enabled with the EncodePipelineTracing config option.
+  int WriteEncodePipelineTimings(const char* fileNameUTF8);
+
   // Lets the sender suspend video when the rate drops below
   // |threshold_bps|, and turns back on when the rate goes back up above
   // |threshold_bps| + |window_bps|.
@@ -188,6 +197,13 @@ class ViEEncoder
                         int64_t capture_time_ms, bool retransmission);
   size_t TimeToSendPadding(size_t bytes);
  private:
+  // Preprocesses and encodes |video_frame|, either directly from DeliverFrame
+  // or from the encode thread when frames are queued.
+  void EncodeFrame(I420VideoFrame* video_frame);
+
+  static bool EncodeThreadFunction(void* obj);
+  bool EncodeThreadProcess();
+
   bool EncoderPaused() const EXCLUSIVE_LOCKS_REQUIRED(data_cs_);
   void TraceFrameDropStart() EXCLUSIVE_LOCKS_REQUIRED(data_cs_);
   void TraceFrameDropEnd() EXCLUSIVE_LOCKS_REQUIRED(data_cs_);
@@ -206,6 +222,13 @@ class ViEEncoder
   scoped_ptr<BitrateObserver> bitrate_observer_;
   scoped_ptr<PacedSender> paced_sender_;
   scoped_ptr<ViEPacedSenderCallback> pacing_callback_;
+  // NULL unless tracing is enabled.
+  const scoped_ptr<EncodePipelineTracer> pipeline_tracer_;
+  // Only used when frames are encoded on a separate thread, see
+  // QueuedEncoding.
+  scoped_ptr<EncodeQueue> encode_queue_;
+  scoped_ptr<EventWrapper> encode_event_;
+  scoped_ptr<ThreadWrapper> encode_thread_;
 
   BitrateController* bitrate_controller_;
 
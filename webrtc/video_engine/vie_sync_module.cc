@@ -41,8 +41,8 @@ int UpdateMeasurements(StreamSynchronization::Measurements* stream,
   }
 
   bool new_rtcp_sr = false;
-  if (!UpdateRtcpList(
-      ntp_secs, ntp_frac, rtp_timestamp, &stream->rtcp, &new_rtcp_sr)) {
+  if (!stream->rtp_to_ntp.UpdateMeasurements(
+      ntp_secs, ntp_frac, rtp_timestamp, &new_rtcp_sr)) {
     return -1;
   }
 
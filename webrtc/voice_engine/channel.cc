@@ -122,6 +122,57 @@ Channel::SendData(FrameType frameType,
                  frameType, payloadType, timeStamp,
                  payloadSize, fragmentation);
 
+    if (sharing_channels_ != NULL)
+    {
+        // Failures are reported by each channel; they don't affect the
+        // channels sending the same payload.
+        for (size_t i = 0; i < sharing_channels_->size(); ++i)
+        {
+            (*sharing_channels_)[i]->SendEncodedData(_channelId, frameType,
+                                                     payloadType, timeStamp,
+                                                     payloadData, payloadSize,
+                                                     fragmentation);
+        }
+    }
+
+    return SendEncodedData(_channelId, frameType, payloadType, timeStamp,
+                           payloadData, payloadSize, fragmentation);
+}
+
+int32_t
+Channel::SendEncodedData(int encoder_channel_id,
+                         FrameType frameType,
+                         uint8_t payloadType,
+                         uint32_t timeStamp,
+                         const uint8_t* payloadData,
+                         size_t payloadSize,
+                         const RTPFragmentationHeader* fragmentation)
+{
+    if (encoder_channel_id != last_encoder_channel_id_)
+    {
+        if (last_encoder_channel_id_ != -1)
+        {
+            // The timestamps of each encoder have their own origin. Continue
+            // from the last payload sent, advanced by the audio this channel
+            // has input since then. That includes DTX gaps and audio buffered
+            // by the encoders, which both see the same input.
+            CodecInst codec;
+            if (audio_coding_->SendCodec(&codec) == 0 &&
+                _audioFrame->sample_rate_hz_ > 0)
+            {
+                const int64_t elapsed_input_samples =
+                    _timeStamp - _lastLocalInputTimeStamp;
+                const uint32_t elapsed_samples = static_cast<uint32_t>(
+                    elapsed_input_samples * codec.plfreq /
+                    _audioFrame->sample_rate_hz_);
+                encoder_timestamp_offset_ =
+                    _lastLocalTimeStamp + elapsed_samples - timeStamp;
+            }
+        }
+        last_encoder_channel_id_ = encoder_channel_id;
+    }
+    timeStamp += encoder_timestamp_offset_;
+
     if (_includeAudioLevelIndication)
     {
         // Store current audio level in the RTP/RTCP module.
@@ -151,6 +202,7 @@ Channel::SendData(FrameType frameType,
     }
 
     _lastLocalTimeStamp = timeStamp;
+    _lastLocalInputTimeStamp = _timeStamp;
     _lastPayloadType = payloadType;
 
     return 0;
@@ -165,6 +217,15 @@ Channel::InFrameType(int16_t frameType)
     CriticalSectionScoped cs(&_callbackCritSect);
     // 1 indicates speech
     _sendFrameType = (frameType == 1) ? 1 : 0;
+    if (sharing_channels_ != NULL)
+    {
+        for (size_t i = 0; i < sharing_channels_->size(); ++i)
+        {
+            Channel* channel = (*sharing_channels_)[i];
+            CriticalSectionScoped cs_sharing(&channel->_callbackCritSect);
+            channel->_sendFrameType = _sendFrameType;
+        }
+    }
     return 0;
 }
 
@@ -726,6 +787,8 @@ Channel::Channel(int32_t channelId,
     _rtpDumpOut(*RtpDump::CreateRtpDump()),
     _outputAudioLevel(),
     _externalTransport(false),
+    audio_frame_pool_(AudioFramePool::Create()),
+    _audioFrame(audio_frame_pool_),
     _inputFilePlayerPtr(NULL),
     _outputFilePlayerPtr(NULL),
     _outputFileRecorderPtr(NULL),
@@ -742,6 +805,13 @@ Channel::Channel(int32_t channelId,
     _outputExternalMediaCallbackPtr(NULL),
     _timeStamp(0), // This is just an offset, RTP module will add it's own random offset
     _sendTelephoneEventPayloadType(106),
+    encoder_input_is_private_(false),
+    sharing_channels_(NULL),
+    last_encoder_channel_id_(-1),
+    encoder_timestamp_offset_(0),
+    send_cn_payload_type_16khz_(-1),
+    send_cn_payload_type_32khz_(-1),
+    opus_max_playback_rate_hz_(0),
     ntp_estimator_(Clock::GetRealTimeClock()),
     jitter_buffer_playout_timestamp_(0),
     playout_timestamp_rtp_(0),
@@ -773,6 +843,7 @@ Channel::Channel(int32_t channelId,
     _playOutbandDtmfEvent(false),
     _playInbandDtmfEvent(false),
     _lastLocalTimeStamp(0),
+    _lastLocalInputTimeStamp(0),
     _lastPayloadType(0),
     _includeAudioLevelIndication(false),
     _outputSpeechType(AudioFrame::kNormalSpeech),
@@ -1097,7 +1168,7 @@ int32_t
 Channel::UpdateLocalTimeStamp()
 {
 
-    _timeStamp += _audioFrame.samples_per_channel_;
+    _timeStamp += _audioFrame->samples_per_channel_;
     return 0;
 }
 
@@ -1547,6 +1618,10 @@ Channel::SetSendCNPayloadType(int type, PayloadFrequencies frequency)
             return -1;
         }
     }
+    if (frequency == kFreq32000Hz)
+        send_cn_payload_type_32khz_ = type;
+    else
+        send_cn_payload_type_16khz_ = type;
     return 0;
 }
 
@@ -1560,6 +1635,7 @@ int Channel::SetOpusMaxPlaybackRate(int frequency_hz) {
         "SetOpusMaxPlaybackRate() failed to set maximum playback rate");
     return -1;
   }
+  opus_max_playback_rate_hz_ = frequency_hz;
   return 0;
 }
 
@@ -3461,12 +3537,13 @@ void Channel::SetVideoEngineBWETarget(ViENetwork* vie_network,
 }
 
 uint32_t
-Channel::Demultiplex(const AudioFrame& audioFrame)
+Channel::Demultiplex(const AudioFrameRef& audioFrame)
 {
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::Demultiplex()");
-    _audioFrame.CopyFrom(audioFrame);
-    _audioFrame.id_ = _channelId;
+    // The frame is shared with the transmit mixer and the other channels
+    // until it is modified.
+    _audioFrame = audioFrame;
     return 0;
 }
 
@@ -3489,7 +3566,7 @@ void Channel::Demultiplex(const int16_t* audio_data,
                            codec.plfreq,
                            mono_recording_audio_.get(),
                            &input_resampler_,
-                           &_audioFrame);
+                           _audioFrame.frame_for_overwrite());
 }
 
 uint32_t
@@ -3498,47 +3575,53 @@ Channel::PrepareEncodeAndSend(int mixingFrequency)
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::PrepareEncodeAndSend()");
 
-    if (_audioFrame.samples_per_channel_ == 0)
+    if (_audioFrame->samples_per_channel_ == 0)
     {
         WEBRTC_TRACE(kTraceWarning, kTraceVoice, VoEId(_instanceId,_channelId),
                      "Channel::PrepareEncodeAndSend() invalid audio frame");
         return 0xFFFFFFFF;
     }
 
+    encoder_input_is_private_ = false;
+
     if (channel_state_.Get().input_file_playing)
     {
         MixOrReplaceAudioWithFile(mixingFrequency);
+        encoder_input_is_private_ = true;
     }
 
     bool is_muted = Mute();  // Cache locally as Mute() takes a lock.
     if (is_muted) {
-      AudioFrameOperations::Mute(_audioFrame);
+      AudioFrameOperations::Mute(*_audioFrame.mutable_frame());
     }
 
     if (channel_state_.Get().input_external_media)
     {
         CriticalSectionScoped cs(&_callbackCritSect);
-        const bool isStereo = (_audioFrame.num_channels_ == 2);
+        const bool isStereo = (_audioFrame->num_channels_ == 2);
         if (_inputExternalMediaCallbackPtr)
         {
+            AudioFrame* frame = _audioFrame.mutable_frame();
             _inputExternalMediaCallbackPtr->Process(
                 _channelId,
                 kRecordingPerChannel,
-               (int16_t*)_audioFrame.data_,
-                _audioFrame.samples_per_channel_,
-                _audioFrame.sample_rate_hz_,
+                frame->data_,
+                frame->samples_per_channel_,
+                frame->sample_rate_hz_,
                 isStereo);
+            encoder_input_is_private_ = true;
         }
     }
 
     InsertInbandDtmfTone();
 
     if (_includeAudioLevelIndication) {
-      int length = _audioFrame.samples_per_channel_ * _audioFrame.num_channels_;
+      int length = _audioFrame->samples_per_channel_ *
+          _audioFrame->num_channels_;
       if (is_muted) {
         rms_level_.ProcessMuted(length);
       } else {
-        rms_level_.Process(_audioFrame.data_, length);
+        rms_level_.Process(_audioFrame->data_, length);
       }
     }
 
@@ -3551,28 +3634,31 @@ Channel::EncodeAndSend()
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::EncodeAndSend()");
 
-    assert(_audioFrame.num_channels_ <= 2);
-    if (_audioFrame.samples_per_channel_ == 0)
+    assert(_audioFrame->num_channels_ <= 2);
+    if (_audioFrame->samples_per_channel_ == 0)
     {
         WEBRTC_TRACE(kTraceWarning, kTraceVoice, VoEId(_instanceId,_channelId),
                      "Channel::EncodeAndSend() invalid audio frame");
         return 0xFFFFFFFF;
     }
 
-    _audioFrame.id_ = _channelId;
+    // Setting the id and timestamp copies a shared frame. This happens once
+    // per encoder, since channels sharing an encoder don't get here.
+    AudioFrame* frame = _audioFrame.mutable_frame();
+    frame->id_ = _channelId;
 
     // --- Add 10ms of raw (PCM) audio data to the encoder @ 32kHz.
 
     // The ACM resamples internally.
-    _audioFrame.timestamp_ = _timeStamp;
-    if (audio_coding_->Add10MsData((AudioFrame&)_audioFrame) != 0)
+    frame->timestamp_ = _timeStamp;
+    if (audio_coding_->Add10MsData(*frame) != 0)
     {
         WEBRTC_TRACE(kTraceError, kTraceVoice, VoEId(_instanceId,_channelId),
                      "Channel::EncodeAndSend() ACM encoding failed");
         return 0xFFFFFFFF;
     }
 
-    _timeStamp += _audioFrame.samples_per_channel_;
+    _timeStamp += frame->samples_per_channel_;
 
     // --- Encode if complete frame is ready
 
@@ -3581,6 +3667,49 @@ Channel::EncodeAndSend()
     return audio_coding_->Process();
 }
 
+bool Channel::GetSharedEncoderConfig(SharedEncoderConfig* config) {
+  if (encoder_input_is_private_ || _audioFrame->samples_per_channel_ == 0)
+    return false;
+  // The encoder adapts its FEC to the packet loss of this channel.
+  if (audio_coding_->CodecFEC())
+    return false;
+  CodecInst secondary_codec;
+  if (audio_coding_->SecondarySendCodec(&secondary_codec) == 0)
+    return false;
+  if (audio_coding_->SendCodec(&config->codec) != 0 ||
+      audio_coding_->VAD(&config->dtx_enabled, &config->vad_enabled,
+                         &config->vad_mode) != 0) {
+    return false;
+  }
+  config->red_payload_type = -1;
+  if (audio_coding_->REDStatus()) {
+    int8_t red_payload_type = 0;
+    if (_rtpRtcpModule->SendREDPayloadType(red_payload_type) != 0)
+      return false;
+    config->red_payload_type = red_payload_type;
+  }
+  config->cn_payload_type_16khz = send_cn_payload_type_16khz_;
+  config->cn_payload_type_32khz = send_cn_payload_type_32khz_;
+  config->opus_max_playback_rate_hz = opus_max_playback_rate_hz_;
+  config->muted = Mute();
+  return true;
+}
+
+uint32_t Channel::EncodeAndSendShared(
+    const std::vector<Channel*>& sharing_channels) {
+  for (size_t i = 0; i < sharing_channels.size(); ++i) {
+    Channel* channel = sharing_channels[i];
+    assert(channel != this);
+    // Keep the input timestamps going, in case the channel encodes on its own
+    // later.
+    channel->_timeStamp += channel->_audioFrame->samples_per_channel_;
+  }
+  sharing_channels_ = &sharing_channels;
+  uint32_t ret = EncodeAndSend();
+  sharing_channels_ = NULL;
+  return ret;
+}
+
 int Channel::RegisterExternalMediaProcessing(
     ProcessingTypes type,
     VoEMediaProcess& processObject)
@@ -3897,14 +4026,15 @@ Channel::MixOrReplaceAudioWithFile(int mixingFrequency)
         }
     }
 
-    assert(_audioFrame.samples_per_channel_ == fileSamples);
+    AudioFrame* frame = _audioFrame.mutable_frame();
+    assert(frame->samples_per_channel_ == fileSamples);
 
     if (_mixFileWithMicrophone)
     {
         // Currently file stream is always mono.
         // TODO(xians): Change the code when FilePlayer supports real stereo.
-        MixWithSat(_audioFrame.data_,
-                   _audioFrame.num_channels_,
+        MixWithSat(frame->data_,
+                   frame->num_channels_,
                    fileBuffer.get(),
                    1,
                    fileSamples);
@@ -3914,14 +4044,14 @@ Channel::MixOrReplaceAudioWithFile(int mixingFrequency)
         // Replace ACM audio with file.
         // Currently file stream is always mono.
         // TODO(xians): Change the code when FilePlayer supports real stereo.
-        _audioFrame.UpdateFrame(_channelId,
-                                0xFFFFFFFF,
-                                fileBuffer.get(),
-                                fileSamples,
-                                mixingFrequency,
-                                AudioFrame::kNormalSpeech,
-                                AudioFrame::kVadUnknown,
-                                1);
+        frame->UpdateFrame(_channelId,
+                           0xFFFFFFFF,
+                           fileBuffer.get(),
+                           fileSamples,
+                           mixingFrequency,
+                           AudioFrame::kNormalSpeech,
+                           AudioFrame::kVadUnknown,
+                           1);
 
     }
     return 0;
@@ -4010,12 +4140,12 @@ Channel::InsertInbandDtmfTone()
         uint16_t frequency(0);
         _inbandDtmfGenerator.GetSampleRate(frequency);
 
-        if (frequency != _audioFrame.sample_rate_hz_)
+        if (frequency != _audioFrame->sample_rate_hz_)
         {
             // Update sample rate of Dtmf tone since the mixing frequency
             // has changed.
             _inbandDtmfGenerator.SetSampleRate(
-                (uint16_t) (_audioFrame.sample_rate_hz_));
+                (uint16_t) (_audioFrame->sample_rate_hz_));
             // Reset the tone to be added taking the new sample rate into
             // account.
             _inbandDtmfGenerator.ResetTone();
@@ -4033,20 +4163,22 @@ Channel::InsertInbandDtmfTone()
         }
 
         // Replace mixed audio with DTMF tone.
+        encoder_input_is_private_ = true;
+        AudioFrame* frame = _audioFrame.mutable_frame();
         for (int sample = 0;
-            sample < _audioFrame.samples_per_channel_;
+            sample < frame->samples_per_channel_;
             sample++)
         {
             for (int channel = 0;
-                channel < _audioFrame.num_channels_;
+                channel < frame->num_channels_;
                 channel++)
             {
-                const int index = sample * _audioFrame.num_channels_ + channel;
-                _audioFrame.data_[index] = toneBuffer[sample];
+                const int index = sample * frame->num_channels_ + channel;
+                frame->data_[index] = toneBuffer[sample];
             }
         }
 
-        assert(_audioFrame.samples_per_channel_ == toneSamples);
+        assert(frame->samples_per_channel_ == toneSamples);
     } else
     {
         // Add 10ms to "delay-since-last-tone" counter
@@ -20,9 +20,11 @@
 #include "webrtc/modules/rtp_rtcp/interface/remote_ntp_time_estimator.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp.h"
+#include "webrtc/modules/utility/interface/audio_frame_pool.h"
 #include "webrtc/modules/utility/interface/file_player.h"
 #include "webrtc/modules/utility/interface/file_recorder.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_refptr.h"
 #include "webrtc/voice_engine/dtmf_inband.h"
 #include "webrtc/voice_engine/dtmf_inband_queue.h"
 #include "webrtc/voice_engine/include/voe_audio_processing.h"
@@ -443,7 +445,13 @@ public:
     {
         return _outputAudioLevel.Level();
     }
-    uint32_t Demultiplex(const AudioFrame& audioFrame);
+    // The pool of the frames this channel writes to.
+    const AudioFramePool* audio_frame_pool() const
+    {
+        return audio_frame_pool_.get();
+    }
+    // Shares |audioFrame| with the transmit mixer until it is modified.
+    uint32_t Demultiplex(const AudioFrameRef& audioFrame);
     // Demultiplex the data to the channel's |_audioFrame|. The difference
     // between this method and the overloaded method above is that |audio_data|
     // does not go through transmit_mixer and APM.
@@ -454,6 +462,30 @@ public:
     uint32_t PrepareEncodeAndSend(int mixingFrequency);
     uint32_t EncodeAndSend();
 
+    // The send settings which, together with the audio frame prepared by
+    // PrepareEncodeAndSend(), determine the encoded payloads. Sending channels
+    // with equal configs can share one encoder.
+    struct SharedEncoderConfig {
+      CodecInst codec;
+      bool dtx_enabled;
+      bool vad_enabled;
+      ACMVADMode vad_mode;
+      int red_payload_type;  // -1 if RED is off.
+      int cn_payload_type_16khz;
+      int cn_payload_type_32khz;
+      int opus_max_playback_rate_hz;
+      bool muted;
+    };
+    // Returns false if this channel can't share its encoder, e.g. if its audio
+    // frame was altered by channel specific processing, or if its encoder
+    // adapts to the packet loss of this channel.
+    bool GetSharedEncoderConfig(SharedEncoderConfig* config);
+    // Same as EncodeAndSend(), but also sends the encoded payloads on
+    // |sharing_channels|, which don't encode on their own. They must have the
+    // same SharedEncoderConfig as this channel and have prepared the same
+    // audio frame.
+    uint32_t EncodeAndSendShared(const std::vector<Channel*>& sharing_channels);
+
     // From BitrateObserver (called by the RTP/RTCP module).
     void OnNetworkChanged(const uint32_t bitrate_bps,
                           const uint8_t fraction_lost,  // 0 - 255.
@@ -479,6 +511,15 @@ private:
     int SetRedPayloadType(int red_payload_type);
     int SetSendRtpHeaderExtension(bool enable, RTPExtensionType type,
                                   unsigned char id);
+    // Sends a payload encoded by the encoder of channel |encoder_channel_id|,
+    // which is either this channel or one it shares the encoder of.
+    int32_t SendEncodedData(int encoder_channel_id,
+                            FrameType frameType,
+                            uint8_t payloadType,
+                            uint32_t timeStamp,
+                            const uint8_t* payloadData,
+                            size_t payloadSize,
+                            const RTPFragmentationHeader* fragmentation);
 
     int32_t GetPlayoutFrequency();
     int GetRTT() const;
@@ -503,7 +544,10 @@ private:
     RtpDump& _rtpDumpOut;
     AudioLevel _outputAudioLevel;
     bool _externalTransport;
-    AudioFrame _audioFrame;
+    // Provides |_audioFrame|, and the copies made when the channel writes to
+    // a frame shared with the transmit mixer.
+    scoped_refptr<AudioFramePool> audio_frame_pool_;
+    AudioFrameRef _audioFrame;
     scoped_ptr<int16_t[]> mono_recording_audio_;
     // Downsamples to the codec rate if necessary.
     PushResampler<int16_t> input_resampler_;
@@ -521,6 +565,21 @@ private:
     VoEMediaProcess* _outputExternalMediaCallbackPtr;
     uint32_t _timeStamp;
     uint8_t _sendTelephoneEventPayloadType;
+    // Set by PrepareEncodeAndSend() if |_audioFrame| was altered by channel
+    // specific processing.
+    bool encoder_input_is_private_;
+    // Channels sending the payloads of this channel's encoder, only set
+    // within EncodeAndSendShared().
+    const std::vector<Channel*>* sharing_channels_;
+    // The channel whose encoder produced the last payload sent, and the offset
+    // added to its timestamps to keep the RTP timestamps continuous when
+    // switching between encoders.
+    int last_encoder_channel_id_;
+    uint32_t encoder_timestamp_offset_;
+    // Send settings the ACM has no getters for.
+    int send_cn_payload_type_16khz_;
+    int send_cn_payload_type_32khz_;
+    int opus_max_playback_rate_hz_;
 
     RemoteNtpTimeEstimator ntp_estimator_ GUARDED_BY(ts_stats_lock_);
 
@@ -569,6 +628,8 @@ private:
     bool _playInbandDtmfEvent;
     // VoeRTP_RTCP
     uint32_t _lastLocalTimeStamp;
+    // |_timeStamp| when |_lastLocalTimeStamp| was sent.
+    uint32_t _lastLocalInputTimeStamp;
     int8_t _lastPayloadType;
     bool _includeAudioLevelIndication;
     // VoENetwork
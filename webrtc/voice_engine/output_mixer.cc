@@ -250,6 +250,12 @@ OutputMixer::SetAnonymousMixabilityStatus(MixerParticipant& participant,
     return _mixerModule.SetAnonymousMixabilityStatus(participant,mixable);
 }
 
+int32_t
+OutputMixer::SetNumDecodeThreads(int numThreads)
+{
+    return _mixerModule.SetNumWorkerThreads(numThreads);
+}
+
 int32_t
 OutputMixer::MixActiveChannels()
 {
@@ -10,6 +10,7 @@
 
 #include "webrtc/voice_engine/shared_data.h"
 
+#include "webrtc/experiments.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
@@ -37,6 +38,8 @@ SharedData::SharedData(const Config& config) :
     if (OutputMixer::Create(_outputMixerPtr, _gInstanceCounter) == 0)
     {
         _outputMixerPtr->SetEngineInformation(_engineStatistics);
+        _outputMixerPtr->SetNumDecodeThreads(
+            config.Get<ParallelPlayoutDecoding>().num_threads);
     }
     if (TransmitMixer::Create(_transmitMixerPtr, _gInstanceCounter) == 0)
     {
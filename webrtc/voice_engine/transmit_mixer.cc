@@ -27,6 +27,28 @@
 namespace webrtc {
 namespace voe {
 
+namespace {
+
+bool SameEncoderConfig(const Channel::SharedEncoderConfig& a,
+                       const Channel::SharedEncoderConfig& b) {
+  return a.codec.pltype == b.codec.pltype &&
+      STR_CASE_CMP(a.codec.plname, b.codec.plname) == 0 &&
+      a.codec.plfreq == b.codec.plfreq &&
+      a.codec.pacsize == b.codec.pacsize &&
+      a.codec.channels == b.codec.channels &&
+      a.codec.rate == b.codec.rate &&
+      a.dtx_enabled == b.dtx_enabled &&
+      a.vad_enabled == b.vad_enabled &&
+      a.vad_mode == b.vad_mode &&
+      a.red_payload_type == b.red_payload_type &&
+      a.cn_payload_type_16khz == b.cn_payload_type_16khz &&
+      a.cn_payload_type_32khz == b.cn_payload_type_32khz &&
+      a.opus_max_playback_rate_hz == b.opus_max_playback_rate_hz &&
+      a.muted == b.muted;
+}
+
+}  // namespace
+
 // TODO(ajm): The thread safety of this is dubious...
 void
 TransmitMixer::OnPeriodicProcess()
@@ -175,6 +197,8 @@ TransmitMixer::TransmitMixer(uint32_t instanceId) :
     audioproc_(NULL),
     _voiceEngineObserverPtr(NULL),
     _processThreadPtr(NULL),
+    audio_frame_pool_(AudioFramePool::Create()),
+    _audioFrame(audio_frame_pool_),
     _filePlayerPtr(NULL),
     _fileRecorderPtr(NULL),
     _fileCallRecorderPtr(NULL),
@@ -341,11 +365,12 @@ TransmitMixer::PrepareDemux(const void* audioSamples,
     {
       CriticalSectionScoped cs(&_callbackCritSect);
       if (external_preproc_ptr_) {
+        AudioFrame* frame = _audioFrame.mutable_frame();
         external_preproc_ptr_->Process(-1, kRecordingPreprocessing,
-                                       _audioFrame.data_,
-                                       _audioFrame.samples_per_channel_,
-                                       _audioFrame.sample_rate_hz_,
-                                       _audioFrame.num_channels_ == 2);
+                                       frame->data_,
+                                       frame->samples_per_channel_,
+                                       frame->sample_rate_hz_,
+                                       frame->num_channels_ == 2);
       }
     }
 
@@ -354,7 +379,7 @@ TransmitMixer::PrepareDemux(const void* audioSamples,
 
     if (swap_stereo_channels_ && stereo_codec_)
       // Only bother swapping if we're using a stereo codec.
-      AudioFrameOperations::SwapStereoChannels(&_audioFrame);
+      AudioFrameOperations::SwapStereoChannels(_audioFrame.mutable_frame());
 
     // --- Annoying typing detection (utilizes the APM/VAD decision)
 #ifdef WEBRTC_VOICE_ENGINE_TYPING_DETECTION
@@ -364,7 +389,7 @@ TransmitMixer::PrepareDemux(const void* audioSamples,
     // --- Mute during DTMF tone if direct feedback is enabled
     if (_remainingMuteMicTimeMs > 0)
     {
-        AudioFrameOperations::Mute(_audioFrame);
+        AudioFrameOperations::Mute(*_audioFrame.mutable_frame());
         _remainingMuteMicTimeMs -= 10;
         if (_remainingMuteMicTimeMs < 0)
         {
@@ -375,13 +400,13 @@ TransmitMixer::PrepareDemux(const void* audioSamples,
     // --- Mute signal
     if (_mute)
     {
-        AudioFrameOperations::Mute(_audioFrame);
+        AudioFrameOperations::Mute(*_audioFrame.mutable_frame());
     }
 
     // --- Mix with file (does not affect the mixing frequency)
     if (_filePlaying)
     {
-        MixOrReplaceAudioWithFile(_audioFrame.sample_rate_hz_);
+        MixOrReplaceAudioWithFile(_audioFrame->sample_rate_hz_);
     }
 
     // --- Record to file
@@ -392,22 +417,23 @@ TransmitMixer::PrepareDemux(const void* audioSamples,
     }
     if (file_recording)
     {
-        RecordAudioToFile(_audioFrame.sample_rate_hz_);
+        RecordAudioToFile(_audioFrame->sample_rate_hz_);
     }
 
     {
       CriticalSectionScoped cs(&_callbackCritSect);
       if (external_postproc_ptr_) {
+        AudioFrame* frame = _audioFrame.mutable_frame();
         external_postproc_ptr_->Process(-1, kRecordingAllChannelsMixed,
-                                        _audioFrame.data_,
-                                        _audioFrame.samples_per_channel_,
-                                        _audioFrame.sample_rate_hz_,
-                                        _audioFrame.num_channels_ == 2);
+                                        frame->data_,
+                                        frame->samples_per_channel_,
+                                        frame->sample_rate_hz_,
+                                        frame->num_channels_ == 2);
       }
     }
 
     // --- Measure audio level of speech after all processing.
-    _audioLevel.ComputeLevel(_audioFrame);
+    _audioLevel.ComputeLevel(*_audioFrame);
     return 0;
 }
 
@@ -423,9 +449,10 @@ TransmitMixer::DemuxAndMix()
         Channel* channelPtr = it.GetChannel();
         if (channelPtr->Sending())
         {
-            // Demultiplex makes a copy of its input.
+            // Demultiplex shares the frame; it is copied only if the
+            // channel modifies it.
             channelPtr->Demultiplex(_audioFrame);
-            channelPtr->PrepareEncodeAndSend(_audioFrame.sample_rate_hz_);
+            channelPtr->PrepareEncodeAndSend(_audioFrame->sample_rate_hz_);
         }
     }
     return 0;
@@ -438,9 +465,10 @@ void TransmitMixer::DemuxAndMix(const int voe_channels[],
     voe::Channel* channel_ptr = ch.channel();
     if (channel_ptr) {
       if (channel_ptr->Sending()) {
-        // Demultiplex makes a copy of its input.
+        // Demultiplex shares the frame; it is copied only if the channel
+        // modifies it.
         channel_ptr->Demultiplex(_audioFrame);
-        channel_ptr->PrepareEncodeAndSend(_audioFrame.sample_rate_hz_);
+        channel_ptr->PrepareEncodeAndSend(_audioFrame->sample_rate_hz_);
       }
     }
   }
@@ -452,25 +480,63 @@ TransmitMixer::EncodeAndSend()
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::EncodeAndSend()");
 
-    for (ChannelManager::Iterator it(_channelManagerPtr); it.IsValid();
-         it.Increment())
+    // The iterator keeps the channels alive while encoding.
+    ChannelManager::Iterator it(_channelManagerPtr);
+    std::vector<Channel*> sending_channels;
+    for (; it.IsValid(); it.Increment())
     {
         Channel* channelPtr = it.GetChannel();
         if (channelPtr->Sending())
         {
-            channelPtr->EncodeAndSend();
+            sending_channels.push_back(channelPtr);
         }
     }
+    EncodeAndSendSharingEncoders(sending_channels);
     return 0;
 }
 
 void TransmitMixer::EncodeAndSend(const int voe_channels[],
                                   int number_of_voe_channels) {
+  // Keeps the channels alive while encoding.
+  std::vector<ChannelOwner> channel_owners;
+  std::vector<Channel*> sending_channels;
   for (int i = 0; i < number_of_voe_channels; ++i) {
     voe::ChannelOwner ch = _channelManagerPtr->GetChannel(voe_channels[i]);
     voe::Channel* channel_ptr = ch.channel();
-    if (channel_ptr && channel_ptr->Sending())
-      channel_ptr->EncodeAndSend();
+    if (channel_ptr && channel_ptr->Sending()) {
+      channel_owners.push_back(ch);
+      sending_channels.push_back(channel_ptr);
+    }
+  }
+  EncodeAndSendSharingEncoders(sending_channels);
+}
+
+void TransmitMixer::EncodeAndSendSharingEncoders(
+    const std::vector<Channel*>& channels) {
+  std::vector<Channel::SharedEncoderConfig> configs(channels.size());
+  std::vector<bool> can_share(channels.size());
+  for (size_t i = 0; i < channels.size(); ++i)
+    can_share[i] = channels[i]->GetSharedEncoderConfig(&configs[i]);
+
+  // Each channel that can share encodes for all later channels with the same
+  // config, which in turn don't encode. The common case of all channels
+  // sharing is linear in the number of channels.
+  std::vector<bool> encoded(channels.size(), false);
+  std::vector<Channel*> sharing_channels;
+  for (size_t i = 0; i < channels.size(); ++i) {
+    if (encoded[i])
+      continue;
+    sharing_channels.clear();
+    if (can_share[i]) {
+      for (size_t j = i + 1; j < channels.size(); ++j) {
+        if (!encoded[j] && can_share[j] &&
+            SameEncoderConfig(configs[i], configs[j])) {
+          sharing_channels.push_back(channels[j]);
+          encoded[j] = true;
+        }
+      }
+    }
+    channels[i]->EncodeAndSendShared(sharing_channels);
   }
 }
 
@@ -1165,7 +1231,7 @@ void TransmitMixer::GenerateAudioFrame(const int16_t* audio,
                            codec_rate,
                            mono_buffer_.get(),
                            &resampler_,
-                           &_audioFrame);
+                           _audioFrame.frame_for_overwrite());
 }
 
 int32_t TransmitMixer::RecordAudioToFile(
@@ -1180,7 +1246,7 @@ int32_t TransmitMixer::RecordAudioToFile(
         return -1;
     }
 
-    if (_fileRecorderPtr->RecordAudioToFile(_audioFrame) != 0)
+    if (_fileRecorderPtr->RecordAudioToFile(*_audioFrame) != 0)
     {
         WEBRTC_TRACE(kTraceWarning, kTraceVoice, VoEId(_instanceId, -1),
                      "TransmitMixer::RecordAudioToFile() file recording"
@@ -1219,14 +1285,15 @@ int32_t TransmitMixer::MixOrReplaceAudioWithFile(
         }
     }
 
-    assert(_audioFrame.samples_per_channel_ == fileSamples);
+    AudioFrame* frame = _audioFrame.mutable_frame();
+    assert(frame->samples_per_channel_ == fileSamples);
 
     if (_mixFileWithMicrophone)
     {
         // Currently file stream is always mono.
         // TODO(xians): Change the code when FilePlayer supports real stereo.
-        MixWithSat(_audioFrame.data_,
-                   _audioFrame.num_channels_,
+        MixWithSat(frame->data_,
+                   frame->num_channels_,
                    fileBuffer.get(),
                    1,
                    fileSamples);
@@ -1235,14 +1302,14 @@ int32_t TransmitMixer::MixOrReplaceAudioWithFile(
         // Replace ACM audio with file.
         // Currently file stream is always mono.
         // TODO(xians): Change the code when FilePlayer supports real stereo.
-        _audioFrame.UpdateFrame(-1,
-                                0xFFFFFFFF,
-                                fileBuffer.get(),
-                                fileSamples,
-                                mixingFrequency,
-                                AudioFrame::kNormalSpeech,
-                                AudioFrame::kVadUnknown,
-                                1);
+        frame->UpdateFrame(-1,
+                           0xFFFFFFFF,
+                           fileBuffer.get(),
+                           fileSamples,
+                           mixingFrequency,
+                           AudioFrame::kNormalSpeech,
+                           AudioFrame::kVadUnknown,
+                           1);
     }
     return 0;
 }
@@ -1269,7 +1336,7 @@ void TransmitMixer::ProcessAudio(int delay_ms, int clock_drift,
 
   audioproc_->set_stream_key_pressed(key_pressed);
 
-  int err = audioproc_->ProcessStream(&_audioFrame);
+  int err = audioproc_->ProcessStream(_audioFrame.mutable_frame());
   if (err != 0) {
     LOG(LS_ERROR) << "ProcessStream() error: " << err;
     assert(false);
@@ -1287,11 +1354,11 @@ void TransmitMixer::ProcessAudio(int delay_ms, int clock_drift,
 void TransmitMixer::TypingDetection(bool keyPressed)
 {
   // We let the VAD determine if we're using this feature or not.
-  if (_audioFrame.vad_activity_ == AudioFrame::kVadUnknown) {
+  if (_audioFrame->vad_activity_ == AudioFrame::kVadUnknown) {
     return;
   }
 
-  bool vadActive = _audioFrame.vad_activity_ == AudioFrame::kVadActive;
+  bool vadActive = _audioFrame->vad_activity_ == AudioFrame::kVadActive;
   if (_typingDetection.Process(keyPressed, vadActive)) {
     _typingNoiseWarningPending = true;
     _typingNoiseDetected = true;
@@ -1308,8 +1375,8 @@ void TransmitMixer::TypingDetection(bool keyPressed)
 
 int TransmitMixer::GetMixingFrequency()
 {
-    assert(_audioFrame.sample_rate_hz_ != 0);
-    return _audioFrame.sample_rate_hz_;
+    assert(_audioFrame->sample_rate_hz_ != 0);
+    return _audioFrame->sample_rate_hz_;
 }
 
 #ifdef WEBRTC_VOICE_ENGINE_TYPING_DETECTION
@@ -11,13 +11,17 @@
 #ifndef WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 #define WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 
+#include <vector>
+
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/audio_processing/typing_detection.h"
 #include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/modules/utility/interface/audio_frame_pool.h"
 #include "webrtc/modules/utility/interface/file_player.h"
 #include "webrtc/modules/utility/interface/file_recorder.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_refptr.h"
 #include "webrtc/voice_engine/include/voe_base.h"
 #include "webrtc/voice_engine/level_indicator.h"
 #include "webrtc/voice_engine/monitor_module.h"
@@ -32,6 +36,7 @@ class VoEMediaProcess;
 
 namespace voe {
 
+class Channel;
 class ChannelManager;
 class MixedAudio;
 class Statistics;
@@ -73,6 +78,12 @@ public:
     // Must be called on the same thread as PrepareDemux().
     uint32_t CaptureLevel() const;
 
+    // The pool of the frames shared with the sending channels. The channels
+    // copy the frames they write to into pools of their own.
+    const AudioFramePool* audio_frame_pool() const {
+        return audio_frame_pool_.get();
+    }
+
     int32_t StopSend();
 
     // VoEDtmf
@@ -172,6 +183,10 @@ private:
     // sending codecs.
     void GetSendCodecInfo(int* max_sample_rate, int* max_channels);
 
+    // Encodes and sends the audio of |channels|, which must be sending.
+    // Channels with the same send settings and input share one encoder.
+    void EncodeAndSendSharingEncoders(const std::vector<Channel*>& channels);
+
     void GenerateAudioFrame(const int16_t audioSamples[],
                             int nSamples,
                             int nChannels,
@@ -197,7 +212,9 @@ private:
 
     // owns
     MonitorModule _monitorModule;
-    AudioFrame _audioFrame;
+    scoped_refptr<AudioFramePool> audio_frame_pool_;
+    // Shared with the sending channels until they modify it.
+    AudioFrameRef _audioFrame;
     PushResampler<int16_t> resampler_;  // ADM sample rate -> mixing rate
     FilePlayer* _filePlayerPtr;
     FileRecorder* _fileRecorderPtr;
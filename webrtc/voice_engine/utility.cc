@@ -28,14 +28,14 @@ void RemixAndResample(const AudioFrame& src_frame,
                       AudioFrame* dst_frame) {
   const int16_t* audio_ptr = src_frame.data_;
   int audio_ptr_num_channels = src_frame.num_channels_;
-  int16_t mono_audio[AudioFrame::kMaxDataSizeSamples];
 
-  // Downmix before resampling.
+  // Downmix before resampling. The downmixed audio is written straight to
+  // |dst_frame| and resampled in place.
   if (src_frame.num_channels_ == 2 && dst_frame->num_channels_ == 1) {
     AudioFrameOperations::StereoToMono(src_frame.data_,
                                        src_frame.samples_per_channel_,
-                                       mono_audio);
-    audio_ptr = mono_audio;
+                                       dst_frame->data_);
+    audio_ptr = dst_frame->data_;
     audio_ptr_num_channels = 1;
   }
 
@@ -10,13 +10,25 @@
 
 #include "webrtc/voice_engine/include/voe_codec.h"
 
+#include <stdio.h>
+
+#include <map>
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/audio_device/include/fake_audio_device.h"
+#include "webrtc/modules/utility/interface/audio_frame_pool.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/test/testsupport/gtest_disable.h"
+#include "webrtc/voice_engine/channel.h"
+#include "webrtc/voice_engine/channel_manager.h"
 #include "webrtc/voice_engine/include/voe_base.h"
 #include "webrtc/voice_engine/include/voe_hardware.h"
+#include "webrtc/voice_engine/include/voe_network.h"
+#include "webrtc/voice_engine/transmit_mixer.h"
 #include "webrtc/voice_engine/voice_engine_defines.h"
+#include "webrtc/voice_engine/voice_engine_impl.h"
 
 namespace webrtc {
 namespace voe {
@@ -219,6 +231,262 @@ TEST(VoECodecInst, TestCompareCodecInstances) {
   EXPECT_FALSE(codec1 == codec2);
 }
 
+// Records the RTP timestamp and payload of every packet sent on a channel.
+class RecordingTransport : public Transport {
+ public:
+  struct Packet {
+    uint32_t timestamp;
+    std::vector<uint8_t> payload;
+  };
+
+  virtual int SendPacket(int channel, const void* data, size_t len) {
+    const size_t kRtpHeaderLength = 12;
+    if (len < kRtpHeaderLength)
+      return -1;
+    const uint8_t* packet = static_cast<const uint8_t*>(data);
+    Packet p;
+    p.timestamp = (packet[4] << 24) | (packet[5] << 16) | (packet[6] << 8) |
+                  packet[7];
+    p.payload.assign(packet + kRtpHeaderLength, packet + len);
+    packets_[channel].push_back(p);
+    return static_cast<int>(len);
+  }
+
+  virtual int SendRTCPPacket(int channel, const void* data, size_t len) {
+    return static_cast<int>(len);
+  }
+
+  const std::vector<Packet>& packets(int channel) { return packets_[channel]; }
+
+  void Clear() { packets_.clear(); }
+
+ private:
+  std::map<int, std::vector<Packet> > packets_;
+};
+
+class VoECodecSharedEncoderTest : public ::testing::Test {
+ protected:
+  static const int kSampleRateHz = 16000;
+  static const int kSamplesPer10Ms = kSampleRateHz / 100;
+
+  VoECodecSharedEncoderTest()
+      : voe_(VoiceEngine::Create()),
+        base_(VoEBase::GetInterface(voe_)),
+        voe_codec_(VoECodec::GetInterface(voe_)),
+        voe_network_(VoENetwork::GetInterface(voe_)),
+        adm_(new FakeAudioDeviceModule),
+        input_phase_(0) {
+  }
+
+  void SetUp() {
+    ASSERT_TRUE(voe_ != NULL);
+    ASSERT_TRUE(base_ != NULL);
+    ASSERT_TRUE(voe_codec_ != NULL);
+    ASSERT_TRUE(voe_network_ != NULL);
+    ASSERT_EQ(0, base_->Init(adm_.get()));
+
+    bool found = false;
+    for (int n = 0; n < voe_codec_->NumOfCodecs() && !found; ++n) {
+      EXPECT_EQ(0, voe_codec_->GetCodec(n, codec_));
+      found = !STR_CASE_CMP(codec_.plname, "isac") &&
+          codec_.plfreq == kSampleRateHz;
+    }
+    ASSERT_TRUE(found);
+  }
+
+  void TearDown() {
+    for (size_t i = 0; i < channels_.size(); ++i) {
+      base_->StopSend(channels_[i]);
+      voe_network_->DeRegisterExternalTransport(channels_[i]);
+      base_->DeleteChannel(channels_[i]);
+    }
+    base_->Terminate();
+    base_->Release();
+    voe_codec_->Release();
+    voe_network_->Release();
+    VoiceEngine::Delete(voe_);
+  }
+
+  void CreateSendingChannels(int num_channels) {
+    for (int i = 0; i < num_channels; ++i) {
+      int channel = base_->CreateChannel();
+      ASSERT_NE(-1, channel);
+      channels_.push_back(channel);
+      EXPECT_EQ(0, voe_network_->RegisterExternalTransport(channel,
+                                                           transport_));
+      EXPECT_EQ(0, voe_codec_->SetSendCodec(channel, codec_));
+      EXPECT_EQ(0, base_->StartSend(channel));
+    }
+  }
+
+  // Delivers 10 ms of a sweeping tone, or of silence, as captured audio.
+  void InsertCapturedAudio(bool silence) {
+    int16_t audio[kSamplesPer10Ms];
+    for (int i = 0; i < kSamplesPer10Ms; ++i) {
+      audio[i] = silence ? 0 : static_cast<int16_t>(
+          ((input_phase_ * 37) % 8000) - 4000);
+      ++input_phase_;
+    }
+    uint32_t new_mic_level = 0;
+    EXPECT_EQ(0, base_->audio_transport()->RecordedDataIsAvailable(
+        audio, kSamplesPer10Ms, 2, 1, kSampleRateHz, 0, 0, 0, false,
+        new_mic_level));
+  }
+
+  // Sums the frame pool statistics of the transmit mixer and the channels.
+  AudioFramePool::Stats GetFramePoolStats() {
+    VoiceEngineImpl* impl = static_cast<VoiceEngineImpl*>(voe_);
+    std::vector<const AudioFramePool*> pools(
+        1, impl->transmit_mixer()->audio_frame_pool());
+    for (size_t i = 0; i < channels_.size(); ++i) {
+      ChannelOwner owner = impl->channel_manager().GetChannel(channels_[i]);
+      pools.push_back(owner.channel()->audio_frame_pool());
+    }
+    AudioFramePool::Stats total;
+    for (size_t i = 0; i < pools.size(); ++i) {
+      AudioFramePool::Stats stats;
+      pools[i]->GetStats(&stats);
+      total.frames_allocated += stats.frames_allocated;
+      total.frames_in_use += stats.frames_in_use;
+      total.bytes_copied += stats.bytes_copied;
+    }
+    return total;
+  }
+
+  VoiceEngine* voe_;
+  VoEBase* base_;
+  VoECodec* voe_codec_;
+  VoENetwork* voe_network_;
+  scoped_ptr<FakeAudioDeviceModule> adm_;
+  RecordingTransport transport_;
+  CodecInst codec_;
+  std::vector<int> channels_;
+  int input_phase_;
+};
+
+TEST_F(VoECodecSharedEncoderTest,
+       DISABLED_ON_ANDROID(IdenticalChannelsSendIdenticalPayloads)) {
+  CreateSendingChannels(3);
+  for (int i = 0; i < 100; ++i)
+    InsertCapturedAudio(false);
+
+  const std::vector<RecordingTransport::Packet>& reference =
+      transport_.packets(channels_[0]);
+  ASSERT_FALSE(reference.empty());
+  for (size_t c = 1; c < channels_.size(); ++c) {
+    const std::vector<RecordingTransport::Packet>& packets =
+        transport_.packets(channels_[c]);
+    ASSERT_EQ(reference.size(), packets.size());
+    for (size_t i = 0; i < packets.size(); ++i) {
+      EXPECT_TRUE(reference[i].payload == packets[i].payload);
+      // Each channel keeps its own random RTP timestamp origin.
+      EXPECT_EQ(reference[i].timestamp - reference[0].timestamp,
+                packets[i].timestamp - packets[0].timestamp);
+    }
+  }
+}
+
+TEST_F(VoECodecSharedEncoderTest,
+       DISABLED_ON_ANDROID(TimestampsContinueWhenLeavingSharedEncoder)) {
+  CreateSendingChannels(2);
+  const std::vector<RecordingTransport::Packet>& reference =
+      transport_.packets(channels_[0]);
+  const std::vector<RecordingTransport::Packet>& packets =
+      transport_.packets(channels_[1]);
+  for (int i = 0; i < 50; ++i)
+    InsertCapturedAudio(false);
+  const size_t num_shared_packets = packets.size();
+  ASSERT_EQ(reference.size(), num_shared_packets);
+  ASSERT_GT(num_shared_packets, 0u);
+
+  // Enabling DTX gives the second channel an encoder of its own, which sends
+  // few packets while the input is silent.
+  EXPECT_EQ(0, voe_codec_->SetVADStatus(channels_[1], true, kVadConventional,
+                                        false));
+  for (int i = 0; i < 50; ++i)
+    InsertCapturedAudio(true);
+  const size_t reference_resume = reference.size();
+  const size_t resume = packets.size();
+  ASSERT_LT(resume - num_shared_packets + 5,
+            reference_resume - num_shared_packets);
+
+  // Matching the settings again makes it share the first channel's encoder.
+  EXPECT_EQ(0, voe_codec_->SetVADStatus(channels_[0], true, kVadConventional,
+                                        false));
+  for (int i = 0; i < 50; ++i)
+    InsertCapturedAudio(false);
+  ASSERT_EQ(reference.size() - reference_resume, packets.size() - resume);
+  ASSERT_GT(packets.size(), resume);
+
+  // The first channel encodes on its own throughout. While the encoder is
+  // shared, the second channel sends the same payloads, with the same
+  // timestamps relative to its first packet.
+  for (size_t i = 0; i < packets.size(); ++i) {
+    size_t j = i;
+    if (i >= resume)
+      j = reference_resume + i - resume;
+    else if (i >= num_shared_packets)
+      continue;
+    EXPECT_TRUE(reference[j].payload == packets[i].payload) << "Packet " << i;
+    EXPECT_EQ(reference[j].timestamp - reference[0].timestamp,
+              packets[i].timestamp - packets[0].timestamp) << "Packet " << i;
+  }
+}
+
+TEST_F(VoECodecSharedEncoderTest,
+       DISABLED_ON_ANDROID(ChannelsStartingLaterJoinSharedEncoder)) {
+  CreateSendingChannels(2);
+  for (int i = 0; i < 30; ++i)
+    InsertCapturedAudio(false);
+  CreateSendingChannels(8);
+  for (int i = 0; i < 30; ++i)
+    InsertCapturedAudio(false);
+
+  // A channel which starts sending later continues the payloads of the
+  // channels already sharing the encoder.
+  const std::vector<RecordingTransport::Packet>& reference =
+      transport_.packets(channels_[0]);
+  for (size_t c = 1; c < channels_.size(); ++c) {
+    const std::vector<RecordingTransport::Packet>& packets =
+        transport_.packets(channels_[c]);
+    ASSERT_FALSE(packets.empty()) << "Channel " << c;
+    ASSERT_LE(packets.size(), reference.size());
+    const size_t offset = reference.size() - packets.size();
+    for (size_t i = 0; i < packets.size(); ++i) {
+      EXPECT_TRUE(reference[offset + i].payload == packets[i].payload)
+          << "Channel " << c << ", packet " << i;
+    }
+  }
+}
+
+TEST_F(VoECodecSharedEncoderTest, DISABLED_SharedEncodingBenchmark) {
+  const int kNumFrames = 500;
+  const int kChannelCounts[] = {1, 10, 100};
+  int total_channels = 0;
+  for (size_t n = 0; n < sizeof(kChannelCounts) / sizeof(*kChannelCounts);
+       ++n) {
+    CreateSendingChannels(kChannelCounts[n] - total_channels);
+    total_channels = kChannelCounts[n];
+    transport_.Clear();
+
+    AudioFramePool::Stats start_stats = GetFramePoolStats();
+    TickTime start = TickTime::Now();
+    for (int i = 0; i < kNumFrames; ++i)
+      InsertCapturedAudio(false);
+    int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+    AudioFramePool::Stats stats = GetFramePoolStats();
+
+    for (size_t c = 0; c < channels_.size(); ++c)
+      EXPECT_FALSE(transport_.packets(channels_[c]).empty());
+    printf("%3d identical send channels: %6.1f us and %5.1f frame bytes "
+           "copied per 10 ms of audio, %d frames in use\n",
+           total_channels, static_cast<double>(elapsed_us) / kNumFrames,
+           static_cast<double>(stats.bytes_copied - start_stats.bytes_copied) /
+               kNumFrames,
+           static_cast<int>(stats.frames_in_use));
+  }
+}
+
 }  // namespace
 }  // namespace voe
 }  // namespace webrtc